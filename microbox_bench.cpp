@@ -0,0 +1,129 @@
+#ifdef EMULATOR
+#include "src/games/game_of_life_engine.hpp"
+#include "src/games/game_of_life_parallel.hpp"
+#include "src/common/logging.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#define TAG "bench_entrypoint"
+
+/**
+ * Options controlling the benchmark run, see `parse_options` for the
+ * corresponding command line flags.
+ */
+struct BenchOptions {
+        /**
+         * Number of rows and columns of the simulated board.
+         */
+        int size = 4096;
+        /**
+         * Number of generations that are timed for each configuration.
+         */
+        int generations = 100;
+};
+
+bool parse_options(int argc, char *argv[], BenchOptions *options);
+void run_benchmark(const BenchOptions &options, int threads,
+                   bool use_toroidal_array);
+
+/**
+ * Measures how fast the Game of Life boards are stepped on the host with
+ * 1, 2, 4 and all of its cores, on both toroidal and bounded boards.
+ */
+int main(int argc, char *argv[])
+{
+        BenchOptions options;
+        if (!parse_options(argc, argv, &options)) {
+                return 1;
+        }
+
+        int cores = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> thread_counts = {1, 2, 4};
+        if (cores != 1 && cores != 2 && cores != 4) {
+                thread_counts.push_back(cores);
+        }
+
+        printf("Game of Life %dx%d, %d generations, %d cores\n", options.size,
+               options.size, options.generations, cores);
+        printf("%-9s %8s %14s %18s\n", "edges", "threads", "generations/s",
+               "cell updates/s");
+        for (bool use_toroidal_array : {true, false}) {
+                for (int threads : thread_counts) {
+                        run_benchmark(options, threads, use_toroidal_array);
+                }
+        }
+        return 0;
+}
+
+void run_benchmark(const BenchOptions &options, int threads,
+                   bool use_toroidal_array)
+{
+        // Each run starts from the same 30% soup so that the results are
+        // comparable.
+        srand(1);
+        LifeGrid grid(options.size, options.size);
+        for (int y = 0; y < options.size; y++) {
+                for (int x = 0; x < options.size; x++) {
+                        grid.set(x, y, rand() % 10 <= 3);
+                }
+        }
+        LifeGrid next;
+        LifeGrid changed;
+        ParallelLifeStepper stepper(threads);
+
+        // The first step allocates the output grids.
+        stepper.take_simulation_step(grid, next, changed, use_toroidal_array);
+        std::swap(grid, next);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < options.generations; i++) {
+                stepper.take_simulation_step(grid, next, changed,
+                                             use_toroidal_array);
+                std::swap(grid, next);
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        double generations_per_second = options.generations / elapsed.count();
+        double cells = (double)options.size * options.size;
+        printf("%-9s %8d %14.1f %18.3e\n",
+               use_toroidal_array ? "toroidal" : "bounded", threads,
+               generations_per_second, generations_per_second * cells);
+}
+
+/**
+ * Parses the `--size` and `--generations` flags.
+ * Returns false if the flags are invalid.
+ */
+bool parse_options(int argc, char *argv[], BenchOptions *options)
+{
+        for (int i = 1; i < argc; i++) {
+                bool has_value = i + 1 < argc;
+                if (strcmp(argv[i], "--size") == 0 && has_value) {
+                        options->size = atoi(argv[++i]);
+                        if (options->size <= 0) {
+                                LOG_ERROR(TAG, "--size expects a positive "
+                                               "board size");
+                                return false;
+                        }
+                } else if (strcmp(argv[i], "--generations") == 0 &&
+                           has_value) {
+                        options->generations = atoi(argv[++i]);
+                        if (options->generations <= 0) {
+                                LOG_ERROR(TAG, "--generations expects a "
+                                               "positive number");
+                                return false;
+                        }
+                } else {
+                        LOG_ERROR(TAG, "Unrecognized argument: %s", argv[i]);
+                        return false;
+                }
+        }
+        return true;
+}
+#endif
@@ -5,6 +5,10 @@
 #include "src/menu.hpp"
 #include "src/platform/interface/platform.hpp"
 #include "src/platform/emulator/sfml_display.hpp"
+#include "src/platform/emulator/headless_display.hpp"
+#include "src/common/buffered_display.hpp"
+#include "src/common/palette_display.hpp"
+#include "src/common/instrumented_display.hpp"
 #include "src/platform/emulator/emulated_wifi_provider.cpp"
 #include "src/platform/emulator/emulator_http_client.hpp"
 #include "src/platform/emulator/emulator_time_provider.cpp"
@@ -14,10 +18,15 @@
 #include "src/platform/emulator/sfml_action_controller.hpp"
 #include "src/common/logging.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 #define TAG "emulator_entrypoint"
 
 SfmlDisplay *display;
 EmulatorTimeProvider time_provider;
+HeadlessTimeProvider headless_time_provider;
 SfmlInputController controller;
 SfmlAsdfInputController asdf_controller;
 SfmlHjklInputController hjkl_controller;
@@ -26,11 +35,72 @@ PersistentStorage persistent_storage;
 WifiProvider *wifi_provider;
 EmulatorHttpClient *client;
 
+/**
+ * Options controlling the emulator run, see `parse_options` for the
+ * corresponding command line flags.
+ */
+struct EmulatorOptions {
+        /**
+         * Renders into an in-memory framebuffer instead of opening a window.
+         */
+        bool headless = false;
+        /**
+         * Number of frames after which the headless emulator exits.
+         */
+        int frame_limit = 1;
+        /**
+         * Path of the .png or .ppm image that the headless emulator saves the
+         * final frame to.
+         */
+        const char *snapshot_path = nullptr;
+        /**
+         * Draws through a `BufferedDisplay` so that only the changed tiles
+         * reach the headless display, reports the number of pushed pixels.
+         */
+        bool buffered = false;
+        /**
+         * Composites the frames through a `PaletteDisplay` with the given
+         * number of bits per pixel (4 or 8), 0 disables it.
+         */
+        int palette_bits_per_pixel = 0;
+#ifdef DISPLAY_INSTRUMENTATION
+        /**
+         * Wraps the display in an `InstrumentedDisplay`, the collected drawing
+         * costs are logged on exit.
+         */
+        bool instrument = false;
+        /**
+         * Shows the cost of the last frame at the top of the screen.
+         */
+        bool instrumentation_overlay = false;
+        /**
+         * Path of the CSV file that the drawing costs are written to on exit.
+         */
+        const char *instrumentation_csv_path = nullptr;
+#endif
+};
+
 void print_version(char *argv[]);
+bool parse_options(int argc, char *argv[], EmulatorOptions *options);
+int run_headless(const EmulatorOptions &options);
+#ifdef DISPLAY_INSTRUMENTATION
+void instrument_display(const EmulatorOptions &options,
+                        InstrumentedDisplay *instrumented, Platform *platform);
+bool report_display_costs(const EmulatorOptions &options,
+                          const InstrumentedDisplay &instrumented);
+#endif
 int main(int argc, char *argv[])
 {
         print_version(argv);
 
+        EmulatorOptions options;
+        if (!parse_options(argc, argv, &options)) {
+                return 1;
+        }
+        if (options.headless) {
+                return run_headless(options);
+        }
+
         LOG_DEBUG(TAG, "Emulator enabled!");
 
         sf::RenderWindow window(sf::VideoMode({DISPLAY_WIDTH, DISPLAY_HEIGHT}),
@@ -84,6 +154,10 @@ int main(int argc, char *argv[])
                              .can_sleep = true,
                              .action_button_kind = ActionButtonKind::Letters,
                              .has_resizable_display = true}};
+#ifdef DISPLAY_INSTRUMENTATION
+        InstrumentedDisplay instrumented_display(display, &time_provider);
+        instrument_display(options, &instrumented_display, &platform);
+#endif
 
         /**
          * We allow the users of the emulator to configure an override for the
@@ -109,9 +183,222 @@ int main(int argc, char *argv[])
                         }
                 }
         }
+#ifdef DISPLAY_INSTRUMENTATION
+        report_display_costs(options, instrumented_display);
+#endif
+        delete (EmulatedWifiProvider *)wifi_provider;
+        delete (EmulatorHttpClient *)client;
+}
+
+/**
+ * Saves the last frame of the headless display in the format determined by
+ * the extension of the path (`.ppm` or `.png`). The PNG encoder comes from
+ * SFML, hence it is not a part of the headless display itself.
+ */
+static bool write_snapshot(const HeadlessDisplay &display, const char *path)
+{
+        size_t length = strlen(path);
+        if (length >= 4 && strcmp(path + length - 4, ".ppm") == 0) {
+                return display.write_ppm(path);
+        }
+        if (length >= 4 && strcmp(path + length - 4, ".png") == 0) {
+                return write_png(display.get_framebuffer(), path);
+        }
+        LOG_ERROR(TAG, "Unsupported snapshot format: %s", path);
+        return false;
+}
+
+/**
+ * Runs the emulator without a window, the apps render into a `HeadlessDisplay`
+ * and there are no input controllers attached, so the run is driven only by
+ * the frame limit. Once the limit is reached, the last frame is saved to the
+ * snapshot path (if one was provided).
+ */
+int run_headless(const EmulatorOptions &options)
+{
+        LOG_DEBUG(TAG, "Headless emulator enabled!");
+
+        HeadlessDisplay headless_display;
+        headless_display.set_frame_limit(options.frame_limit);
+        BufferedDisplay buffered_display(&headless_display);
+        PaletteDisplay palette_display(
+            &headless_display,
+            options.palette_bits_per_pixel ? options.palette_bits_per_pixel
+                                           : 4);
+        Display *display = &headless_display;
+        if (options.buffered) {
+                display = &buffered_display;
+        } else if (options.palette_bits_per_pixel) {
+                display = &palette_display;
+        }
+        display->setup();
+
+        persistent_storage = PersistentStorage{};
+        wifi_provider = new EmulatedWifiProvider();
+        client = new EmulatorHttpClient();
+
+        Platform platform = {
+            .display = display,
+            .directional_controllers = {},
+            .action_controllers = {},
+            .time_provider = &headless_time_provider,
+            .persistent_storage = &persistent_storage,
+            .wifi_provider = wifi_provider,
+            .client = client,
+            .capabilities = {.has_wifi = true,
+                             .can_sleep = true,
+                             .action_button_kind = ActionButtonKind::Letters,
+                             .has_resizable_display = false}};
+#ifdef DISPLAY_INSTRUMENTATION
+        // The costs are measured using the real clock, the headless time
+        // provider only advances on delays.
+        InstrumentedDisplay instrumented_display(display, &time_provider);
+        instrument_display(options, &instrumented_display, &platform);
+#endif
+
+        while (true) {
+                auto maybe_action = select_app_and_run(platform);
+                if (maybe_action.has_value() &&
+                    maybe_action.value() == UserAction::CloseWindow) {
+                        break;
+                }
+        }
+        LOG_DEBUG(TAG, "Rendered %d frames. Exiting...",
+                  headless_display.get_frame_count());
+        if (options.buffered) {
+                const BufferedDisplayStatistics &statistics =
+                    buffered_display.get_statistics();
+                LOG_INFO(TAG, "Pushed %ld pixels in %d frames (%ld per frame)",
+                         statistics.total_pixels_pushed, statistics.frames,
+                         statistics.total_pixels_pushed /
+                             std::max(statistics.frames, 1));
+                LOG_INFO(TAG, "Drew %ld pixels, %ld bytes saved",
+                         statistics.total_pixels_drawn,
+                         statistics.bytes_saved());
+        }
+        if (options.palette_bits_per_pixel) {
+                const IndexedFramebuffer &surface =
+                    palette_display.get_surface();
+                LOG_INFO(TAG, "Composited in %d bands of %d rows using %d bytes",
+                         palette_display.get_statistics().bands,
+                         surface.get_band_height(), surface.get_memory_usage());
+        }
+
+        int exit_code = 0;
+        if (options.snapshot_path &&
+            !write_snapshot(headless_display, options.snapshot_path)) {
+                exit_code = 1;
+        }
+#ifdef DISPLAY_INSTRUMENTATION
+        if (!report_display_costs(options, instrumented_display)) {
+                exit_code = 1;
+        }
+#endif
         delete (EmulatedWifiProvider *)wifi_provider;
         delete (EmulatorHttpClient *)client;
+        return exit_code;
+}
+
+/**
+ * Parses the command line flags of the emulator:
+ *  --headless          render into an in-memory framebuffer, no window
+ *  --frames <n>        exit the headless emulator after n frames (default 1)
+ *  --snapshot <path>   save the last headless frame as a .png or .ppm image
+ *  --buffered          draw through the dirty-tile buffered display
+ *  --palette <bits>    composite through the 4 or 8 bpp palette display
+ *  --instrument        measure the drawing costs and log them on exit
+ *  --instrument-overlay  show the cost of each frame on the screen
+ *  --instrument-csv <path>  write the drawing costs to a CSV file on exit
+ * The --instrument flags are only available if the emulator was built with
+ * the display instrumentation.
+ * Returns false if the flags are invalid.
+ */
+bool parse_options(int argc, char *argv[], EmulatorOptions *options)
+{
+        for (int i = 1; i < argc; i++) {
+                bool has_value = i + 1 < argc;
+                if (strcmp(argv[i], "--headless") == 0) {
+                        options->headless = true;
+                } else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+                        options->frame_limit = atoi(argv[++i]);
+                        if (options->frame_limit <= 0) {
+                                LOG_ERROR(TAG, "--frames expects a positive "
+                                               "number of frames");
+                                return false;
+                        }
+                } else if (strcmp(argv[i], "--buffered") == 0) {
+                        options->buffered = true;
+                } else if (strcmp(argv[i], "--palette") == 0 && has_value) {
+                        options->palette_bits_per_pixel = atoi(argv[++i]);
+                        if (options->palette_bits_per_pixel != 4 &&
+                            options->palette_bits_per_pixel != 8) {
+                                LOG_ERROR(TAG, "--palette expects 4 or 8 bits "
+                                               "per pixel");
+                                return false;
+                        }
+                } else if (strcmp(argv[i], "--snapshot") == 0 && has_value) {
+                        options->snapshot_path = argv[++i];
+#ifdef DISPLAY_INSTRUMENTATION
+                } else if (strcmp(argv[i], "--instrument") == 0) {
+                        options->instrument = true;
+                } else if (strcmp(argv[i], "--instrument-overlay") == 0) {
+                        options->instrument = true;
+                        options->instrumentation_overlay = true;
+                } else if (strcmp(argv[i], "--instrument-csv") == 0 &&
+                           has_value) {
+                        options->instrument = true;
+                        options->instrumentation_csv_path = argv[++i];
+#endif
+                } else {
+                        LOG_ERROR(TAG, "Unrecognized argument: %s", argv[i]);
+                        return false;
+                }
+        }
+        if (!options->headless &&
+            (options->snapshot_path || options->buffered ||
+             options->palette_bits_per_pixel)) {
+                LOG_ERROR(TAG, "--snapshot, --buffered and --palette require "
+                               "--headless");
+                return false;
+        }
+        if (options->buffered && options->palette_bits_per_pixel) {
+                LOG_ERROR(TAG, "--buffered and --palette cannot be combined");
+                return false;
+        }
+        return true;
+}
+
+#ifdef DISPLAY_INSTRUMENTATION
+/**
+ * Puts the instrumented display in front of the platform display if the
+ * instrumentation was requested.
+ */
+void instrument_display(const EmulatorOptions &options,
+                        InstrumentedDisplay *instrumented, Platform *platform)
+{
+        if (!options.instrument) {
+                return;
+        }
+        instrumented->set_overlay(options.instrumentation_overlay);
+        platform->display = instrumented;
+        platform->instrumentation = instrumented;
+}
+
+/**
+ * Logs the collected drawing costs and writes them to the CSV file if one was
+ * requested. Returns false if the file could not be written.
+ */
+bool report_display_costs(const EmulatorOptions &options,
+                          const InstrumentedDisplay &instrumented)
+{
+        if (!options.instrument) {
+                return true;
+        }
+        instrumented.log_summary();
+        return !options.instrumentation_csv_path ||
+               instrumented.write_csv(options.instrumentation_csv_path);
 }
+#endif
 
 void print_version(char *argv[])
 {
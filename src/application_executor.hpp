@@ -8,6 +8,7 @@
 #include "common/configuration.hpp"
 #include "common/logging.hpp"
 #include "common/common_transitions.hpp"
+#include "common/instrumented_display.hpp"
 
 #define EXECUTOR_TAG "executor"
 
@@ -80,6 +81,10 @@ std::optional<UserAction>
 execute_app(const ApplicationExecutor<ConfigStruct> &executor,
             const Platform &p, const UserInterfaceCustomization &customization)
 {
+#ifdef DISPLAY_INSTRUMENTATION
+        InstrumentedAppScope instrumented_app(p.instrumentation,
+                                              executor.get_game_name());
+#endif
 
         while (true) {
                 // Before each game/application we allow the user to specify its
@@ -100,9 +105,8 @@ execute_app(const ApplicationExecutor<ConfigStruct> &executor,
 
                 if (help_requested(maybe_event)) {
                         log_help_requested(executor.get_game_name());
-                        render_wrapped_help_text(p, customization,
-                                                 executor.get_help_text());
-                        auto maybe_event = wait_until_green_pressed(p);
+                        auto maybe_event = show_wrapped_help_text(
+                            p, customization, executor.get_help_text());
 
                         /*
                          * Here things get a bit complex on the emulator:
@@ -164,15 +164,11 @@ UserAction handle_fetch(const Platform &p,
         // calculated in the proper solution.
         int y_start =
             p.display->get_font_configuration().font_dimensions.height * 7;
-        render_bar_graph(p, customization, y_start, labels, temperatures,
-                         curr_idx);
+        BarGraph graph(p, customization, y_start, labels, temperatures);
+        graph.render(curr_idx);
 
-        auto move_datapoint_selection = [&](int prev_idx, int new_idx) {
-                render_bar_graph(p, customization, y_start, labels,
-                                 temperatures, prev_idx,
-                                 customization.accent_color, true);
-                render_bar_graph(p, customization, y_start, labels,
-                                 temperatures, new_idx, Color::Red, true);
+        auto move_datapoint_selection = [&](int new_idx) {
+                graph.move_highlight(new_idx);
 
                 const auto &datapoint = new_idx == current_time_idx
                                             ? data.current
@@ -197,15 +193,13 @@ UserAction handle_fetch(const Platform &p,
                 if (maybe_direction.has_value()) {
                         Direction dir = maybe_direction.value();
                         if (dir == Direction::LEFT) {
-                                int prev = curr_idx;
                                 curr_idx = modulo_decrement(curr_idx,
                                                             data.hourly.size());
-                                move_datapoint_selection(prev, curr_idx);
+                                move_datapoint_selection(curr_idx);
                         } else if (dir == Direction::RIGHT) {
-                                int prev = curr_idx;
                                 curr_idx = modulo_increment(curr_idx,
                                                             data.hourly.size());
-                                move_datapoint_selection(prev, curr_idx);
+                                move_datapoint_selection(curr_idx);
                         }
                 }
 
@@ -220,18 +214,16 @@ UserAction handle_fetch(const Platform &p,
                         }
                         switch (act) {
                         case CONFIRM_ACTION: {
-                                int prev = curr_idx;
                                 curr_idx = current_time_idx;
-                                move_datapoint_selection(prev, curr_idx);
+                                move_datapoint_selection(curr_idx);
                         } break;
                         case BACK_ACTION:
                                 p.time_provider->delay_ms(INPUT_POLLING_DELAY);
                                 return UserAction::PlayAgain;
                         case FORWARD_ACTION: {
-                                int prev = curr_idx;
                                 curr_idx = modulo_increment(curr_idx,
                                                             data.hourly.size());
-                                move_datapoint_selection(prev, curr_idx);
+                                move_datapoint_selection(curr_idx);
                                 // Wait a bit longer on forward scroll on button
                                 // presses. This is needed for higher precision
                                 // steering of the highlight selection.
@@ -245,16 +237,14 @@ UserAction handle_fetch(const Platform &p,
                                     "current time. Press left to advance "
                                     "slowly by one datapoint. Press "
                                     "right to exit.";
-                                render_wrapped_help_text(p, customization,
-                                                         message);
-                                wait_until_green_pressed(p);
+                                graph.release();
+                                show_wrapped_help_text(p, customization,
+                                                       message);
                                 p.display->clear(Black);
                                 render_weather_data(p, data.current,
                                                     config.forecast_days,
                                                     false);
-                                render_bar_graph(p, customization, y_start,
-                                                 labels, temperatures,
-                                                 curr_idx);
+                                graph.render(curr_idx);
                         }
                 }
                 input_registered_last_iteration = true;
@@ -0,0 +1,303 @@
+#include "buffered_display.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "buffered_display"
+
+/**
+ * Returns true if the two rectangles overlap or share an edge.
+ */
+static bool touches(const DirtyRect &a, const DirtyRect &b)
+{
+        return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+               a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+static DirtyRect bounding_box(const DirtyRect &a, const DirtyRect &b)
+{
+        int x = std::min(a.x, b.x);
+        int y = std::min(a.y, b.y);
+        int x_end = std::max(a.x + a.width, b.x + b.width);
+        int y_end = std::max(a.y + a.height, b.y + b.height);
+        return {x, y, x_end - x, y_end - y};
+}
+
+static long area(const DirtyRect &rect)
+{
+        return (long)rect.width * rect.height;
+}
+
+void DirtyTrackingFramebuffer::mark_dirty(DirtyRect rect)
+{
+        // Absorb all rectangles touching the new one, the resulting bounding
+        // box might touch some of the remaining ones, hence we repeat until
+        // no more merges are possible.
+        bool merged = true;
+        while (merged) {
+                merged = false;
+                for (size_t i = 0; i < dirty_rects.size(); i++) {
+                        if (touches(dirty_rects[i], rect)) {
+                                rect = bounding_box(dirty_rects[i], rect);
+                                dirty_rects.erase(dirty_rects.begin() + i);
+                                merged = true;
+                                break;
+                        }
+                }
+        }
+
+        if (dirty_rects.size() < BUFFERED_DISPLAY_MAX_DIRTY_RECTS) {
+                dirty_rects.push_back(rect);
+                return;
+        }
+
+        size_t best = 0;
+        long best_growth = -1;
+        for (size_t i = 0; i < dirty_rects.size(); i++) {
+                long growth = area(bounding_box(dirty_rects[i], rect)) -
+                              area(dirty_rects[i]);
+                if (best_growth == -1 || growth < best_growth) {
+                        best = i;
+                        best_growth = growth;
+                }
+        }
+        DirtyRect merged_rect = bounding_box(dirty_rects[best], rect);
+        dirty_rects.erase(dirty_rects.begin() + best);
+        mark_dirty(merged_rect);
+}
+
+void DirtyTrackingFramebuffer::fill_clipped_rect(int x, int y, int w, int h,
+                                                 uint16_t color)
+{
+        Rgb565Framebuffer::fill_clipped_rect(x, y, w, h, color);
+        mark_dirty({x, y, w, h});
+        drawn_pixels += (long)w * h;
+}
+
+void DirtyTrackingFramebuffer::push_image(int x, int y, int w, int h,
+                                          const uint16_t *data)
+{
+        Rgb565Framebuffer::push_image(x, y, w, h, data);
+        int x_start = std::max(x, 0);
+        int y_start = std::max(y, 0);
+        int x_end = std::min(x + w, width);
+        int y_end = std::min(y + h, height);
+        if (x_start < x_end && y_start < y_end) {
+                mark_dirty({x_start, y_start, x_end - x_start,
+                            y_end - y_start});
+                drawn_pixels += (long)(x_end - x_start) * (y_end - y_start);
+        }
+}
+
+BufferedDisplay::BufferedDisplay(Display *display, ShadowMode shadow_mode)
+    : display(display), tft_display(display->cast_into_tft_compatible()),
+      shadow_mode(shadow_mode),
+      tiles_x((display->get_width() + BUFFERED_DISPLAY_TILE_SIZE - 1) /
+              BUFFERED_DISPLAY_TILE_SIZE),
+      tiles_y((display->get_height() + BUFFERED_DISPLAY_TILE_SIZE - 1) /
+              BUFFERED_DISPLAY_TILE_SIZE),
+      back_buffer(display->get_width(), display->get_height(),
+                  shadow_mode == ShadowMode::TileHashes
+                      ? BUFFERED_DISPLAY_TILE_SIZE
+                      : 0),
+      tile_states(tiles_x * tiles_y)
+{
+        if (shadow_mode == ShadowMode::FullCopy) {
+                front_buffer.resize(display->get_width() *
+                                    display->get_height());
+        } else {
+                tile_hashes.resize(tiles_x * tiles_y);
+        }
+}
+
+void BufferedDisplay::setup() const
+{
+        display->setup();
+        invalidate();
+}
+
+void BufferedDisplay::initialize() const { display->initialize(); }
+
+void BufferedDisplay::sleep() const { display->sleep(); }
+
+int BufferedDisplay::get_height() const { return display->get_height(); }
+
+int BufferedDisplay::get_width() const { return display->get_width(); }
+
+DisplayDimensions BufferedDisplay::get_display_dimensions() const
+{
+        return display->get_display_dimensions();
+}
+
+int BufferedDisplay::get_display_corner_radius() const
+{
+        return display->get_display_corner_radius();
+}
+
+bool BufferedDisplay::refresh() const
+{
+        flush();
+        return display->refresh();
+}
+
+void BufferedDisplay::invalidate() const { full_repaint = true; }
+
+/**
+ * FNV-1a hash of the pixels of a tile.
+ */
+static uint32_t hash_tile(const Rgb565Framebuffer &framebuffer, int x, int y,
+                          int w, int h)
+{
+        uint32_t hash = 2166136261u;
+        for (int row = y; row < y + h; row++) {
+                const uint16_t *row_pixels = framebuffer.row(row) + x;
+                for (int column = 0; column < w; column++) {
+                        hash = (hash ^ (row_pixels[column] & 0xFF)) * 16777619u;
+                        hash = (hash ^ (row_pixels[column] >> 8)) * 16777619u;
+                }
+        }
+        return hash;
+}
+
+bool BufferedDisplay::tile_changed(int tile_x, int tile_y) const
+{
+        int width = get_width();
+        int x = tile_x * BUFFERED_DISPLAY_TILE_SIZE;
+        int y = tile_y * BUFFERED_DISPLAY_TILE_SIZE;
+        int w = std::min(BUFFERED_DISPLAY_TILE_SIZE, width - x);
+        int h = std::min(BUFFERED_DISPLAY_TILE_SIZE, get_height() - y);
+
+        if (shadow_mode == ShadowMode::TileHashes) {
+                uint32_t hash = hash_tile(back_buffer, x, y, w, h);
+                uint32_t &displayed_hash = tile_hashes[tile_y * tiles_x + tile_x];
+                bool changed = full_repaint || hash != displayed_hash;
+                displayed_hash = hash;
+                return changed;
+        }
+
+        if (full_repaint) {
+                return true;
+        }
+        for (int row = y; row < y + h; row++) {
+                const uint16_t *back = back_buffer.row(row) + x;
+                const uint16_t *front = front_buffer.data() + row * width + x;
+                if (memcmp(back, front, w * sizeof(uint16_t)) != 0) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+void BufferedDisplay::flush() const
+{
+        enum TileState : uint8_t { Unchecked, Unchanged, Changed };
+
+        std::fill(tile_states.begin(), tile_states.end(), Unchecked);
+        std::vector<DirtyRect> full_screen;
+        if (full_repaint) {
+                full_screen.push_back({0, 0, get_width(), get_height()});
+        }
+        const std::vector<DirtyRect> &dirty_rects =
+            full_repaint ? full_screen : back_buffer.get_dirty_rects();
+
+        for (const DirtyRect &rect : dirty_rects) {
+                int first_x = rect.x / BUFFERED_DISPLAY_TILE_SIZE;
+                int last_x = (rect.x + rect.width - 1) /
+                             BUFFERED_DISPLAY_TILE_SIZE;
+                int first_y = rect.y / BUFFERED_DISPLAY_TILE_SIZE;
+                int last_y = (rect.y + rect.height - 1) /
+                             BUFFERED_DISPLAY_TILE_SIZE;
+                for (int ty = first_y; ty <= last_y; ty++) {
+                        for (int tx = first_x; tx <= last_x; tx++) {
+                                uint8_t &state = tile_states[ty * tiles_x + tx];
+                                if (state == Unchecked) {
+                                        state = tile_changed(tx, ty)
+                                                    ? Changed
+                                                    : Unchanged;
+                                }
+                        }
+                }
+        }
+
+        statistics.frames++;
+        statistics.tiles_pushed = 0;
+        statistics.pixels_pushed = 0;
+        statistics.transfers = 0;
+
+        // Consecutive changed tiles in a tile row are pushed as one window.
+        for (int ty = 0; ty < tiles_y; ty++) {
+                int tx = 0;
+                while (tx < tiles_x) {
+                        if (tile_states[ty * tiles_x + tx] != Changed) {
+                                tx++;
+                                continue;
+                        }
+                        int first = tx;
+                        while (tx < tiles_x &&
+                               tile_states[ty * tiles_x + tx] == Changed) {
+                                tx++;
+                        }
+                        push_tiles(first, tx - 1, ty);
+                }
+        }
+
+        statistics.total_pixels_pushed += statistics.pixels_pushed;
+        long drawn_pixels = back_buffer.get_drawn_pixels();
+        statistics.pixels_drawn = drawn_pixels - statistics.total_pixels_drawn;
+        statistics.total_pixels_drawn = drawn_pixels;
+        back_buffer.clear_dirty_rects();
+        full_repaint = false;
+}
+
+void BufferedDisplay::push_tiles(int first_tile_x, int last_tile_x,
+                                 int tile_y) const
+{
+        int width = get_width();
+        int x = first_tile_x * BUFFERED_DISPLAY_TILE_SIZE;
+        int y = tile_y * BUFFERED_DISPLAY_TILE_SIZE;
+        int x_end = std::min((last_tile_x + 1) * BUFFERED_DISPLAY_TILE_SIZE,
+                             width);
+        int y_end = std::min(y + BUFFERED_DISPLAY_TILE_SIZE, get_height());
+
+        push_window(x, y, x_end - x, y_end - y);
+
+        if (shadow_mode == ShadowMode::FullCopy) {
+                for (int row = y; row < y_end; row++) {
+                        const uint16_t *source = back_buffer.row(row) + x;
+                        std::copy(source, source + (x_end - x),
+                                  front_buffer.data() + row * width + x);
+                }
+        }
+        statistics.tiles_pushed += last_tile_x - first_tile_x + 1;
+        statistics.pixels_pushed += (long)(x_end - x) * (y_end - y);
+}
+
+void BufferedDisplay::push_window(int x, int y, int w, int h) const
+{
+        if (tft_display) {
+                staging_buffer.resize(w * h);
+                for (int row = 0; row < h; row++) {
+                        const uint16_t *source = back_buffer.row(y + row) + x;
+                        std::copy(source, source + w,
+                                  staging_buffer.data() + row * w);
+                }
+                tft_display->pushImage(x, y, w, h, staging_buffer.data());
+                statistics.transfers++;
+                return;
+        }
+
+        for (int row = y; row < y + h; row++) {
+                const uint16_t *pixels = back_buffer.row(row);
+                int run_start = x;
+                for (int column = x + 1; column <= x + w; column++) {
+                        if (column < x + w &&
+                            pixels[column] == pixels[run_start]) {
+                                continue;
+                        }
+                        display->clear_region({.x = run_start, .y = row},
+                                              {.x = column, .y = row + 1},
+                                              (Color)pixels[run_start]);
+                        statistics.transfers++;
+                        run_start = column;
+                }
+        }
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include "framebuffer.hpp"
+#include "framebuffer_display.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Size (in pixels) of the square tiles that the buffered display compares and
+ * pushes to the underlying display.
+ */
+#define BUFFERED_DISPLAY_TILE_SIZE 16
+/**
+ * Maximum number of disjoint dirty rectangles tracked between two refreshes.
+ * Once the limit is reached, the new rectangle is merged with the one that
+ * results in the smallest bounding box.
+ */
+#define BUFFERED_DISPLAY_MAX_DIRTY_RECTS 16
+
+struct DirtyRect {
+        int x;
+        int y;
+        int width;
+        int height;
+};
+
+/**
+ * Framebuffer that keeps track of the regions that were drawn into since the
+ * dirty rectangles were last cleared. Overlapping and adjacent regions are
+ * merged into their bounding box as they are recorded.
+ */
+class DirtyTrackingFramebuffer : public Rgb565Framebuffer
+{
+      public:
+        DirtyTrackingFramebuffer(int width, int height, int strip_height = 0)
+            : Rgb565Framebuffer(width, height, strip_height)
+        {
+        }
+
+        void push_image(int x, int y, int w, int h,
+                        const uint16_t *data) override;
+
+        const std::vector<DirtyRect> &get_dirty_rects() const
+        {
+                return dirty_rects;
+        }
+        void clear_dirty_rects() { dirty_rects.clear(); }
+        /**
+         * Number of pixels written since the framebuffer was created, pixels
+         * written several times are counted each time.
+         */
+        long get_drawn_pixels() const { return drawn_pixels; }
+
+      protected:
+        void fill_clipped_rect(int x, int y, int w, int h,
+                               uint16_t color) override;
+
+      private:
+        void mark_dirty(DirtyRect rect);
+        std::vector<DirtyRect> dirty_rects;
+        long drawn_pixels = 0;
+};
+
+/**
+ * Determines how the buffered display remembers what is currently shown on the
+ * underlying display.
+ */
+enum class ShadowMode {
+        /**
+         * Keeps a full copy of the displayed frame, the tiles are compared
+         * pixel by pixel. Requires two full framebuffers.
+         */
+        FullCopy,
+        /**
+         * Keeps only a hash of each displayed tile. This needs a fraction of
+         * the memory of the full copy and is intended for memory-constrained
+         * targets, the framebuffer the apps draw into is allocated in strips
+         * one tile high for the same reason.
+         */
+        TileHashes,
+};
+
+struct BufferedDisplayStatistics {
+        int frames = 0;
+        /**
+         * Numbers of tiles, pixels and driver calls (window transfers) sent
+         * to the underlying display during the last refresh.
+         */
+        int tiles_pushed = 0;
+        long pixels_pushed = 0;
+        int transfers = 0;
+        long total_pixels_pushed = 0;
+        /**
+         * Pixels written by the drawing calls during the last refresh and
+         * in total, this is what the wrapped display would have received
+         * without the buffering.
+         */
+        long pixels_drawn = 0;
+        long total_pixels_drawn = 0;
+
+        /**
+         * Bytes of RGB565 pixels that did not need to be sent to the wrapped
+         * display. This is negative if the pushed tiles were mostly drawn
+         * into only partially.
+         */
+        long bytes_saved() const
+        {
+                return (total_pixels_drawn - total_pixels_pushed) *
+                       (long)sizeof(uint16_t);
+        }
+};
+
+/**
+ * Display decorator that lets the apps draw naively while the wrapped display
+ * only receives the regions that have actually changed.
+ *
+ * All drawing is rasterized into a shadow framebuffer (see
+ * `FramebufferDisplay`). On `refresh` the dirty regions recorded since the
+ * previous refresh are split into tiles, the tiles whose contents differ from
+ * what is currently shown are pushed to the wrapped display and only then
+ * the wrapped display is refreshed. Horizontally adjacent changed tiles are
+ * pushed as a single window.
+ *
+ * If the wrapped display exposes the TFT-compatible interface, the tiles are
+ * sent using `pushImage`. Otherwise, each row of a tile is decomposed into runs
+ * of pixels with the same color which are sent using `clear_region`.
+ */
+class BufferedDisplay : public FramebufferDisplay
+{
+      public:
+        BufferedDisplay(Display *display,
+                        ShadowMode shadow_mode = ShadowMode::FullCopy);
+
+        void setup() const override;
+        void initialize() const override;
+        int get_height() const override;
+        int get_width() const override;
+        DisplayDimensions get_display_dimensions() const override;
+        int get_display_corner_radius() const override;
+        /**
+         * Pushes the changed tiles to the wrapped display and refreshes it.
+         */
+        bool refresh() const override;
+        void sleep() const override;
+
+        /**
+         * Pushes the changed tiles without refreshing the wrapped display.
+         */
+        void flush() const;
+        /**
+         * Forgets what is shown on the wrapped display, all tiles are pushed
+         * on the next refresh.
+         */
+        void invalidate() const;
+
+        const BufferedDisplayStatistics &get_statistics() const
+        {
+                return statistics;
+        }
+
+      protected:
+        RasterTarget &target() const override { return back_buffer; }
+
+      private:
+        Display *display;
+        TftCompatibleDisplay *tft_display;
+        ShadowMode shadow_mode;
+
+        int tiles_x;
+        int tiles_y;
+
+        mutable DirtyTrackingFramebuffer back_buffer;
+        /**
+         * Contents of the wrapped display, only used in the `FullCopy` mode.
+         */
+        mutable std::vector<uint16_t> front_buffer;
+        /**
+         * Hashes of the tiles shown on the wrapped display, only used in the
+         * `TileHashes` mode.
+         */
+        mutable std::vector<uint32_t> tile_hashes;
+        /**
+         * Scratch buffers reused between refreshes: state of each tile
+         * during the current flush and the pixels of the pushed window.
+         */
+        mutable std::vector<uint8_t> tile_states;
+        mutable std::vector<uint16_t> staging_buffer;
+        mutable bool full_repaint = true;
+
+        mutable BufferedDisplayStatistics statistics;
+
+        bool tile_changed(int tile_x, int tile_y) const;
+        void push_tiles(int first_tile_x, int last_tile_x, int tile_y) const;
+        void push_window(int x, int y, int w, int h) const;
+};
@@ -374,13 +374,14 @@ collect_configuration(const Platform &p, Configuration &config,
  * Responsible for rendering a menu allowing the user to select from a list of
  * available options by 'scrolling' left and right. Each of the list options
  * needs to provide a thumbnail renderer that will be invoked when the game is
- * selected.
+ * selected. If a thumbnail cache is provided, the thumbnails are drawn through
+ * it and keyed by the index of the option.
  */
 std::optional<UserAction> collect_configuration_single_option_with_thumbnails(
     const Platform &p, const UserInterfaceCustomization &customization,
     ConfigurationOption &option, const char *menu_name,
     const std::vector<std::unique_ptr<ThumbnailRenderer>> &thumbnails,
-    bool allow_exit, bool should_render_logo)
+    bool allow_exit, bool should_render_logo, ThumbnailCache *thumbnail_cache)
 {
         // Sanity check ensuring that we have enough thumbnail renderers for
         // each available option.
@@ -400,8 +401,14 @@ std::optional<UserAction> collect_configuration_single_option_with_thumbnails(
                             should_render_logo);
 
         auto render_thumbnail_for_current_selection = [&]() {
-                thumbnails[option.currently_selected]->render_thumbnail(
-                    p, customization);
+                ThumbnailRenderer &renderer =
+                    *thumbnails[option.currently_selected];
+                if (thumbnail_cache) {
+                        thumbnail_cache->render(option.currently_selected,
+                                                renderer, p, customization);
+                        return;
+                }
+                renderer.render_thumbnail(p, customization);
         };
         render_thumbnail_for_current_selection();
 
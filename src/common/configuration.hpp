@@ -3,6 +3,7 @@
 #include "../platform/interface/platform.hpp"
 #include "user_interface_customization.hpp"
 #include "thumbnail.hpp"
+#include "thumbnail_cache.hpp"
 #include "map"
 #include <optional>
 
@@ -267,7 +268,8 @@ std::optional<UserAction> collect_configuration_single_option_with_thumbnails(
     const Platform &p, const UserInterfaceCustomization &customization,
     ConfigurationOption &option, const char *menu_name,
     const std::vector<std::unique_ptr<ThumbnailRenderer>> &thumbnails,
-    bool allow_exit, bool should_render_logo);
+    bool allow_exit, bool should_render_logo,
+    ThumbnailCache *thumbnail_cache = nullptr);
 
 void populate_int_option_values(ConfigurationOption &value,
                                 const std::vector<int> &available_values);
@@ -0,0 +1,356 @@
+#include "draw_command.hpp"
+#include <initializer_list>
+
+#define TAG "draw_command"
+
+void replay_draw_command(const DrawCommand &command, const char *text,
+                         Display &display)
+{
+        const int16_t *a = command.args;
+        Color color = (Color)command.color;
+        Color bg_color = (Color)command.bg_color;
+        switch (command.type) {
+        case DrawCommandType::Clear:
+                display.clear(color);
+                return;
+        case DrawCommandType::RoundedBorder:
+                display.draw_rounded_border(color);
+                return;
+        case DrawCommandType::Circle:
+                display.draw_circle({.x = a[0], .y = a[1]}, a[2], color, a[3],
+                                    command.flags != 0);
+                return;
+        case DrawCommandType::Rectangle:
+                display.draw_rectangle({.x = a[0], .y = a[1]}, a[2], a[3],
+                                       color, a[4], command.flags != 0);
+                return;
+        case DrawCommandType::RoundedRectangle:
+                display.draw_rounded_rectangle({.x = a[0], .y = a[1]}, a[2],
+                                               a[3], a[4], color);
+                return;
+        case DrawCommandType::Line:
+                display.draw_line({.x = a[0], .y = a[1]}, {.x = a[2], .y = a[3]},
+                                  color);
+                return;
+        case DrawCommandType::String:
+                // None of the displays modify the buffer, the interface
+                // only takes a non-const pointer for historical reasons.
+                display.draw_string({.x = a[0], .y = a[1]},
+                                    const_cast<char *>(text),
+                                    (FontSize)command.flags, bg_color, color);
+                return;
+        case DrawCommandType::ClearRegion:
+                display.clear_region({.x = a[0], .y = a[1]},
+                                     {.x = a[2], .y = a[3]}, color);
+                return;
+        case DrawCommandType::Scroll:
+                display.set_scroll({.axis = (ScrollAxis)command.flags,
+                                    .top_left = {.x = a[0], .y = a[1]},
+                                    .width = a[2],
+                                    .height = a[3]},
+                                   a[4]);
+                return;
+        default:
+                break;
+        }
+
+        TftCompatibleDisplay *tft = display.cast_into_tft_compatible();
+        if (!tft) {
+                return;
+        }
+        switch (command.type) {
+        case DrawCommandType::TftPixel:
+                tft->drawPixel(a[0], a[1], command.color);
+                break;
+        case DrawCommandType::TftChar:
+                tft->drawChar(a[0], a[1], a[2], command.color,
+                              command.bg_color, command.flags);
+                break;
+        case DrawCommandType::TftLine:
+                tft->drawLine(a[0], a[1], a[2], a[3], command.color);
+                break;
+        case DrawCommandType::TftRect:
+                tft->drawRect(a[0], a[1], a[2], a[3], command.color);
+                break;
+        case DrawCommandType::TftFillRect:
+                tft->fillRect(a[0], a[1], a[2], a[3], command.color);
+                break;
+        case DrawCommandType::TftTriangle:
+                tft->drawTriangle(a[0], a[1], a[2], a[3], a[4], a[5],
+                                  command.color);
+                break;
+        case DrawCommandType::TftFillTriangle:
+                tft->fillTriangle(a[0], a[1], a[2], a[3], a[4], a[5],
+                                  command.color);
+                break;
+        case DrawCommandType::TftRoundRect:
+                tft->drawRoundRect(a[0], a[1], a[2], a[3], a[4],
+                                   command.color);
+                break;
+        case DrawCommandType::TftFillRoundRect:
+                tft->fillRoundRect(a[0], a[1], a[2], a[3], a[4],
+                                   command.color);
+                break;
+        case DrawCommandType::TftCircle:
+                tft->drawCircle(a[0], a[1], a[2], command.color);
+                break;
+        case DrawCommandType::TftFillCircle:
+                tft->fillCircle(a[0], a[1], a[2], command.color);
+                break;
+        case DrawCommandType::TftEllipse:
+                tft->drawEllipse(a[0], a[1], a[2], a[3], command.color);
+                break;
+        case DrawCommandType::TftFillEllipse:
+                tft->fillEllipse(a[0], a[1], a[2], a[3], command.color);
+                break;
+        case DrawCommandType::TftString:
+                tft->drawString(text, a[0], a[1]);
+                break;
+        case DrawCommandType::TftFillScreen:
+                tft->fillScreen(command.color);
+                break;
+        case DrawCommandType::TftTextColor:
+                tft->setTextColor(command.color);
+                break;
+        case DrawCommandType::TftTextSize:
+                tft->setTextSize(command.flags);
+                break;
+        case DrawCommandType::TftImage:
+                tft->pushImage(a[0], a[1], a[2], a[3], command.image);
+                break;
+        default:
+                break;
+        }
+}
+
+/**
+ * Builds a command, the unused arguments are zeroed.
+ */
+static DrawCommand make_command(DrawCommandType type, uint32_t color,
+                                std::initializer_list<int32_t> args,
+                                uint8_t flags = 0, uint32_t bg_color = 0,
+                                const uint16_t *image = nullptr)
+{
+        DrawCommand command = {.type = type,
+                               .flags = flags,
+                               .color = (uint16_t)color,
+                               .bg_color = (uint16_t)bg_color,
+                               .args = {},
+                               .image = image};
+        int i = 0;
+        for (int32_t arg : args) {
+                command.args[i++] = (int16_t)arg;
+        }
+        return command;
+}
+
+void DrawCommandRecorder::clear(Color color) const
+{
+        record(make_command(DrawCommandType::Clear, color, {}), nullptr);
+}
+
+void DrawCommandRecorder::draw_rounded_border(Color color) const
+{
+        record(make_command(DrawCommandType::RoundedBorder, color, {}),
+               nullptr);
+}
+
+void DrawCommandRecorder::draw_circle(IntPoint center, int radius, Color color,
+                                      int border_width, bool filled) const
+{
+        record(make_command(DrawCommandType::Circle, color,
+                            {center.x, center.y, radius, border_width},
+                            filled),
+               nullptr);
+}
+
+void DrawCommandRecorder::draw_rectangle(IntPoint start, int width, int height,
+                                         Color color, int border_width,
+                                         bool filled) const
+{
+        record(make_command(DrawCommandType::Rectangle, color,
+                            {start.x, start.y, width, height, border_width},
+                            filled),
+               nullptr);
+}
+
+void DrawCommandRecorder::draw_rounded_rectangle(IntPoint start, int width,
+                                                 int height, int radius,
+                                                 Color color) const
+{
+        record(make_command(DrawCommandType::RoundedRectangle, color,
+                            {start.x, start.y, width, height, radius}),
+               nullptr);
+}
+
+void DrawCommandRecorder::draw_line(IntPoint start, IntPoint end,
+                                    Color color) const
+{
+        record(make_command(DrawCommandType::Line, color,
+                            {start.x, start.y, end.x, end.y}),
+               nullptr);
+}
+
+void DrawCommandRecorder::draw_string(IntPoint start, char *string_buffer,
+                                      FontSize font_size, Color bg_color,
+                                      Color fg_color) const
+{
+        record(make_command(DrawCommandType::String, fg_color,
+                            {start.x, start.y}, font_size, bg_color),
+               string_buffer);
+}
+
+void DrawCommandRecorder::clear_region(IntPoint top_left, IntPoint bottom_right,
+                                       Color clear_color) const
+{
+        record(make_command(DrawCommandType::ClearRegion, clear_color,
+                            {top_left.x, top_left.y, bottom_right.x,
+                             bottom_right.y}),
+               nullptr);
+}
+
+void DrawCommandRecorder::set_scroll(const ScrollRegion &region,
+                                     int offset) const
+{
+        record(make_command(DrawCommandType::Scroll, 0,
+                            {region.top_left.x, region.top_left.y,
+                             region.width, region.height, offset},
+                            (uint8_t)region.axis),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+        record(make_command(DrawCommandType::TftPixel, color, {x, y}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawChar(int32_t x, int32_t y, uint16_t c,
+                                   uint32_t color, uint32_t bg, uint8_t size)
+{
+        record(make_command(DrawCommandType::TftChar, color, {x, y, c}, size,
+                            bg),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawLine(int32_t xs, int32_t ys, int32_t xe,
+                                   int32_t ye, uint32_t color)
+{
+        record(make_command(DrawCommandType::TftLine, color, {xs, ys, xe, ye}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawRect(int x, int y, int w, int h, int color)
+{
+        record(make_command(DrawCommandType::TftRect, color, {x, y, w, h}),
+               nullptr);
+}
+
+void DrawCommandRecorder::fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                                   uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillRect, color, {x, y, w, h}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawTriangle(int32_t xs, int32_t ys, int32_t x2,
+                                       int32_t y2, int32_t xe, int32_t ye,
+                                       uint32_t color)
+{
+        record(make_command(DrawCommandType::TftTriangle, color,
+                            {xs, ys, x2, y2, xe, ye}),
+               nullptr);
+}
+
+void DrawCommandRecorder::fillTriangle(int32_t xs, int32_t ys, int32_t x2,
+                                       int32_t y2, int32_t xe, int32_t ye,
+                                       uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillTriangle, color,
+                            {xs, ys, x2, y2, xe, ye}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawRoundRect(int32_t x, int32_t y, int32_t w,
+                                        int32_t h, int32_t radius,
+                                        uint32_t color)
+{
+        record(make_command(DrawCommandType::TftRoundRect, color,
+                            {x, y, w, h, radius}),
+               nullptr);
+}
+
+void DrawCommandRecorder::fillRoundRect(int32_t x, int32_t y, int32_t w,
+                                        int32_t h, int32_t radius,
+                                        uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillRoundRect, color,
+                            {x, y, w, h, radius}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawCircle(int32_t x, int32_t y, int32_t r,
+                                     uint32_t color)
+{
+        record(make_command(DrawCommandType::TftCircle, color, {x, y, r}),
+               nullptr);
+}
+
+void DrawCommandRecorder::fillCircle(int32_t x, int32_t y, int32_t r,
+                                     uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillCircle, color, {x, y, r}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawEllipse(int32_t x, int32_t y, int32_t rx,
+                                      int32_t ry, uint32_t color)
+{
+        record(make_command(DrawCommandType::TftEllipse, color,
+                            {x, y, rx, ry}),
+               nullptr);
+}
+
+void DrawCommandRecorder::fillEllipse(int32_t x, int32_t y, int32_t rx,
+                                      int32_t ry, uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillEllipse, color,
+                            {x, y, rx, ry}),
+               nullptr);
+}
+
+void DrawCommandRecorder::drawString(const char *string, int32_t x, int32_t y)
+{
+        record(make_command(DrawCommandType::TftString, 0, {x, y}), string);
+}
+
+void DrawCommandRecorder::fillScreen(uint32_t color)
+{
+        record(make_command(DrawCommandType::TftFillScreen, color, {}),
+               nullptr);
+}
+
+void DrawCommandRecorder::setTextColor(uint32_t color)
+{
+        record(make_command(DrawCommandType::TftTextColor, color, {}),
+               nullptr);
+}
+
+void DrawCommandRecorder::setTextSize(uint8_t size)
+{
+        record(make_command(DrawCommandType::TftTextSize, 0, {}, size),
+               nullptr);
+}
+
+void DrawCommandRecorder::pushImage(int x, int y, int width, int height,
+                                    const uint16_t *image_array)
+{
+        record(make_command(DrawCommandType::TftImage, 0,
+                            {x, y, width, height}, 0, 0, image_array),
+               nullptr);
+}
+
+TftCompatibleDisplay *DrawCommandRecorder::cast_into_tft_compatible()
+{
+        return this;
+}
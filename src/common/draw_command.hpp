@@ -0,0 +1,141 @@
+#pragma once
+#include "../platform/interface/display.hpp"
+#include <cstdint>
+
+/**
+ * Identifies the drawing function of the `Display` / `TftCompatibleDisplay`
+ * interfaces that a `DrawCommand` stands for.
+ */
+enum class DrawCommandType : uint8_t {
+        Clear,
+        RoundedBorder,
+        Circle,
+        Rectangle,
+        RoundedRectangle,
+        Line,
+        String,
+        ClearRegion,
+        TftPixel,
+        TftChar,
+        TftLine,
+        TftRect,
+        TftFillRect,
+        TftTriangle,
+        TftFillTriangle,
+        TftRoundRect,
+        TftFillRoundRect,
+        TftCircle,
+        TftFillCircle,
+        TftEllipse,
+        TftFillEllipse,
+        TftString,
+        TftFillScreen,
+        TftTextColor,
+        TftTextSize,
+        TftImage,
+        Scroll,
+};
+
+/**
+ * A single call to one of the drawing functions of the display interfaces
+ * captured as plain data so that it can be stored and executed later (see
+ * `replay_draw_command`).
+ *
+ * The meaning of the arguments depends on the command type, they follow the
+ * order of the parameters of the corresponding display function, e.g. for
+ * `Rectangle`: x, y, width, height, border width. `Scroll` stores the region
+ * followed by the offset and keeps the axis in the flags. Strings are not stored in
+ * the command itself, the recorder keeps them and passes them along when the
+ * command is replayed. Images are referenced by pointer and hence need to
+ * outlive the command.
+ */
+struct DrawCommand {
+        DrawCommandType type;
+        /**
+         * Filled flag for shapes, font size for strings, text size for
+         * characters, axis for scrolling.
+         */
+        uint8_t flags;
+        uint16_t color;
+        uint16_t bg_color;
+        int16_t args[6];
+        const uint16_t *image;
+};
+
+/**
+ * Executes the command on the display. Commands of the TFT-compatible
+ * interface are skipped if the display does not expose it.
+ */
+void replay_draw_command(const DrawCommand &command, const char *text,
+                         Display &display);
+
+/**
+ * Implements all drawing functions of the display interfaces by converting
+ * each call into a `DrawCommand` and handing it over to `record`. The
+ * subclasses decide what happens with the commands and implement the
+ * remaining (non-drawing) parts of the display interface.
+ */
+class DrawCommandRecorder : public Display, public TftCompatibleDisplay
+{
+      public:
+        void clear(Color color) const override;
+        void draw_rounded_border(Color color) const override;
+        void draw_circle(IntPoint center, int radius, Color color,
+                         int border_width, bool filled) const override;
+        void draw_rectangle(IntPoint start, int width, int height, Color color,
+                            int border_width, bool filled) const override;
+        void draw_rounded_rectangle(IntPoint start, int width, int height,
+                                    int radius, Color color) const override;
+        void draw_line(IntPoint start, IntPoint end, Color color) const override;
+        void draw_string(IntPoint start, char *string_buffer, FontSize font_size,
+                         Color bg_color, Color fg_color) const override;
+        void clear_region(IntPoint top_left, IntPoint bottom_right,
+                          Color clear_color) const override;
+        /**
+         * Scrolling is recorded in order with the drawing. Whether the
+         * display supports it is up to the subclasses, by default it doesn't.
+         */
+        void set_scroll(const ScrollRegion &region, int offset) const override;
+
+        void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+        void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color,
+                      uint32_t bg, uint8_t size) override;
+        void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye,
+                      uint32_t color) override;
+        void drawRect(int x, int y, int w, int h, int color) override;
+        void fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                      uint32_t color) override;
+        void drawTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
+                          int32_t xe, int32_t ye, uint32_t color) override;
+        void fillTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
+                          int32_t xe, int32_t ye, uint32_t color) override;
+        void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                           int32_t radius, uint32_t color) override;
+        void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                           int32_t radius, uint32_t color) override;
+        void drawCircle(int32_t x, int32_t y, int32_t r,
+                        uint32_t color) override;
+        void fillCircle(int32_t x, int32_t y, int32_t r,
+                        uint32_t color) override;
+        void drawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
+                         uint32_t color) override;
+        void fillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
+                         uint32_t color) override;
+        void drawString(const char *string, int32_t x, int32_t y) override;
+        void fillScreen(uint32_t color) override;
+        void setTextColor(uint32_t color) override;
+        void setTextSize(uint8_t size) override;
+        void pushImage(int x, int y, int width, int height,
+                       const uint16_t *image_array) override;
+
+        TftCompatibleDisplay *cast_into_tft_compatible() override;
+
+      protected:
+        /**
+         * Receives every drawing call made on the display. `text` is only
+         * set for the string commands, it is not guaranteed to outlive the
+         * call.
+         */
+        virtual void record(const DrawCommand &command,
+                            const char *text) const = 0;
+};
@@ -0,0 +1,126 @@
+#include "draw_command_queue.hpp"
+#include <cassert>
+#include <cstring>
+
+#define TAG "draw_command_queue"
+
+DrawCommandQueue::DrawCommandQueue(int capacity, int text_capacity)
+    : slots(capacity), mask(capacity - 1), text_ring(text_capacity),
+      text_mask(text_capacity - 1)
+{
+        assert((capacity & (capacity - 1)) == 0);
+        assert((text_capacity & (text_capacity - 1)) == 0);
+}
+
+bool DrawCommandQueue::try_push(const DrawCommand &command, const char *text)
+{
+        return push(command, text, false);
+}
+
+bool DrawCommandQueue::try_push_frame_end()
+{
+        return push({}, nullptr, true);
+}
+
+bool DrawCommandQueue::fits(const char *text) const
+{
+        return !text || strlen(text) + 1 <= text_ring.size();
+}
+
+bool DrawCommandQueue::push(const DrawCommand &command, const char *text,
+                            bool frame_end)
+{
+        uint32_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) > mask) {
+                return false;
+        }
+
+        uint32_t length = text ? strlen(text) + 1 : 0;
+        uint32_t text_used =
+            text_write - text_read.load(std::memory_order_acquire);
+        if (text_used + length > text_ring.size()) {
+                return false;
+        }
+
+        Slot &slot = slots[position & mask];
+        slot.command = command;
+        slot.frame_end = frame_end;
+        slot.has_text = text != nullptr;
+        slot.text_start = text_write;
+        for (uint32_t i = 0; i < length; i++) {
+                text_ring[(text_write + i) & text_mask] = text[i];
+        }
+        text_write += length;
+        slot.text_end = text_write;
+
+        // Publishes the slot and the text to the consumer.
+        head.store(position + 1, std::memory_order_release);
+        return true;
+}
+
+int DrawCommandQueue::process(Display &display, int max_commands)
+{
+        int processed = 0;
+        uint32_t position = tail.load(std::memory_order_relaxed);
+        uint32_t end = head.load(std::memory_order_acquire);
+        while (position != end &&
+               (max_commands < 0 || processed < max_commands)) {
+                const Slot &slot = slots[position & mask];
+                if (slot.frame_end) {
+                        if (!display.refresh()) {
+                                closed.store(true, std::memory_order_release);
+                        }
+                        completed_frames.fetch_add(1,
+                                                   std::memory_order_release);
+                } else {
+                        const char *text = nullptr;
+                        if (slot.has_text) {
+                                uint32_t start = slot.text_start & text_mask;
+                                uint32_t length =
+                                    slot.text_end - slot.text_start;
+                                if (start + length <= text_ring.size()) {
+                                        text = text_ring.data() + start;
+                                } else {
+                                        text_scratch.resize(length);
+                                        for (uint32_t i = 0; i < length; i++) {
+                                                text_scratch[i] = text_ring
+                                                    [(start + i) & text_mask];
+                                        }
+                                        text = text_scratch.data();
+                                }
+                        }
+                        replay_draw_command(slot.command, text, display);
+                }
+                // Hands the text and the slot back to the producer.
+                text_read.store(slot.text_end, std::memory_order_release);
+                position++;
+                tail.store(position, std::memory_order_release);
+                processed++;
+        }
+        return processed;
+}
+
+uint32_t DrawCommandQueue::get_pushed_count() const
+{
+        return head.load(std::memory_order_acquire);
+}
+
+uint32_t DrawCommandQueue::get_completed_count() const
+{
+        return tail.load(std::memory_order_acquire);
+}
+
+uint32_t DrawCommandQueue::get_completed_frames() const
+{
+        return completed_frames.load(std::memory_order_acquire);
+}
+
+bool DrawCommandQueue::is_empty() const
+{
+        return get_completed_count() == get_pushed_count();
+}
+
+bool DrawCommandQueue::is_closed() const
+{
+        return closed.load(std::memory_order_acquire);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "draw_command.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Default number of commands that fit into the queue, needs to be a power of
+ * two. The default queue takes up ~9KB on the ESP32.
+ */
+#define DRAW_COMMAND_QUEUE_CAPACITY 256
+/**
+ * Default number of bytes reserved for the texts of the queued string
+ * commands, needs to be a power of two.
+ */
+#define DRAW_COMMAND_QUEUE_TEXT_CAPACITY 1024
+
+/**
+ * Lock-free single-producer / single-consumer ring buffer of drawing commands.
+ *
+ * The producer (the game loop) pushes the commands and frame ends, the
+ * consumer (a render task running on another core) pops them and executes
+ * them on the display. The producer side may only be used from a single
+ * thread and the consumer side from another single thread, no other
+ * synchronization is required.
+ *
+ * The texts of the string commands are copied into a separate ring of bytes
+ * that is released as the commands are consumed. Images are referenced by
+ * pointer, hence the producer needs to keep them valid until the command was
+ * processed (see `get_completed_count`).
+ */
+class DrawCommandQueue
+{
+      public:
+        DrawCommandQueue(int capacity = DRAW_COMMAND_QUEUE_CAPACITY,
+                         int text_capacity = DRAW_COMMAND_QUEUE_TEXT_CAPACITY);
+
+        /**
+         * Producer side. Adds the command to the queue, returns false if
+         * there is no space left for the command or its text.
+         */
+        bool try_push(const DrawCommand &command, const char *text);
+        /**
+         * Producer side. Marks the end of a frame, the consumer refreshes the
+         * display once it gets there. Returns false if the queue is full.
+         */
+        bool try_push_frame_end();
+        /**
+         * Producer side. Returns true if the text could ever fit into the
+         * queue.
+         */
+        bool fits(const char *text) const;
+
+        /**
+         * Consumer side. Executes up to `max_commands` of the queued commands
+         * on the display and returns how many of them were processed.
+         */
+        int process(Display &display, int max_commands = -1);
+
+        /**
+         * Number of commands (including the frame ends) pushed and processed
+         * so far. The counters wrap around, only their difference is
+         * meaningful.
+         */
+        uint32_t get_pushed_count() const;
+        uint32_t get_completed_count() const;
+        uint32_t get_completed_frames() const;
+        bool is_empty() const;
+        /**
+         * Returns true once refreshing the display failed on the consumer
+         * side, i.e. the emulator window was closed.
+         */
+        bool is_closed() const;
+
+      private:
+        struct Slot {
+                DrawCommand command;
+                bool frame_end;
+                bool has_text;
+                /**
+                 * Values of the text write counter before and after the text
+                 * was written, the text may wrap around the end of the ring.
+                 */
+                uint32_t text_start;
+                uint32_t text_end;
+        };
+
+        std::vector<Slot> slots;
+        uint32_t mask;
+        std::vector<char> text_ring;
+        uint32_t text_mask;
+        /**
+         * Consumer side copy of the texts that wrap around the end of the
+         * text ring.
+         */
+        std::vector<char> text_scratch;
+
+        /**
+         * Written by the producer only.
+         */
+        std::atomic<uint32_t> head{0};
+        uint32_t text_write = 0;
+        /**
+         * Written by the consumer only.
+         */
+        std::atomic<uint32_t> tail{0};
+        std::atomic<uint32_t> text_read{0};
+        std::atomic<uint32_t> completed_frames{0};
+        std::atomic<bool> closed{false};
+
+        bool push(const DrawCommand &command, const char *text,
+                  bool frame_end);
+};
@@ -0,0 +1,83 @@
+#include "frame_scheduler.hpp"
+#include "logging.hpp"
+#include <algorithm>
+
+#define TAG "frame_scheduler"
+
+FrameScheduler::FrameScheduler(const TimeProvider *time_provider,
+                               int frame_period, int tick_period,
+                               int max_catch_up_ticks)
+    : time_provider(time_provider), frame_period(frame_period),
+      tick_period(tick_period), max_catch_up_ticks(max_catch_up_ticks)
+{
+        frame_start = time_provider->milliseconds();
+        next_tick = frame_start + tick_period;
+}
+
+bool FrameScheduler::consume_tick()
+{
+        if (tick_period <= 0) {
+                return false;
+        }
+        long now = time_provider->milliseconds();
+        if (now < next_tick) {
+                return false;
+        }
+        // Number of ticks that are due on top of the one consumed here.
+        long behind = (now - next_tick) / tick_period;
+        if (behind >= max_catch_up_ticks) {
+                long dropped = behind - (max_catch_up_ticks - 1);
+                statistics.dropped_ticks += dropped;
+                next_tick += dropped * tick_period;
+                LOG_DEBUG(TAG, "Fell behind, dropping %ld ticks.", dropped);
+        }
+        next_tick += tick_period;
+        statistics.ticks++;
+        return true;
+}
+
+void FrameScheduler::skip_ticks()
+{
+        if (tick_period > 0) {
+                next_tick = time_provider->milliseconds() + tick_period;
+        }
+}
+
+void FrameScheduler::end_frame()
+{
+        long now = time_provider->milliseconds();
+        long elapsed = now - frame_start;
+        statistics.frames++;
+        statistics.longest_frame = std::max(statistics.longest_frame, elapsed);
+        if (elapsed > frame_period) {
+                statistics.overruns++;
+                LOG_DEBUG(TAG, "Frame took %ld ms, the budget is %d ms.",
+                          elapsed, frame_period);
+        }
+
+        // If a tick is already due, the loop doesn't sleep to catch up on it.
+        long wake_up = frame_start + frame_period;
+        if (tick_period > 0) {
+                wake_up = std::min(wake_up, next_tick);
+        }
+        if (wake_up <= now) {
+                frame_start = now;
+                return;
+        }
+        time_provider->delay_ms(wake_up - now);
+        // The next frame is measured from the planned wake up time so that
+        // the delays overshooting slightly don't accumulate.
+        frame_start = wake_up;
+}
+
+void FrameScheduler::delay(int ms)
+{
+        time_provider->delay_ms(ms);
+        frame_start = time_provider->milliseconds();
+}
+
+void FrameScheduler::set_tick_period(int tick_period)
+{
+        this->tick_period = tick_period;
+        skip_ticks();
+}
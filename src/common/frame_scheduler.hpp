@@ -0,0 +1,93 @@
+#pragma once
+#include "../platform/interface/time_provider.hpp"
+
+/**
+ * Maximum number of logic ticks that the scheduler lets a game loop catch up
+ * on after a slow frame. If the loop falls further behind (e.g. because the
+ * window was dragged around in the emulator), the remaining ticks are dropped
+ * instead of fast-forwarding the game.
+ */
+#define FRAME_SCHEDULER_MAX_CATCH_UP_TICKS 4
+
+struct FrameSchedulerStatistics {
+        long frames = 0;
+        long ticks = 0;
+        /**
+         * Number of frames that took longer than the frame period.
+         */
+        long overruns = 0;
+        /**
+         * Number of ticks dropped because the loop fell too far behind.
+         */
+        long dropped_ticks = 0;
+        long longest_frame = 0;
+};
+
+/**
+ * Paces game loops using `TimeProvider::milliseconds()` instead of sleeping
+ * for a fixed delay on each iteration, which makes the game speed depend on
+ * how long the drawing takes on the given platform.
+ *
+ * Each frame of the loop polls the input, runs the logic ticks that are due
+ * (`consume_tick`), refreshes the display and calls `end_frame`, which only
+ * sleeps for the part of the frame period that is left. The logic runs at
+ * the fixed tick period independently of the frame period: when a frame
+ * overruns, the ticks that were missed are run on the following frames
+ * without sleeping in between, up to `FRAME_SCHEDULER_MAX_CATCH_UP_TICKS`.
+ *
+ * Loops that only react to the input can use a scheduler without a tick
+ * period to pace the input polling.
+ */
+class FrameScheduler
+{
+      public:
+        /**
+         * `frame_period` is the target duration of a single loop iteration
+         * and `tick_period` the interval between the logic ticks, both in
+         * milliseconds. A tick period of 0 disables the ticks.
+         */
+        FrameScheduler(const TimeProvider *time_provider, int frame_period,
+                       int tick_period = 0,
+                       int max_catch_up_ticks =
+                           FRAME_SCHEDULER_MAX_CATCH_UP_TICKS);
+
+        /**
+         * Returns true if a logic tick is due and marks it as processed.
+         * Ticks are consumed one at a time so that each one can be
+         * processed with the game state it leaves behind.
+         */
+        bool consume_tick();
+        /**
+         * Drops the ticks that are due, the next one will be due a whole
+         * tick period from now. Used while the game is paused so that it
+         * doesn't fast-forward after being resumed.
+         */
+        void skip_ticks();
+        /**
+         * Sleeps for the remaining part of the frame period. Returns
+         * immediately if a logic tick is already due so that the loop can
+         * catch up on it. Overrunning frames are counted in the statistics.
+         */
+        void end_frame();
+        /**
+         * Sleeps outside of the frame budget and starts a new frame
+         * afterwards. Used for the hold-off after an input was registered,
+         * which would otherwise be reported as an overrun.
+         */
+        void delay(int ms);
+
+        void set_tick_period(int tick_period);
+        const FrameSchedulerStatistics &get_statistics() const
+        {
+                return statistics;
+        }
+
+      private:
+        const TimeProvider *time_provider;
+        int frame_period;
+        int tick_period;
+        int max_catch_up_ticks;
+        long frame_start;
+        long next_tick;
+        FrameSchedulerStatistics statistics;
+};
@@ -0,0 +1,176 @@
+#include "framebuffer.hpp"
+#include "maths_utils.hpp"
+#include <algorithm>
+
+#define TAG "framebuffer"
+
+Rgb565Framebuffer::Rgb565Framebuffer(int width, int height, int strip_height)
+    : RasterTarget(width, height),
+      strip_height(strip_height > 0 ? strip_height : std::max(height, 1))
+{
+        for (int y = 0; y < height; y += this->strip_height) {
+                int rows = std::min(this->strip_height, height - y);
+                strips.emplace_back(width * rows, 0);
+        }
+        if (strips.empty()) {
+                strips.emplace_back();
+        }
+}
+
+void Rgb565Framebuffer::fill_rows(int x, int y, int w, int h, uint16_t color)
+{
+        for (int row = y; row < y + h; row++) {
+                uint16_t *row_start = mutable_row(row) + x;
+                std::fill(row_start, row_start + w, color);
+        }
+}
+
+void Rgb565Framebuffer::fill_clipped_rect(int x, int y, int w, int h,
+                                          uint16_t color)
+{
+        if (scroll.is_empty()) {
+                fill_rows(x, y, w, h, color);
+                return;
+        }
+
+        // The rectangle is split into the parts next to the scrolled region,
+        // which are drawn as is, and the part overlapping it, which gets
+        // moved by the scroll offset and may wrap around the region end.
+        bool horizontal = scroll.axis == ScrollAxis::Horizontal;
+        auto fill = [&](int along, int along_length, int across,
+                        int across_length) {
+                if (along_length <= 0 || across_length <= 0) {
+                        return;
+                }
+                if (horizontal) {
+                        fill_rows(along, across, along_length, across_length,
+                                  color);
+                } else {
+                        fill_rows(across, along, across_length, along_length,
+                                  color);
+                }
+        };
+        int along = horizontal ? x : y;
+        int along_end = along + (horizontal ? w : h);
+        int across = horizontal ? y : x;
+        int across_end = across + (horizontal ? h : w);
+        int band_start = scroll.start();
+        int band_end = band_start + scroll.length();
+        int band_across = horizontal ? scroll.top_left.y : scroll.top_left.x;
+        int band_across_end =
+            band_across + (horizontal ? scroll.height : scroll.width);
+
+        fill(along, along_end - along, across,
+             std::min(across_end, band_across) - across);
+        int after = std::max(across, band_across_end);
+        fill(along, along_end - along, after, across_end - after);
+
+        int inside = std::max(across, band_across);
+        int inside_length = std::min(across_end, band_across_end) - inside;
+        fill(along, std::min(along_end, band_start) - along, inside,
+             inside_length);
+        int behind = std::max(along, band_end);
+        fill(behind, along_end - behind, inside, inside_length);
+
+        int from = std::max(along, band_start);
+        int to = std::min(along_end, band_end);
+        if (from >= to) {
+                return;
+        }
+        int target =
+            band_start + mathematical_modulo(from - band_start - scroll_offset,
+                                             scroll.length());
+        int first = std::min(to - from, band_end - target);
+        fill(target, first, inside, inside_length);
+        fill(band_start, to - from - first, inside, inside_length);
+}
+
+void Rgb565Framebuffer::push_image(int x, int y, int w, int h,
+                                   const uint16_t *data)
+{
+        if (!scroll.is_empty()) {
+                // The rows of the image may wrap around the end of the
+                // scrolled region, the generic implementation takes care of
+                // that by filling the image in runs.
+                RasterTarget::push_image(x, y, w, h, data);
+                return;
+        }
+
+        int x_start = std::max(x, 0);
+        int y_start = std::max(y, 0);
+        int x_end = std::min(x + w, width);
+        int y_end = std::min(y + h, height);
+        if (x_start >= x_end || y_start >= y_end) {
+                return;
+        }
+
+        for (int row = y_start; row < y_end; row++) {
+                const uint16_t *source = data + (row - y) * w + (x_start - x);
+                std::copy(source, source + (x_end - x_start),
+                          mutable_row(row) + x_start);
+        }
+}
+
+void Rgb565Framebuffer::set_scroll(const ScrollRegion &region, int offset)
+{
+        int x_start = std::max(region.top_left.x, 0);
+        int y_start = std::max(region.top_left.y, 0);
+        ScrollRegion clipped = {
+            .axis = region.axis,
+            .top_left = {.x = x_start, .y = y_start},
+            .width = std::min(region.top_left.x + region.width, width) -
+                     x_start,
+            .height = std::min(region.top_left.y + region.height, height) -
+                      y_start};
+        if (clipped.is_empty()) {
+                clipped = {};
+        }
+
+        if (clipped == scroll) {
+                rotate_region(scroll, offset - scroll_offset);
+        } else {
+                // Puts the pixels back to where they have been drawn before
+                // applying the new region.
+                rotate_region(scroll, -scroll_offset);
+                rotate_region(clipped, offset);
+        }
+        scroll = clipped;
+        scroll_offset = clipped.is_empty()
+                            ? 0
+                            : mathematical_modulo(offset, clipped.length());
+}
+
+void Rgb565Framebuffer::rotate_region(const ScrollRegion &region, int shift)
+{
+        if (region.is_empty()) {
+                return;
+        }
+        int length = region.length();
+        shift = mathematical_modulo(shift, length);
+        if (shift == 0) {
+                return;
+        }
+
+        int x = region.top_left.x;
+        int y = region.top_left.y;
+        if (region.axis == ScrollAxis::Horizontal) {
+                for (int row = y; row < y + region.height; row++) {
+                        uint16_t *start = mutable_row(row) + x;
+                        std::rotate(start, start + shift, start + length);
+                }
+                return;
+        }
+
+        std::vector<uint16_t> rows(region.width * length);
+        for (int i = 0; i < length; i++) {
+                const uint16_t *source = row(y + i) + x;
+                std::copy(source, source + region.width,
+                          rows.begin() + i * region.width);
+        }
+        for (int i = 0; i < length; i++) {
+                auto source =
+                    rows.begin() + (i + shift) % length * region.width;
+                std::copy(source, source + region.width,
+                          mutable_row(y + i) + x);
+        }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "../platform/interface/display.hpp"
+#include "raster.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * In-memory RGB565 framebuffer. The pixels are stored row by row in the same
+ * format as the one used by the LCD displays, so the contents of the
+ * framebuffer can be compared against (or pushed directly to) the physical
+ * display memory.
+ *
+ * By default all rows are kept in a single block. If `strip_height` is set,
+ * each strip of that many rows is allocated separately instead. This allows
+ * for holding a full frame on targets whose heap is too fragmented for a
+ * single large allocation (a 320x240 frame takes up 150KB).
+ */
+class Rgb565Framebuffer : public RasterTarget
+{
+      public:
+        Rgb565Framebuffer(int width, int height, int strip_height = 0);
+
+        uint16_t pixel(int x, int y) const { return row(y)[x]; }
+        const uint16_t *row(int y) const
+        {
+                return strips[y / strip_height].data() +
+                       (y % strip_height) * width;
+        }
+        /**
+         * Returns all pixels of the framebuffer, only available if the
+         * framebuffer is not split into strips.
+         */
+        const uint16_t *data() const { return strips[0].data(); }
+
+        /**
+         * Copies the image into the framebuffer row by row, the parts of the
+         * image that do not fit into the framebuffer are skipped.
+         */
+        void push_image(int x, int y, int w, int h,
+                        const uint16_t *data) override;
+
+        /**
+         * Emulates the hardware scrolling of the display controllers (see
+         * `Display::set_scroll`). The framebuffer keeps holding the pixels as
+         * they are shown: the contents of the region are rotated whenever the
+         * scroll changes and everything drawn into the region afterwards is
+         * redirected to where the display would show it.
+         */
+        void set_scroll(const ScrollRegion &region, int offset);
+
+      protected:
+        void fill_clipped_rect(int x, int y, int w, int h,
+                               uint16_t color) override;
+
+      private:
+        int strip_height;
+        std::vector<std::vector<uint16_t>> strips;
+        ScrollRegion scroll = {};
+        int scroll_offset = 0;
+
+        uint16_t *mutable_row(int y)
+        {
+                return strips[y / strip_height].data() +
+                       (y % strip_height) * width;
+        }
+        void fill_rows(int x, int y, int w, int h, uint16_t color);
+        /**
+         * Moves the pixel at position `i` of the region (along the scrolled
+         * axis) to position `i - shift`, wrapping around its ends.
+         */
+        void rotate_region(const ScrollRegion &region, int shift);
+};
@@ -0,0 +1,246 @@
+#include "framebuffer_display.hpp"
+#include "../lib/waveshare_1_69_inch_lcd/fonts/fonts.h"
+#include <algorithm>
+
+#define SCREEN_BORDER_WIDTH 3
+#define TAG "framebuffer_display"
+
+BitmapFont bitmap_font_from_size(FontSize font_size)
+{
+        switch (font_size) {
+        case Size8:
+                return {Font8.table, Font8.Width, Font8.Height};
+        case Size24:
+                return {Font24.table, Font24.Width, Font24.Height};
+        case Size16:
+        default:
+                return {Font16.table, Font16.Width, Font16.Height};
+        }
+}
+
+/**
+ * The TFT_eSPI text functions use the smallest font scaled up by the text
+ * size, we do the same using the smallest Waveshare font.
+ */
+static BitmapFont tft_base_font() { return bitmap_font_from_size(Size8); }
+
+void FramebufferDisplay::clear(Color color) const
+{
+        target().fill_screen(color);
+}
+
+/**
+ * On displays without rounded corners the border is a plain frame along the
+ * edges of the screen. Otherwise, same as in the 1.69 inch LCD driver, the
+ * screen is cleared and the border follows the rounded corners.
+ */
+void FramebufferDisplay::draw_rounded_border(Color color) const
+{
+        int radius = get_display_corner_radius();
+        int width = get_width();
+        int height = get_height();
+        if (radius == 0) {
+                int spill = SCREEN_BORDER_WIDTH - 1;
+                target().draw_frame(spill, spill, width - 2 * spill,
+                                    height - 2 * spill, SCREEN_BORDER_WIDTH,
+                                    color);
+                return;
+        }
+
+        int margin = SCREEN_BORDER_WIDTH;
+        int inner_margin = margin + SCREEN_BORDER_WIDTH;
+        target().fill_screen(Black);
+        target().fill_round_rect(margin, margin, width - 2 * margin,
+                                 height - 2 * margin, radius, color);
+        target().fill_round_rect(inner_margin, inner_margin,
+                                 width - 2 * inner_margin,
+                                 height - 2 * inner_margin,
+                                 std::max(radius - SCREEN_BORDER_WIDTH, 0),
+                                 Black);
+}
+
+void FramebufferDisplay::draw_circle(IntPoint center, int radius, Color color,
+                                     int border_width, bool filled) const
+{
+        if (filled) {
+                target().fill_circle(center.x, center.y, radius, color);
+        } else if (border_width <= 1) {
+                target().draw_circle(center.x, center.y, radius, color);
+        } else {
+                target().fill_ring(center.x, center.y, radius, border_width,
+                                   color);
+        }
+}
+
+/**
+ * Same as in the SFML display, borders wider than 1px spill to the outside of
+ * the rectangle.
+ */
+void FramebufferDisplay::draw_rectangle(IntPoint start, int width, int height,
+                                        Color color, int border_width,
+                                        bool filled) const
+{
+        if (filled) {
+                target().fill_rect(start.x, start.y, width, height, color);
+        }
+        if (!filled || border_width > 1) {
+                target().draw_frame(start.x, start.y, width, height,
+                                    std::max(border_width, 1), color);
+        }
+}
+
+void FramebufferDisplay::draw_rounded_rectangle(IntPoint start, int width,
+                                                int height, int radius,
+                                                Color color) const
+{
+        target().fill_round_rect(start.x, start.y, width, height, radius,
+                                 color);
+}
+
+void FramebufferDisplay::draw_line(IntPoint start, IntPoint end,
+                                   Color color) const
+{
+        target().draw_line(start.x, start.y, end.x, end.y, color);
+}
+
+void FramebufferDisplay::draw_string(IntPoint start, char *string_buffer,
+                                     FontSize font_size, Color bg_color,
+                                     Color fg_color) const
+{
+        // Same as TFT_eSPI, the background is only filled if it differs from
+        // the text color.
+        target().draw_text(start.x, start.y, string_buffer,
+                           bitmap_font_from_size(font_size), fg_color,
+                           bg_color, bg_color != fg_color);
+}
+
+void FramebufferDisplay::clear_region(IntPoint top_left, IntPoint bottom_right,
+                                      Color clear_color) const
+{
+        target().fill_rect(top_left.x, top_left.y,
+                           bottom_right.x - top_left.x,
+                           bottom_right.y - top_left.y, clear_color);
+}
+
+FontConfiguration FramebufferDisplay::get_font_configuration() const
+{
+        BitmapFont font = bitmap_font_from_size(Size16);
+        BitmapFont heading_font = bitmap_font_from_size(Size24);
+        return FontConfiguration{
+            .font_dimensions = {.width = font.width, .height = font.height},
+            .heading_font_dimensions = {.width = heading_font.width,
+                                        .height = heading_font.height}};
+}
+
+void FramebufferDisplay::drawPixel(int32_t x, int32_t y, uint32_t color)
+{
+        target().draw_pixel(x, y, color);
+}
+
+void FramebufferDisplay::drawChar(int32_t x, int32_t y, uint16_t c,
+                                  uint32_t color, uint32_t bg, uint8_t size)
+{
+        target().draw_glyph(x, y, (char)c, tft_base_font(), color, bg,
+                            bg != color, size);
+}
+
+void FramebufferDisplay::drawLine(int32_t xs, int32_t ys, int32_t xe,
+                                  int32_t ye, uint32_t color)
+{
+        target().draw_line(xs, ys, xe, ye, color);
+}
+
+void FramebufferDisplay::drawRect(int x, int y, int w, int h, int color)
+{
+        target().draw_rect(x, y, w, h, color);
+}
+
+void FramebufferDisplay::fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                                  uint32_t color)
+{
+        target().fill_rect(x, y, w, h, color);
+}
+
+void FramebufferDisplay::drawTriangle(int32_t xs, int32_t ys, int32_t x2,
+                                      int32_t y2, int32_t xe, int32_t ye,
+                                      uint32_t color)
+{
+        target().draw_triangle(xs, ys, x2, y2, xe, ye, color);
+}
+
+void FramebufferDisplay::fillTriangle(int32_t xs, int32_t ys, int32_t x2,
+                                      int32_t y2, int32_t xe, int32_t ye,
+                                      uint32_t color)
+{
+        target().fill_triangle(xs, ys, x2, y2, xe, ye, color);
+}
+
+void FramebufferDisplay::drawRoundRect(int32_t x, int32_t y, int32_t w,
+                                       int32_t h, int32_t radius,
+                                       uint32_t color)
+{
+        target().draw_round_rect(x, y, w, h, radius, color);
+}
+
+void FramebufferDisplay::fillRoundRect(int32_t x, int32_t y, int32_t w,
+                                       int32_t h, int32_t radius,
+                                       uint32_t color)
+{
+        target().fill_round_rect(x, y, w, h, radius, color);
+}
+
+void FramebufferDisplay::drawCircle(int32_t x, int32_t y, int32_t r,
+                                    uint32_t color)
+{
+        target().draw_circle(x, y, r, color);
+}
+
+void FramebufferDisplay::fillCircle(int32_t x, int32_t y, int32_t r,
+                                    uint32_t color)
+{
+        target().fill_circle(x, y, r, color);
+}
+
+void FramebufferDisplay::drawEllipse(int32_t x, int32_t y, int32_t rx,
+                                     int32_t ry, uint32_t color)
+{
+        target().draw_ellipse(x, y, rx, ry, color);
+}
+
+void FramebufferDisplay::fillEllipse(int32_t x, int32_t y, int32_t rx,
+                                     int32_t ry, uint32_t color)
+{
+        target().fill_ellipse(x, y, rx, ry, color);
+}
+
+void FramebufferDisplay::drawString(const char *string, int32_t x, int32_t y)
+{
+        target().draw_text(x, y, string, tft_base_font(), tft_text_color,
+                           tft_text_color, false, tft_text_size);
+}
+
+void FramebufferDisplay::fillScreen(uint32_t color)
+{
+        target().fill_screen(color);
+}
+
+void FramebufferDisplay::setTextColor(uint32_t color)
+{
+        tft_text_color = color;
+}
+
+void FramebufferDisplay::setTextSize(uint8_t size)
+{
+        tft_text_size = size > 0 ? size : 1;
+}
+
+void FramebufferDisplay::pushImage(int x, int y, int width, int height,
+                                   const uint16_t *image_array)
+{
+        target().push_image(x, y, width, height, image_array);
+}
+
+TftCompatibleDisplay *FramebufferDisplay::cast_into_tft_compatible()
+{
+        return this;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "../platform/interface/display.hpp"
+#include "raster.hpp"
+
+/**
+ * Returns the bitmap font that is used by the software-rasterized displays for
+ * the given font size.
+ */
+BitmapFont bitmap_font_from_size(FontSize font_size);
+
+/**
+ * Base class for the displays that rasterize all shapes in software (see
+ * `RasterTarget`) instead of delegating them to a display driver library.
+ *
+ * The `Display` primitives are mapped onto the TFT_eSPI-style shapes in the
+ * same way as in the `LcdDisplay` driver for the 2.4 inch display, text is
+ * rendered using the bitmap fonts that come with the Waveshare LCD library.
+ *
+ * The subclasses provide the raster target and everything that is specific to
+ * the actual device: setup, dimensions, refreshing.
+ */
+class FramebufferDisplay : public Display, public TftCompatibleDisplay
+{
+      public:
+        void clear(Color color) const override;
+        void draw_rounded_border(Color color) const override;
+        void draw_circle(IntPoint center, int radius, Color color,
+                         int border_width, bool filled) const override;
+        void draw_rectangle(IntPoint start, int width, int height, Color color,
+                            int border_width, bool filled) const override;
+        void draw_rounded_rectangle(IntPoint start, int width, int height,
+                                    int radius, Color color) const override;
+        void draw_line(IntPoint start, IntPoint end, Color color) const override;
+        void draw_string(IntPoint start, char *string_buffer, FontSize font_size,
+                         Color bg_color, Color fg_color) const override;
+        void clear_region(IntPoint top_left, IntPoint bottom_right,
+                          Color clear_color) const override;
+        FontConfiguration get_font_configuration() const override;
+
+        void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+        void drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color,
+                      uint32_t bg, uint8_t size) override;
+        void drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye,
+                      uint32_t color) override;
+        void drawRect(int x, int y, int w, int h, int color) override;
+        void fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                      uint32_t color) override;
+        void drawTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
+                          int32_t xe, int32_t ye, uint32_t color) override;
+        void fillTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
+                          int32_t xe, int32_t ye, uint32_t color) override;
+        void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                           int32_t radius, uint32_t color) override;
+        void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                           int32_t radius, uint32_t color) override;
+        void drawCircle(int32_t x, int32_t y, int32_t r,
+                        uint32_t color) override;
+        void fillCircle(int32_t x, int32_t y, int32_t r,
+                        uint32_t color) override;
+        void drawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
+                         uint32_t color) override;
+        void fillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
+                         uint32_t color) override;
+        void drawString(const char *string, int32_t x, int32_t y) override;
+        void fillScreen(uint32_t color) override;
+        void setTextColor(uint32_t color) override;
+        void setTextSize(uint8_t size) override;
+        void pushImage(int x, int y, int width, int height,
+                       const uint16_t *image_array) override;
+
+        TftCompatibleDisplay *cast_into_tft_compatible() override;
+
+      protected:
+        /**
+         * The raster target that all shapes are drawn into.
+         */
+        virtual RasterTarget &target() const = 0;
+
+      private:
+        /**
+         * Text size and color set through the TftCompatibleDisplay interface.
+         */
+        uint8_t tft_text_size = 1;
+        uint16_t tft_text_color = White;
+};
@@ -1,5 +1,6 @@
 #include "grid.hpp"
 #include "logging.hpp"
+#include "recording_display.hpp"
 #include <cstring>
 
 #define TAG "grid"
@@ -87,7 +88,6 @@ void draw_grid_frame(const Platform &p,
 {
         LOG_DEBUG(TAG, "Rendering rectangular game area.");
         p.display->initialize();
-        p.display->clear(Black);
 
         int x_margin = dimensions.left_horizontal_margin;
         int y_margin = dimensions.top_vertical_margin;
@@ -95,20 +95,32 @@ void draw_grid_frame(const Platform &p,
         int actual_width = dimensions.actual_width;
         int actual_height = dimensions.actual_height;
 
-        int border_width = 1;
-        // We need to make the border rectangle and the canvas slightly
-        // bigger to ensure that it does not overlap with the game area.
-        // Otherwise the caret rendering erases parts of the border as
-        // it moves around (as the caret intersects with the border
-        // partially)
-        int border_offset = 2;
-
-        // We draw the border at the end to ensure that it doesn't get cropped
-        // by draw string operations above.
-        p.display->draw_rectangle(
-            {.x = x_margin - border_offset, .y = y_margin - border_offset},
-            actual_width + 2 * border_offset, actual_height + 2 * border_offset,
-            customization.accent_color, border_width, false);
+        // The frame is shared by all grid games, it is recorded once and
+        // replayed afterwards.
+        static CachedDisplayList grid_frame;
+        uint32_t key = display_list_key({x_margin, y_margin, actual_width,
+                                         actual_height,
+                                         customization.accent_color});
+        grid_frame.draw(*p.display, key, [&](const Display &display) {
+                display.clear(Black);
+
+                int border_width = 1;
+                // We need to make the border rectangle and the canvas slightly
+                // bigger to ensure that it does not overlap with the game
+                // area. Otherwise the caret rendering erases parts of the
+                // border as it moves around (as the caret intersects with the
+                // border partially)
+                int border_offset = 2;
+
+                // We draw the border at the end to ensure that it doesn't get
+                // cropped by draw string operations above.
+                display.draw_rectangle({.x = x_margin - border_offset,
+                                        .y = y_margin - border_offset},
+                                       actual_width + 2 * border_offset,
+                                       actual_height + 2 * border_offset,
+                                       customization.accent_color, border_width,
+                                       false);
+        });
         LOG_DEBUG(TAG, "Rectangular game area drawn.");
 }
 
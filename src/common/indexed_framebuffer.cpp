@@ -0,0 +1,137 @@
+#include "indexed_framebuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "indexed_framebuffer"
+
+IndexedFramebuffer::IndexedFramebuffer(int width, int height,
+                                       int bits_per_pixel, int band_height)
+    : RasterTarget(width, height), bits_per_pixel(bits_per_pixel == 8 ? 8 : 4),
+      band_height(std::clamp(band_height, 1, height)),
+      stride((width * this->bits_per_pixel + 7) / 8),
+      pixels(stride * this->band_height, 0),
+      palette(1 << this->bits_per_pixel, 0)
+{
+        reset_palette();
+        set_band(0);
+}
+
+void IndexedFramebuffer::set_band(int band_start)
+{
+        clip_top = band_start;
+        clip_bottom = std::min(band_start + band_height, height);
+}
+
+void IndexedFramebuffer::clear_band()
+{
+        std::fill(pixels.begin(), pixels.end(), INDEXED_FRAMEBUFFER_TRANSPARENT);
+}
+
+void IndexedFramebuffer::reset_palette()
+{
+        palette_size = 1;
+        palette_misses = 0;
+        // Nothing can be drawn using the transparent index, hence it is a
+        // safe 'no color cached yet' marker.
+        last_index = INDEXED_FRAMEBUFFER_TRANSPARENT;
+        last_color = 0;
+        clear_band();
+}
+
+/**
+ * Squared distance between two RGB565 colors, the components are scaled to
+ * the 6-bit range of the green channel.
+ */
+static int color_distance(uint16_t a, uint16_t b)
+{
+        int red = (((a >> 11) & 0x1F) - ((b >> 11) & 0x1F)) * 2;
+        int green = ((a >> 5) & 0x3F) - ((b >> 5) & 0x3F);
+        int blue = ((a & 0x1F) - (b & 0x1F)) * 2;
+        return red * red + green * green + blue * blue;
+}
+
+uint8_t IndexedFramebuffer::color_index(uint16_t color)
+{
+        if (last_index != INDEXED_FRAMEBUFFER_TRANSPARENT &&
+            color == last_color) {
+                return last_index;
+        }
+
+        int found = -1;
+        for (int i = 1; i < palette_size; i++) {
+                if (palette[i] == color) {
+                        found = i;
+                        break;
+                }
+        }
+        if (found == -1 && palette_size < (int)palette.size()) {
+                found = palette_size++;
+                palette[found] = color;
+        }
+        if (found == -1) {
+                palette_misses++;
+                found = 1;
+                for (int i = 2; i < palette_size; i++) {
+                        if (color_distance(palette[i], color) <
+                            color_distance(palette[found], color)) {
+                                found = i;
+                        }
+                }
+        }
+
+        last_color = color;
+        last_index = found;
+        return found;
+}
+
+void IndexedFramebuffer::fill_clipped_rect(int x, int y, int w, int h,
+                                           uint16_t color)
+{
+        uint8_t index = color_index(color);
+        for (int row = y; row < y + h; row++) {
+                uint8_t *row_pixels = pixels.data() + (row - clip_top) * stride;
+                if (bits_per_pixel == 8) {
+                        memset(row_pixels + x, index, w);
+                        continue;
+                }
+
+                // The left pixel of each pair is stored in the high nibble.
+                int column = x;
+                int end = x + w;
+                if (column % 2 == 1 && column < end) {
+                        uint8_t &pair = row_pixels[column / 2];
+                        pair = (pair & 0xF0) | index;
+                        column++;
+                }
+                int full_pairs = (end - column) / 2;
+                memset(row_pixels + column / 2, (index << 4) | index,
+                       full_pairs);
+                column += full_pairs * 2;
+                if (column < end) {
+                        uint8_t &pair = row_pixels[column / 2];
+                        pair = (pair & 0x0F) | (index << 4);
+                }
+        }
+}
+
+uint8_t IndexedFramebuffer::index(int x, int y) const
+{
+        const uint8_t *row_pixels = pixels.data() + (y - clip_top) * stride;
+        if (bits_per_pixel == 8) {
+                return row_pixels[x];
+        }
+        uint8_t pair = row_pixels[x / 2];
+        return x % 2 == 0 ? pair >> 4 : pair & 0x0F;
+}
+
+void IndexedFramebuffer::expand_row(int x, int y, int w, uint16_t *out) const
+{
+        for (int column = x; column < x + w; column++) {
+                *out++ = palette[index(column, y)];
+        }
+}
+
+int IndexedFramebuffer::get_memory_usage() const
+{
+        return pixels.size() + palette.size() * sizeof(uint16_t);
+}
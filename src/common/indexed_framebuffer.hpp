@@ -0,0 +1,95 @@
+#pragma once
+#include "raster.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Palette index of the pixels that were not drawn into since the band was
+ * last cleared.
+ */
+#define INDEXED_FRAMEBUFFER_TRANSPARENT 0
+
+/**
+ * Palette-indexed off-screen surface that stores 4 or 8 bits per pixel
+ * instead of the 16 bits of RGB565. A 240x280 screen takes up ~33KB at 4 bits
+ * per pixel which is still too much for the 32KB of RAM of the Arduino R4,
+ * hence the surface can hold only a horizontal band of the screen at a time
+ * (see `set_band`). Everything drawn outside of the current band is clipped.
+ *
+ * The palette is built up as the colors are drawn: the first occurrence of a
+ * color takes up the next free palette entry. Entry 0 is reserved for the
+ * transparent pixels that weren't drawn into, so a 4-bit surface can hold 15
+ * distinct colors. Once the palette is full, further colors are replaced by the
+ * closest color in the palette and counted in `get_palette_misses`.
+ */
+class IndexedFramebuffer : public RasterTarget
+{
+      public:
+        /**
+         * `bits_per_pixel` needs to be either 4 or 8, `band_height` is the
+         * number of rows held in memory, it is clamped to [1, height].
+         */
+        IndexedFramebuffer(int width, int height, int bits_per_pixel,
+                           int band_height);
+
+        int get_bits_per_pixel() const { return bits_per_pixel; }
+        int get_band_height() const { return band_height; }
+        int get_band_start() const { return clip_top; }
+        int get_band_end() const { return clip_bottom; }
+
+        /**
+         * Moves the band held in memory so that it starts at the given row.
+         * The contents of the band are not modified, call `clear_band` to
+         * start drawing the new band from scratch.
+         */
+        void set_band(int band_start);
+        /**
+         * Makes all pixels of the current band transparent.
+         */
+        void clear_band();
+        /**
+         * Forgets all colors in the palette. This invalidates the contents of
+         * the band.
+         */
+        void reset_palette();
+
+        /**
+         * Returns the palette index of the pixel, the row needs to lie inside
+         * of the current band.
+         */
+        uint8_t index(int x, int y) const;
+        uint16_t palette_color(uint8_t index) const { return palette[index]; }
+        /**
+         * Expands `w` pixels of a row of the current band into RGB565.
+         * Transparent pixels are expanded to black.
+         */
+        void expand_row(int x, int y, int w, uint16_t *out) const;
+
+        int get_palette_size() const { return palette_size; }
+        int get_palette_misses() const { return palette_misses; }
+        /**
+         * Number of bytes taken up by the pixels of the band and the palette.
+         */
+        int get_memory_usage() const;
+
+      protected:
+        void fill_clipped_rect(int x, int y, int w, int h,
+                               uint16_t color) override;
+
+      private:
+        int bits_per_pixel;
+        int band_height;
+        int stride;
+        std::vector<uint8_t> pixels;
+        std::vector<uint16_t> palette;
+        int palette_size;
+        int palette_misses;
+        /**
+         * Most recently looked up color, consecutive spans are usually drawn
+         * with the same color.
+         */
+        uint16_t last_color;
+        uint8_t last_index;
+
+        uint8_t color_index(uint16_t color);
+};
@@ -0,0 +1,494 @@
+#ifdef DISPLAY_INSTRUMENTATION
+#include "instrumented_display.hpp"
+#include "logging.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#define TAG "instrumented_display"
+
+/**
+ * Bytes sent to the display controller to set up the address window before
+ * the pixels of a drawing call: the column and row address commands with
+ * their 4 data bytes each and the memory write command.
+ */
+#define TRANSFER_WINDOW_BYTES 11
+/**
+ * Dimensions of the built-in font of the TFT-compatible interface at text
+ * size 1.
+ */
+#define TFT_FONT_WIDTH 6
+#define TFT_FONT_HEIGHT 8
+/**
+ * Number of characters of the overlay text, shorter texts are padded so that
+ * they erase the previous overlay.
+ */
+#define OVERLAY_CHARS 20
+
+static const char *const PRIMITIVE_NAMES[DRAW_COMMAND_TYPE_COUNT] = {
+    "clear",
+    "rounded_border",
+    "circle",
+    "rectangle",
+    "rounded_rectangle",
+    "line",
+    "string",
+    "clear_region",
+    "tft_pixel",
+    "tft_char",
+    "tft_line",
+    "tft_rect",
+    "tft_fill_rect",
+    "tft_triangle",
+    "tft_fill_triangle",
+    "tft_round_rect",
+    "tft_fill_round_rect",
+    "tft_circle",
+    "tft_fill_circle",
+    "tft_ellipse",
+    "tft_fill_ellipse",
+    "tft_string",
+    "tft_fill_screen",
+    "tft_text_color",
+    "tft_text_size",
+    "tft_image",
+    "scroll",
+};
+
+void CostHistogram::add(uint32_t value)
+{
+        int bucket = 0;
+        while (value >> bucket && bucket < COST_HISTOGRAM_BUCKETS - 1) {
+                bucket++;
+        }
+        buckets[bucket]++;
+        count++;
+}
+
+uint32_t CostHistogram::percentile(int percent) const
+{
+        uint32_t target = ((uint64_t)count * percent + 99) / 100;
+        uint32_t seen = 0;
+        for (int i = 0; i < COST_HISTOGRAM_BUCKETS; i++) {
+                seen += buckets[i];
+                if (seen >= target && seen > 0) {
+                        return bucket_end(i);
+                }
+        }
+        return 0;
+}
+
+uint32_t CostHistogram::bucket_start(int bucket)
+{
+        return bucket == 0 ? 0 : 1u << (bucket - 1);
+}
+
+uint32_t CostHistogram::bucket_end(int bucket)
+{
+        if (bucket == COST_HISTOGRAM_BUCKETS - 1) {
+                return UINT32_MAX;
+        }
+        return bucket == 0 ? 0 : (1u << bucket) - 1;
+}
+
+uint32_t FrameCost::overdraw_percent() const
+{
+        return unique_pixels ? (uint64_t)pixels * 100 / unique_pixels : 100;
+}
+
+/**
+ * Area written by a drawing call. Only rectangular areas are `exact`, those
+ * are tracked in the coverage bitmap, for the other shapes only the number of
+ * pixels is estimated.
+ */
+struct PixelArea {
+        uint32_t pixels = 0;
+        bool exact = false;
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+};
+
+static PixelArea rectangle_area(int x, int y, int width, int height)
+{
+        PixelArea area;
+        area.pixels = std::max(width, 0) * std::max(height, 0);
+        area.exact = true;
+        area.x = x;
+        area.y = y;
+        area.width = width;
+        area.height = height;
+        return area;
+}
+
+static PixelArea outline_area(uint32_t pixels)
+{
+        PixelArea area;
+        area.pixels = pixels;
+        return area;
+}
+
+static uint32_t line_pixels(int xs, int ys, int xe, int ye)
+{
+        return std::max(abs(xe - xs), abs(ye - ys)) + 1;
+}
+
+static PixelArea line_area(int xs, int ys, int xe, int ye)
+{
+        if (xs == xe || ys == ye) {
+                return rectangle_area(std::min(xs, xe), std::min(ys, ye),
+                                      abs(xe - xs) + 1, abs(ye - ys) + 1);
+        }
+        return outline_area(line_pixels(xs, ys, xe, ye));
+}
+
+/**
+ * Circumference and area of circles and ellipses are approximated using
+ * pi ~ 355/113.
+ */
+static uint32_t ellipse_outline(int rx, int ry)
+{
+        return 355 * (rx + ry) / 113;
+}
+
+static uint32_t ellipse_fill(int rx, int ry) { return 355 * rx * ry / 113; }
+
+static FontDimensions string_font(const Display &display, FontSize size)
+{
+        FontConfiguration fonts = display.get_font_configuration();
+        switch (size) {
+        case Size24:
+                return fonts.heading_font_dimensions;
+        case Size8:
+                return {fonts.font_dimensions.width / 2,
+                        fonts.font_dimensions.height / 2};
+        default:
+                return fonts.font_dimensions;
+        }
+}
+
+static PixelArea measure(const DrawCommand &command, const char *text,
+                         const Display &display, int tft_text_size)
+{
+        const int16_t *a = command.args;
+        int w = display.get_width();
+        int h = display.get_height();
+        int length = text ? strlen(text) : 0;
+        switch (command.type) {
+        case DrawCommandType::Clear:
+        case DrawCommandType::TftFillScreen:
+                return rectangle_area(0, 0, w, h);
+        case DrawCommandType::RoundedBorder:
+                return outline_area(2 * (w + h));
+        case DrawCommandType::Circle:
+                if (command.flags) {
+                        return outline_area(ellipse_fill(a[2], a[2]));
+                }
+                return outline_area(ellipse_outline(a[2], a[2]) * a[3]);
+        case DrawCommandType::Rectangle:
+                if (command.flags) {
+                        return rectangle_area(a[0], a[1], a[2], a[3]);
+                }
+                return outline_area(2 * (a[2] + a[3]) * a[4]);
+        case DrawCommandType::RoundedRectangle:
+        case DrawCommandType::TftFillRect:
+        case DrawCommandType::TftFillRoundRect:
+        case DrawCommandType::TftImage:
+                return rectangle_area(a[0], a[1], a[2], a[3]);
+        case DrawCommandType::Line:
+        case DrawCommandType::TftLine:
+                return line_area(a[0], a[1], a[2], a[3]);
+        case DrawCommandType::String: {
+                FontDimensions font =
+                    string_font(display, (FontSize)command.flags);
+                return rectangle_area(a[0], a[1], length * font.width,
+                                      font.height);
+        }
+        case DrawCommandType::ClearRegion:
+                return rectangle_area(a[0], a[1], a[2] - a[0] + 1,
+                                      a[3] - a[1] + 1);
+        case DrawCommandType::TftPixel:
+                return rectangle_area(a[0], a[1], 1, 1);
+        case DrawCommandType::TftChar:
+                return rectangle_area(a[0], a[1],
+                                      TFT_FONT_WIDTH * command.flags,
+                                      TFT_FONT_HEIGHT * command.flags);
+        case DrawCommandType::TftString:
+                return rectangle_area(a[0], a[1],
+                                      length * TFT_FONT_WIDTH * tft_text_size,
+                                      TFT_FONT_HEIGHT * tft_text_size);
+        case DrawCommandType::TftRect:
+        case DrawCommandType::TftRoundRect:
+                return outline_area(2 * (a[2] + a[3]));
+        case DrawCommandType::TftTriangle:
+                return outline_area(line_pixels(a[0], a[1], a[2], a[3]) +
+                                    line_pixels(a[2], a[3], a[4], a[5]) +
+                                    line_pixels(a[4], a[5], a[0], a[1]));
+        case DrawCommandType::TftFillTriangle:
+                return outline_area(abs((a[2] - a[0]) * (a[5] - a[1]) -
+                                        (a[4] - a[0]) * (a[3] - a[1])) /
+                                    2);
+        case DrawCommandType::TftCircle:
+                return outline_area(ellipse_outline(a[2], a[2]));
+        case DrawCommandType::TftFillCircle:
+                return outline_area(ellipse_fill(a[2], a[2]));
+        case DrawCommandType::TftEllipse:
+                return outline_area(ellipse_outline(a[2], a[3]));
+        case DrawCommandType::TftFillEllipse:
+                return outline_area(ellipse_fill(a[2], a[3]));
+        default:
+                // Changes of the text state and scrolling don't draw
+                // anything.
+                return outline_area(0);
+        }
+}
+
+TftCompatibleDisplay *InstrumentedDisplay::cast_into_tft_compatible()
+{
+        return display->cast_into_tft_compatible() ? this : nullptr;
+}
+
+void InstrumentedDisplay::begin_app(const char *name)
+{
+        for (size_t i = 0; i < apps.size(); i++) {
+                if (strcmp(apps[i].name, name) == 0) {
+                        current_app = i;
+                        return;
+                }
+        }
+        AppDisplayCost app;
+        app.name = name;
+        apps.push_back(app);
+        current_app = apps.size() - 1;
+}
+
+const AppDisplayCost *InstrumentedDisplay::find_app(const char *name) const
+{
+        for (const AppDisplayCost &app : apps) {
+                if (strcmp(app.name, name) == 0) {
+                        return &app;
+                }
+        }
+        return nullptr;
+}
+
+void InstrumentedDisplay::record(const DrawCommand &command,
+                                 const char *text) const
+{
+        if (command.type == DrawCommandType::TftTextSize) {
+                tft_text_size = std::max<int>(command.flags, 1);
+        }
+        PixelArea area = measure(command, text, *display, tft_text_size);
+
+        long start = time_provider->microseconds();
+        replay_draw_command(command, text, *display);
+        uint32_t elapsed = time_provider->microseconds() - start;
+
+        AppDisplayCost &app = apps[current_app];
+        PrimitiveCost &primitive = app.primitives[(int)command.type];
+        primitive.calls++;
+        primitive.pixels += area.pixels;
+        primitive.time_us += elapsed;
+
+        frame.calls++;
+        frame.pixels += area.pixels;
+        frame.time_us += elapsed;
+        if (area.pixels > 0) {
+                frame.transfer_bytes +=
+                    area.pixels * sizeof(uint16_t) + TRANSFER_WINDOW_BYTES;
+        }
+        if (area.exact) {
+                cover(area.x, area.y, area.width, area.height);
+        } else {
+                // Outlines are assumed not to overlap anything.
+                frame.unique_pixels += area.pixels;
+        }
+}
+
+void InstrumentedDisplay::cover(int x, int y, int width, int height) const
+{
+        int w = display->get_width();
+        int h = display->get_height();
+        size_t words = (w * h + 31) / 32;
+        if (coverage_width != w || coverage.size() != words) {
+                coverage.assign(words, 0);
+                coverage_width = w;
+        }
+        int x0 = std::max(x, 0);
+        int y0 = std::max(y, 0);
+        int x1 = std::min(x + width, w);
+        int y1 = std::min(y + height, h);
+        if (x0 >= x1) {
+                return;
+        }
+        for (int row = y0; row < y1; row++) {
+                int start = row * w + x0;
+                int end = row * w + x1;
+                // Partial words at both ends, whole words in between.
+                while (start < end && start % 32) {
+                        coverage[start / 32] |= 1u << (start % 32);
+                        start++;
+                }
+                while (start + 32 <= end) {
+                        coverage[start / 32] = UINT32_MAX;
+                        start += 32;
+                }
+                while (start < end) {
+                        coverage[start / 32] |= 1u << (start % 32);
+                        start++;
+                }
+        }
+}
+
+void InstrumentedDisplay::close_frame() const
+{
+        for (uint32_t &word : coverage) {
+                frame.unique_pixels += __builtin_popcount(word);
+                word = 0;
+        }
+
+        AppDisplayCost &app = apps[current_app];
+        if (frame.calls == 0) {
+                app.idle_frames++;
+        } else {
+                app.frames++;
+                app.calls_per_frame.add(frame.calls);
+                app.pixels_per_frame.add(frame.pixels);
+                app.transfer_bytes_per_frame.add(frame.transfer_bytes);
+                app.overdraw_percent.add(frame.overdraw_percent());
+                app.time_per_frame_us.add(frame.time_us);
+                last_frame = frame;
+        }
+        frame = FrameCost();
+}
+
+bool InstrumentedDisplay::refresh() const
+{
+        bool drawn = frame.calls > 0;
+        close_frame();
+        if (overlay && drawn) {
+                draw_overlay();
+        }
+        return display->refresh();
+}
+
+void InstrumentedDisplay::draw_overlay() const
+{
+        const FrameCost &cost = last_frame;
+        char pixels[12];
+        if (cost.pixels < 10000) {
+                snprintf(pixels, sizeof(pixels), "%upx", (unsigned)cost.pixels);
+        } else {
+                snprintf(pixels, sizeof(pixels), "%ukpx",
+                         (unsigned)cost.pixels / 1000);
+        }
+        uint32_t overdraw = cost.overdraw_percent();
+        char text[48];
+        snprintf(text, sizeof(text), "%uc %s x%u.%u %u.%ums",
+                 (unsigned)cost.calls, pixels, (unsigned)overdraw / 100,
+                 (unsigned)overdraw % 100 / 10, (unsigned)cost.time_us / 1000,
+                 (unsigned)cost.time_us % 1000 / 100);
+        int length = std::min<int>(strlen(text), OVERLAY_CHARS);
+        memset(text + length, ' ', OVERLAY_CHARS - length);
+        text[OVERLAY_CHARS] = '\0';
+
+        // The overlay is drawn directly on the wrapped display so that it
+        // doesn't count towards the cost of the next frame.
+        FontDimensions font = display->get_font_configuration().font_dimensions;
+        int width = OVERLAY_CHARS * font.width;
+        int x = std::max((display->get_width() - width) / 2, 0);
+        int y = display->get_display_corner_radius() / 4 + 2;
+        display->draw_string({.x = x, .y = y}, text, Size16, Black, White);
+}
+
+void InstrumentedDisplay::log_summary() const
+{
+        for (const AppDisplayCost &app : apps) {
+                if (app.frames == 0) {
+                        continue;
+                }
+                LOG_INFO(TAG, "%s: %u frames drawn, %u idle refreshes",
+                         app.name, (unsigned)app.frames,
+                         (unsigned)app.idle_frames);
+                LOG_INFO(TAG,
+                         "%s: per frame p50/p95 calls %u/%u, pixels %u/%u, "
+                         "bytes %u/%u, overdraw %u/%u%%, time %u/%uus",
+                         app.name, (unsigned)app.calls_per_frame.percentile(50),
+                         (unsigned)app.calls_per_frame.percentile(95),
+                         (unsigned)app.pixels_per_frame.percentile(50),
+                         (unsigned)app.pixels_per_frame.percentile(95),
+                         (unsigned)app.transfer_bytes_per_frame.percentile(50),
+                         (unsigned)app.transfer_bytes_per_frame.percentile(95),
+                         (unsigned)app.overdraw_percent.percentile(50),
+                         (unsigned)app.overdraw_percent.percentile(95),
+                         (unsigned)app.time_per_frame_us.percentile(50),
+                         (unsigned)app.time_per_frame_us.percentile(95));
+                for (int i = 0; i < DRAW_COMMAND_TYPE_COUNT; i++) {
+                        const PrimitiveCost &primitive = app.primitives[i];
+                        if (primitive.calls == 0) {
+                                continue;
+                        }
+                        LOG_INFO(TAG, "%s: %s %u calls, %lu pixels, %luus",
+                                 app.name, PRIMITIVE_NAMES[i],
+                                 (unsigned)primitive.calls,
+                                 (unsigned long)primitive.pixels,
+                                 (unsigned long)primitive.time_us);
+                }
+        }
+}
+
+#ifdef EMULATOR
+static void write_histogram(FILE *file, const char *app, const char *section,
+                            const CostHistogram &histogram)
+{
+        for (int i = 0; i < COST_HISTOGRAM_BUCKETS; i++) {
+                if (histogram.buckets[i] == 0) {
+                        continue;
+                }
+                fprintf(file, "%s,%s,%u-%u,%u,\n", app, section,
+                        CostHistogram::bucket_start(i),
+                        CostHistogram::bucket_end(i), histogram.buckets[i]);
+        }
+}
+
+bool InstrumentedDisplay::write_csv(const char *path) const
+{
+        FILE *file = fopen(path, "w");
+        if (!file) {
+                LOG_ERROR(TAG, "Unable to open %s for writing", path);
+                return false;
+        }
+        fprintf(file, "app,section,name,count,total\n");
+        for (const AppDisplayCost &app : apps) {
+                fprintf(file, "%s,frames,drawn,%u,\n", app.name, app.frames);
+                fprintf(file, "%s,frames,idle,%u,\n", app.name,
+                        app.idle_frames);
+                for (int i = 0; i < DRAW_COMMAND_TYPE_COUNT; i++) {
+                        const PrimitiveCost &primitive = app.primitives[i];
+                        if (primitive.calls == 0) {
+                                continue;
+                        }
+                        fprintf(file, "%s,primitive_pixels,%s,%u,%lu\n",
+                                app.name, PRIMITIVE_NAMES[i], primitive.calls,
+                                (unsigned long)primitive.pixels);
+                        fprintf(file, "%s,primitive_time_us,%s,%u,%lu\n",
+                                app.name, PRIMITIVE_NAMES[i], primitive.calls,
+                                (unsigned long)primitive.time_us);
+                }
+                write_histogram(file, app.name, "calls_per_frame",
+                                app.calls_per_frame);
+                write_histogram(file, app.name, "pixels_per_frame",
+                                app.pixels_per_frame);
+                write_histogram(file, app.name, "bytes_per_frame",
+                                app.transfer_bytes_per_frame);
+                write_histogram(file, app.name, "overdraw_percent",
+                                app.overdraw_percent);
+                write_histogram(file, app.name, "time_per_frame_us",
+                                app.time_per_frame_us);
+        }
+        bool written = ferror(file) == 0;
+        return fclose(file) == 0 && written;
+}
+#endif
+#endif
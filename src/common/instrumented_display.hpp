@@ -0,0 +1,225 @@
+#pragma once
+#ifdef DISPLAY_INSTRUMENTATION
+#include "draw_command.hpp"
+#include "../platform/interface/time_provider.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Number of buckets of the cost histograms, bucket `i` counts the values in
+ * [2^(i-1), 2^i), bucket 0 counts the zeros and the last bucket everything
+ * above.
+ */
+#define COST_HISTOGRAM_BUCKETS 24
+#define DRAW_COMMAND_TYPE_COUNT ((int)DrawCommandType::Scroll + 1)
+/**
+ * App under which the drawing done outside of any app (e.g. the main menu) is
+ * reported.
+ */
+#define INSTRUMENTATION_DEFAULT_APP "menu"
+
+struct CostHistogram {
+        uint32_t buckets[COST_HISTOGRAM_BUCKETS] = {};
+        uint32_t count = 0;
+
+        void add(uint32_t value);
+        /**
+         * Returns the upper bound of the bucket below which `percent` of the
+         * values lie.
+         */
+        uint32_t percentile(int percent) const;
+        static uint32_t bucket_start(int bucket);
+        static uint32_t bucket_end(int bucket);
+};
+
+struct PrimitiveCost {
+        uint32_t calls = 0;
+        uint64_t pixels = 0;
+        uint64_t time_us = 0;
+};
+
+/**
+ * Cost of the drawing calls made between two refreshes of the display.
+ */
+struct FrameCost {
+        uint32_t calls = 0;
+        /**
+         * Pixels written by the drawing calls, the pixels painted several
+         * times are counted each time.
+         */
+        uint32_t pixels = 0;
+        /**
+         * Distinct pixels written. The coverage is tracked on the bounding
+         * boxes of the commands, hence the overdraw of outlines (circles,
+         * diagonal lines, ...) is underestimated.
+         */
+        uint32_t unique_pixels = 0;
+        /**
+         * Estimate of the bytes sent to the display controller, RGB565 pixels
+         * plus the address window set up for each call.
+         */
+        uint32_t transfer_bytes = 0;
+        /**
+         * Time spent in the drawing calls of the wrapped display.
+         */
+        uint32_t time_us = 0;
+
+        /**
+         * Ratio of the written and the distinct pixels in percent, 100 means
+         * that no pixel was painted twice.
+         */
+        uint32_t overdraw_percent() const;
+};
+
+/**
+ * Costs of all frames drawn while an app was running.
+ */
+struct AppDisplayCost {
+        const char *name;
+        uint32_t frames = 0;
+        /**
+         * Refreshes without any drawing calls, e.g. while polling for input.
+         * They are not included in the histograms.
+         */
+        uint32_t idle_frames = 0;
+        PrimitiveCost primitives[DRAW_COMMAND_TYPE_COUNT];
+        CostHistogram calls_per_frame;
+        CostHistogram pixels_per_frame;
+        CostHistogram transfer_bytes_per_frame;
+        CostHistogram overdraw_percent;
+        CostHistogram time_per_frame_us;
+};
+
+/**
+ * Display decorator measuring how much each frame costs: the number of calls
+ * per drawing primitive, the pixels and bytes they push, the overdraw and the
+ * time spent in the wrapped display. The frames are attributed to the app
+ * that is currently running (see `InstrumentedAppScope`) and collected into
+ * per-app histograms that can be logged, written to a CSV file on the
+ * emulator or summarized in an on-screen overlay.
+ *
+ * The instrumentation is only compiled in if the `DISPLAY_INSTRUMENTATION`
+ * flag is defined.
+ */
+class InstrumentedDisplay : public DrawCommandRecorder
+{
+      public:
+        InstrumentedDisplay(Display *display, const TimeProvider *time_provider)
+            : display(display), time_provider(time_provider)
+        {
+                begin_app(INSTRUMENTATION_DEFAULT_APP);
+        }
+
+        void setup() const override { display->setup(); }
+        void initialize() const override { display->initialize(); }
+        int get_height() const override { return display->get_height(); }
+        int get_width() const override { return display->get_width(); }
+        FontConfiguration get_font_configuration() const override
+        {
+                return display->get_font_configuration();
+        }
+        DisplayDimensions get_display_dimensions() const override
+        {
+                return display->get_display_dimensions();
+        }
+        int get_display_corner_radius() const override
+        {
+                return display->get_display_corner_radius();
+        }
+        /**
+         * Closes the current frame and draws the overlay (if enabled) before
+         * refreshing the wrapped display.
+         */
+        bool refresh() const override;
+        void sleep() const override { display->sleep(); }
+        bool supports_scroll(const ScrollRegion &region) const override
+        {
+                return display->supports_scroll(region);
+        }
+
+        TftCompatibleDisplay *cast_into_tft_compatible() override;
+
+        /**
+         * Attributes the following frames to the app with the given name. The
+         * name needs to outlive the display.
+         */
+        void begin_app(const char *name);
+        const char *get_app() const { return apps[current_app].name; }
+
+        /**
+         * Shows the cost of the last frame in a bar at the top of the screen.
+         */
+        void set_overlay(bool enabled) { overlay = enabled; }
+
+        const FrameCost &get_last_frame() const { return last_frame; }
+        const std::vector<AppDisplayCost> &get_apps() const { return apps; }
+        const AppDisplayCost *find_app(const char *name) const;
+
+        void log_summary() const;
+#ifdef EMULATOR
+        /**
+         * Writes the per-app primitive counters and histograms as rows of
+         * `app,section,name,count,total`. Returns false if the file cannot
+         * be written.
+         */
+        bool write_csv(const char *path) const;
+#endif
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override;
+
+      private:
+        Display *display;
+        const TimeProvider *time_provider;
+        mutable std::vector<AppDisplayCost> apps;
+        size_t current_app = 0;
+        bool overlay = false;
+
+        mutable FrameCost frame;
+        mutable FrameCost last_frame;
+        /**
+         * One bit per pixel of the display, set for the pixels written in the
+         * current frame.
+         */
+        mutable std::vector<uint32_t> coverage;
+        mutable int coverage_width = 0;
+        /**
+         * Text size of the TFT-compatible interface, needed to estimate the
+         * size of the strings.
+         */
+        mutable int tft_text_size = 1;
+
+        void cover(int x, int y, int width, int height) const;
+        void close_frame() const;
+        void draw_overlay() const;
+};
+
+/**
+ * Attributes the frames drawn during its lifetime to an app, the previous app
+ * is restored once it goes out of scope. Does nothing if the platform display
+ * is not instrumented.
+ */
+class InstrumentedAppScope
+{
+      public:
+        InstrumentedAppScope(InstrumentedDisplay *display, const char *name)
+            : display(display)
+        {
+                if (display) {
+                        previous_app = display->get_app();
+                        display->begin_app(name);
+                }
+        }
+        ~InstrumentedAppScope()
+        {
+                if (display) {
+                        display->begin_app(previous_app);
+                }
+        }
+
+      private:
+        InstrumentedDisplay *display;
+        const char *previous_app = nullptr;
+};
+#endif
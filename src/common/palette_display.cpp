@@ -0,0 +1,297 @@
+#include "palette_display.hpp"
+#include "logging.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "palette_display"
+
+/**
+ * Number of bytes of the buffers that are allocated up front regardless of
+ * the height of the band: the recorded commands and their texts, the staging
+ * buffer (if the pixels are pushed) and the palette.
+ */
+static int fixed_memory_usage(int bits_per_pixel, bool staged)
+{
+        int commands =
+            PALETTE_DISPLAY_MAX_COMMANDS * (sizeof(DrawCommand) + sizeof(int));
+        int staging =
+            staged ? PALETTE_DISPLAY_STAGING_PIXELS * sizeof(uint16_t) : 0;
+        int palette = (1 << bits_per_pixel) * sizeof(uint16_t);
+        return commands + PALETTE_DISPLAY_MAX_TEXT_BYTES + staging + palette;
+}
+
+/**
+ * Number of rows of the indexed band that fit into what is left of the budget.
+ */
+static int band_height_for_budget(Display *display, int bits_per_pixel,
+                                  bool staged, int ram_budget)
+{
+        int stride = (display->get_width() * bits_per_pixel + 7) / 8;
+        int band_budget =
+            ram_budget - fixed_memory_usage(bits_per_pixel, staged);
+        if (band_budget < stride) {
+                LOG_INFO(TAG,
+                         "The RAM budget of %d bytes doesn't fit a single "
+                         "row, compositing row by row.",
+                         ram_budget);
+        }
+        return std::clamp(band_budget / stride, 1, display->get_height());
+}
+
+PaletteDisplay::PaletteDisplay(Display *display, int bits_per_pixel,
+                               int ram_budget)
+    : display(display), tft_display(display->cast_into_tft_compatible()),
+      pixel_push(!tft_display && display->supports_pixel_push()),
+      renderer(display, bits_per_pixel,
+               band_height_for_budget(display, bits_per_pixel,
+                                      tft_display || pixel_push, ram_budget))
+{
+        commands.reserve(PALETTE_DISPLAY_MAX_COMMANDS);
+        text_offsets.reserve(PALETTE_DISPLAY_MAX_COMMANDS);
+        texts.reserve(PALETTE_DISPLAY_MAX_TEXT_BYTES);
+        if (tft_display || pixel_push) {
+                staging_buffer.resize(PALETTE_DISPLAY_STAGING_PIXELS);
+        }
+}
+
+int PaletteDisplay::get_memory_usage() const
+{
+        return renderer.get_surface().get_memory_usage() +
+               commands.capacity() * sizeof(DrawCommand) +
+               text_offsets.capacity() * sizeof(int) + texts.capacity() +
+               staging_buffer.capacity() * sizeof(uint16_t);
+}
+
+void PaletteDisplay::setup() const { display->setup(); }
+
+void PaletteDisplay::initialize() const { display->initialize(); }
+
+void PaletteDisplay::sleep() const { display->sleep(); }
+
+int PaletteDisplay::get_height() const { return display->get_height(); }
+
+int PaletteDisplay::get_width() const { return display->get_width(); }
+
+FontConfiguration PaletteDisplay::get_font_configuration() const
+{
+        return renderer.get_font_configuration();
+}
+
+DisplayDimensions PaletteDisplay::get_display_dimensions() const
+{
+        return display->get_display_dimensions();
+}
+
+int PaletteDisplay::get_display_corner_radius() const
+{
+        return display->get_display_corner_radius();
+}
+
+bool PaletteDisplay::refresh() const
+{
+        flush();
+        return display->refresh();
+}
+
+void PaletteDisplay::record(const DrawCommand &command, const char *text) const
+{
+        // Texts longer than the reserved space still get recorded, at the
+        // cost of growing the buffer.
+        if (text && !texts.empty() &&
+            texts.size() + strlen(text) + 1 > PALETTE_DISPLAY_MAX_TEXT_BYTES) {
+                flush();
+        }
+        commands.push_back(command);
+        if (text) {
+                text_offsets.push_back(texts.size());
+                texts.insert(texts.end(), text, text + strlen(text) + 1);
+        } else {
+                text_offsets.push_back(-1);
+        }
+
+        if (commands.size() >= PALETTE_DISPLAY_MAX_COMMANDS) {
+                flush();
+        }
+}
+
+void PaletteDisplay::flush() const
+{
+        statistics.frames++;
+        statistics.bands = 0;
+        statistics.pixels_pushed = 0;
+        statistics.transfers = 0;
+        statistics.palette_misses = 0;
+        if (commands.empty()) {
+                return;
+        }
+
+        IndexedFramebuffer &surface = renderer.get_surface();
+        surface.reset_palette();
+        for (int band_start = 0; band_start < get_height();
+             band_start += surface.get_band_height()) {
+                surface.set_band(band_start);
+                surface.clear_band();
+                renderer.setTextColor(text_color);
+                renderer.setTextSize(text_size);
+                for (size_t i = 0; i < commands.size(); i++) {
+                        const char *text = text_offsets[i] == -1
+                                               ? nullptr
+                                               : texts.data() + text_offsets[i];
+                        replay_draw_command(commands[i], text, renderer);
+                }
+                push_band();
+                statistics.bands++;
+        }
+        statistics.palette_misses = surface.get_palette_misses();
+
+        for (const DrawCommand &command : commands) {
+                if (command.type == DrawCommandType::TftTextColor) {
+                        text_color = command.color;
+                } else if (command.type == DrawCommandType::TftTextSize) {
+                        text_size = command.flags > 0 ? command.flags : 1;
+                }
+        }
+        commands.clear();
+        text_offsets.clear();
+        texts.clear();
+}
+
+void PaletteDisplay::push_band() const
+{
+        const IndexedFramebuffer &surface = renderer.get_surface();
+        int width = get_width();
+        int band_start = surface.get_band_start();
+        int band_end = surface.get_band_end();
+
+        // Find the bounding box of the drawn pixels and check whether all of
+        // its pixels were drawn, in that case it is sent as a whole.
+        int x_start = width;
+        int x_end = 0;
+        int y_start = band_end;
+        int y_end = band_start;
+        bool fully_covered = true;
+        for (int row = band_start; row < band_end; row++) {
+                int first = 0;
+                while (first < width && surface.index(first, row) ==
+                                            INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                        first++;
+                }
+                if (first == width) {
+                        fully_covered = false;
+                        continue;
+                }
+                int last = width - 1;
+                while (surface.index(last, row) ==
+                       INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                        last--;
+                }
+                x_start = std::min(x_start, first);
+                x_end = std::max(x_end, last + 1);
+                y_start = std::min(y_start, row);
+                y_end = row + 1;
+        }
+        if (y_start >= y_end) {
+                return;
+        }
+        for (int row = y_start; row < y_end && fully_covered; row++) {
+                for (int column = x_start; column < x_end; column++) {
+                        if (surface.index(column, row) ==
+                            INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                                fully_covered = false;
+                                break;
+                        }
+                }
+        }
+
+        if (!staging_buffer.empty() && fully_covered) {
+                int w = x_end - x_start;
+                int rows_per_window =
+                    std::max(PALETTE_DISPLAY_STAGING_PIXELS / w, 1);
+                for (int row = y_start; row < y_end; row += rows_per_window) {
+                        push_window(x_start, row, w,
+                                    std::min(rows_per_window, y_end - row));
+                }
+                return;
+        }
+
+        for (int row = y_start; row < y_end; row++) {
+                int column = x_start;
+                while (column < x_end) {
+                        if (surface.index(column, row) ==
+                            INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                                column++;
+                                continue;
+                        }
+                        int run_start = column;
+                        while (column < x_end &&
+                               surface.index(column, row) !=
+                                   INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                                column++;
+                        }
+                        push_runs(run_start, row, column - run_start);
+                }
+        }
+}
+
+void PaletteDisplay::push_window(int x, int y, int w, int h) const
+{
+        const IndexedFramebuffer &surface = renderer.get_surface();
+        if (w > PALETTE_DISPLAY_STAGING_PIXELS) {
+                // Only possible for displays wider than the staging buffer,
+                // the rows are sent in pieces.
+                for (int row = y; row < y + h; row++) {
+                        push_runs(x, row, w);
+                }
+                return;
+        }
+        for (int row = 0; row < h; row++) {
+                surface.expand_row(x, y + row, w,
+                                   staging_buffer.data() + row * w);
+        }
+        push_staged(x, y, w, h);
+        statistics.pixels_pushed += (long)w * h;
+}
+
+void PaletteDisplay::push_staged(int x, int y, int w, int h) const
+{
+        if (tft_display) {
+                tft_display->pushImage(x, y, w, h, staging_buffer.data());
+        } else {
+                display->push_pixels({.x = x, .y = y}, w, h,
+                                     staging_buffer.data());
+        }
+        statistics.transfers++;
+}
+
+/**
+ * Sends a horizontal run of drawn pixels.
+ */
+void PaletteDisplay::push_runs(int x, int y, int w) const
+{
+        const IndexedFramebuffer &surface = renderer.get_surface();
+        statistics.pixels_pushed += w;
+        if (!staging_buffer.empty()) {
+                for (int start = x; start < x + w;
+                     start += PALETTE_DISPLAY_STAGING_PIXELS) {
+                        int length = std::min(PALETTE_DISPLAY_STAGING_PIXELS,
+                                              x + w - start);
+                        surface.expand_row(start, y, length,
+                                           staging_buffer.data());
+                        push_staged(start, y, length, 1);
+                }
+                return;
+        }
+
+        int run_start = x;
+        for (int column = x + 1; column <= x + w; column++) {
+                if (column < x + w &&
+                    surface.index(column, y) == surface.index(run_start, y)) {
+                        continue;
+                }
+                display->clear_region(
+                    {.x = run_start, .y = y}, {.x = column, .y = y + 1},
+                    (Color)surface.palette_color(surface.index(run_start, y)));
+                statistics.transfers++;
+                run_start = column;
+        }
+}
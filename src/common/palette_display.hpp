@@ -0,0 +1,188 @@
+#pragma once
+#include "draw_command.hpp"
+#include "framebuffer_display.hpp"
+#include "indexed_framebuffer.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Default number of bytes of RAM that the palette display may use in total
+ * (see `PaletteDisplay::get_memory_usage`). On the Arduino R4 the command and
+ * text buffers and the staging buffer take up 9.5KB, the rest of the budget
+ * holds a band of 47 rows of the 280px wide 1.69 inch display at 4 bits per
+ * pixel, i.e. a full frame is composited in 6 bands.
+ */
+#define PALETTE_DISPLAY_DEFAULT_RAM_BUDGET 16384
+/**
+ * Number of RGB565 pixels expanded from the band before they are sent to the
+ * wrapped display in a single transfer.
+ */
+#define PALETTE_DISPLAY_STAGING_PIXELS 1024
+/**
+ * Number of drawing commands recorded before the pending commands are
+ * composited and pushed without waiting for the refresh.
+ */
+#define PALETTE_DISPLAY_MAX_COMMANDS 256
+/**
+ * Number of bytes reserved for the texts of the recorded commands, the
+ * pending commands are flushed if a text doesn't fit anymore.
+ */
+#define PALETTE_DISPLAY_MAX_TEXT_BYTES 512
+
+struct PaletteDisplayStatistics {
+        int frames = 0;
+        /**
+         * Numbers of bands composited, pixels and driver calls (window
+         * transfers) sent to the wrapped display and colors that did not fit
+         * into the palette during the last refresh.
+         */
+        int bands = 0;
+        long pixels_pushed = 0;
+        int transfers = 0;
+        int palette_misses = 0;
+};
+
+/**
+ * Composites the frame into an `IndexedFramebuffer` that is rendered by the
+ * palette display band by band.
+ */
+class PaletteBandRenderer : public FramebufferDisplay
+{
+      public:
+        PaletteBandRenderer(const Display *display, int bits_per_pixel,
+                            int band_height)
+            : display(display),
+              surface(display->get_width(), display->get_height(),
+                      bits_per_pixel, band_height)
+        {
+        }
+
+        void setup() const override {}
+        void initialize() const override {}
+        int get_height() const override { return display->get_height(); }
+        int get_width() const override { return display->get_width(); }
+        DisplayDimensions get_display_dimensions() const override
+        {
+                return display->get_display_dimensions();
+        }
+        int get_display_corner_radius() const override
+        {
+                return display->get_display_corner_radius();
+        }
+        bool refresh() const override { return true; }
+        void sleep() const override {}
+
+        IndexedFramebuffer &get_surface() const { return surface; }
+
+      protected:
+        RasterTarget &target() const override { return surface; }
+
+      private:
+        const Display *display;
+        mutable IndexedFramebuffer surface;
+};
+
+/**
+ * Display decorator for memory-constrained targets that cannot hold a full
+ * RGB565 framebuffer (a 240x280 frame takes up 131KB while the Arduino R4 has
+ * 32KB of RAM).
+ *
+ * The drawing calls are recorded instead of being forwarded to the wrapped
+ * display. On `refresh` the frame is composited into a 4 or 8 bits per pixel
+ * palette-indexed band that fits into the configured RAM budget: for each band
+ * of rows all recorded commands are replayed into the band, the band is
+ * expanded to RGB565 and pushed to the wrapped display. Only the pixels that
+ * were drawn during the frame are pushed, everything else stays as it is on
+ * the wrapped display, same as if the commands were executed directly.
+ *
+ * If the wrapped display exposes the TFT-compatible interface or supports
+ * pushing pixels (see `Display::push_pixels`), the band is sent through a
+ * staging buffer (in a few large windows if the frame covers the whole band,
+ * otherwise run by run). Otherwise, each row is decomposed into runs of pixels
+ * with the same color which are sent using `clear_region`.
+ *
+ * The RAM budget covers the band as well as the buffers of the recorded
+ * commands and the staging buffer, which are allocated up front.
+ *
+ * Images passed to `pushImage` are only referenced by the recorded commands,
+ * hence they need to stay valid until the next refresh.
+ */
+class PaletteDisplay : public DrawCommandRecorder
+{
+      public:
+        PaletteDisplay(Display *display, int bits_per_pixel = 4,
+                       int ram_budget = PALETTE_DISPLAY_DEFAULT_RAM_BUDGET);
+
+        void setup() const override;
+        void initialize() const override;
+        int get_height() const override;
+        int get_width() const override;
+        FontConfiguration get_font_configuration() const override;
+        DisplayDimensions get_display_dimensions() const override;
+        int get_display_corner_radius() const override;
+        /**
+         * Composites and pushes the recorded commands and refreshes the
+         * wrapped display.
+         */
+        bool refresh() const override;
+        void sleep() const override;
+
+        /**
+         * Composites and pushes the recorded commands without refreshing the
+         * wrapped display.
+         */
+        void flush() const;
+
+        const IndexedFramebuffer &get_surface() const
+        {
+                return renderer.get_surface();
+        }
+        const PaletteDisplayStatistics &get_statistics() const
+        {
+                return statistics;
+        }
+        /**
+         * Returns the number of bytes taken up by the band, the palette and
+         * the buffers of the recorded commands and pixels.
+         */
+        int get_memory_usage() const;
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override;
+
+      private:
+        Display *display;
+        TftCompatibleDisplay *tft_display;
+        /**
+         * True if the pixels are sent using `Display::push_pixels` instead
+         * of `pushImage`.
+         */
+        bool pixel_push;
+        mutable PaletteBandRenderer renderer;
+
+        mutable std::vector<DrawCommand> commands;
+        /**
+         * Offsets of the texts of the string commands in `texts`, -1 for the
+         * commands without text.
+         */
+        mutable std::vector<int> text_offsets;
+        mutable std::vector<char> texts;
+        /**
+         * State of the TFT text settings at the start of the recorded
+         * commands, each band is rendered starting from this state.
+         */
+        mutable uint32_t text_color = White;
+        mutable uint8_t text_size = 1;
+
+        mutable std::vector<uint16_t> staging_buffer;
+        mutable PaletteDisplayStatistics statistics;
+
+        void push_band() const;
+        void push_window(int x, int y, int w, int h) const;
+        void push_runs(int x, int y, int w) const;
+        /**
+         * Sends the `w` x `h` pixels from the staging buffer.
+         */
+        void push_staged(int x, int y, int w, int h) const;
+};
@@ -0,0 +1,94 @@
+#include "queued_display.hpp"
+
+#define TAG "queued_display"
+
+void QueuedDisplay::setup() const { display->setup(); }
+
+void QueuedDisplay::initialize() const
+{
+        flush();
+        display->initialize();
+}
+
+int QueuedDisplay::get_height() const { return display->get_height(); }
+
+int QueuedDisplay::get_width() const { return display->get_width(); }
+
+FontConfiguration QueuedDisplay::get_font_configuration() const
+{
+        return display->get_font_configuration();
+}
+
+DisplayDimensions QueuedDisplay::get_display_dimensions() const
+{
+        return display->get_display_dimensions();
+}
+
+int QueuedDisplay::get_display_corner_radius() const
+{
+        return display->get_display_corner_radius();
+}
+
+bool QueuedDisplay::refresh() const
+{
+        bool blocked = false;
+        while (!queue->try_push_frame_end()) {
+                blocked = true;
+                time_provider->delay_ms(QUEUED_DISPLAY_WAIT_DELAY);
+        }
+        statistics.blocked_pushes += blocked;
+        submitted_frames++;
+        statistics.frames++;
+
+        // Frame fence: the render task may still be working on this frame
+        // but not on the previous one.
+        if (submitted_frames - queue->get_completed_frames() > 1) {
+                statistics.blocked_frames++;
+                while (submitted_frames - queue->get_completed_frames() > 1) {
+                        time_provider->delay_ms(QUEUED_DISPLAY_WAIT_DELAY);
+                }
+        }
+        return !queue->is_closed();
+}
+
+void QueuedDisplay::sleep() const
+{
+        flush();
+        display->sleep();
+}
+
+void QueuedDisplay::flush() const
+{
+        wait_until_completed(queue->get_pushed_count());
+}
+
+void QueuedDisplay::wait_until_completed(uint32_t count) const
+{
+        // The counters wrap around, hence the difference is compared.
+        while ((int32_t)(count - queue->get_completed_count()) > 0) {
+                time_provider->delay_ms(QUEUED_DISPLAY_WAIT_DELAY);
+        }
+}
+
+void QueuedDisplay::record(const DrawCommand &command, const char *text) const
+{
+        if (!queue->fits(text)) {
+                // The render task is idle once the queue is drained, hence
+                // the display can be used directly.
+                flush();
+                statistics.synchronous_commands++;
+                replay_draw_command(command, text, *display);
+                return;
+        }
+
+        bool blocked = false;
+        while (!queue->try_push(command, text)) {
+                blocked = true;
+                time_provider->delay_ms(QUEUED_DISPLAY_WAIT_DELAY);
+        }
+        statistics.blocked_pushes += blocked;
+
+        if (command.type == DrawCommandType::TftImage) {
+                flush();
+        }
+}
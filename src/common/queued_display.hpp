@@ -0,0 +1,99 @@
+#pragma once
+#include "draw_command.hpp"
+#include "draw_command_queue.hpp"
+#include "../platform/interface/time_provider.hpp"
+
+/**
+ * Number of milliseconds the producer sleeps while it waits for the render
+ * task to make space in the queue or to finish a frame.
+ */
+#define QUEUED_DISPLAY_WAIT_DELAY 1
+
+struct QueuedDisplayStatistics {
+        int frames = 0;
+        /**
+         * Number of times the queue was full and the game loop had to wait
+         * for the render task.
+         */
+        int blocked_pushes = 0;
+        /**
+         * Number of times `refresh` had to wait for the previous frame.
+         */
+        int blocked_frames = 0;
+        /**
+         * Number of commands that had to be executed on the game loop side
+         * because their text did not fit into the queue.
+         */
+        int synchronous_commands = 0;
+};
+
+/**
+ * Display decorator that moves the drawing off the game loop: the drawing
+ * calls are pushed into a `DrawCommandQueue` and executed on the wrapped
+ * display by a render task running on another core, which calls
+ * `DrawCommandQueue::process` in a loop.
+ *
+ * The game loop only blocks when the queue is full and on the frame fence:
+ * `refresh` marks the end of the frame and waits until the render task has
+ * finished the previous one, hence at most one frame is in flight while the
+ * game logic of the next one runs. The wrapped display is refreshed by the
+ * render task, a failed refresh is reported by the following `refresh` call.
+ *
+ * `pushImage` waits until the image was sent as the callers reuse their image
+ * buffers right after the call. The non-drawing calls (`initialize`, `sleep`)
+ * wait until the queue is drained and are then executed directly on the
+ * wrapped display.
+ */
+class QueuedDisplay : public DrawCommandRecorder
+{
+      public:
+        QueuedDisplay(Display *display, DrawCommandQueue *queue,
+                      const TimeProvider *time_provider)
+            : display(display), queue(queue), time_provider(time_provider)
+        {
+        }
+
+        void setup() const override;
+        void initialize() const override;
+        int get_height() const override;
+        int get_width() const override;
+        FontConfiguration get_font_configuration() const override;
+        DisplayDimensions get_display_dimensions() const override;
+        int get_display_corner_radius() const override;
+        bool refresh() const override;
+        void sleep() const override;
+        /**
+         * The scroll commands are queued along with the drawing, only the
+         * query is answered directly by the wrapped display.
+         */
+        bool supports_scroll(const ScrollRegion &region) const override
+        {
+                return display->supports_scroll(region);
+        }
+
+        /**
+         * Waits until the render task has executed all queued commands.
+         */
+        void flush() const;
+
+        const QueuedDisplayStatistics &get_statistics() const
+        {
+                return statistics;
+        }
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override;
+
+      private:
+        Display *display;
+        DrawCommandQueue *queue;
+        const TimeProvider *time_provider;
+        /**
+         * Number of frame ends pushed into the queue.
+         */
+        mutable uint32_t submitted_frames = 0;
+        mutable QueuedDisplayStatistics statistics;
+
+        void wait_until_completed(uint32_t count) const;
+};
@@ -0,0 +1,557 @@
+#include "raster.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#define TAG "raster"
+
+void RasterTarget::fill_rect(int x, int y, int w, int h, uint16_t color)
+{
+        int x_start = std::max(x, 0);
+        int y_start = std::max(y, clip_top);
+        int x_end = std::min(x + w, width);
+        int y_end = std::min(y + h, clip_bottom);
+        if (x_start >= x_end || y_start >= y_end) {
+                return;
+        }
+        fill_clipped_rect(x_start, y_start, x_end - x_start, y_end - y_start,
+                          color);
+}
+
+void RasterTarget::draw_pixel(int x, int y, uint16_t color)
+{
+        fill_rect(x, y, 1, 1, color);
+}
+
+void RasterTarget::draw_horizontal_line(int x, int y, int length,
+                                        uint16_t color)
+{
+        fill_rect(x, y, length, 1, color);
+}
+
+void RasterTarget::draw_vertical_line(int x, int y, int length,
+                                      uint16_t color)
+{
+        fill_rect(x, y, 1, length, color);
+}
+
+void RasterTarget::fill_screen(uint16_t color)
+{
+        if (clip_top < clip_bottom) {
+                fill_clipped_rect(0, clip_top, width, clip_bottom - clip_top,
+                                  color);
+        }
+}
+
+void RasterTarget::draw_rect(int x, int y, int w, int h, uint16_t color)
+{
+        draw_frame(x, y, w, h, 1, color);
+}
+
+void RasterTarget::draw_frame(int x, int y, int w, int h, int thickness,
+                              uint16_t color)
+{
+        if (w <= 0 || h <= 0 || thickness <= 0) {
+                return;
+        }
+        // Number of pixels that spill outside of the rectangle.
+        int spill = thickness - 1;
+        int outer_width = w + 2 * spill;
+        // Top and bottom strips span the full width of the frame, the side
+        // strips only cover the rows in between them.
+        fill_rect(x - spill, y - spill, outer_width, thickness, color);
+        fill_rect(x - spill, y + h - 1, outer_width, thickness, color);
+        fill_rect(x - spill, y + 1, thickness, h - 2, color);
+        fill_rect(x + w - 1, y + 1, thickness, h - 2, color);
+}
+
+void RasterTarget::draw_line(int xs, int ys, int xe, int ye, uint16_t color)
+{
+        bool steep = std::abs(ye - ys) > std::abs(xe - xs);
+        if (steep) {
+                std::swap(xs, ys);
+                std::swap(xe, ye);
+        }
+        if (xs > xe) {
+                std::swap(xs, xe);
+                std::swap(ys, ye);
+        }
+
+        int dx = xe - xs;
+        int dy = std::abs(ye - ys);
+        int err = dx / 2;
+        int y_step = ys < ye ? 1 : -1;
+
+        /**
+         * Plain Bresenham would emit the line pixel by pixel, instead we
+         * collect the consecutive pixels that share the same minor coordinate
+         * into a single run and emit it as one span.
+         */
+        int y = ys;
+        int run_start = xs;
+        for (int x = xs; x <= xe; x++) {
+                err -= dy;
+                if (err >= 0 && x != xe) {
+                        continue;
+                }
+                int run_length = x - run_start + 1;
+                if (steep) {
+                        draw_vertical_line(y, run_start, run_length, color);
+                } else {
+                        draw_horizontal_line(run_start, y, run_length, color);
+                }
+                run_start = x + 1;
+                if (err < 0) {
+                        y += y_step;
+                        err += dx;
+                }
+        }
+}
+
+void compute_circle_half_widths(int r, int *half_widths)
+{
+        /**
+         * We follow the midpoint iteration used by the fillCircle function of
+         * the TFT_eSPI / Adafruit GFX libraries. Those fill the circle with
+         * vertical lines, first we record how far each column extends from
+         * the center and then transpose that into the extent of each row.
+         */
+        std::vector<int> column_extents(r + 1, -1);
+        column_extents[0] = r;
+
+        int f = 1 - r;
+        int ddF_x = 1;
+        int ddF_y = -2 * r;
+        int x = 0;
+        int y = r;
+        int px = x;
+        int py = y;
+        while (x < y) {
+                if (f >= 0) {
+                        y--;
+                        ddF_y += 2;
+                        f += ddF_y;
+                }
+                x++;
+                ddF_x += 2;
+                f += ddF_x;
+                if (x < y + 1) {
+                        column_extents[x] = std::max(column_extents[x], y);
+                }
+                if (y != py) {
+                        column_extents[py] = std::max(column_extents[py], px);
+                        py = y;
+                }
+                px = x;
+        }
+
+        for (int dy = 0; dy <= r; dy++) {
+                half_widths[dy] = 0;
+        }
+        for (int dx = 0; dx <= r; dx++) {
+                int extent = column_extents[dx];
+                if (extent >= 0) {
+                        half_widths[extent] = std::max(half_widths[extent], dx);
+                }
+        }
+        // A column that reaches row `dy` also covers all rows above it.
+        for (int dy = r - 1; dy >= 0; dy--) {
+                half_widths[dy] = std::max(half_widths[dy], half_widths[dy + 1]);
+        }
+}
+
+void RasterTarget::fill_circle(int x, int y, int r, uint16_t color)
+{
+        fill_rounded_box(x, y, x, y, r, color);
+}
+
+void RasterTarget::fill_rounded_box(int left, int top, int right, int bottom,
+                                    int r, uint16_t color)
+{
+        if (r < 0 || left > right || top > bottom) {
+                return;
+        }
+        std::vector<int> half_widths(r + 1);
+        compute_circle_half_widths(r, half_widths.data());
+
+        // Consecutive rows of the same extent (e.g. near the widest part of
+        // the corners) are merged into a single rectangle.
+        int run_start = top - r;
+        int run_half_width = half_widths[r];
+        for (int row = top - r + 1; row <= bottom + r + 1; row++) {
+                int half_width = -1;
+                if (row <= bottom + r) {
+                        int dy = row < top ? top - row
+                                           : std::max(row - bottom, 0);
+                        half_width = half_widths[dy];
+                }
+                if (half_width == run_half_width) {
+                        continue;
+                }
+                fill_rect(left - run_half_width, run_start,
+                          right - left + 2 * run_half_width + 1,
+                          row - run_start, color);
+                run_start = row;
+                run_half_width = half_width;
+        }
+}
+void RasterTarget::fill_ring(int x, int y, int r, int thickness,
+                             uint16_t color)
+{
+        int inner_r = r - thickness;
+        if (inner_r < 0) {
+                fill_circle(x, y, r, color);
+                return;
+        }
+        std::vector<int> outer(r + 1);
+        std::vector<int> inner(inner_r + 1);
+        compute_circle_half_widths(r, outer.data());
+        compute_circle_half_widths(inner_r, inner.data());
+        for (int dy = -r; dy <= r; dy++) {
+                int outer_half = outer[std::abs(dy)];
+                if (std::abs(dy) > inner_r) {
+                        draw_horizontal_line(x - outer_half, y + dy,
+                                             2 * outer_half + 1, color);
+                        continue;
+                }
+                int inner_half = inner[std::abs(dy)];
+                int span = outer_half - inner_half;
+                draw_horizontal_line(x - outer_half, y + dy, span, color);
+                draw_horizontal_line(x + inner_half + 1, y + dy, span, color);
+        }
+}
+
+void RasterTarget::draw_circle(int x, int y, int r, uint16_t color)
+{
+        if (r < 0) {
+                return;
+        }
+        int f = 1 - r;
+        int ddF_x = 1;
+        int ddF_y = -2 * r;
+        int dx = 0;
+        int dy = r;
+
+        draw_pixel(x, y + r, color);
+        draw_pixel(x, y - r, color);
+        draw_pixel(x + r, y, color);
+        draw_pixel(x - r, y, color);
+
+        while (dx < dy) {
+                if (f >= 0) {
+                        dy--;
+                        ddF_y += 2;
+                        f += ddF_y;
+                }
+                dx++;
+                ddF_x += 2;
+                f += ddF_x;
+
+                draw_pixel(x + dx, y + dy, color);
+                draw_pixel(x - dx, y + dy, color);
+                draw_pixel(x + dx, y - dy, color);
+                draw_pixel(x - dx, y - dy, color);
+                draw_pixel(x + dy, y + dx, color);
+                draw_pixel(x - dy, y + dx, color);
+                draw_pixel(x + dy, y - dx, color);
+                draw_pixel(x - dy, y - dx, color);
+        }
+}
+
+/**
+ * Draws the selected quarters of a circle outline, the corners bitmask uses
+ * the Adafruit GFX convention: 1 - top left, 2 - top right, 4 - bottom right,
+ * 8 - bottom left.
+ */
+void RasterTarget::draw_circle_corners(int x, int y, int r, uint8_t corners,
+                                       uint16_t color)
+{
+        int f = 1 - r;
+        int ddF_x = 1;
+        int ddF_y = -2 * r;
+        int dx = 0;
+        int dy = r;
+
+        while (dx < dy) {
+                if (f >= 0) {
+                        dy--;
+                        ddF_y += 2;
+                        f += ddF_y;
+                }
+                dx++;
+                ddF_x += 2;
+                f += ddF_x;
+                if (corners & 0x4) {
+                        draw_pixel(x + dx, y + dy, color);
+                        draw_pixel(x + dy, y + dx, color);
+                }
+                if (corners & 0x2) {
+                        draw_pixel(x + dx, y - dy, color);
+                        draw_pixel(x + dy, y - dx, color);
+                }
+                if (corners & 0x8) {
+                        draw_pixel(x - dy, y + dx, color);
+                        draw_pixel(x - dx, y + dy, color);
+                }
+                if (corners & 0x1) {
+                        draw_pixel(x - dy, y - dx, color);
+                        draw_pixel(x - dx, y - dy, color);
+                }
+        }
+}
+
+void RasterTarget::draw_round_rect(int x, int y, int w, int h, int r,
+                                   uint16_t color)
+{
+        if (w <= 0 || h <= 0) {
+                return;
+        }
+        r = std::clamp(r, 0, std::min(w, h) / 2);
+        draw_horizontal_line(x + r, y, w - 2 * r, color);
+        draw_horizontal_line(x + r, y + h - 1, w - 2 * r, color);
+        draw_vertical_line(x, y + r, h - 2 * r, color);
+        draw_vertical_line(x + w - 1, y + r, h - 2 * r, color);
+        draw_circle_corners(x + r, y + r, r, 0x1, color);
+        draw_circle_corners(x + w - r - 1, y + r, r, 0x2, color);
+        draw_circle_corners(x + w - r - 1, y + h - r - 1, r, 0x4, color);
+        draw_circle_corners(x + r, y + h - r - 1, r, 0x8, color);
+}
+
+void RasterTarget::fill_round_rect(int x, int y, int w, int h, int r,
+                                   uint16_t color)
+{
+        if (w <= 0 || h <= 0) {
+                return;
+        }
+        // The corners are quarters of a circle centered `r` pixels away from
+        // the edges, the straight part in between is stretched to fit.
+        r = std::clamp(r, 0, std::min(w, h) / 2);
+        fill_rounded_box(x + r, y + r, x + w - r - 1, y + h - r - 1, r, color);
+}
+void RasterTarget::draw_triangle(int x0, int y0, int x1, int y1, int x2,
+                                 int y2, uint16_t color)
+{
+        draw_line(x0, y0, x1, y1, color);
+        draw_line(x1, y1, x2, y2, color);
+        draw_line(x2, y2, x0, y0, color);
+}
+
+void RasterTarget::fill_triangle(int x0, int y0, int x1, int y1, int x2,
+                                 int y2, uint16_t color)
+{
+        // Sort the vertices by their y coordinate (y0 <= y1 <= y2).
+        if (y0 > y1) {
+                std::swap(y0, y1);
+                std::swap(x0, x1);
+        }
+        if (y1 > y2) {
+                std::swap(y2, y1);
+                std::swap(x2, x1);
+        }
+        if (y0 > y1) {
+                std::swap(y0, y1);
+                std::swap(x0, x1);
+        }
+
+        // Degenerate case: all vertices lie on the same row.
+        if (y0 == y2) {
+                int a = std::min({x0, x1, x2});
+                int b = std::max({x0, x1, x2});
+                draw_horizontal_line(a, y0, b - a + 1, color);
+                return;
+        }
+
+        int32_t dx01 = x1 - x0;
+        int32_t dy01 = y1 - y0;
+        int32_t dx02 = x2 - x0;
+        int32_t dy02 = y2 - y0;
+        int32_t dx12 = x2 - x1;
+        int32_t dy12 = y2 - y1;
+        int32_t sa = 0;
+        int32_t sb = 0;
+
+        /**
+         * The upper part of the triangle goes from y0 to y1 with the edges
+         * 0-1 and 0-2. If y1 == y2 (flat bottom), the last row is included
+         * here, otherwise it is skipped and drawn in the second loop to avoid
+         * dividing by zero when y0 == y1 (flat top).
+         */
+        int last = y1 == y2 ? y1 : y1 - 1;
+        int y = y0;
+        for (; y <= last; y++) {
+                int a = x0 + sa / dy01;
+                int b = x0 + sb / dy02;
+                sa += dx01;
+                sb += dx02;
+                if (a > b) {
+                        std::swap(a, b);
+                }
+                draw_horizontal_line(a, y, b - a + 1, color);
+        }
+
+        // The lower part uses the edges 1-2 and 0-2.
+        sa = dx12 * (y - y1);
+        sb = dx02 * (y - y0);
+        for (; y <= y2; y++) {
+                int a = x1 + sa / dy12;
+                int b = x0 + sb / dy02;
+                sa += dx12;
+                sb += dx02;
+                if (a > b) {
+                        std::swap(a, b);
+                }
+                draw_horizontal_line(a, y, b - a + 1, color);
+        }
+}
+
+void RasterTarget::draw_ellipse(int x, int y, int rx, int ry, uint16_t color)
+{
+        // Same as the TFT_eSPI implementation, degenerate ellipses are skipped.
+        if (rx < 2 || ry < 2) {
+                return;
+        }
+        int32_t rx2 = rx * rx;
+        int32_t ry2 = ry * ry;
+        int32_t fx2 = 4 * rx2;
+        int32_t fy2 = 4 * ry2;
+        int32_t s;
+        int32_t dx;
+        int32_t dy;
+
+        for (dx = 0, dy = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry);
+             ry2 * dx <= rx2 * dy; dx++) {
+                draw_pixel(x + dx, y + dy, color);
+                draw_pixel(x - dx, y + dy, color);
+                draw_pixel(x - dx, y - dy, color);
+                draw_pixel(x + dx, y - dy, color);
+                if (s >= 0) {
+                        s += fx2 * (1 - dy);
+                        dy--;
+                }
+                s += ry2 * ((4 * dx) + 6);
+        }
+
+        for (dx = rx, dy = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx);
+             rx2 * dy <= ry2 * dx; dy++) {
+                draw_pixel(x + dx, y + dy, color);
+                draw_pixel(x - dx, y + dy, color);
+                draw_pixel(x - dx, y - dy, color);
+                draw_pixel(x + dx, y - dy, color);
+                if (s >= 0) {
+                        s += fy2 * (1 - dx);
+                        dx--;
+                }
+                s += rx2 * ((4 * dy) + 6);
+        }
+}
+
+void RasterTarget::fill_ellipse(int x, int y, int rx, int ry, uint16_t color)
+{
+        if (rx < 2 || ry < 2) {
+                return;
+        }
+        int32_t rx2 = rx * rx;
+        int32_t ry2 = ry * ry;
+        int32_t fx2 = 4 * rx2;
+        int32_t fy2 = 4 * ry2;
+        int32_t s;
+        int32_t dx;
+        int32_t dy;
+
+        for (dx = 0, dy = ry, s = 2 * ry2 + rx2 * (1 - 2 * ry);
+             ry2 * dx <= rx2 * dy; dx++) {
+                draw_horizontal_line(x - dx, y - dy, 2 * dx + 1, color);
+                draw_horizontal_line(x - dx, y + dy, 2 * dx + 1, color);
+                if (s >= 0) {
+                        s += fx2 * (1 - dy);
+                        dy--;
+                }
+                s += ry2 * ((4 * dx) + 6);
+        }
+
+        for (dx = rx, dy = 0, s = 2 * rx2 + ry2 * (1 - 2 * rx);
+             rx2 * dy <= ry2 * dx; dy++) {
+                draw_horizontal_line(x - dx, y - dy, 2 * dx + 1, color);
+                draw_horizontal_line(x - dx, y + dy, 2 * dx + 1, color);
+                if (s >= 0) {
+                        s += fy2 * (1 - dx);
+                        dx--;
+                }
+                s += rx2 * ((4 * dy) + 6);
+        }
+}
+
+void RasterTarget::draw_glyph(int x, int y, char c, const BitmapFont &font,
+                              uint16_t fg_color, uint16_t bg_color,
+                              bool opaque, int scale)
+{
+        if (c < ' ' || c > '~' || scale <= 0) {
+                return;
+        }
+        int glyph_size = (font.width * font.height + 7) / 8;
+        const uint8_t *glyph = font.table + (c - ' ') * glyph_size;
+
+        int bit = 0;
+        for (int row = 0; row < font.height; row++) {
+                /**
+                 * Consecutive pixels of the same kind are merged into a single
+                 * span, this way e.g. an opaque space character is drawn using
+                 * one span per row.
+                 */
+                int run_start = 0;
+                bool run_set = glyph[bit / 8] & (0x80 >> (bit % 8));
+                for (int column = 1; column <= font.width; column++) {
+                        int next = bit + column;
+                        bool set = column < font.width &&
+                                   (glyph[next / 8] & (0x80 >> (next % 8)));
+                        if (column < font.width && set == run_set) {
+                                continue;
+                        }
+                        if (run_set || opaque) {
+                                fill_rect(x + run_start * scale,
+                                          y + row * scale,
+                                          (column - run_start) * scale, scale,
+                                          run_set ? fg_color : bg_color);
+                        }
+                        run_start = column;
+                        run_set = set;
+                }
+                bit += font.width;
+        }
+}
+
+int RasterTarget::draw_text(int x, int y, const char *text,
+                            const BitmapFont &font, uint16_t fg_color,
+                            uint16_t bg_color, bool opaque, int scale)
+{
+        for (const char *c = text; *c != '\0'; c++) {
+                if (*c < ' ' || *c > '~') {
+                        continue;
+                }
+                draw_glyph(x, y, *c, font, fg_color, bg_color, opaque, scale);
+                x += font.width * scale;
+        }
+        return x;
+}
+
+void RasterTarget::push_image(int x, int y, int w, int h, const uint16_t *data)
+{
+        int x_start = std::max(x, 0);
+        int y_start = std::max(y, clip_top);
+        int x_end = std::min(x + w, width);
+        int y_end = std::min(y + h, clip_bottom);
+
+        for (int row = y_start; row < y_end; row++) {
+                const uint16_t *row_data = data + (row - y) * w;
+                int run_start = x_start;
+                for (int column = x_start + 1; column <= x_end; column++) {
+                        if (column < x_end &&
+                            row_data[column - x] == row_data[run_start - x]) {
+                                continue;
+                        }
+                        fill_clipped_rect(run_start, row, column - run_start, 1,
+                                          row_data[run_start - x]);
+                        run_start = column;
+                }
+        }
+}
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Description of a monospaced bitmap font. The glyphs are stored one after
+ * another starting from the space character. Each glyph is a plane of
+ * `width * height` bits rounded up to whole bytes, the rows follow each other
+ * without padding and the most significant bit of each byte comes first. This
+ * is the layout of the font tables that come with the Waveshare LCD library
+ * (see `src/lib/waveshare_1_69_inch_lcd/fonts/font_packing.h`).
+ */
+struct BitmapFont {
+        const uint8_t *table;
+        uint16_t width;
+        uint16_t height;
+};
+
+/**
+ * Software rasterizer for all drawing primitives exposed by the `Display` and
+ * `TftCompatibleDisplay` interfaces.
+ *
+ * Every primitive is clipped against the bounds of the target and decomposed
+ * into filled axis-aligned rectangles (in most cases horizontal spans of
+ * height 1), hence the concrete targets only need to implement
+ * `fill_clipped_rect`. This way the same pixel-exact rasterization logic can
+ * be shared between the in-memory framebuffers and targets that forward the
+ * spans to a display driver.
+ *
+ * The shapes are rasterized using the same algorithms as the TFT_eSPI /
+ * Adafruit GFX libraries (midpoint circles, Bresenham lines, scanline
+ * triangles), so that the output is as close as possible to what the
+ * physical 2.4 inch LCD displays.
+ */
+class RasterTarget
+{
+      public:
+        RasterTarget(int width, int height)
+            : width(width), height(height), clip_top(0), clip_bottom(height)
+        {
+        }
+        virtual ~RasterTarget() = default;
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        void draw_pixel(int x, int y, uint16_t color);
+        void draw_horizontal_line(int x, int y, int length, uint16_t color);
+        void draw_vertical_line(int x, int y, int length, uint16_t color);
+        void fill_rect(int x, int y, int w, int h, uint16_t color);
+        void fill_screen(uint16_t color);
+        /**
+         * Draws a 1px outline of the rectangle (all pixels of the outline
+         * lie inside of the rectangle).
+         */
+        void draw_rect(int x, int y, int w, int h, uint16_t color);
+        /**
+         * Draws an outline of the rectangle that is `thickness` pixels wide.
+         * The innermost pixels of the frame are the same as the ones drawn by
+         * `draw_rect`, the remaining ones spill to the outside of the
+         * rectangle.
+         */
+        void draw_frame(int x, int y, int w, int h, int thickness,
+                        uint16_t color);
+        void draw_line(int xs, int ys, int xe, int ye, uint16_t color);
+
+        void draw_circle(int x, int y, int r, uint16_t color);
+        void fill_circle(int x, int y, int r, uint16_t color);
+        /**
+         * Fills the part of the disc of radius `r` that lies outside of the
+         * disc of radius `r - thickness`, i.e. a circle outline that is
+         * `thickness` pixels wide.
+         */
+        void fill_ring(int x, int y, int r, int thickness, uint16_t color);
+
+        void draw_round_rect(int x, int y, int w, int h, int r,
+                             uint16_t color);
+        void fill_round_rect(int x, int y, int w, int h, int r,
+                             uint16_t color);
+        /**
+         * Fills the rectangle with the corners (left, top) and (right,
+         * bottom) (both inclusive) grown by `r` pixels on all sides, the
+         * corners being rounded by quarters of a circle of radius `r`
+         * centered at the corners of the original rectangle. This is the
+         * shared scanline rasterizer behind the filled circles and rounded
+         * rectangles: every row is a single span, nothing is drawn twice and
+         * consecutive rows with the same extent are filled as one rectangle.
+         */
+        void fill_rounded_box(int left, int top, int right, int bottom, int r,
+                              uint16_t color);
+
+        void draw_triangle(int x0, int y0, int x1, int y1, int x2, int y2,
+                           uint16_t color);
+        void fill_triangle(int x0, int y0, int x1, int y1, int x2, int y2,
+                           uint16_t color);
+
+        void draw_ellipse(int x, int y, int rx, int ry, uint16_t color);
+        void fill_ellipse(int x, int y, int rx, int ry, uint16_t color);
+
+        /**
+         * Draws a single character of the bitmap font with its top left
+         * corner at (x, y). Each pixel of the glyph is scaled up into a
+         * `scale` x `scale` square. If `opaque` is false, the background
+         * pixels of the glyph are left untouched.
+         */
+        void draw_glyph(int x, int y, char c, const BitmapFont &font,
+                        uint16_t fg_color, uint16_t bg_color, bool opaque,
+                        int scale = 1);
+        /**
+         * Draws a string one glyph after another, returns the x coordinate
+         * right after the last glyph. Characters outside of the printable
+         * ASCII range are skipped.
+         */
+        int draw_text(int x, int y, const char *text, const BitmapFont &font,
+                      uint16_t fg_color, uint16_t bg_color, bool opaque,
+                      int scale = 1);
+
+        /**
+         * Draws a `w` x `h` RGB565 image stored row by row. The default
+         * implementation emits a span for each run of identical pixels,
+         * targets that have direct access to their pixels should override it.
+         */
+        virtual void push_image(int x, int y, int w, int h,
+                                const uint16_t *data);
+
+      protected:
+        /**
+         * Fills the rectangle with the given color. The rectangle is
+         * guaranteed to be non-empty and to lie fully inside of the bounds of
+         * the target (and inside of the clipped rows).
+         */
+        virtual void fill_clipped_rect(int x, int y, int w, int h,
+                                       uint16_t color) = 0;
+
+        int width;
+        int height;
+        /**
+         * Only the rows in [clip_top, clip_bottom) are drawn into. By default
+         * this is the whole target, targets that hold only a horizontal band
+         * of the screen restrict it to that band.
+         */
+        int clip_top;
+        int clip_bottom;
+
+      private:
+        void draw_circle_corners(int x, int y, int r, uint8_t corners,
+                                 uint16_t color);
+};
+
+/**
+ * Computes the horizontal extent of each row of a filled circle of radius `r`
+ * as rasterized by `RasterTarget::fill_circle`. After the call,
+ * `half_widths[dy]` for `0 <= dy <= r` holds the largest `dx` such that pixel
+ * (dx, dy) relative to the center belongs to the circle. The output array needs
+ * to hold at least `r + 1` elements.
+ */
+void compute_circle_half_widths(int r, int *half_widths);
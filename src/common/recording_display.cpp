@@ -0,0 +1,414 @@
+#include "recording_display.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "recording_display"
+
+/**
+ * Number of pixels by which the bounds of the drawn shapes are extended to
+ * cover the differences between the display drivers (e.g. inclusive rectangle
+ * ends, thick lines).
+ */
+#define DISPLAY_LIST_BOUNDS_MARGIN 2
+
+/**
+ * Rectangle with exclusive ends.
+ */
+struct Bounds {
+        int x0;
+        int y0;
+        int x1;
+        int y1;
+
+        bool contains(const Bounds &other) const
+        {
+                return x0 <= other.x0 && y0 <= other.y0 && other.x1 <= x1 &&
+                       other.y1 <= y1;
+        }
+        bool is_empty() const { return x0 >= x1 || y0 >= y1; }
+};
+
+static Bounds expand(Bounds bounds, int margin)
+{
+        return {bounds.x0 - margin, bounds.y0 - margin, bounds.x1 + margin,
+                bounds.y1 + margin};
+}
+
+/**
+ * Returns the region that the command may draw into. Returns false for the
+ * commands that change the TFT text state or the scrolling, those can never
+ * be dropped.
+ */
+static bool drawn_bounds(const DrawCommand &command, int width, int height,
+                         Bounds &bounds)
+{
+        const int16_t *a = command.args;
+        Bounds screen = {0, 0, width, height};
+        switch (command.type) {
+        case DrawCommandType::TftTextColor:
+        case DrawCommandType::TftTextSize:
+        case DrawCommandType::Scroll:
+                return false;
+        case DrawCommandType::Circle:
+                bounds = expand({a[0] - a[2], a[1] - a[2], a[0] + a[2] + 1,
+                                 a[1] + a[2] + 1},
+                                a[3]);
+                break;
+        case DrawCommandType::Rectangle:
+                bounds = expand({a[0], a[1], a[0] + a[2], a[1] + a[3]}, a[4]);
+                break;
+        case DrawCommandType::RoundedRectangle:
+        case DrawCommandType::TftRect:
+        case DrawCommandType::TftFillRect:
+        case DrawCommandType::TftRoundRect:
+        case DrawCommandType::TftFillRoundRect:
+        case DrawCommandType::TftImage:
+                bounds = {a[0], a[1], a[0] + a[2], a[1] + a[3]};
+                break;
+        case DrawCommandType::Line:
+        case DrawCommandType::TftLine:
+        case DrawCommandType::ClearRegion:
+                bounds = {std::min(a[0], a[2]), std::min(a[1], a[3]),
+                          std::max(a[0], a[2]) + 1, std::max(a[1], a[3]) + 1};
+                break;
+        case DrawCommandType::TftPixel:
+                bounds = {a[0], a[1], a[0] + 1, a[1] + 1};
+                break;
+        case DrawCommandType::TftTriangle:
+        case DrawCommandType::TftFillTriangle:
+                bounds = {std::min({a[0], a[2], a[4]}),
+                          std::min({a[1], a[3], a[5]}),
+                          std::max({a[0], a[2], a[4]}) + 1,
+                          std::max({a[1], a[3], a[5]}) + 1};
+                break;
+        case DrawCommandType::TftCircle:
+        case DrawCommandType::TftFillCircle:
+                bounds = {a[0] - a[2], a[1] - a[2], a[0] + a[2] + 1,
+                          a[1] + a[2] + 1};
+                break;
+        case DrawCommandType::TftEllipse:
+        case DrawCommandType::TftFillEllipse:
+                bounds = {a[0] - a[2], a[1] - a[3], a[0] + a[2] + 1,
+                          a[1] + a[3] + 1};
+                break;
+        default:
+                // Clearing the screen, the rounded border and the text may
+                // draw anywhere.
+                bounds = screen;
+                return true;
+        }
+        bounds = expand(bounds, DISPLAY_LIST_BOUNDS_MARGIN);
+        return true;
+}
+
+/**
+ * Returns the region that the command is guaranteed to paint over with an
+ * opaque color on all displays.
+ */
+static bool covered_bounds(const DrawCommand &command, Bounds &bounds)
+{
+        const int16_t *a = command.args;
+        switch (command.type) {
+        case DrawCommandType::Clear:
+        case DrawCommandType::TftFillScreen:
+                // Bounds of the clear are not limited by the recorded display
+                // size in case the screen is rotated.
+                bounds = {INT16_MIN, INT16_MIN, INT16_MAX, INT16_MAX};
+                return true;
+        case DrawCommandType::ClearRegion:
+                bounds = expand({a[0], a[1], a[2], a[3]}, -1);
+                break;
+        case DrawCommandType::Rectangle:
+                if (!command.flags) {
+                        return false;
+                }
+                bounds = expand({a[0], a[1], a[0] + a[2], a[1] + a[3]}, -1);
+                break;
+        case DrawCommandType::TftFillRect:
+                bounds = {a[0], a[1], a[0] + a[2], a[1] + a[3]};
+                break;
+        default:
+                return false;
+        }
+        return !bounds.is_empty();
+}
+
+void DisplayList::replay(Display &display) const
+{
+        for (size_t i = 0; i < commands.size(); i++) {
+                const char *text =
+                    text_offsets[i] == -1 ? nullptr
+                                          : texts.data() + text_offsets[i];
+                replay_draw_command(commands[i], text, display);
+        }
+}
+
+void DisplayList::optimize(uint8_t optimizations)
+{
+        if (optimizations & DropOverdrawn) {
+                drop_overdrawn();
+        }
+        if (optimizations & CoalesceSpans) {
+                coalesce_spans();
+        }
+        if (optimizations & MergeFills) {
+                merge_fills();
+        }
+}
+
+void DisplayList::clear()
+{
+        commands.clear();
+        text_offsets.clear();
+        texts.clear();
+}
+
+int DisplayList::memory_usage() const
+{
+        return commands.size() * (sizeof(DrawCommand) + sizeof(int)) +
+               texts.size();
+}
+
+/**
+ * Walks the list backwards collecting the regions covered by the opaque
+ * fills, each command drawn entirely within a region that is covered later
+ * on is dropped.
+ */
+void DisplayList::drop_overdrawn()
+{
+        std::vector<Bounds> covers;
+        std::vector<bool> keep(commands.size(), true);
+        for (int i = commands.size() - 1; i >= 0; i--) {
+                // Scrolling moves the pixels drawn before it, the fills that
+                // come after no longer cover them.
+                if (commands[i].type == DrawCommandType::Scroll) {
+                        covers.clear();
+                        continue;
+                }
+                Bounds drawn;
+                if (drawn_bounds(commands[i], width, height, drawn)) {
+                        for (const Bounds &cover : covers) {
+                                if (cover.contains(drawn)) {
+                                        keep[i] = false;
+                                        break;
+                                }
+                        }
+                }
+                Bounds covered;
+                if (keep[i] && covered_bounds(commands[i], covered)) {
+                        covers.push_back(covered);
+                }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+                if (keep[i]) {
+                        commands[kept] = commands[i];
+                        text_offsets[kept] = text_offsets[i];
+                        kept++;
+                }
+        }
+        commands.resize(kept);
+        text_offsets.resize(kept);
+}
+
+/**
+ * Returns true if both commands are axis-aligned lines of the same kind and
+ * color lying on the same row or column and touching each other, in which case
+ * `into` is extended to cover `line` as well.
+ */
+static bool join_lines(DrawCommand &into, const DrawCommand &line)
+{
+        bool is_line = line.type == DrawCommandType::Line ||
+                       line.type == DrawCommandType::TftLine;
+        if (into.type != line.type || into.color != line.color || !is_line) {
+                return false;
+        }
+        int16_t *a = into.args;
+        const int16_t *b = line.args;
+        // Index of the coordinate that is constant along the line.
+        int fixed;
+        if (a[1] == a[3] && b[1] == b[3] && a[1] == b[1]) {
+                fixed = 1;
+        } else if (a[0] == a[2] && b[0] == b[2] && a[0] == b[0]) {
+                fixed = 0;
+        } else {
+                return false;
+        }
+        int along = 1 - fixed;
+        int a_start = std::min(a[along], a[along + 2]);
+        int a_end = std::max(a[along], a[along + 2]);
+        int b_start = std::min(b[along], b[along + 2]);
+        int b_end = std::max(b[along], b[along + 2]);
+        if (b_start > a_end + 1 || a_start > b_end + 1) {
+                return false;
+        }
+        a[along] = std::min(a_start, b_start);
+        a[along + 2] = std::max(a_end, b_end);
+        return true;
+}
+
+void DisplayList::coalesce_spans()
+{
+        size_t kept = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+                DrawCommand command = commands[i];
+                if (kept > 0) {
+                        DrawCommand &last = commands[kept - 1];
+                        // A run of pixels turns into a one pixel high fill.
+                        bool pixel_run =
+                            command.type == DrawCommandType::TftPixel &&
+                            command.color == last.color &&
+                            command.args[1] == last.args[1] &&
+                            ((last.type == DrawCommandType::TftPixel &&
+                              command.args[0] == last.args[0] + 1) ||
+                             (last.type == DrawCommandType::TftFillRect &&
+                              last.args[3] == 1 &&
+                              command.args[0] == last.args[0] + last.args[2]));
+                        if (pixel_run) {
+                                if (last.type == DrawCommandType::TftPixel) {
+                                        last.type =
+                                            DrawCommandType::TftFillRect;
+                                        last.args[2] = 1;
+                                        last.args[3] = 1;
+                                }
+                                last.args[2]++;
+                                continue;
+                        }
+                        if (join_lines(last, command)) {
+                                continue;
+                        }
+                }
+                commands[kept] = command;
+                text_offsets[kept] = text_offsets[i];
+                kept++;
+        }
+        commands.resize(kept);
+        text_offsets.resize(kept);
+}
+
+/**
+ * Returns true if both commands are fills of the same kind and color sharing a
+ * whole edge, in which case `into` is extended to cover `fill` as well.
+ */
+static bool join_fills(DrawCommand &into, const DrawCommand &fill)
+{
+        if (into.type != fill.type || into.color != fill.color) {
+                return false;
+        }
+        // Converts both fills to rectangles with exclusive ends.
+        Bounds a;
+        Bounds b;
+        switch (fill.type) {
+        case DrawCommandType::TftFillRect:
+                a = {into.args[0], into.args[1], into.args[0] + into.args[2],
+                     into.args[1] + into.args[3]};
+                b = {fill.args[0], fill.args[1], fill.args[0] + fill.args[2],
+                     fill.args[1] + fill.args[3]};
+                break;
+        case DrawCommandType::ClearRegion:
+                a = {into.args[0], into.args[1], into.args[2], into.args[3]};
+                b = {fill.args[0], fill.args[1], fill.args[2], fill.args[3]};
+                break;
+        default:
+                return false;
+        }
+
+        bool same_rows = a.y0 == b.y0 && a.y1 == b.y1;
+        bool same_columns = a.x0 == b.x0 && a.x1 == b.x1;
+        bool side_by_side = same_rows && (a.x1 == b.x0 || b.x1 == a.x0);
+        bool stacked = same_columns && (a.y1 == b.y0 || b.y1 == a.y0);
+        if (!side_by_side && !stacked) {
+                return false;
+        }
+        Bounds merged = {std::min(a.x0, b.x0), std::min(a.y0, b.y0),
+                         std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+        if (fill.type == DrawCommandType::TftFillRect) {
+                into.args[0] = merged.x0;
+                into.args[1] = merged.y0;
+                into.args[2] = merged.x1 - merged.x0;
+                into.args[3] = merged.y1 - merged.y0;
+        } else {
+                into.args[0] = merged.x0;
+                into.args[1] = merged.y0;
+                into.args[2] = merged.x1;
+                into.args[3] = merged.y1;
+        }
+        return true;
+}
+
+void DisplayList::merge_fills()
+{
+        size_t kept = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+                if (kept > 0 && join_fills(commands[kept - 1], commands[i])) {
+                        continue;
+                }
+                commands[kept] = commands[i];
+                text_offsets[kept] = text_offsets[i];
+                kept++;
+        }
+        commands.resize(kept);
+        text_offsets.resize(kept);
+}
+
+RecordingDisplay::RecordingDisplay(Display *display, DisplayList *list)
+    : display(display), list(list)
+{
+        list->width = display->get_width();
+        list->height = display->get_height();
+}
+
+TftCompatibleDisplay *RecordingDisplay::cast_into_tft_compatible()
+{
+        return display->cast_into_tft_compatible() ? this : nullptr;
+}
+
+void RecordingDisplay::record(const DrawCommand &command,
+                              const char *text) const
+{
+        list->commands.push_back(command);
+        if (text) {
+                list->text_offsets.push_back(list->texts.size());
+                list->texts.insert(list->texts.end(), text,
+                                   text + strlen(text) + 1);
+        } else {
+                list->text_offsets.push_back(-1);
+        }
+}
+
+void CachedDisplayList::draw(Display &display, uint32_t key,
+                             const std::function<void(const Display &)> &render,
+                             uint8_t optimizations)
+{
+        if (!valid || this->display != &display || this->key != key) {
+                list.clear();
+                RecordingDisplay recorder(&display, &list);
+                render(recorder);
+                list.optimize(optimizations);
+                this->display = &display;
+                this->key = key;
+                valid = true;
+                recordings++;
+        }
+        list.replay(display);
+}
+
+uint32_t display_list_key(std::initializer_list<int> values, const char *text)
+{
+        // FNV-1a over the bytes of the values followed by the text.
+        uint32_t hash = 2166136261u;
+        auto add_byte = [&hash](uint8_t byte) {
+                hash ^= byte;
+                hash *= 16777619u;
+        };
+        for (int value : values) {
+                for (size_t i = 0; i < sizeof(int); i++) {
+                        add_byte((value >> (8 * i)) & 0xFF);
+                }
+        }
+        for (const char *c = text; c && *c; c++) {
+                add_byte(*c);
+        }
+        return hash;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include "draw_command.hpp"
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * Optimizations applied to a display list after it was recorded, see
+ * `DisplayList::optimize`.
+ */
+enum DisplayListOptimization : uint8_t {
+        /**
+         * Removes the commands whose pixels are all painted over by a later
+         * opaque fill.
+         */
+        DropOverdrawn = 1 << 0,
+        /**
+         * Joins runs of same-colored pixels and collinear lines touching each
+         * other into a single span.
+         */
+        CoalesceSpans = 1 << 1,
+        /**
+         * Joins consecutive same-colored fills that share an edge into a
+         * single fill.
+         */
+        MergeFills = 1 << 2,
+        AllOptimizations = DropOverdrawn | CoalesceSpans | MergeFills,
+};
+
+/**
+ * Compact recording of drawing calls that can be replayed on a display any
+ * number of times. Strings are stored in the list itself, images are only
+ * referenced and need to outlive the list.
+ */
+class DisplayList
+{
+      public:
+        void replay(Display &display) const;
+        /**
+         * Rewrites the list into fewer commands that produce the same pixels.
+         * `optimizations` is a combination of `DisplayListOptimization` flags.
+         * The fills used for dropping overdrawn commands are shrunk slightly
+         * to account for the display drivers that don't agree on whether the
+         * rectangle ends are inclusive.
+         */
+        void optimize(uint8_t optimizations = AllOptimizations);
+        void clear();
+
+        int get_command_count() const { return commands.size(); }
+        const std::vector<DrawCommand> &get_commands() const
+        {
+                return commands;
+        }
+        /**
+         * Number of bytes taken up by the commands and the texts.
+         */
+        int memory_usage() const;
+
+      private:
+        friend class RecordingDisplay;
+
+        std::vector<DrawCommand> commands;
+        /**
+         * Offsets of the texts of the string commands in `texts`, -1 for the
+         * commands without text.
+         */
+        std::vector<int> text_offsets;
+        std::vector<char> texts;
+        /**
+         * Size of the display the list was recorded on, used as the bounds
+         * of the commands that can draw anywhere (e.g. strings).
+         */
+        int width = 0;
+        int height = 0;
+
+        void drop_overdrawn();
+        void coalesce_spans();
+        void merge_fills();
+};
+
+/**
+ * Display that records all drawing calls into a `DisplayList` instead of
+ * executing them. The layout queries (size, fonts, ...) are answered by the
+ * wrapped display so that the recorded screen is laid out exactly as if it
+ * was drawn on the wrapped display directly. The TFT-compatible interface is
+ * only exposed if the wrapped display has it.
+ */
+class RecordingDisplay : public DrawCommandRecorder
+{
+      public:
+        RecordingDisplay(Display *display, DisplayList *list);
+
+        void setup() const override {}
+        void initialize() const override {}
+        int get_height() const override { return display->get_height(); }
+        int get_width() const override { return display->get_width(); }
+        FontConfiguration get_font_configuration() const override
+        {
+                return display->get_font_configuration();
+        }
+        DisplayDimensions get_display_dimensions() const override
+        {
+                return display->get_display_dimensions();
+        }
+        int get_display_corner_radius() const override
+        {
+                return display->get_display_corner_radius();
+        }
+        bool refresh() const override { return true; }
+        void sleep() const override {}
+
+        TftCompatibleDisplay *cast_into_tft_compatible() override;
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override;
+
+      private:
+        Display *display;
+        DisplayList *list;
+};
+
+/**
+ * Display list of a static screen that a caller keeps around. Instead of
+ * regenerating the screen through all of its drawing calls and layout
+ * computations each time it is shown, the calls are recorded once and the
+ * optimized list is replayed afterwards.
+ */
+class CachedDisplayList
+{
+      public:
+        /**
+         * Draws the screen on the display. `render` is only executed (and
+         * recorded) if the display or the key changed since the last call.
+         * The key needs to capture everything the screen depends on, see
+         * `display_list_key`.
+         */
+        void draw(Display &display, uint32_t key,
+                  const std::function<void(const Display &)> &render,
+                  uint8_t optimizations = AllOptimizations);
+        void invalidate() { valid = false; }
+
+        const DisplayList &get_list() const { return list; }
+        int get_recordings() const { return recordings; }
+
+      private:
+        DisplayList list;
+        const Display *display = nullptr;
+        uint32_t key = 0;
+        bool valid = false;
+        int recordings = 0;
+};
+
+/**
+ * Hashes the values (and optionally a text) that a cached screen depends on
+ * into a key for `CachedDisplayList::draw`.
+ */
+uint32_t display_list_key(std::initializer_list<int> values,
+                          const char *text = nullptr);
@@ -0,0 +1,80 @@
+#include "scroll_view.hpp"
+#include "maths_utils.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+#define TAG "scroll_view"
+
+ScrollView::ScrollView(const Display *display, const ScrollRegion &region,
+                       DrawScrolledContent draw_content)
+    : display(display), region(region), draw_content(std::move(draw_content)),
+      scrolled_by_display(!region.is_empty() &&
+                          display->supports_scroll(region))
+{
+}
+
+ScrollView::~ScrollView() { reset(); }
+
+void ScrollView::reset()
+{
+        if (scrolled_by_display) {
+                display->set_scroll({}, 0);
+        }
+}
+
+void ScrollView::draw(int position)
+{
+        this->position = position;
+        if (scrolled_by_display) {
+                int offset = mathematical_modulo(position, region.length());
+                display->set_scroll(region, offset);
+        }
+        redraw(position, region.length());
+}
+
+void ScrollView::scroll_to(int position)
+{
+        int delta = position - this->position;
+        int length = region.length();
+        if (delta == 0) {
+                return;
+        }
+        if (!scrolled_by_display || abs(delta) >= length) {
+                draw(position);
+                return;
+        }
+
+        // The display now shows the window at the new position, the strip
+        // that scrolled in still holds the content that scrolled out.
+        this->position = position;
+        display->set_scroll(region, mathematical_modulo(position, length));
+        if (delta > 0) {
+                redraw(position + length - delta, delta);
+        } else {
+                redraw(position, -delta);
+        }
+}
+
+void ScrollView::redraw(int content_start, int length)
+{
+        int region_length = region.length();
+        int from = std::max(content_start, position);
+        int to = std::min(content_start + length, position + region_length);
+        if (from >= to) {
+                return;
+        }
+        if (!scrolled_by_display) {
+                draw_content(*display, from, region.start() + from - position,
+                             to - from);
+                return;
+        }
+
+        // The range is split where it wraps around the end of the region.
+        int slot = mathematical_modulo(from, region_length);
+        int first = std::min(to - from, region_length - slot);
+        draw_content(*display, from, region.start() + slot, first);
+        if (first < to - from) {
+                draw_content(*display, from + first, region.start(),
+                             to - from - first);
+        }
+}
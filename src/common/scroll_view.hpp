@@ -0,0 +1,74 @@
+#pragma once
+#include "../platform/interface/display.hpp"
+#include <functional>
+
+/**
+ * Draws the part `[content_start, content_start + length)` of the scrolled
+ * content (measured along the scrolled axis) at `screen_start` on the display.
+ * It must not draw outside of that range along the axis nor outside of the
+ * scrolled region across it, the range is also expected to be cleared first.
+ */
+using DrawScrolledContent =
+    std::function<void(const Display &display, int content_start,
+                       int screen_start, int length)>;
+
+/**
+ * Shows a window into content that is longer than a region of the screen,
+ * e.g. a graph with more bars than fit on the screen or a long text.
+ *
+ * If the display is able to scroll the region by itself (see
+ * `Display::set_scroll`), the content is kept in the region as in a ring
+ * buffer: the content position `p` is stored at `start + p mod length`.
+ * Moving the window then only scrolls the display and draws the newly exposed
+ * strip. Otherwise the whole region is redrawn at each move.
+ *
+ * The scrolling of the display is reset once the view goes out of scope.
+ */
+class ScrollView
+{
+      public:
+        ScrollView(const Display *display, const ScrollRegion &region,
+                   DrawScrolledContent draw_content);
+        ~ScrollView();
+
+        ScrollView(const ScrollView &) = delete;
+        ScrollView &operator=(const ScrollView &) = delete;
+
+        /**
+         * Draws the whole region with the window starting at the given
+         * content position.
+         */
+        void draw(int position);
+        /**
+         * Moves the window to the given content position, only the content
+         * that wasn't visible before gets drawn if the display scrolls.
+         * Nothing is drawn if the window stays where it is.
+         */
+        void scroll_to(int position);
+        /**
+         * Draws the given part of the content again, e.g. after it has been
+         * highlighted. The parts outside of the window are skipped.
+         */
+        void redraw(int content_start, int length);
+        /**
+         * Restores the normal addressing of the display, needs to be called
+         * before drawing anything else over the region (e.g. a help screen).
+         * The next `draw` scrolls the region again.
+         */
+        void reset();
+
+        int get_position() const { return position; }
+        const ScrollRegion &get_region() const { return region; }
+        /**
+         * Returns true if the display scrolls the region, false if the region
+         * is redrawn instead.
+         */
+        bool is_scrolled_by_display() const { return scrolled_by_display; }
+
+      private:
+        const Display *display;
+        ScrollRegion region;
+        DrawScrolledContent draw_content;
+        bool scrolled_by_display;
+        int position = 0;
+};
@@ -0,0 +1,363 @@
+#include "thumbnail_cache.hpp"
+#include "palette_display.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "thumbnail_cache"
+
+/**
+ * Display that records the drawing calls of a thumbnail renderer. The shapes
+ * are kept for rasterizing the sprite, the text calls go straight into the
+ * text overlay of the sprite. Everything else is forwarded to the actual
+ * display so that the thumbnails lay themselves out in the same way.
+ */
+class ThumbnailRecorder : public DrawCommandRecorder
+{
+      public:
+        ThumbnailRecorder(const Display *display,
+                          std::vector<DrawCommand> &text_commands,
+                          std::vector<int> &text_offsets,
+                          std::vector<char> &texts)
+            : display(display), text_commands(text_commands),
+              text_offsets(text_offsets), texts(texts)
+        {
+        }
+
+        void setup() const override {}
+        void initialize() const override {}
+        int get_height() const override { return display->get_height(); }
+        int get_width() const override { return display->get_width(); }
+        FontConfiguration get_font_configuration() const override
+        {
+                return display->get_font_configuration();
+        }
+        DisplayDimensions get_display_dimensions() const override
+        {
+                return display->get_display_dimensions();
+        }
+        int get_display_corner_radius() const override
+        {
+                return display->get_display_corner_radius();
+        }
+        bool refresh() const override { return true; }
+        void sleep() const override {}
+
+        const std::vector<DrawCommand> &get_shapes() const { return shapes; }
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override
+        {
+                switch (command.type) {
+                case DrawCommandType::String:
+                case DrawCommandType::TftChar:
+                case DrawCommandType::TftString:
+                case DrawCommandType::TftTextColor:
+                case DrawCommandType::TftTextSize:
+                        text_commands.push_back(command);
+                        if (text) {
+                                text_offsets.push_back(texts.size());
+                                texts.insert(texts.end(), text,
+                                             text + strlen(text) + 1);
+                        } else {
+                                text_offsets.push_back(-1);
+                        }
+                        return;
+                default:
+                        shapes.push_back(command);
+                }
+        }
+
+      private:
+        const Display *display;
+        mutable std::vector<DrawCommand> shapes;
+        std::vector<DrawCommand> &text_commands;
+        std::vector<int> &text_offsets;
+        std::vector<char> &texts;
+};
+
+uint8_t ThumbnailCache::Sprite::index(int column, int row) const
+{
+        const uint8_t *row_pixels = pixels.data() + row * stride();
+        if (bits_per_pixel == 8) {
+                return row_pixels[column];
+        }
+        uint8_t byte = row_pixels[column / 2];
+        return column % 2 == 0 ? byte >> 4 : byte & 0x0F;
+}
+
+int ThumbnailCache::Sprite::memory_usage() const
+{
+        return pixels.size() + palette.size() * sizeof(uint16_t) +
+               text_commands.size() * sizeof(DrawCommand) +
+               text_offsets.size() * sizeof(int) + texts.size();
+}
+
+void ThumbnailCache::render(int key, ThumbnailRenderer &renderer,
+                            const Platform &platform,
+                            const UserInterfaceCustomization &customization)
+{
+        Display &display = *platform.display;
+        if (!display.cast_into_tft_compatible()) {
+                renderer.render_thumbnail(platform, customization);
+                return;
+        }
+
+        clock++;
+        Sprite *cached = find(key, &display, customization);
+        if (cached) {
+                statistics.hits++;
+                cached->last_used = clock;
+                draw(*cached, display);
+                return;
+        }
+
+        statistics.misses++;
+        Sprite sprite = {.key = key,
+                         .accent_color = customization.accent_color,
+                         .rendering_mode = customization.rendering_mode,
+                         .display = &display,
+                         .x = 0,
+                         .y = 0,
+                         .width = 0,
+                         .height = 0,
+                         .bits_per_pixel = 4,
+                         .pixels = {},
+                         .palette = {},
+                         .text_commands = {},
+                         .text_offsets = {},
+                         .texts = {},
+                         .last_used = clock};
+        rasterize(renderer, platform, customization, sprite);
+        draw(sprite, display);
+        insert(std::move(sprite));
+}
+
+void ThumbnailCache::clear() { sprites.clear(); }
+
+int ThumbnailCache::get_memory_usage() const
+{
+        int usage = 0;
+        for (const Sprite &sprite : sprites) {
+                usage += sprite.memory_usage();
+        }
+        return usage;
+}
+
+ThumbnailCache::Sprite *
+ThumbnailCache::find(int key, const Display *display,
+                     const UserInterfaceCustomization &customization)
+{
+        for (Sprite &sprite : sprites) {
+                if (sprite.key == key && sprite.display == display &&
+                    sprite.accent_color == customization.accent_color &&
+                    sprite.rendering_mode == customization.rendering_mode) {
+                        return &sprite;
+                }
+        }
+        return nullptr;
+}
+
+/**
+ * Records the drawing calls of the renderer and rasterizes them into the
+ * sprite. The shapes are replayed band by band twice: the first pass finds
+ * the bounding box of the drawn pixels and builds up the palette, which
+ * determines the size and bit depth of the sprite. The second pass copies the
+ * indices of the bands overlapping the bounding box into the sprite.
+ */
+void ThumbnailCache::rasterize(ThumbnailRenderer &renderer,
+                               const Platform &platform,
+                               const UserInterfaceCustomization &customization,
+                               Sprite &sprite)
+{
+        const Display &display = *platform.display;
+        ThumbnailRecorder recorder(&display, sprite.text_commands,
+                                   sprite.text_offsets, sprite.texts);
+        Platform recording_platform = platform;
+        recording_platform.display = &recorder;
+        renderer.render_thumbnail(recording_platform, customization);
+
+        int width = display.get_width();
+        int height = display.get_height();
+        PaletteBandRenderer band(&display, 8,
+                                 THUMBNAIL_CACHE_BAND_BUDGET / width);
+        IndexedFramebuffer &surface = band.get_surface();
+        auto replay_band = [&](int band_start) {
+                surface.set_band(band_start);
+                surface.clear_band();
+                for (const DrawCommand &command : recorder.get_shapes()) {
+                        replay_draw_command(command, nullptr, band);
+                }
+        };
+
+        int x_start = width;
+        int x_end = 0;
+        int y_start = height;
+        int y_end = 0;
+        for (int band_start = 0; band_start < height;
+             band_start += surface.get_band_height()) {
+                replay_band(band_start);
+                for (int row = band_start; row < surface.get_band_end();
+                     row++) {
+                        for (int column = 0; column < width; column++) {
+                                if (surface.index(column, row) ==
+                                    INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                                        continue;
+                                }
+                                x_start = std::min(x_start, column);
+                                x_end = std::max(x_end, column + 1);
+                                y_start = std::min(y_start, row);
+                                y_end = row + 1;
+                        }
+                }
+        }
+        if (y_start >= y_end) {
+                return;
+        }
+
+        sprite.x = x_start;
+        sprite.y = y_start;
+        sprite.width = x_end - x_start;
+        sprite.height = y_end - y_start;
+        sprite.bits_per_pixel = surface.get_palette_size() <= 16 ? 4 : 8;
+        sprite.pixels.assign(sprite.stride() * sprite.height, 0);
+        for (int i = 0; i < surface.get_palette_size(); i++) {
+                sprite.palette.push_back(surface.palette_color(i));
+        }
+
+        // The palette is complete after the first pass, hence the bands are
+        // indexed in the same way when they are replayed again.
+        int band_height = surface.get_band_height();
+        for (int band_start = y_start - y_start % band_height;
+             band_start < y_end; band_start += band_height) {
+                replay_band(band_start);
+                int first_row = std::max(band_start, y_start);
+                int last_row = std::min(surface.get_band_end(), y_end);
+                for (int row = first_row; row < last_row; row++) {
+                        uint8_t *out = sprite.pixels.data() +
+                                       (row - y_start) * sprite.stride();
+                        for (int column = 0; column < sprite.width; column++) {
+                                uint8_t index =
+                                    surface.index(x_start + column, row);
+                                if (sprite.bits_per_pixel == 8) {
+                                        out[column] = index;
+                                } else if (column % 2 == 0) {
+                                        out[column / 2] = index << 4;
+                                } else {
+                                        out[column / 2] |= index;
+                                }
+                        }
+                }
+        }
+}
+
+/**
+ * Adds the sprite to the cache, evicting the least recently used sprites
+ * until it fits into the budget. Sprites larger than the whole budget are
+ * not cached.
+ */
+void ThumbnailCache::insert(Sprite &&sprite)
+{
+        int size = sprite.memory_usage();
+        if (size > memory_budget) {
+                return;
+        }
+        int usage = get_memory_usage();
+        while (usage + size > memory_budget && !sprites.empty()) {
+                auto least_recently_used = std::min_element(
+                    sprites.begin(), sprites.end(),
+                    [](const Sprite &a, const Sprite &b) {
+                            return a.last_used < b.last_used;
+                    });
+                usage -= least_recently_used->memory_usage();
+                sprites.erase(least_recently_used);
+                statistics.evictions++;
+        }
+        sprites.push_back(std::move(sprite));
+}
+
+/**
+ * Sends the sprite to the display followed by the text overlay. Consecutive
+ * rows without undrawn pixels are sent in a single window, the other rows as
+ * one window per run of drawn pixels.
+ */
+void ThumbnailCache::draw(const Sprite &sprite, Display &display)
+{
+        TftCompatibleDisplay &tft = *display.cast_into_tft_compatible();
+        if (sprite.height > 0) {
+                staging_buffer.resize(THUMBNAIL_CACHE_STAGING_PIXELS);
+        }
+        int rows_per_window =
+            std::max(THUMBNAIL_CACHE_STAGING_PIXELS / std::max(sprite.width, 1),
+                     1);
+        int window_start = 0;
+        for (int row = 0; row <= sprite.height; row++) {
+                bool opaque = row < sprite.height &&
+                              sprite.width <= THUMBNAIL_CACHE_STAGING_PIXELS;
+                for (int column = 0; opaque && column < sprite.width;
+                     column++) {
+                        opaque = sprite.index(column, row) !=
+                                 INDEXED_FRAMEBUFFER_TRANSPARENT;
+                }
+                if (opaque && row - window_start < rows_per_window) {
+                        continue;
+                }
+                if (row > window_start) {
+                        push_window(sprite, tft, window_start,
+                                    row - window_start);
+                }
+                window_start = row;
+                if (row < sprite.height && !opaque) {
+                        push_runs(sprite, tft, row);
+                        window_start = row + 1;
+                }
+        }
+
+        for (size_t i = 0; i < sprite.text_commands.size(); i++) {
+                const char *text = sprite.text_offsets[i] == -1
+                                       ? nullptr
+                                       : sprite.texts.data() +
+                                             sprite.text_offsets[i];
+                replay_draw_command(sprite.text_commands[i], text, display);
+        }
+}
+
+void ThumbnailCache::push_window(const Sprite &sprite,
+                                 TftCompatibleDisplay &tft, int row, int rows)
+{
+        uint16_t *out = staging_buffer.data();
+        for (int y = row; y < row + rows; y++) {
+                for (int column = 0; column < sprite.width; column++) {
+                        *out++ = sprite.palette[sprite.index(column, y)];
+                }
+        }
+        tft.pushImage(sprite.x, sprite.y + row, sprite.width, rows,
+                      staging_buffer.data());
+}
+
+/**
+ * Sends each run of drawn pixels of the row separately.
+ */
+void ThumbnailCache::push_runs(const Sprite &sprite, TftCompatibleDisplay &tft,
+                               int row)
+{
+        int column = 0;
+        while (column < sprite.width) {
+                if (sprite.index(column, row) ==
+                    INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                        column++;
+                        continue;
+                }
+                int run_start = column;
+                while (column < sprite.width &&
+                       column - run_start < THUMBNAIL_CACHE_STAGING_PIXELS &&
+                       sprite.index(column, row) !=
+                           INDEXED_FRAMEBUFFER_TRANSPARENT) {
+                        staging_buffer[column - run_start] =
+                            sprite.palette[sprite.index(column, row)];
+                        column++;
+                }
+                tft.pushImage(sprite.x + run_start, sprite.y + row,
+                              column - run_start, 1, staging_buffer.data());
+        }
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include "draw_command.hpp"
+#include "thumbnail.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Default number of bytes that the cached thumbnail sprites may take up. A
+ * typical game thumbnail covers the lower half of the 320x240 display and is
+ * stored in ~20KB at 4 bits per pixel, so the default keeps the last few
+ * thumbnails around on the ESP32. The emulator keeps all of them.
+ */
+#ifdef EMULATOR
+#define THUMBNAIL_CACHE_DEFAULT_MEMORY_BUDGET (1024 * 1024)
+#else
+#define THUMBNAIL_CACHE_DEFAULT_MEMORY_BUDGET (64 * 1024)
+#endif
+/**
+ * Number of bytes of the indexed band that the thumbnails are rasterized into
+ * before they are cropped into a sprite.
+ */
+#define THUMBNAIL_CACHE_BAND_BUDGET 8192
+/**
+ * Number of RGB565 pixels expanded from a sprite before they are sent to the
+ * display in a single `pushImage` call.
+ */
+#define THUMBNAIL_CACHE_STAGING_PIXELS 2048
+
+struct ThumbnailCacheStatistics {
+        int hits = 0;
+        int misses = 0;
+        int evictions = 0;
+};
+
+/**
+ * Retained cache of rendered thumbnails for the main menu carousel.
+ *
+ * The thumbnails are drawn procedurally, re-running all of that drawing code
+ * each time the user scrolls through the menu is slow enough for the user to
+ * see the thumbnail paint in. Instead, the first time a thumbnail is shown,
+ * its drawing calls are recorded and rasterized into a palette-compressed
+ * sprite (4 bits per pixel if the thumbnail uses at most 15 colors, 8 bits
+ * otherwise) cropped to the pixels that the thumbnail draws. Afterwards the
+ * sprite is sent to the display using `pushImage`. Pixels that the thumbnail
+ * does not draw are left untouched, same as when drawing it directly.
+ *
+ * Text is not rasterized into the sprite as the software rasterizer uses
+ * different fonts than the display drivers. The text calls are kept with the
+ * sprite and replayed on the display after the sprite was sent, hence
+ * thumbnails shouldn't draw shapes over previously drawn text.
+ *
+ * The sprites are bounded by the memory budget, the least recently shown
+ * sprites are evicted first. Displays that don't expose the TFT-compatible
+ * interface draw the thumbnails directly.
+ */
+class ThumbnailCache
+{
+      public:
+        ThumbnailCache(int memory_budget = THUMBNAIL_CACHE_DEFAULT_MEMORY_BUDGET)
+            : memory_budget(memory_budget)
+        {
+        }
+
+        /**
+         * Draws the thumbnail on the display of the platform. `key` identifies
+         * the thumbnail, the caller needs to ensure that the same key is
+         * always used with the same renderer. The sprites are also keyed by
+         * the parts of the customization that the thumbnails depend on.
+         */
+        void render(int key, ThumbnailRenderer &renderer,
+                    const Platform &platform,
+                    const UserInterfaceCustomization &customization);
+        /**
+         * Drops all cached sprites.
+         */
+        void clear();
+
+        /**
+         * Number of bytes taken up by the cached sprites.
+         */
+        int get_memory_usage() const;
+        int get_cached_count() const { return sprites.size(); }
+        const ThumbnailCacheStatistics &get_statistics() const
+        {
+                return statistics;
+        }
+
+      private:
+        struct Sprite {
+                int key;
+                Color accent_color;
+                UserInterfaceRenderingMode rendering_mode;
+                const Display *display;
+                int x;
+                int y;
+                int width;
+                int height;
+                int bits_per_pixel;
+                /**
+                 * Rows of palette indices, each one padded to whole bytes.
+                 * Index 0 marks the pixels that are not drawn.
+                 */
+                std::vector<uint8_t> pixels;
+                std::vector<uint16_t> palette;
+                /**
+                 * Text calls drawn on top of the sprite, see `TextOverlay`.
+                 */
+                std::vector<DrawCommand> text_commands;
+                std::vector<int> text_offsets;
+                std::vector<char> texts;
+                unsigned long last_used;
+
+                int stride() const { return (width * bits_per_pixel + 7) / 8; }
+                uint8_t index(int column, int row) const;
+                int memory_usage() const;
+        };
+
+        int memory_budget;
+        std::vector<Sprite> sprites;
+        std::vector<uint16_t> staging_buffer;
+        unsigned long clock = 0;
+        ThumbnailCacheStatistics statistics;
+
+        Sprite *find(int key, const Display *display,
+                     const UserInterfaceCustomization &customization);
+        void rasterize(ThumbnailRenderer &renderer, const Platform &platform,
+                       const UserInterfaceCustomization &customization,
+                       Sprite &sprite);
+        void insert(Sprite &&sprite);
+        void draw(const Sprite &sprite, Display &display);
+        void push_window(const Sprite &sprite, TftCompatibleDisplay &tft,
+                         int row, int rows);
+        void push_runs(const Sprite &sprite, TftCompatibleDisplay &tft,
+                       int row);
+};
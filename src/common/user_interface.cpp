@@ -15,6 +15,7 @@
 #include "constants.hpp"
 #include "font_size.hpp"
 #include "point.hpp"
+#include "recording_display.hpp"
 
 #define GRID_BG_COLOR White
 #define TAG "user_interface"
@@ -946,68 +947,103 @@ void render_default_controls_explanations(const Platform &p)
             *p.display, p.capabilities.action_button_kind, button_hints);
 }
 
-void render_wrapped_text(const Platform &p,
-                         const UserInterfaceCustomization &customization,
-                         const char *text)
-{
-        p.display->clear(Black);
+/**
+ * Placement of the wrapped text on the screen. The lines that don't fit above
+ * the "OK" hint of the help screens are only shown when scrolling through the
+ * text (see `show_wrapped_help_text`).
+ */
+struct WrappedTextLayout {
+        int x;
+        int y;
+        int line_height;
+        int visible_lines;
+        int maximum_line_chars;
+};
 
+static WrappedTextLayout wrapped_text_layout(const Display &display)
+{
         // We exctract the display dimensions and font sizes into
         // shorter variable names to make the code easier to read.
-        int h = p.display->get_height();
-        int w = p.display->get_width();
+        int h = display.get_height();
+        int w = display.get_width();
         // If the corner radius of the display is 0, we still need to add some
         // margin.
         int margin =
-            std::max(MINIMUM_MARGIN, p.display->get_display_corner_radius());
-        auto [fw, fh] = p.display->get_font_configuration().font_dimensions;
+            std::max(MINIMUM_MARGIN, display.get_display_corner_radius());
+        auto [fw, fh] = display.get_font_configuration().font_dimensions;
 
         // We allow the text to go into 1/2 of the width of the display
         // corner radius
-        int maximum_line_chars = (w - margin) / fw;
-
-        int text_len = strlen(text);
-        int text_x = margin / 2;
-        int text_start_y = 2 * fh;
-
-        int lines_drawn = 0;
-        int curr_word_x_offset = 0;
-        bool first_word = true;
-
-        // We allocate dynamically a copy of the constant string as
-        // strtok needs a mutable reference.
-        char *text_copy = (char *)calloc(strlen(text) + 1, sizeof(char));
-        // We need to properly null-terminate the other string.
-        text_copy[strlen(text)] = '\0';
-        strncpy(text_copy, text, strlen(text));
-
-        char *word = strtok((char *)text_copy, " ");
-        while (word != nullptr) {
-                int curr_y = text_start_y + fh * lines_drawn;
-                if (curr_word_x_offset + strlen(word) + 1 <=
-                    maximum_line_chars) {
-                        if (first_word) {
-                                // We omit the space separator on the
-                                // first word.
-                                first_word = false;
-                        } else {
-                                curr_word_x_offset += 1;
-                        }
+        return {.x = margin / 2,
+                .y = 2 * fh,
+                .line_height = fh,
+                .visible_lines = (h - 4 * fh) / fh,
+                .maximum_line_chars = (w - margin) / fw};
+}
+
+/**
+ * Splits the text into lines of at most `maximum_line_chars` characters,
+ * breaking them between words.
+ */
+static std::vector<std::string> wrap_text(const char *text,
+                                          int maximum_line_chars)
+{
+        std::vector<std::string> lines(1);
+        const char *word = text;
+        while (*word) {
+                if (*word == ' ') {
+                        word++;
+                        continue;
+                }
+                int length = strcspn(word, " ");
+                std::string &line = lines.back();
+                if (line.empty()) {
+                        // We omit the space separator on the first word.
+                } else if (line.size() + length + 1 <= maximum_line_chars) {
+                        line += ' ';
                 } else {
-                        lines_drawn++;
-                        curr_word_x_offset = 0;
-                        curr_y = text_start_y + fh * lines_drawn;
+                        lines.emplace_back();
                 }
+                lines.back().append(word, length);
+                word += length;
+        }
+        return lines;
+}
 
-                p.display->draw_string(
-                    {.x = text_x + fw * curr_word_x_offset, .y = curr_y},
-                    (char *)word, FontSize::Size16, Black, White);
-                curr_word_x_offset += strlen(word);
-
-                word = strtok(nullptr, " ");
+static void draw_wrapped_lines(const Display &display,
+                               const WrappedTextLayout &layout,
+                               const std::vector<std::string> &lines,
+                               int first_line, int line_count, int y)
+{
+        for (int i = first_line;
+             i < first_line + line_count && i < lines.size(); i++) {
+                int line_y = y + (i - first_line) * layout.line_height;
+                display.draw_string({.x = layout.x, .y = line_y},
+                                    (char *)lines[i].c_str(), FontSize::Size16,
+                                    Black, White);
         }
+}
 
-        free(text_copy);
+static void draw_wrapped_text(const Display &display, const char *text)
+{
+        display.clear(Black);
+        WrappedTextLayout layout = wrapped_text_layout(display);
+        draw_wrapped_lines(display, layout,
+                           wrap_text(text, layout.maximum_line_chars), 0,
+                           layout.visible_lines, layout.y);
+}
+
+void render_wrapped_text(const Platform &p,
+                         const UserInterfaceCustomization &customization,
+                         const char *text)
+{
+        // The help screens are shown repeatedly, the last one is recorded and
+        // replayed instead of wrapping the text again.
+        static CachedDisplayList wrapped_text;
+        wrapped_text.draw(*p.display, display_list_key({}, text),
+                          [text](const Display &display) {
+                                  draw_wrapped_text(display, text);
+                          });
 }
 
 /**
@@ -1073,6 +1109,76 @@ void render_wrapped_help_text(const Platform &p,
         }
 }
 
+std::optional<UserAction>
+show_wrapped_help_text(const Platform &p,
+                       const UserInterfaceCustomization &customization,
+                       const char *help_text)
+{
+        render_wrapped_help_text(p, customization, help_text);
+
+        WrappedTextLayout layout = wrapped_text_layout(*p.display);
+        std::vector<std::string> lines =
+            wrap_text(help_text, layout.maximum_line_chars);
+        int hidden_lines = lines.size() - layout.visible_lines;
+        if (hidden_lines <= 0) {
+                return wait_until_green_pressed(p);
+        }
+
+        // The first page of the text is already on the screen, it is where
+        // the view starts off. The window moves by whole lines, hence the
+        // ranges that need to be drawn always consist of whole lines too.
+        ScrollRegion region = {
+            .axis = ScrollAxis::Vertical,
+            .top_left = {.x = 0, .y = layout.y},
+            .width = p.display->get_width(),
+            .height = layout.visible_lines * layout.line_height};
+        ScrollView view(p.display, region,
+                        [&](const Display &display, int content_start,
+                            int screen_start, int length) {
+                                display.clear_region(
+                                    {0, screen_start},
+                                    {region.width, screen_start + length},
+                                    Black);
+                                draw_wrapped_lines(
+                                    display, layout, lines,
+                                    content_start / layout.line_height,
+                                    length / layout.line_height, screen_start);
+                        });
+        int first_line = 0;
+        while (true) {
+                auto maybe_action = poll_action_input(p.action_controllers);
+                if (maybe_action.has_value() &&
+                    maybe_action.value() == Action::GREEN) {
+                        LOG_DEBUG(TAG, "User confirmed 'OK'");
+                        p.time_provider->delay_ms(MOVE_REGISTERED_DELAY);
+                        return std::nullopt;
+                }
+                auto maybe_direction =
+                    poll_directional_input(p.directional_controllers);
+                if (maybe_direction.has_value()) {
+                        Direction direction = maybe_direction.value();
+                        int previous_line = first_line;
+                        if (direction == Direction::UP && first_line > 0) {
+                                first_line--;
+                        } else if (direction == Direction::DOWN &&
+                                   first_line < hidden_lines) {
+                                first_line++;
+                        }
+                        if (first_line != previous_line) {
+                                view.scroll_to(first_line *
+                                               layout.line_height);
+                                p.time_provider->delay_ms(
+                                    MOVE_REGISTERED_DELAY);
+                        }
+                }
+                p.time_provider->delay_ms(INPUT_POLLING_DELAY);
+
+                if (!p.display->refresh()) {
+                        return UserAction::CloseWindow;
+                }
+        }
+}
+
 void draw_cube_perspective(const Display &display, IntPoint position, int size,
                            Color color)
 {
@@ -1786,118 +1892,192 @@ std::optional<UserAction> wait_until_action_input(const Platform &p,
         }
 }
 
-void render_bar_graph(const Platform &p,
-                      const UserInterfaceCustomization &customization,
-                      int y_start, const std::vector<std::string> &x_labels,
-                      const std::vector<float> &y_values,
-                      std::optional<int> highlighted_bar_index,
-                      Color highlighted_bar_color, bool update_highlight_only)
+BarGraph::BarGraph(const Platform &p,
+                   const UserInterfaceCustomization &customization,
+                   int y_start, const std::vector<std::string> &x_labels,
+                   const std::vector<float> &y_values)
+    : p(p), customization(customization), x_labels(x_labels),
+      y_values(y_values), y_start(y_start)
 {
-        const auto &display = *p.display;
         auto [width, height, _radius] = p.display->get_display_dimensions();
 
         // Before we can calculate the margins we need to know the max width
         // of the y-axis label to the left of the graph.
-        float maximum, minimum;
-        {
-                auto it = std::max_element(y_values.begin(), y_values.end());
-                maximum = *it;
-        }
-        {
-                auto it = std::min_element(y_values.begin(), y_values.end());
-                minimum = *it;
-        }
+        maximum = *std::max_element(y_values.begin(), y_values.end());
+        minimum = *std::min_element(y_values.begin(), y_values.end());
         char min_str[10], max_str[10];
         sprintf(max_str, "%.1f", maximum);
         sprintf(min_str, "%.1f", minimum);
         int max_label_len = std::max(strlen(min_str), strlen(max_str));
 
-        auto [fw, fh] = display.get_font_configuration().font_dimensions;
+        auto [fw, fh] = p.display->get_font_configuration().font_dimensions;
 
         // We divide fw by 2 as we are using FontSize 8 for the labels that
         // is two times smaller compared to the default font 16.
-        int left_margin = 5 + fw / 2 * (max_label_len + 1);
+        left_margin = 5 + fw / 2 * (max_label_len + 1);
         int margin = 15;
         int bottom_margin = 3 + fh;
         int bar_spacing = 1;
-        int available_width = width - margin - left_margin;
-        int available_height = height - y_start - bottom_margin;
-        int bar_width = available_width / y_values.size() - bar_spacing;
+        available_width = width - margin - left_margin;
+        available_height = height - y_start - bottom_margin;
+        bar_width = available_width / y_values.size() - bar_spacing;
+        scrolling = bar_width < BAR_GRAPH_MIN_BAR_WIDTH;
+        if (scrolling) {
+                bar_width = BAR_GRAPH_MIN_BAR_WIDTH;
+        }
+        bar_pitch = bar_width + bar_spacing;
+        origin = {left_margin, y_start + available_height};
+
+        // The region starts right after the y-axis and includes the x-axis,
+        // the first bar is placed one bar further to the right.
+        int content_length = (y_values.size() + 1) * bar_pitch;
+        ScrollRegion region = {
+            .axis = ScrollAxis::Horizontal,
+            .top_left = {.x = left_margin + 1, .y = y_start},
+            .width = scrolling ? available_width : content_length,
+            .height = available_height + 1};
+        view.emplace(p.display, region,
+                     [this](const Display &display, int content_start,
+                            int screen_start, int length) {
+                             draw_content(display, content_start,
+                                          screen_start, length);
+                     });
+}
+
+int BarGraph::bar_height(float value) const
+{
+        int min_height = available_height / 5;
+        int max_height = available_height;
+        float range = maximum - minimum;
+        if (range == 0)
+                return (int)(min_height + max_height) / 2;
+        int baseline = min_height;
+        return baseline +
+               ((max_height - min_height) * (value - minimum) / range);
+}
+
+int BarGraph::bar_start(int index) const
+{
+        return (index + 1) * bar_pitch - 1;
+}
+
+int BarGraph::window_position(int index) const
+{
+        if (!scrolling) {
+                return 0;
+        }
+        int length = view->get_region().length();
+        int content_length = (y_values.size() + 1) * bar_pitch;
+        int centered = bar_start(index) + bar_width / 2 - length / 2;
+        return std::clamp(centered, 0, content_length - length);
+}
+
+void BarGraph::draw_content(const Display &display, int content_start,
+                            int screen_start, int length) const
+{
+        int content_end = content_start + length;
+        int screen_end = screen_start + length;
+        display.clear_region({screen_start, y_start},
+                             {screen_end, origin.y + 1}, Black);
+        display.draw_line({screen_start, origin.y}, {screen_end - 1, origin.y},
+                          White);
+        // If we are rendering both positive and negative values, we need to
+        // draw the zero line to improve clarity.
+        if (minimum < 0 && maximum > 0) {
+                int zero_y = origin.y - bar_height(0);
+                display.draw_line({screen_start, zero_y},
+                                  {screen_end - 1, zero_y}, White);
+        }
+
+        int first = std::max(0, (content_start + 1) / bar_pitch - 1);
+        for (int i = first; i < y_values.size(); i++) {
+                int bar_x = bar_start(i);
+                if (bar_x >= content_end) {
+                        break;
+                }
+                // Bars are cut where the range ends, the rest is drawn along
+                // with the neighbouring range.
+                int from = std::max(bar_x, content_start);
+                int to = std::min(bar_x + bar_width, content_end);
+                if (from >= to) {
+                        continue;
+                }
+                int height = bar_height(y_values[i]);
+                Color color = i == highlighted ? Red
+                                               : customization.accent_color;
+                display.draw_rectangle(
+                    {screen_start + from - content_start, origin.y - height},
+                    to - from, height, color, 1, true);
+        }
+}
+
+void BarGraph::draw_x_labels() const
+{
+        if (x_labels.empty()) {
+                return;
+        }
+        int label_period = y_values.size() / x_labels.size();
+        IntPoint label_position = {origin.x + 1, origin.y + 5};
+        if (scrolling) {
+                int index = std::min<int>(highlighted / label_period,
+                                          x_labels.size() - 1);
+                p.display->draw_string(label_position,
+                                       (char *)x_labels[index].c_str(),
+                                       FontSize::Size8, Black, White);
+                return;
+        }
+        for (int i = 0;
+             i < y_values.size() && i / label_period < x_labels.size();
+             i += label_period) {
+                const std::string &label = x_labels[i / label_period];
+                label_position.x = origin.x + 1 + bar_start(i);
+                p.display->draw_string(label_position, (char *)label.c_str(),
+                                       FontSize::Size8, Black, White);
+        }
+}
 
-        auto origin = IntPoint{left_margin, y_start + available_height};
+void BarGraph::render(int highlighted_index)
+{
+        const auto &display = *p.display;
+        auto [fw, fh] = display.get_font_configuration().font_dimensions;
+        highlighted = highlighted_index;
 
-        auto draw_y_label = [&](char *label, int height_offset) {
+        auto draw_y_label = [&](float value, int height_offset) {
+                char label[10];
+                sprintf(label, "%.1f", value);
                 int label_len = (fw / 2) * (strlen(label) + 1);
                 display.draw_string(
                     {left_margin - label_len, y_start + height_offset}, label,
                     FontSize::Size8, Color::Black, Color::White);
         };
 
-        auto scale = [&](double x) {
-                int min_height = available_height / 5;
-                int max_height = available_height;
-                float range = maximum - minimum;
-                if (range == 0)
-                        return (int)(min_height + max_height) / 2;
-                int baseline = min_height;
-                int scaled = baseline + ((max_height - min_height) *
-                                         (x - minimum) / range);
-                return scaled;
-        };
-
-        if (!update_highlight_only) {
-                display.draw_line({left_margin, y_start}, origin, Color::White);
-                display.draw_line(origin, origin + IntPoint{available_width, 0},
-                                  Color::White);
-                // If we are rendering both positive and negative values, we
-                // need to draw the zero line to improve clarity.
-                if (minimum < 0 && maximum > 0) {
-                        int zero_height = scale(0);
-                        int zero_y = origin.y - zero_height;
-                        display.draw_line(
-                            {left_margin, zero_y},
-                            {left_margin + available_width, zero_y},
-                            Color::White);
-                        draw_y_label((char *)"0.0",
-                                     available_height - zero_height);
-                }
-                draw_y_label(max_str, 0);
-                draw_y_label(min_str, available_height - scale(minimum));
+        display.draw_line({left_margin, y_start}, origin, Color::White);
+        if (minimum < 0 && maximum > 0) {
+                draw_y_label(0, available_height - bar_height(0));
         }
+        draw_y_label(maximum, 0);
+        draw_y_label(minimum, available_height - bar_height(minimum));
+        draw_x_labels();
+        view->draw(window_position(highlighted));
+}
 
-        for (int i = 0; i < y_values.size(); i++) {
-                double h = y_values[i];
-                int height = scale(h);
-                int bar_x = left_margin + (i + 1) * (bar_width + bar_spacing);
-                IntPoint bar_start = {bar_x, origin.y - height};
-
-                Color color = highlighted_bar_index.has_value() &&
-                                      highlighted_bar_index.value() == i
-                                  ? highlighted_bar_color
-                                  : customization.accent_color;
-
-                if (!update_highlight_only ||
-                    highlighted_bar_index.value() == i) {
-                        display.draw_rectangle(bar_start, bar_width, height,
-                                               color, 1, true);
-                }
-
-                // Draw x axis labels
-                if (x_labels.empty()) {
-                        continue;
-                }
-                int label_period = y_values.size() / x_labels.size();
-
-                if (i % label_period == 0) {
-                        int idx = i / label_period;
-                        if (!update_highlight_only) {
-                                display.draw_string(
-                                    {bar_x, origin.y + 5},
-                                    (char *)x_labels[idx].c_str(),
-                                    FontSize::Size8, Color::Black,
-                                    Color::White);
-                        }
-                }
+void BarGraph::move_highlight(int highlighted_index)
+{
+        int previous = highlighted;
+        highlighted = highlighted_index;
+        int position = window_position(highlighted);
+        // If the display doesn't scroll, moving the window redraws all bars
+        // with the new highlight already. Otherwise only the strip that
+        // scrolls in is drawn, hence the two bars need to be redrawn.
+        bool redrawn = position != view->get_position() &&
+                       !view->is_scrolled_by_display();
+        view->scroll_to(position);
+        if (!redrawn) {
+                view->redraw(bar_start(previous), bar_width);
+                view->redraw(bar_start(highlighted), bar_width);
+        }
+        if (scrolling) {
+                draw_x_labels();
         }
 }
 
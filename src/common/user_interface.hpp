@@ -2,9 +2,11 @@
 
 #include <stdlib.h>
 #include <map>
+#include <optional>
 #include "user_interface_customization.hpp"
 #include "configuration.hpp"
 #include "../platform/interface/display.hpp"
+#include "scroll_view.hpp"
 
 void setup_display();
 
@@ -53,6 +55,14 @@ void render_controls_explanations(const Display &display,
 void render_wrapped_help_text(const Platform &p,
                               const UserInterfaceCustomization &customization,
                               const char *help_text);
+/**
+ * Shows the help text and waits until green is pressed. Texts that don't fit
+ * on the screen can be scrolled through line by line using the joystick.
+ */
+std::optional<UserAction>
+show_wrapped_help_text(const Platform &p,
+                       const UserInterfaceCustomization &customization,
+                       const char *help_text);
 void render_wrapped_text(const Platform &p,
                          const UserInterfaceCustomization &customization,
                          const char *text);
@@ -60,12 +70,70 @@ std::optional<UserAction> wait_until_green_pressed(const Platform &p);
 std::optional<UserAction> wait_until_action_input(const Platform &p,
                                                   Action &action);
 
-void render_bar_graph(const Platform &p,
-                      const UserInterfaceCustomization &customization,
-                      int y_start, const std::vector<std::string> &x_labels,
-                      const std::vector<float> &y_labels,
-                      std::optional<int> highlighted_bar_index = std::nullopt,
-                      Color highlighted_bar_color = Red,
-                      bool update_highlight_only = false);
+/**
+ * Bars narrower than this make the bar graph scroll instead of squeezing all
+ * bars onto the screen.
+ */
+#define BAR_GRAPH_MIN_BAR_WIDTH 3
+
+/**
+ * Bar graph of the values below `y_start` with one of the bars highlighted.
+ * The x-axis labels are spread evenly over the bars.
+ *
+ * If the bars don't fit on the screen, the graph scrolls horizontally to keep
+ * the highlighted bar in the middle (see `ScrollView`), in which case only
+ * the label of the highlighted bar is shown below the axis.
+ */
+class BarGraph
+{
+      public:
+        BarGraph(const Platform &p,
+                 const UserInterfaceCustomization &customization, int y_start,
+                 const std::vector<std::string> &x_labels,
+                 const std::vector<float> &y_values);
+
+        /**
+         * Draws the whole graph.
+         */
+        void render(int highlighted_index);
+        /**
+         * Moves the highlight, only the two affected bars are redrawn unless
+         * the graph needs to scroll.
+         */
+        void move_highlight(int highlighted_index);
+        /**
+         * Stops scrolling the display, needs to be called before drawing a
+         * different screen. `render` resumes the scrolling.
+         */
+        void release() { view->reset(); }
+
+      private:
+        const Platform &p;
+        const UserInterfaceCustomization &customization;
+        std::vector<std::string> x_labels;
+        std::vector<float> y_values;
+        int y_start;
+        float minimum;
+        float maximum;
+        int left_margin;
+        int available_width;
+        int available_height;
+        int bar_width;
+        int bar_pitch;
+        bool scrolling;
+        IntPoint origin;
+        int highlighted = 0;
+        std::optional<ScrollView> view;
+
+        int bar_height(float value) const;
+        /**
+         * Position of the bar along the scrolled content.
+         */
+        int bar_start(int index) const;
+        int window_position(int index) const;
+        void draw_content(const Display &display, int content_start,
+                          int screen_start, int length) const;
+        void draw_x_labels() const;
+};
 
 ConfigurationDiff *empty_diff();
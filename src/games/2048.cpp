@@ -13,6 +13,7 @@
 #include "../platform/interface/display.hpp"
 #include "../platform/interface/platform.hpp"
 #include "../common/configuration.hpp"
+#include "../common/frame_scheduler.hpp"
 
 #include "../menu.hpp"
 #include "../common/common_transitions.hpp"
@@ -148,6 +149,7 @@ UserAction Clean2048::app_loop(const Platform &p,
                 return UserAction::CloseWindow;
         }
 
+        FrameScheduler scheduler(p.time_provider, INPUT_POLLING_DELAY);
         while (!(is_game_over(*state) || is_game_finished(*state))) {
                 auto maybe_direction =
                     poll_directional_input(p.directional_controllers);
@@ -158,7 +160,7 @@ UserAction Clean2048::app_loop(const Platform &p,
                                   DirectionStr::to_cstr(dir));
                         take_turn(*state, dir);
                         update_game_grid(p, *state, customization);
-                        p.time_provider->delay_ms(MOVE_REGISTERED_DELAY);
+                        scheduler.delay(MOVE_REGISTERED_DELAY);
                 } else if (maybe_action.has_value()) {
                         Action act = maybe_action.value();
                         if (act == Action::RED) {
@@ -190,11 +192,11 @@ UserAction Clean2048::app_loop(const Platform &p,
                                 return UserAction::Exit;
                         }
                 }
-                p.time_provider->delay_ms(INPUT_POLLING_DELAY);
                 if (!p.display->refresh()) {
                         free_game_state(state);
                         return UserAction::CloseWindow;
                 }
+                scheduler.end_frame();
         }
 
         if (is_game_over(*state)) {
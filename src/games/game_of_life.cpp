@@ -1,11 +1,19 @@
 #include <cstdint>
 #include <memory>
 #include <cstring>
+#ifdef EMULATOR
+#include <filesystem>
+#endif
 #include "game_of_life.hpp"
+#include "game_of_life_engine.hpp"
+#include "game_of_life_history.hpp"
+#include "game_of_life_patterns.hpp"
+#include "game_of_life_universe.hpp"
 
 #include "../common/logging.hpp"
 #include "../common/maths_utils.hpp"
 #include "../common/grid.hpp"
+#include "../common/frame_scheduler.hpp"
 
 #include "../apps/settings.hpp"
 #include "../menu.hpp"
@@ -21,31 +29,19 @@
 #define EXPLANATION_ABOVE_GRID_OFFEST 0
 #endif
 
-#define REWIND_BUF_SIZE 50
-
-#define ALIVE true
-#define EMPTY false
+#define REWIND_BUF_SIZE 500
 
 GameOfLifeConfiguration DEFAULT_GAME_OF_LIFE_CONFIG = {
-    .header = {.magic = CONFIGURATION_MAGIC, .version = 1},
+    .header = {.magic = CONFIGURATION_MAGIC, .version = 4},
     .prepopulate_grid = false,
     .use_toroidal_array = true,
+    .infinite_universe = false,
     .simulation_speed = 2,
     .rewind_buffer_size = REWIND_BUF_SIZE,
+    .rule = CONWAY_LIFE_RULE,
+    .pattern = 0,
 };
 
-/* Type aliases */
-
-/**
- * Each simulation cell is a single boolean variable
- */
-using GameOfLifeCell = bool;
-/**
- * Simulation grid is a pointer to an array of u8s that encode grid state
- * in a compact way.
- */
-using Grid = uint8_t *;
-
 enum class SimulationMode {
         RUNNING = 0,
         PAUSED = 1,
@@ -69,28 +65,49 @@ struct GameOfLifeState {
         /**
          * Current state of the cellular automata
          */
-        Grid grid;
+        LifeGrid grid;
+        /**
+         * The next generation is computed into this grid, after which it is
+         * swapped with the current one. This avoids allocating a new grid on
+         * each simulation step.
+         */
+        LifeGrid next_grid;
         /**
-         * Ring buffer storing previous simulation states that are used
-         * for going 'back in time'. Note that each user input also
-         * counts as a simulation step so will be included in the rewind buffer.
-         *
-         * Because of memory constraints, we need to use a hand-rolled bitset
-         * to store each 'frame' of the game simulation. The reason for this
-         * is that storing the diffs with two integer (x, y) coordinates
-         * occupies too much memory.
+         * Cells that have changed on the last simulation step (or rewind),
+         * only those need to be re-rendered.
          */
-        std::vector<uint8_t *> rewind_buff;
+        LifeGrid changed_cells;
         /**
-         * The current position in the circular buffer.
+         * Delta-encoded history of the previous simulation states that is
+         * used for going 'back in time'. Note that each user input also
+         * counts as a generation, so that the flipped cells can be rewound.
          */
-        int curr_rewind_buff_idx;
+        LifeHistory history;
         /**
-         * The position in the circular buffer that contains the latest
-         * state of the grid. This is required to prevent the rewind
-         * functionality from wrapping around.
+         * Part of the bounded grid that can change on the next generation,
+         * only that part is simulated and re-rendered.
          */
-        int latest_rewind_buff_idx;
+        LifeActivity activity;
+        /**
+         * Detects that the bounded grid has settled into a still life or an
+         * oscillation, the simulation is then paused to save power.
+         */
+        LifeCycleDetector cycles;
+        /**
+         * Length of the message above the grid that tells the user that the
+         * grid has settled, 0 if it isn't shown. The message stays until the
+         * user changes the cells.
+         */
+        int settled_message_length;
+        /**
+         * The unbounded universe simulated in the infinite mode, `grid` then
+         * holds the part of it that is visible in the viewport.
+         */
+        LifeUniverse universe;
+        /**
+         * Universe coordinates of the top left cell of the viewport.
+         */
+        IntPoint viewport;
         /**
          * The current position of the caret (i.e. the small square used for
          * user input). When the user presses the confirm action, the cell under
@@ -99,31 +116,9 @@ struct GameOfLifeState {
          */
         IntPoint caret;
 
-        ~GameOfLifeState()
-        {
-                delete &dimensions;
-                delete[] grid;
-                for (int i = 0; i < rewind_buff.size(); i++) {
-                        LOG_DEBUG(TAG, "Deleting grid at: %x", rewind_buff[i]);
-                        if (rewind_buff[i] != nullptr)
-                                delete[] (rewind_buff[i]);
-                }
-        }
+        ~GameOfLifeState() { delete &dimensions; }
 };
 
-inline bool get_cell(int x, int y, int cols, Grid grid);
-inline void set_cell(int x, int y, int cols, Grid grid, bool alive);
-inline Grid allocate_grid(int cells);
-
-/**
- * Models a change of the Game of Life state from one frame to another. This
- * is needed to render changes when a single iteration of the simulation loop
- * is taken. Note that counterintuitively, it is more efficient to crate a new
- * full grid (represented as a bitset) on each iteration than it is to create
- * diff objects. This is beause our grid is relatively small.
- */
-typedef std::pair<uint8_t *, uint8_t *> StateEvolution;
-
 /* Configuration Handling */
 
 /**
@@ -169,29 +164,55 @@ void draw_game_cell(const Display &display,
 /* Simulation State Transitions (and some UI rendering mixed in (not ideal)) */
 
 /**
- * Applies the game of life cellular automata evolution rules and returns
- * a pair of the old grid state and the new grid state (so that both can be
- * e.g. inserted into the history rewind buffer).
+ * Re-draws the cells set in `changed` using their color in the new `grid`
+ * state.
  */
-StateEvolution take_simulation_step(const SquareCellGridDimensions &dimensions,
-                                    Grid grid, bool use_toroidal_array);
 void render_state_change(const Display &display,
                          const SquareCellGridDimensions &dimensions,
-                         StateEvolution evolution);
+                         const LifeGrid &grid, const LifeGrid &changed);
 void spawn_cells_randomly(const Display &display,
                           const SquareCellGridDimensions &dimensions,
-                          Grid grid);
-void save_grid_state_in_rewind_buffer(std::vector<Grid> &rewind_buffer,
-                                      int &rewind_buf_idx, Grid grid,
-                                      int grid_cell_count);
+                          LifeGrid &grid);
+/**
+ * Places the pattern selected in the config in the middle of the grid and
+ * renders it. Much quicker than flipping the cells one by one.
+ */
+void spawn_pattern(const Display &display,
+                   const SquareCellGridDimensions &dimensions, int pattern,
+                   LifeGrid &grid);
+#ifdef EMULATOR
+/**
+ * Exports the visible board into the patterns directory in the RLE format,
+ * it then shows up among the patterns as 'saved'.
+ */
+void save_board(const GameOfLifeState &state);
+#endif
 void handle_rewind(const Display &display, GameOfLifeState &state,
                    Direction dir);
 void move_caret(const Display &display,
                 const UserInterfaceCustomization &customization,
                 GameOfLifeState &state, Direction dir);
+/**
+ * Moves the viewport of the infinite universe by a single cell in the given
+ * direction.
+ */
+void pan_viewport(const Display &display, GameOfLifeState &state,
+                  Direction dir);
 void toggle_pause(const Display &display,
                   const UserInterfaceCustomization &customization,
                   GameOfLifeState &state);
+/**
+ * Pauses the simulation once the grid has settled into a still life or an
+ * oscillation, there is no point in burning the battery on it. The user is
+ * told after how many generations it has settled and can resume it.
+ */
+void report_settled(const Platform &p, GameOfLifeState &state);
+void clear_settled_report(const Platform &p, GameOfLifeState &state);
+/**
+ * Needs to be called whenever the cells set in `changed_cells` are changed
+ * outside of the simulation, e.g. by the user.
+ */
+void mark_cells_edited(GameOfLifeState &state);
 void toggle_rewind(const Display &display,
                    const UserInterfaceCustomization &customization,
                    GameOfLifeState &state);
@@ -228,12 +249,16 @@ load_initial_game_of_life_config(const PersistentStorage &storage)
                 memcpy(output, &config, sizeof(GameOfLifeConfiguration));
         }
 
+        char rule[LIFE_RULE_MAX_LENGTH];
+        format_life_rule(output->rule, rule);
         LOG_DEBUG(TAG,
                   "Loaded game of life configuration: prepopulate_grid=%d, "
-                  "use_toroidal_array=%d, simulation_speed=%d, "
-                  "rewind_buffer_size=%d",
+                  "use_toroidal_array=%d, infinite_universe=%d, "
+                  "simulation_speed=%d, rewind_buffer_size=%d, rule=%s, "
+                  "pattern=%d",
                   output->prepopulate_grid, output->use_toroidal_array,
-                  output->simulation_speed, output->rewind_buffer_size);
+                  output->infinite_universe, output->simulation_speed,
+                  output->rewind_buffer_size, rule, output->pattern);
 
         return output;
 }
@@ -253,10 +278,11 @@ const char *GameOfLife::get_help_text() const
                "'down' "
                "to toggle the cell between alive/dead, 'up' to pause, 'left' "
                "to "
-               "rewind back in time, 'right' to exit. There is no aim, you "
-               "stare "
-               "at "
-               "the simulation";
+               "rewind back in time, 'right' to exit. On the infinite grid, "
+               "moving the caret past the edge of the screen pans the view. "
+               "The simulation pauses once the grid settles into a still "
+               "life or an oscillation. "
+               "There is no aim, you stare at the simulation";
 }
 
 void evolution_tick(const Display &display, GameOfLifeState &state);
@@ -268,7 +294,6 @@ UserAction GameOfLife::app_loop(const Platform &p,
         // Extracted here for clarity and to avoid repeated dereferencing.
         const Display &display = *p.display;
         Color accent = customization.accent_color;
-        int buf_size = config.rewind_buffer_size;
         LOG_DEBUG(TAG, "Entering Game of Life game loop");
 
         SquareCellGridDimensions *dimensions = calculate_grid_dimensions(
@@ -279,10 +304,19 @@ UserAction GameOfLife::app_loop(const Platform &p,
             .config = config,
             .dimensions = *dimensions,
             .mode = SimulationMode::PAUSED,
-            .grid = allocate_grid(dimensions->rows * dimensions->cols),
-            .rewind_buff = std::vector<uint8_t *>(buf_size, nullptr),
-            .curr_rewind_buff_idx = -1,
-            .latest_rewind_buff_idx = -1,
+            .grid = LifeGrid(dimensions->rows, dimensions->cols),
+            .next_grid = LifeGrid(dimensions->rows, dimensions->cols),
+            .changed_cells = LifeGrid(dimensions->rows, dimensions->cols),
+            // The infinite mode can't be rewound, hence the memory of the
+            // history is left to the universe.
+            .history = config.infinite_universe
+                           ? LifeHistory(0, 0)
+                           : LifeHistory(config.rewind_buffer_size),
+            .activity = LifeActivity(),
+            .cycles = LifeCycleDetector(),
+            .settled_message_length = 0,
+            .universe = LifeUniverse(),
+            .viewport = {0, 0},
             .caret = {0, 0},
         };
 
@@ -313,12 +347,21 @@ UserAction GameOfLife::app_loop(const Platform &p,
         }
         if (config.prepopulate_grid)
                 spawn_cells_randomly(display, state.dimensions, state.grid);
+        spawn_pattern(display, state.dimensions, config.pattern, state.grid);
+        state.activity.mark_all(state.grid);
+        state.cycles.reset(state.activity.hash);
+        if (config.infinite_universe) {
+                state.universe.set_rule(config.rule);
+                GameOfLifeEngine::for_each_set_cell(
+                    state.grid,
+                    [&](int x, int y) { state.universe.set(x, y, true); });
+        }
         draw_caret(display, state.dimensions, state.caret, accent);
 
-        // Loop control variables.
-        int evolution_period =
-            (1000 / config.simulation_speed) / GAME_LOOP_DELAY;
-        int iteration = 0;
+        // Loop control variables. The input is polled every GAME_LOOP_DELAY
+        // milliseconds, the simulation evolves on each tick of the scheduler.
+        FrameScheduler scheduler(p.time_provider, GAME_LOOP_DELAY,
+                                 1000 / config.simulation_speed);
         bool exit_requested = false;
         // To avoid button debounce issues, we only process action input if
         // it wasn't processed on the last iteration. This is to avoid
@@ -328,12 +371,6 @@ UserAction GameOfLife::app_loop(const Platform &p,
         bool action_on_last_iteration = false;
 
         while (!exit_requested) {
-                if (!p.display->refresh())
-                        return UserAction::CloseWindow;
-                if (state.mode == SimulationMode::RUNNING &&
-                    iteration == evolution_period - 1)
-                        evolution_tick(display, state);
-
                 auto input = poll_directional_input(p.directional_controllers);
                 if (input.has_value()) {
                         Direction dir = input.value();
@@ -355,14 +392,35 @@ UserAction GameOfLife::app_loop(const Platform &p,
                                 flip_curr_cell(display, customization, state);
                                 break;
                         case BACK_ACTION:
+#ifdef EMULATOR
+                                save_board(state);
+#endif
                                 return UserAction::PlayAgain;
                         }
                         action_on_last_iteration = true;
                 } else {
                         action_on_last_iteration = false;
                 }
-                p.time_provider->delay_ms(GAME_LOOP_DELAY);
-                iteration = (iteration + 1) % evolution_period;
+                // Changing the cells restarts the detection of oscillations.
+                if (state.settled_message_length > 0 &&
+                    state.cycles.get_period() == 0) {
+                        clear_settled_report(p, state);
+                }
+
+                if (state.mode == SimulationMode::RUNNING) {
+                        while (scheduler.consume_tick())
+                                evolution_tick(display, state);
+                        if (state.cycles.get_period() > 0 &&
+                            state.settled_message_length == 0) {
+                                report_settled(p, state);
+                        }
+                } else {
+                        scheduler.skip_ticks();
+                }
+
+                if (!p.display->refresh())
+                        return UserAction::CloseWindow;
+                scheduler.end_frame();
         }
         return UserAction::PlayAgain;
 }
@@ -370,18 +428,36 @@ UserAction GameOfLife::app_loop(const Platform &p,
 void evolution_tick(const Display &display, GameOfLifeState &state)
 {
         LOG_DEBUG(TAG, "Taking a simulation step");
-        StateEvolution evolution = take_simulation_step(
-            state.dimensions, state.grid, state.config.use_toroidal_array);
-        render_state_change(display, state.dimensions, evolution);
-        auto &gd = state.dimensions;
-        int rows = gd.rows;
-        int cols = gd.cols;
-        int total_cells = rows * cols;
-        save_grid_state_in_rewind_buffer(state.rewind_buff,
-                                         state.curr_rewind_buff_idx, state.grid,
-                                         total_cells);
-        delete[] state.grid;
-        state.grid = evolution.second;
+        if (state.config.infinite_universe) {
+                state.universe.step();
+                state.universe.copy_region(state.viewport.x, state.viewport.y,
+                                           state.next_grid);
+                GameOfLifeEngine::diff(state.grid, state.next_grid,
+                                       state.changed_cells);
+                render_state_change(display, state.dimensions,
+                                    state.next_grid, state.changed_cells);
+                std::swap(state.grid, state.next_grid);
+                return;
+        }
+
+        // Once the grid is still, there is nothing left to compute.
+        if (state.activity.is_still()) {
+                return;
+        }
+        // The bounded grid is stepped in place, only around the cells that
+        // changed on the previous generation.
+        GameOfLifeEngine::take_active_step(
+            state.grid, state.changed_cells, state.config.use_toroidal_array,
+            state.activity, state.config.rule);
+        // The history only covers the visible grid, hence the infinite mode
+        // can't be rewound.
+        state.history.push(state.changed_cells);
+        state.cycles.observe(state.activity.hash);
+        GameOfLifeEngine::for_each_changed_cell(
+            state.changed_cells, state.activity, [&](int x, int y) {
+                    Color color = state.grid.get(x, y) ? White : Black;
+                    draw_game_cell(display, state.dimensions, {x, y}, color);
+            });
 }
 
 std::optional<UserAction>
@@ -401,6 +477,39 @@ GameOfLife::collect_config(const Platform &p,
         return std::nullopt;
 }
 
+#ifdef EMULATOR
+/**
+ * Paths of the pattern files listed in the config, they follow the pattern
+ * bank in the list of the patterns.
+ */
+static std::vector<std::string> pattern_files;
+#endif
+
+/**
+ * Lists the names of the patterns that can be spawned, 'None' first.
+ */
+static std::vector<const char *> list_pattern_names()
+{
+        std::vector<const char *> names = {"None"};
+        for (int i = 0; i < LIFE_PATTERN_BANK_SIZE; i++) {
+                names.push_back(LIFE_PATTERN_BANK[i].name);
+        }
+#ifdef EMULATOR
+        // The names need to outlive the configuration that points to them.
+        static std::vector<std::string> file_names;
+        pattern_files = list_life_pattern_files(LIFE_PATTERNS_DIRECTORY);
+        file_names.clear();
+        for (const std::string &path : pattern_files) {
+                file_names.push_back(
+                    std::filesystem::path(path).stem().string());
+        }
+        for (const std::string &name : file_names) {
+                names.push_back(name.c_str());
+        }
+#endif
+        return names;
+}
+
 Configuration *
 assemble_game_of_life_configuration(const PersistentStorage &storage)
 {
@@ -420,7 +529,49 @@ assemble_game_of_life_configuration(const PersistentStorage &storage)
             "Toroidal array", {"Yes", "No"},
             map_boolean_to_yes_or_no(initial_config->use_toroidal_array));
 
-        auto options = {spawn_randomly, simulation_speed, toroidal_array};
+        // Controls how many generations can be rewound.
+        auto *rewind_depth = ConfigurationOption::of_integers(
+            "Rewind depth", {50, 500, 5000},
+            initial_config->rewind_buffer_size);
+
+#if LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET > 0
+        // Controls if the grid is unbounded, the screen then pans over it.
+        auto *infinite_universe = ConfigurationOption::of_strings(
+            "Infinite grid", {"Yes", "No"},
+            map_boolean_to_yes_or_no(initial_config->infinite_universe));
+#endif
+
+        // Controls the rule that the cells evolve under. The rules other than
+        // Conway's can only be picked from the list, a rule that is not on it
+        // falls back to Conway's.
+        char initial_rule[LIFE_RULE_MAX_LENGTH];
+        format_life_rule(initial_config->rule, initial_rule);
+        auto *rule = ConfigurationOption::of_strings(
+            "Rule",
+            {"B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B1357/S1357",
+             "B3/S12345"},
+            initial_rule);
+        if (rule->currently_selected < 0) {
+                rule->currently_selected = 0;
+        }
+
+        // Controls the pattern spawned in the middle of the grid.
+        std::vector<const char *> pattern_names = list_pattern_names();
+        int initial_pattern = initial_config->pattern;
+        if (initial_pattern < 0 ||
+            initial_pattern >= (int)pattern_names.size()) {
+                initial_pattern = 0;
+        }
+        auto *pattern = ConfigurationOption::of_strings(
+            "Pattern", pattern_names, pattern_names[initial_pattern]);
+
+        std::vector<ConfigurationOption *> options = {
+            spawn_randomly, simulation_speed, toroidal_array, rewind_depth};
+#if LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET > 0
+        options.push_back(infinite_universe);
+#endif
+        options.push_back(rule);
+        options.push_back(pattern);
 
         return new Configuration("Game of Life", options);
 }
@@ -435,8 +586,6 @@ void extract_game_config(GameOfLifeConfiguration &game_config,
             prepopulate_grid.available_values)[curr_choice_idx];
         game_config.prepopulate_grid = extract_yes_or_no_option(choice);
 
-        game_config.rewind_buffer_size = REWIND_BUF_SIZE;
-
         ConfigurationOption simulation_speed = *config.options[1];
         int curr_speed_idx = simulation_speed.currently_selected;
         game_config.simulation_speed = static_cast<int *>(
@@ -449,112 +598,45 @@ void extract_game_config(GameOfLifeConfiguration &game_config,
             use_toroidal_array.available_values)[use_toroidal_array_choice_idx];
         game_config.use_toroidal_array =
             extract_yes_or_no_option(toroidal_array_choice);
-}
-
-StateEvolution take_simulation_step(const SquareCellGridDimensions &dimensions,
-                                    Grid grid, bool use_toroidal_array)
-{
-        // This assumes that the grid is rectangular.
-        int rows = dimensions.rows;
-        int cols = dimensions.cols;
-        int total_cells = rows * cols;
-
-        Grid new_grid = allocate_grid(total_cells);
-        for (int y = 0; y < rows; y++) {
-                for (int x = 0; x < cols; x++) {
-                        GameOfLifeCell current_state =
-                            get_cell(x, y, cols, grid);
-                        LOG_TRACE(TAG,
-                                  "Processing cell at (%d, %d) with state %d",
-                                  x, y, current_state);
-                        int alive_nb = 0;
-                        IntPoint curr = {.x = x, .y = y};
-
-                        std::vector<IntPoint> neighbours;
-
-                        if (use_toroidal_array) {
-                                neighbours = get_neighbours_toroidal_array(
-                                    curr, rows, cols);
-                        } else {
-                                neighbours = get_neighbours_inside_grid(
-                                    curr, rows, cols);
-                        }
-
-                        for (IntPoint nb : neighbours) {
-                                if (get_cell(nb.x, nb.y, cols, grid) == ALIVE) {
-                                        alive_nb++;
-                                }
-                        }
 
-                        GameOfLifeCell new_state = EMPTY;
-
-                        if (current_state == ALIVE) {
-                                // Underpopulation or overpopulation
-                                if (alive_nb < 2 || alive_nb > 3) {
-                                        new_state = EMPTY;
-                                } else {
-                                        // Lives on to the next generation as it
-                                        // has exactly 2 or 3 neighbours.
-                                        new_state = ALIVE;
-                                }
-                        } else if (alive_nb == 3) {
-                                new_state = ALIVE; // Reproduction
-                        }
+        ConfigurationOption rewind_depth = *config.options[3];
+        int curr_depth_idx = rewind_depth.currently_selected;
+        game_config.rewind_buffer_size = static_cast<int *>(
+            rewind_depth.available_values)[curr_depth_idx];
+
+        // The infinite grid option is only there on the platforms that have
+        // the memory for the universe, the options after it shift otherwise.
+        int next_option = 4;
+#if LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET > 0
+        ConfigurationOption infinite_universe = *config.options[next_option++];
+        int infinite_universe_choice_idx = infinite_universe.currently_selected;
+        const char *infinite_universe_choice = static_cast<const char **>(
+            infinite_universe.available_values)[infinite_universe_choice_idx];
+        game_config.infinite_universe =
+            extract_yes_or_no_option(infinite_universe_choice);
+#else
+        game_config.infinite_universe = false;
+#endif
 
-                        set_cell(x, y, cols, new_grid, new_state);
-                }
+        ConfigurationOption rule = *config.options[next_option++];
+        const char *rule_choice = static_cast<const char **>(
+            rule.available_values)[rule.currently_selected];
+        if (!parse_life_rule(rule_choice, game_config.rule)) {
+                game_config.rule = CONWAY_LIFE_RULE;
         }
-        return std::make_pair(grid, new_grid);
+
+        ConfigurationOption pattern = *config.options[next_option];
+        game_config.pattern = pattern.currently_selected;
 }
 
 void render_state_change(const Display &display,
                          const SquareCellGridDimensions &dimensions,
-                         StateEvolution evolution)
+                         const LifeGrid &grid, const LifeGrid &changed)
 {
-        int rows = dimensions.rows;
-        int cols = dimensions.cols;
-
-        for (int y = 0; y < rows; y++) {
-                for (int x = 0; x < cols; x++) {
-                        GameOfLifeCell prev =
-                            get_cell(x, y, cols, evolution.first);
-                        GameOfLifeCell curr =
-                            get_cell(x, y, cols, evolution.second);
-
-                        if (curr != prev) {
-                                Color color = curr == ALIVE ? White : Black;
-                                draw_game_cell(display, dimensions, {x, y},
-                                               color);
-                        }
-                }
-        }
-}
-
-Grid copy_grid(Grid source, int total_cells);
-void save_grid_state_in_rewind_buffer(std::vector<Grid> &rewind_buffer,
-                                      int &rewind_buf_idx, Grid grid,
-                                      int grid_cell_count)
-{
-
-        // We need to increment the index and wrap it around as we are using
-        // a ring buffer.
-        rewind_buf_idx = (rewind_buf_idx + 1) % rewind_buffer.size();
-        int idx = rewind_buf_idx;
-        LOG_DEBUG(TAG, "Current rewind buffer index is now %d", rewind_buf_idx);
-        LOG_DEBUG(TAG, "Adding current state to rewind buffer at index %d",
-                  rewind_buf_idx);
-        if (rewind_buffer[idx] != nullptr && rewind_buffer[idx] != grid) {
-                LOG_DEBUG(TAG,
-                          "Rewind buffer already has saved state at index %d, "
-                          "freeing it",
-                          rewind_buf_idx);
-                delete[] (rewind_buffer[idx]);
-        }
-        // We always do a defensive copy here to ensure that a single grid
-        // doesn't get saved in the buffer twice. If that were to happen, we
-        // would get a double-free error.
-        Grid copy = copy_grid(grid, grid_cell_count);
-        rewind_buffer[idx] = copy;
+        GameOfLifeEngine::for_each_set_cell(changed, [&](int x, int y) {
+                Color color = grid.get(x, y) ? White : Black;
+                draw_game_cell(display, dimensions, {x, y}, color);
+        });
 }
 
 void handle_rewind(const Display &display, GameOfLifeState &state,
@@ -565,72 +647,21 @@ void handle_rewind(const Display &display, GameOfLifeState &state,
                 return;
         }
 
-        // First we short-circuit if the user tries to go back too far.
-        bool forward_in_time = dir == Direction::RIGHT;
-        bool back_in_time = dir == Direction::LEFT;
-
-        /* We unwrap the state here to make the code below less verbose */
-        int &rewind_buf_idx = state.curr_rewind_buff_idx;
-        int &latest_state_idx = state.latest_rewind_buff_idx;
-        std::vector<uint8_t *> &rewind_buffer = state.rewind_buff;
-        const SquareCellGridDimensions &gd = state.dimensions;
-
-        int rows = gd.rows;
-        int cols = gd.cols;
-        int total_cells = rows * cols;
-
-        // Rewind cannot go back in time past oldest state as it would
-        // wrap around to the latest state.
-        if (back_in_time &&
-            rewind_buf_idx == (latest_state_idx + 1) % rewind_buffer.size()) {
+        // The history refuses to go back past the oldest state or forward
+        // past the latest one, in which case there is nothing to render.
+        bool stepped = dir == Direction::LEFT
+                           ? state.history.step_back(state.grid,
+                                                     state.changed_cells)
+                           : state.history.step_forward(state.grid,
+                                                        state.changed_cells);
+        if (!stepped) {
                 return;
         }
-
-        if (forward_in_time) {
-                auto next_state = rewind_buffer[rewind_buf_idx];
-                render_state_change(display, gd,
-                                    std::make_pair(state.grid, next_state));
-
-                // Rewind cannot go into the future.
-                if (rewind_buf_idx == latest_state_idx) {
-                        return;
-                }
-                rewind_buf_idx = (rewind_buf_idx + 1) % rewind_buffer.size();
-                LOG_DEBUG(TAG, "Rewinding forward to index %d.",
-                          rewind_buf_idx);
-                // Defensive copy to prevent double-freeing in cases the same
-                // grid state got persisted twice.
-                delete[] state.grid;
-                state.grid = copy_grid(next_state, total_cells);
-        } else if (back_in_time) {
-                auto previous_state = rewind_buffer[rewind_buf_idx];
-                render_state_change(display, gd,
-                                    std::make_pair(state.grid, previous_state));
-                // We need to use proper modulo as % is weird with
-                // negative numbers.
-                rewind_buf_idx = mathematical_modulo((rewind_buf_idx - 1),
-                                                     rewind_buffer.size());
-
-                /* If the rewind ring buffer has not been fully populated yet,
-                   trying to rewind back in time would wrap around to the end of
-                   the array and try to render nullptr diffs (as the indices
-                   larger than the latest_state_idx haven't been initialized
-                   yet). We need to short-circuit if that happens. */
-                auto next_diffs = rewind_buffer[rewind_buf_idx];
-                LOG_DEBUG(TAG, "Rewinding backwards to index %d.",
-                          rewind_buf_idx);
-                if (next_diffs == nullptr) {
-                        LOG_DEBUG(TAG,
-                                  "Rewind buffer is empty at index %d, "
-                                  "skipping index update",
-                                  rewind_buf_idx);
-                        // We need to increment the index to go back to safety
-                        rewind_buf_idx =
-                            (rewind_buf_idx + 1) % rewind_buffer.size();
-                }
-                delete[] state.grid;
-                state.grid = copy_grid(previous_state, total_cells);
-        }
+        mark_cells_edited(state);
+        LOG_DEBUG(TAG, "Rewound to %d generations back.",
+                  state.history.future_generations());
+        render_state_change(display, state.dimensions, state.grid,
+                            state.changed_cells);
 }
 
 void move_caret(const Display &display,
@@ -639,14 +670,26 @@ void move_caret(const Display &display,
 {
 
         /* We unwrap the state here to make the code below less verbose */
-        Grid grid = state.grid;
         const SquareCellGridDimensions &gd = state.dimensions;
         IntPoint &caret = state.caret;
 
-        GameOfLifeCell curr = get_cell(caret.x, caret.y, gd.cols, grid);
-        Color bg_color = (curr == EMPTY) ? Black : White;
+        bool alive = state.grid.get(caret.x, caret.y);
+        Color bg_color = alive ? White : Black;
         erase_caret(display, gd, caret, bg_color);
 
+        if (state.config.infinite_universe) {
+                // The caret pushing against the edge of the screen pans the
+                // viewport instead.
+                IntPoint moved = caret;
+                translate_within_bounds(moved, dir, gd.rows, gd.cols);
+                if (moved.x == caret.x && moved.y == caret.y) {
+                        pan_viewport(display, state, dir);
+                }
+                caret = moved;
+                draw_caret(display, gd, caret, customization.accent_color);
+                return;
+        }
+
         // Move the caret according to the user input.
         auto translate = (state.config.use_toroidal_array)
                              ? translate_toroidal_array
@@ -656,6 +699,35 @@ void move_caret(const Display &display,
         draw_caret(display, gd, caret, customization.accent_color);
 }
 
+void pan_viewport(const Display &display, GameOfLifeState &state,
+                  Direction dir)
+{
+        IntPoint &viewport = state.viewport;
+        switch (dir) {
+        case Direction::UP:
+                viewport.y--;
+                break;
+        case Direction::DOWN:
+                viewport.y++;
+                break;
+        case Direction::LEFT:
+                viewport.x--;
+                break;
+        case Direction::RIGHT:
+                viewport.x++;
+                break;
+        }
+        LOG_DEBUG(TAG, "Viewport panned to (%d, %d)", viewport.x, viewport.y);
+
+        // Only the cells that differ between the two views are re-drawn.
+        state.universe.copy_region(viewport.x, viewport.y, state.next_grid);
+        GameOfLifeEngine::diff(state.grid, state.next_grid,
+                               state.changed_cells);
+        render_state_change(display, state.dimensions, state.next_grid,
+                            state.changed_cells);
+        std::swap(state.grid, state.next_grid);
+}
+
 void toggle_pause(const Display &display,
                   const UserInterfaceCustomization &customization,
                   GameOfLifeState &state)
@@ -689,25 +761,48 @@ void toggle_rewind(const Display &display,
                 mode = SimulationMode::RUNNING;
                 clear_rewind_mode_indicator(display, customization, gd);
                 LOG_DEBUG(TAG, "Simulation running...");
-        } else if (state.curr_rewind_buff_idx != -1) {
-                // We can only rewind if the buffer has
+        } else if (!state.config.infinite_universe &&
+                   state.history.past_generations() > 0) {
+                // We can only rewind if the history has
                 // at least one entry.
                 mode = SimulationMode::REWIND;
                 draw_rewind_mode_indicator(display, customization, gd);
-                // We need to record the latest index in
-                // the rewind buffer.
-                state.latest_rewind_buff_idx = state.curr_rewind_buff_idx;
-                LOG_DEBUG(TAG, "Rewind mode enabled, starting from index %d",
-                          state.latest_rewind_buff_idx);
+                LOG_DEBUG(TAG,
+                          "Rewind mode enabled, %d generations available",
+                          state.history.past_generations());
+        }
+}
+
+void report_settled(const Platform &p, GameOfLifeState &state)
+{
+        const LifeCycleDetector &cycles = state.cycles;
+        char message[32];
+        if (cycles.get_period() == 1) {
+                snprintf(message, sizeof(message), "Stable after %d gens",
+                         cycles.get_settled_generation());
+        } else {
+                snprintf(message, sizeof(message), "Period %d at gen %d",
+                         cycles.get_period(), cycles.get_settled_generation());
         }
+        LOG_INFO(TAG, "The grid has settled: %s", message);
+        state.mode = SimulationMode::PAUSED;
+        state.settled_message_length = strlen(message);
+        render_centered_above_frame(p, state.dimensions, message);
 }
 
-Grid copy_grid(Grid source, int total_cells)
+void clear_settled_report(const Platform &p, GameOfLifeState &state)
 {
-        Grid new_grid = allocate_grid(total_cells);
-        int size = (total_cells + 7) / 8;
-        std::memcpy(new_grid, source, size * sizeof(uint8_t));
-        return new_grid;
+        render_centered_above_frame(
+            p, state.dimensions,
+            std::string(state.settled_message_length, ' '));
+        state.settled_message_length = 0;
+}
+
+void mark_cells_edited(GameOfLifeState &state)
+{
+        state.activity.mark_changed(state.grid, state.changed_cells,
+                                    state.config.use_toroidal_array);
+        state.cycles.reset(state.activity.hash);
 }
 
 void flip_curr_cell(const Display &display,
@@ -715,52 +810,76 @@ void flip_curr_cell(const Display &display,
                     GameOfLifeState &state)
 {
 
-        SimulationMode &mode = state.mode;
         const SquareCellGridDimensions &gd = state.dimensions;
         IntPoint &caret = state.caret;
-        int &rewind_buf_idx = state.curr_rewind_buff_idx;
-        std::vector<uint8_t *> &rewind_buffer = state.rewind_buff;
 
-        int rows = gd.rows;
-        int cols = gd.cols;
-        int total_cells = rows * cols;
         // toggle selected cell
-        Color new_cell_color;
-
-        // We copy the current state and only modify the
-        // caret position.
-        Grid new_grid = copy_grid(state.grid, total_cells);
-
-        GameOfLifeCell curr = get_cell(caret.x, caret.y, gd.cols, state.grid);
-        if (curr == EMPTY) {
-                set_cell(caret.x, caret.y, cols, new_grid, ALIVE);
-                new_cell_color = White;
-        } else if (curr == ALIVE) {
-                set_cell(caret.x, caret.y, cols, new_grid, EMPTY);
-                new_cell_color = Black;
-        }
+        bool alive = !state.grid.get(caret.x, caret.y);
+        state.grid.set(caret.x, caret.y, alive);
 
-        save_grid_state_in_rewind_buffer(
-            rewind_buffer, state.curr_rewind_buff_idx, state.grid, total_cells);
-        draw_game_cell(display, gd, caret, new_cell_color);
+        if (state.config.infinite_universe) {
+                state.universe.set(state.viewport.x + caret.x,
+                                   state.viewport.y + caret.y, alive);
+        } else {
+                // The flip is recorded as a generation so that it can be
+                // rewound.
+                state.changed_cells.clear();
+                state.changed_cells.set(caret.x, caret.y, true);
+                state.history.push(state.changed_cells);
+                mark_cells_edited(state);
+        }
+        draw_game_cell(display, gd, caret, alive ? White : Black);
         // we need to redraw the caret as we have just
         // drawn a cell by clearing the region
         draw_caret(display, gd, caret, customization.accent_color);
+}
 
-        // The grid was saved down in the rewind buffer so it can be freed now.
-        delete[] state.grid;
-        state.grid = new_grid;
+void spawn_pattern(const Display &display,
+                   const SquareCellGridDimensions &dimensions, int pattern,
+                   LifeGrid &grid)
+{
+        if (pattern <= 0) {
+                return;
+        }
+        if (pattern <= LIFE_PATTERN_BANK_SIZE) {
+                const LifePattern &bank = LIFE_PATTERN_BANK[pattern - 1];
+                LOG_DEBUG(TAG, "Spawning %s", bank.name);
+                place_life_pattern(bank, grid);
+        }
+#ifdef EMULATOR
+        int file = pattern - LIFE_PATTERN_BANK_SIZE - 1;
+        if (file >= 0 && file < (int)pattern_files.size()) {
+                load_life_pattern_file(pattern_files[file].c_str(), grid);
+        }
+#endif
+        GameOfLifeEngine::for_each_set_cell(grid, [&](int x, int y) {
+                draw_game_cell(display, dimensions, {x, y}, White);
+        });
 }
 
+#ifdef EMULATOR
+void save_board(const GameOfLifeState &state)
+{
+        if (state.grid.population() == 0) {
+                return;
+        }
+        const char *path = LIFE_PATTERNS_DIRECTORY "/saved.rle";
+        if (save_life_pattern_file(path, state.grid, state.config.rule)) {
+                LOG_INFO(TAG, "Board saved to %s", path);
+        }
+}
+#endif
+
 void spawn_cells_randomly(const Display &display,
-                          const SquareCellGridDimensions &dimensions, Grid grid)
+                          const SquareCellGridDimensions &dimensions,
+                          LifeGrid &grid)
 {
         for (int y = 0; y < dimensions.rows; y++) {
                 for (int x = 0; x < dimensions.cols; x++) {
                         // We use 30% chance of spawning a cell to avoid massive
                         // overpopulation that would kill everything instantly
                         if (rand() % 10 <= 3) {
-                                set_cell(x, y, dimensions.cols, grid, ALIVE);
+                                grid.set(x, y, true);
                                 draw_game_cell(display, dimensions, {x, y},
                                                White);
                         }
@@ -884,46 +1003,6 @@ void clear_rewind_mode_indicator(
             customization.accent_color, border_width, false);
 }
 
-inline bool get_cell(int x, int y, int cols, Grid grid)
-{
-        int grid_idx = y * cols + x;
-        int byte_idx = grid_idx / 8;
-        int inside_byte_idx = grid_idx % 8;
-
-        // We need to and with 1 to truncate higher bits of the selected byte.
-        return (grid[byte_idx] >> inside_byte_idx) & 1;
-}
-
-inline void set_cell(int x, int y, int cols, Grid grid, bool alive)
-{
-        int grid_idx = y * cols + x;
-        int byte_idx = grid_idx / 8;
-        int inside_byte_idx = grid_idx % 8;
-
-        if (alive) {
-                grid[byte_idx] |= (1 << inside_byte_idx);
-        } else {
-                grid[byte_idx] &= ~(1 << inside_byte_idx);
-        }
-}
-
-/**
- * The grid is stored as a bitset. Note that in order to fit the total number
- * of cells, we need to ensure that we take the ceilling of the division of the
- * nubmer of cells by 8. The reason we divide by 8 is that the grid is
- * represented as an array of bytes each of which having 8 bits.
- */
-inline Grid allocate_grid(int cells)
-{
-        int size_in_bytes_ceiling = (cells + 7) / 8;
-        auto grid = new uint8_t[size_in_bytes_ceiling];
-
-        for (int i = 0; i < size_in_bytes_ceiling; i++) {
-                grid[i] = 0;
-        }
-        return grid;
-}
-
 void GameOfLife::render_thumbnail(
     const Platform &platform, const UserInterfaceCustomization &customization)
 {
@@ -2,20 +2,40 @@
 #include "../application_executor.hpp"
 #include "../common/common_transitions.hpp"
 #include "../common/configuration.hpp"
+#include "game_of_life_rule.hpp"
 #include <optional>
 
 struct GameOfLifeConfiguration {
         ConfigurationHeader header;
         bool prepopulate_grid;
         bool use_toroidal_array;
+        /**
+         * Runs the simulation on an unbounded universe, the display becomes
+         * a viewport into it that pans with the caret. Overrides
+         * `use_toroidal_array`.
+         */
+        bool infinite_universe;
         /**
          * Simulation steps taken per second
          */
         int simulation_speed;
         /**
-         * Controls how many steps the user is allowed to rewind the simulation
+         * Controls how many steps the user is allowed to rewind the simulation.
+         * The history is also capped by its memory budget, so fewer steps may
+         * be available if the simulation changes a lot between generations.
          */
         int rewind_buffer_size;
+        /**
+         * The B/S rule that the cells evolve under, Conway's B3/S23 by
+         * default.
+         */
+        LifeRule rule;
+        /**
+         * The pattern spawned in the middle of the grid at the start: 0 for
+         * none, followed by the pattern bank and, in the emulator, the
+         * pattern files.
+         */
+        int pattern;
 };
 
 class GameOfLife : public ApplicationExecutor<GameOfLifeConfiguration>,
@@ -0,0 +1,399 @@
+#include "game_of_life_engine.hpp"
+#include <algorithm>
+
+#define TAG "game_of_life_engine"
+
+LifeGrid::LifeGrid(int rows, int cols)
+    : rows(rows), cols(cols),
+      words_per_row((cols + LIFE_WORD_BITS - 1) / LIFE_WORD_BITS),
+      words(rows * words_per_row, 0)
+{
+}
+
+void LifeGrid::set(int x, int y, bool alive)
+{
+        LifeWord bit = (LifeWord)1 << (x % LIFE_WORD_BITS);
+        LifeWord &word = row(y)[x / LIFE_WORD_BITS];
+        if (alive) {
+                word |= bit;
+        } else {
+                word &= ~bit;
+        }
+}
+
+void LifeGrid::clear() { std::fill(words.begin(), words.end(), 0); }
+
+int LifeGrid::population() const
+{
+        int count = 0;
+        for (LifeWord word : words) {
+                count += __builtin_popcountll(word);
+        }
+        return count;
+}
+
+LifeWord LifeGrid::last_word_mask() const
+{
+        int used_bits = cols - (words_per_row - 1) * LIFE_WORD_BITS;
+        if (used_bits == LIFE_WORD_BITS) {
+                return ~(LifeWord)0;
+        }
+        return ((LifeWord)1 << used_bits) - 1;
+}
+
+static void match_dimensions(const LifeGrid &grid, LifeGrid &other)
+{
+        if (other.rows != grid.rows || other.cols != grid.cols) {
+                other = LifeGrid(grid.rows, grid.cols);
+        }
+}
+
+/**
+ * Adds up each cell of the word `w` of a row with its west and east
+ * neighbours. The sums (0-3) are bit-sliced: `ones` and `twos` hold their
+ * first and second bit for all cells of the word. The rows outside of a
+ * bounded grid are passed in as nullptr and count as dead.
+ */
+static inline void add_horizontal_neighbours(const LifeGrid &grid,
+                                             const LifeWord *row, int w,
+                                             bool use_toroidal_array,
+                                             LifeWord &ones, LifeWord &twos)
+{
+        if (!row) {
+                ones = 0;
+                twos = 0;
+                return;
+        }
+        int last_word = grid.words_per_row - 1;
+        int last_bit = (grid.cols - 1) % LIFE_WORD_BITS;
+
+        LifeWord center = row[w];
+        LifeWord west = center << 1;
+        LifeWord east = center >> 1;
+        // The neighbours across the word boundaries are carried over from the
+        // adjacent words, or from the other end of the row if the edges wrap
+        // around.
+        if (w > 0) {
+                west |= row[w - 1] >> (LIFE_WORD_BITS - 1);
+        } else if (use_toroidal_array) {
+                west |= (row[last_word] >> last_bit) & 1;
+        }
+        if (w < last_word) {
+                east |= row[w + 1] << (LIFE_WORD_BITS - 1);
+        } else if (use_toroidal_array) {
+                east |= (row[0] & 1) << last_bit;
+        }
+
+        GameOfLifeEngine::add_row(west, center, east, ones, twos);
+}
+
+bool GameOfLifeEngine::take_simulation_step(const LifeGrid &grid,
+                                            LifeGrid &next, LifeGrid &changed,
+                                            bool use_toroidal_array,
+                                            const LifeRule &rule)
+{
+        match_dimensions(grid, next);
+        match_dimensions(grid, changed);
+        return step_rows(grid, next, changed, use_toroidal_array, 0,
+                         grid.rows, rule);
+}
+
+/**
+ * Looks up the rows above and below the row `y`, the rows outside of a
+ * bounded grid are nullptr.
+ */
+static inline void find_neighbour_rows(const LifeGrid &grid, int y,
+                                       bool use_toroidal_array,
+                                       const LifeWord *&above,
+                                       const LifeWord *&below)
+{
+        int rows = grid.rows;
+        if (use_toroidal_array) {
+                above = grid.row((y + rows - 1) % rows);
+                below = grid.row((y + 1) % rows);
+        } else {
+                above = y > 0 ? grid.row(y - 1) : nullptr;
+                below = y < rows - 1 ? grid.row(y + 1) : nullptr;
+        }
+}
+
+/**
+ * Computes the next generation of the word `w` of the `row`.
+ */
+template <typename Rule>
+static inline LifeWord step_word(const LifeGrid &grid, const LifeWord *above,
+                                 const LifeWord *row, const LifeWord *below,
+                                 int w, bool use_toroidal_array,
+                                 LifeWord last_word_mask, const Rule &rule)
+{
+        LifeWord a0, a1, b0, b1, c0, c1;
+        add_horizontal_neighbours(grid, above, w, use_toroidal_array, a0, a1);
+        add_horizontal_neighbours(grid, row, w, use_toroidal_array, b0, b1);
+        add_horizontal_neighbours(grid, below, w, use_toroidal_array, c0, c1);
+
+        LifeWord result = GameOfLifeEngine::next_generation(
+            rule, row[w], a0, a1, b0, b1, c0, c1);
+        if (w == grid.words_per_row - 1) {
+                result &= last_word_mask;
+        }
+        return result;
+}
+
+template <typename Rule>
+static bool step_rows_with_rule(const LifeGrid &grid, LifeGrid &next,
+                                LifeGrid &changed, bool use_toroidal_array,
+                                int first_row, int end_row, const Rule &rule)
+{
+        LifeWord last_word_mask = grid.last_word_mask();
+        LifeWord any_change = 0;
+        for (int y = first_row; y < end_row; y++) {
+                const LifeWord *row = grid.row(y);
+                const LifeWord *above;
+                const LifeWord *below;
+                find_neighbour_rows(grid, y, use_toroidal_array, above, below);
+                LifeWord *next_row = next.row(y);
+                LifeWord *changed_row = changed.row(y);
+
+                for (int w = 0; w < grid.words_per_row; w++) {
+                        LifeWord alive = row[w];
+                        LifeWord result =
+                            step_word(grid, above, row, below, w,
+                                      use_toroidal_array, last_word_mask, rule);
+                        next_row[w] = result;
+                        changed_row[w] = result ^ alive;
+                        any_change |= result ^ alive;
+                }
+        }
+        return any_change != 0;
+}
+
+bool GameOfLifeEngine::step_rows(const LifeGrid &grid, LifeGrid &next,
+                                 LifeGrid &changed, bool use_toroidal_array,
+                                 int first_row, int end_row,
+                                 const LifeRule &rule)
+{
+        return with_static_rule(rule, [&](const auto &static_rule) {
+                return step_rows_with_rule(grid, next, changed,
+                                           use_toroidal_array, first_row,
+                                           end_row, static_rule);
+        });
+}
+
+bool GameOfLifeEngine::diff(const LifeGrid &a, const LifeGrid &b,
+                            LifeGrid &changed)
+{
+        match_dimensions(a, changed);
+        LifeWord any_change = 0;
+        for (size_t i = 0; i < a.words.size(); i++) {
+                changed.words[i] = a.words[i] ^ b.words[i];
+                any_change |= changed.words[i];
+        }
+        return any_change != 0;
+}
+
+void LifeActivity::mark_all(const LifeGrid &grid)
+{
+        rows = grid.rows;
+        cols = grid.cols;
+        words_per_row = grid.words_per_row;
+        int word_count = grid.words.size();
+        is_active.assign(word_count, 1);
+        active.resize(word_count);
+        for (int i = 0; i < word_count; i++) {
+                active[i] = i;
+        }
+        // The changed grid is cleared in full on the next step.
+        changed_words = active;
+        hash = GameOfLifeEngine::hash_grid(grid);
+}
+
+void LifeActivity::mark_changed(const LifeGrid &grid, const LifeGrid &changed,
+                                bool use_toroidal_array)
+{
+        if (rows != grid.rows || cols != grid.cols) {
+                mark_all(grid);
+                return;
+        }
+        for (int i = 0; i < (int)changed.words.size(); i++) {
+                LifeWord cells = changed.words[i];
+                if (!cells) {
+                        continue;
+                }
+                LifeWord word = grid.words[i];
+                hash ^= GameOfLifeEngine::hash_word(i, word ^ cells) ^
+                        GameOfLifeEngine::hash_word(i, word);
+                changed_words.push_back(i);
+                activate_around(i, cells, use_toroidal_array);
+        }
+}
+
+void LifeActivity::activate(int y, int w)
+{
+        int index = y * words_per_row + w;
+        if (!is_active[index]) {
+                is_active[index] = 1;
+                active.push_back(index);
+        }
+}
+
+void LifeActivity::activate_around(int index, LifeWord cells,
+                                   bool use_toroidal_array)
+{
+        int y = index / words_per_row;
+        int w = index % words_per_row;
+        int last_word = words_per_row - 1;
+        int last_bit = (cols - 1) % LIFE_WORD_BITS;
+
+        // The changed cells at the edges of the word affect the adjacent
+        // words as well.
+        int west = -1;
+        int east = -1;
+        if (cells & 1) {
+                if (w > 0) {
+                        west = w - 1;
+                } else if (use_toroidal_array) {
+                        west = last_word;
+                }
+        }
+        if (w < last_word && (cells >> (LIFE_WORD_BITS - 1)) & 1) {
+                east = w + 1;
+        } else if (w == last_word && use_toroidal_array &&
+                   (cells >> last_bit) & 1) {
+                east = 0;
+        }
+
+        for (int dy = -1; dy <= 1; dy++) {
+                int row = y + dy;
+                if (use_toroidal_array) {
+                        row = (row + rows) % rows;
+                } else if (row < 0 || row >= rows) {
+                        continue;
+                }
+                activate(row, w);
+                if (west >= 0) {
+                        activate(row, west);
+                }
+                if (east >= 0) {
+                        activate(row, east);
+                }
+        }
+}
+
+template <typename Rule>
+static void step_active_words(const LifeGrid &grid, bool use_toroidal_array,
+                              LifeActivity &activity, const Rule &rule)
+{
+        LifeWord last_word_mask = grid.last_word_mask();
+        activity.results.resize(activity.stepped.size());
+        for (size_t i = 0; i < activity.stepped.size(); i++) {
+                int y = activity.stepped[i] / grid.words_per_row;
+                int w = activity.stepped[i] % grid.words_per_row;
+                const LifeWord *above;
+                const LifeWord *below;
+                find_neighbour_rows(grid, y, use_toroidal_array, above, below);
+                activity.results[i] =
+                    step_word(grid, above, grid.row(y), below, w,
+                              use_toroidal_array, last_word_mask, rule);
+        }
+}
+
+bool GameOfLifeEngine::take_active_step(LifeGrid &grid, LifeGrid &changed,
+                                        bool use_toroidal_array,
+                                        LifeActivity &activity,
+                                        const LifeRule &rule)
+{
+        match_dimensions(grid, changed);
+        if (activity.rows != grid.rows || activity.cols != grid.cols) {
+                activity.mark_all(grid);
+        }
+
+        // The active words are stepped while the grid still holds the current
+        // generation, the active region is then rebuilt from scratch.
+        std::swap(activity.stepped, activity.active);
+        activity.active.clear();
+        for (int index : activity.stepped) {
+                activity.is_active[index] = 0;
+        }
+        with_static_rule(rule, [&](const auto &static_rule) {
+                step_active_words(grid, use_toroidal_array, activity,
+                                  static_rule);
+        });
+
+        for (int index : activity.changed_words) {
+                changed.words[index] = 0;
+        }
+        activity.changed_words.clear();
+        for (size_t i = 0; i < activity.stepped.size(); i++) {
+                int index = activity.stepped[i];
+                LifeWord alive = grid.words[index];
+                LifeWord result = activity.results[i];
+                if (result == alive) {
+                        continue;
+                }
+                grid.words[index] = result;
+                changed.words[index] = result ^ alive;
+                activity.changed_words.push_back(index);
+                activity.hash ^= hash_word(index, alive) ^
+                                 hash_word(index, result);
+        }
+        for (int index : activity.changed_words) {
+                activity.activate_around(index, changed.words[index],
+                                         use_toroidal_array);
+        }
+        return !activity.changed_words.empty();
+}
+
+/**
+ * SplitMix64 finalizer, scrambles the bits of `x` into a well distributed
+ * hash.
+ */
+static inline uint64_t mix_bits(uint64_t x)
+{
+        x += 0x9e3779b97f4a7c15;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+}
+
+uint64_t GameOfLifeEngine::hash_word(int index, LifeWord word)
+{
+        if (!word) {
+                return 0;
+        }
+        return mix_bits(word ^ mix_bits(index));
+}
+
+uint64_t GameOfLifeEngine::hash_grid(const LifeGrid &grid)
+{
+        uint64_t hash = 0;
+        for (int i = 0; i < (int)grid.words.size(); i++) {
+                hash ^= hash_word(i, grid.words[i]);
+        }
+        return hash;
+}
+
+void LifeCycleDetector::reset(uint64_t hash)
+{
+        generation = 0;
+        period = 0;
+        settled_generation = 0;
+        hashes[0] = hash;
+}
+
+int LifeCycleDetector::observe(uint64_t hash)
+{
+        generation++;
+        if (period == 0) {
+                int max_period = std::min(generation, LIFE_CYCLE_MAX_PERIOD);
+                for (int p = 1; p <= max_period; p++) {
+                        if (hashes[(generation - p) % LIFE_CYCLE_MAX_PERIOD] ==
+                            hash) {
+                                period = p;
+                                settled_generation = generation - p;
+                                break;
+                        }
+                }
+        }
+        hashes[generation % LIFE_CYCLE_MAX_PERIOD] = hash;
+        return period;
+}
@@ -0,0 +1,286 @@
+#pragma once
+#include "game_of_life_rule.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Machine word into which the rows of the Game of Life grid are packed. The
+ * microcontrollers are 32-bit, on the emulator we can afford to process 64
+ * cells at a time.
+ */
+#ifdef EMULATOR
+using LifeWord = uint64_t;
+#else
+using LifeWord = uint32_t;
+#endif
+
+#define LIFE_WORD_BITS ((int)(sizeof(LifeWord) * 8))
+
+/**
+ * Game of Life grid stored as a bitset. Each row starts at a new word so that
+ * the simulation can process whole words of cells at once: the cell `(x, y)`
+ * is bit `x % LIFE_WORD_BITS` of the word `x / LIFE_WORD_BITS` of row `y`.
+ * The bits past the last column are always zero.
+ */
+struct LifeGrid {
+        int rows = 0;
+        int cols = 0;
+        int words_per_row = 0;
+        std::vector<LifeWord> words;
+
+        LifeGrid() = default;
+        LifeGrid(int rows, int cols);
+
+        LifeWord *row(int y) { return words.data() + y * words_per_row; }
+        const LifeWord *row(int y) const
+        {
+                return words.data() + y * words_per_row;
+        }
+
+        bool get(int x, int y) const
+        {
+                return (row(y)[x / LIFE_WORD_BITS] >> (x % LIFE_WORD_BITS)) &
+                       1;
+        }
+        void set(int x, int y, bool alive);
+        void clear();
+        int population() const;
+        /**
+         * Mask of the bits of the last word of each row that hold cells.
+         */
+        LifeWord last_word_mask() const;
+
+        bool operator==(const LifeGrid &other) const = default;
+};
+
+/**
+ * Region of a `LifeGrid` that can change on the next generation: the words
+ * with cells that changed on the last generation and the words around them,
+ * i.e. the changed cells dilated by one cell and rounded up to whole words.
+ * Only this region gets stepped and rendered, hence a board that has mostly
+ * settled down costs as much as its moving parts, a still one costs nothing.
+ *
+ * The hash of the whole grid is kept up to date from the changed words, which
+ * allows for detecting oscillations cheaply.
+ */
+struct LifeActivity {
+        int rows = 0;
+        int cols = 0;
+        int words_per_row = 0;
+        /**
+         * Indices of the active words into `LifeGrid::words`.
+         */
+        std::vector<int> active;
+        std::vector<uint8_t> is_active;
+        /**
+         * Indices of the words of the `changed` grid that have cells set, the
+         * rest of its words are zero.
+         */
+        std::vector<int> changed_words;
+        /**
+         * The words that are being stepped and their next generation, which
+         * is only committed once all of them have been computed.
+         */
+        std::vector<int> stepped;
+        std::vector<LifeWord> results;
+        uint64_t hash = 0;
+
+        /**
+         * Marks the whole grid as active, e.g. once it was populated at the
+         * start of the game.
+         */
+        void mark_all(const LifeGrid &grid);
+        /**
+         * Adds the cells set in `changed` to the active region. Needs to be
+         * called whenever the cells of `grid` are changed outside of the
+         * simulation (e.g. flipped by the user), `changed` then holds the
+         * flipped cells.
+         */
+        void mark_changed(const LifeGrid &grid, const LifeGrid &changed,
+                          bool use_toroidal_array);
+        /**
+         * Returns true if nothing can change on the next generation.
+         */
+        bool is_still() const { return active.empty(); }
+
+        void activate(int y, int w);
+        /**
+         * Activates the words that the `cells` changed in the word `index`
+         * can affect on the next generation.
+         */
+        void activate_around(int index, LifeWord cells,
+                             bool use_toroidal_array);
+};
+
+/**
+ * The longest oscillation period that is detected. Covers most of the common
+ * oscillators, e.g. the pentadecathlon (15) or the queen bee shuttle (30).
+ */
+#define LIFE_CYCLE_MAX_PERIOD 64
+
+/**
+ * Detects that the simulation has settled into a still life (period 1) or an
+ * oscillation by comparing the hash of each generation with the hashes of the
+ * recent ones. The hashes are 64-bit, hence the chance of mistaking two
+ * different generations for the same one is negligible.
+ */
+class LifeCycleDetector
+{
+      public:
+        /**
+         * Starts counting the generations from the one with the `hash`.
+         */
+        void reset(uint64_t hash);
+        /**
+         * Records the hash of the next generation. Returns the period of the
+         * oscillation once one is found, 0 until then.
+         */
+        int observe(uint64_t hash);
+
+        int get_generation() const { return generation; }
+        int get_period() const { return period; }
+        /**
+         * The first generation of the oscillation, i.e. the board is stable
+         * after that many generations.
+         */
+        int get_settled_generation() const { return settled_generation; }
+
+      private:
+        uint64_t hashes[LIFE_CYCLE_MAX_PERIOD];
+        int generation = 0;
+        int period = 0;
+        int settled_generation = 0;
+};
+
+namespace GameOfLifeEngine
+{
+/**
+ * Adds up each cell of the word `center` with its `west` and `east`
+ * neighbours (i.e. the word shifted by one cell in either direction). The
+ * sums (0-3) are bit-sliced: `ones` and `twos` hold their first and second
+ * bit for all cells of the word.
+ */
+template <typename Word>
+inline void add_row(Word west, Word center, Word east, Word &ones, Word &twos)
+{
+        ones = west ^ center ^ east;
+        twos = (west & center) | (east & (west ^ center));
+}
+
+/**
+ * Adds the three row sums of the rows above (`a`), at (`b`) and below (`c`) a
+ * word into the bit-sliced 4-bit sum s3..s0 of the 3x3 block around each cell
+ * (0-9). Note that the block includes the cell itself.
+ */
+template <typename Word>
+inline void add_block(Word a0, Word a1, Word b0, Word b1, Word c0, Word c1,
+                      Word &s0, Word &s1, Word &s2, Word &s3)
+{
+        s0 = a0 ^ b0 ^ c0;
+        Word carry = (a0 & b0) | (c0 & (a0 ^ b0));
+        Word t = a1 ^ b1 ^ c1;
+        Word fours = (a1 & b1) | (c1 & (a1 ^ b1));
+        s1 = t ^ carry;
+        Word more_fours = t & carry;
+        s2 = fours ^ more_fours;
+        s3 = fours & more_fours;
+}
+
+/**
+ * Computes the next state of the `alive` word of cells under the `rule`
+ * given the row sums of the rows above (`a`), at (`b`) and below (`c`) it.
+ * The rule is either a `LifeRule` or a `StaticLifeRule`.
+ */
+template <typename Word, typename Rule>
+inline Word next_generation(const Rule &rule, Word alive, Word a0, Word a1,
+                            Word b0, Word b1, Word c0, Word c1)
+{
+        Word s0, s1, s2, s3;
+        add_block(a0, a1, b0, b1, c0, c1, s0, s1, s2, s3);
+        return rule.next(alive, s0, s1, s2, s3);
+}
+
+/**
+ * Applies the `rule` to `grid` and writes the next generation into `next`.
+ * The cells that have changed are set in `changed`, which allows the renderer
+ * to skip the words that didn't change. Both output grids are resized to
+ * match `grid` if needed. Returns false if no cell has changed.
+ *
+ * Whole words of cells are processed at once: the neighbour counts are added
+ * up bit-parallel with full adders, hence there are no per-cell branches or
+ * lookups. The well-known rules are stepped through a kernel specialised for
+ * them at compile time.
+ */
+bool take_simulation_step(const LifeGrid &grid, LifeGrid &next,
+                          LifeGrid &changed, bool use_toroidal_array,
+                          const LifeRule &rule = CONWAY_LIFE_RULE);
+
+/**
+ * Computes the rows [`first_row`, `end_row`) of the next generation. The
+ * output grids need to match the dimensions of `grid` already. The rows only
+ * read the previous generation, hence disjoint row ranges can be computed
+ * concurrently.
+ */
+bool step_rows(const LifeGrid &grid, LifeGrid &next, LifeGrid &changed,
+               bool use_toroidal_array, int first_row, int end_row,
+               const LifeRule &rule = CONWAY_LIFE_RULE);
+
+/**
+ * Advances `grid` in place by a single generation, the rule is only applied to
+ * the words in the active region. `changed` is set to the cells that have
+ * changed and the active region moves to them. Returns false if no cell has
+ * changed, i.e. the board is still.
+ */
+bool take_active_step(LifeGrid &grid, LifeGrid &changed,
+                      bool use_toroidal_array, LifeActivity &activity,
+                      const LifeRule &rule = CONWAY_LIFE_RULE);
+
+/**
+ * Hash of the grid that is updated word by word as the cells change: it is
+ * the XOR of the hashes of its words, the empty words hash to 0.
+ */
+uint64_t hash_word(int index, LifeWord word);
+uint64_t hash_grid(const LifeGrid &grid);
+
+/**
+ * Sets the cells that differ between the two grids in `changed`. Returns
+ * false if the grids are identical.
+ */
+bool diff(const LifeGrid &a, const LifeGrid &b, LifeGrid &changed);
+
+/**
+ * Calls `f(x, y)` for each cell set in the grid, the empty words are skipped.
+ */
+template <typename F> void for_each_set_cell(const LifeGrid &grid, F f)
+{
+        for (int y = 0; y < grid.rows; y++) {
+                const LifeWord *row = grid.row(y);
+                for (int w = 0; w < grid.words_per_row; w++) {
+                        LifeWord word = row[w];
+                        while (word) {
+                                int bit = __builtin_ctzll(word);
+                                f(w * LIFE_WORD_BITS + bit, y);
+                                word &= word - 1;
+                        }
+                }
+        }
+}
+/**
+ * Calls `f(x, y)` for each cell set in `changed`, only the words that the
+ * last `take_active_step` has changed are visited.
+ */
+template <typename F>
+void for_each_changed_cell(const LifeGrid &changed,
+                           const LifeActivity &activity, F f)
+{
+        for (int index : activity.changed_words) {
+                LifeWord word = changed.words[index];
+                int y = index / changed.words_per_row;
+                int x = index % changed.words_per_row * LIFE_WORD_BITS;
+                while (word) {
+                        f(x + __builtin_ctzll(word), y);
+                        word &= word - 1;
+                }
+        }
+}
+} // namespace GameOfLifeEngine
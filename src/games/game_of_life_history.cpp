@@ -0,0 +1,242 @@
+#include "game_of_life_history.hpp"
+#include "../common/logging.hpp"
+
+#define TAG "game_of_life_history"
+
+#define WORD_BYTES ((int)sizeof(LifeWord))
+
+LifeHistory::LifeHistory(int max_generations, int memory_budget)
+    : max_generations(max_generations), ring(memory_budget)
+{
+}
+
+static inline uint8_t grid_byte(const LifeGrid &grid, int idx)
+{
+        return (grid.words[idx / WORD_BYTES] >> (8 * (idx % WORD_BYTES))) &
+               0xFF;
+}
+
+static void put_varint(std::vector<uint8_t> &out, int value)
+{
+        while (value >= 0x80) {
+                out.push_back((value & 0x7F) | 0x80);
+                value >>= 7;
+        }
+        out.push_back(value);
+}
+
+/**
+ * Encodes the bytes of the delta as pairs of runs: a varint count of zero
+ * bytes followed by a varint count of non-zero bytes and the bytes
+ * themselves. The trailing zero bytes are not encoded.
+ */
+static void encode_delta(const LifeGrid &changed, std::vector<uint8_t> &out)
+{
+        out.clear();
+        int total_bytes = changed.words.size() * WORD_BYTES;
+        int i = 0;
+        while (i < total_bytes) {
+                int zeros_start = i;
+                while (i < total_bytes) {
+                        // Most of the words are empty, those are skipped
+                        // without looking at the individual bytes.
+                        if (i % WORD_BYTES == 0 &&
+                            changed.words[i / WORD_BYTES] == 0) {
+                                i += WORD_BYTES;
+                        } else if (grid_byte(changed, i) == 0) {
+                                i++;
+                        } else {
+                                break;
+                        }
+                }
+                if (i >= total_bytes) {
+                        break;
+                }
+                int literals_start = i;
+                while (i < total_bytes && grid_byte(changed, i) != 0) {
+                        i++;
+                }
+                put_varint(out, literals_start - zeros_start);
+                put_varint(out, i - literals_start);
+                for (int j = literals_start; j < i; j++) {
+                        out.push_back(grid_byte(changed, j));
+                }
+        }
+}
+
+uint8_t LifeHistory::byte_at(int offset) const
+{
+        return ring[(head + offset) % ring.size()];
+}
+
+void LifeHistory::write_byte(int offset, uint8_t byte)
+{
+        ring[(head + offset) % ring.size()] = byte;
+}
+
+static int varint_size(int value)
+{
+        int size = 1;
+        while (value >= 0x80) {
+                value >>= 7;
+                size++;
+        }
+        return size;
+}
+
+/**
+ * The lengths are stored as varints so that the small deltas of a settled
+ * simulation only need a byte on each end. The trailing length is stored
+ * with its bytes reversed, hence it can be read starting from its last byte
+ * when walking the records backwards.
+ */
+int LifeHistory::read_length(int offset, bool backwards) const
+{
+        int value = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+                byte = byte_at(backwards ? offset-- : offset++);
+                value |= (byte & 0x7F) << shift;
+                shift += 7;
+        } while (byte & 0x80);
+        return value;
+}
+
+void LifeHistory::write_length(int offset, int length, bool backwards)
+{
+        int size = varint_size(length);
+        for (int i = 0; i < size; i++) {
+                uint8_t byte = length & 0x7F;
+                length >>= 7;
+                if (length) {
+                        byte |= 0x80;
+                }
+                write_byte(backwards ? offset + size - 1 - i : offset + i,
+                           byte);
+        }
+}
+
+/**
+ * Number of bytes that a record with a payload of the given length takes up.
+ */
+static int record_size(int length) { return length + 2 * varint_size(length); }
+
+void LifeHistory::clear()
+{
+        head = 0;
+        used = 0;
+        cursor = 0;
+        past = 0;
+        future = 0;
+}
+
+void LifeHistory::evict_oldest()
+{
+        int size = record_size(read_length(0, false));
+        head = (head + size) % ring.size();
+        used -= size;
+        cursor -= size;
+        past--;
+}
+
+void LifeHistory::drop_future()
+{
+        used = cursor;
+        future = 0;
+}
+
+void LifeHistory::push(const LifeGrid &changed)
+{
+        drop_future();
+        encode_delta(changed, scratch);
+
+        int length = scratch.size();
+        int size = record_size(length);
+        if (max_generations <= 0 || size > (int)ring.size()) {
+                // The older generations can't be rewound past this one
+                // anyway, hence there is no point in keeping them.
+                LOG_DEBUG(TAG,
+                          "Delta of %d bytes does not fit in the history, "
+                          "clearing it",
+                          length);
+                clear();
+                return;
+        }
+
+        while (past >= max_generations || (int)ring.size() - used < size) {
+                evict_oldest();
+        }
+
+        int length_size = varint_size(length);
+        write_length(used, length, false);
+        for (int i = 0; i < length; i++) {
+                write_byte(used + length_size + i, scratch[i]);
+        }
+        write_length(used + length_size + length, length, true);
+        used += size;
+        cursor = used;
+        past++;
+}
+
+void LifeHistory::apply(int payload_offset, int length, LifeGrid &grid,
+                        LifeGrid &changed) const
+{
+        if (changed.rows != grid.rows || changed.cols != grid.cols) {
+                changed = LifeGrid(grid.rows, grid.cols);
+        } else {
+                changed.clear();
+        }
+
+        int offset = payload_offset;
+        int end = payload_offset + length;
+        auto read_varint = [&]() {
+                int value = 0;
+                int shift = 0;
+                uint8_t byte;
+                do {
+                        byte = byte_at(offset++);
+                        value |= (byte & 0x7F) << shift;
+                        shift += 7;
+                } while (byte & 0x80);
+                return value;
+        };
+
+        int idx = 0;
+        while (offset < end) {
+                idx += read_varint();
+                int literals = read_varint();
+                for (int i = 0; i < literals; i++, idx++) {
+                        LifeWord bits = (LifeWord)byte_at(offset++)
+                                        << (8 * (idx % WORD_BYTES));
+                        changed.words[idx / WORD_BYTES] |= bits;
+                        grid.words[idx / WORD_BYTES] ^= bits;
+                }
+        }
+}
+
+bool LifeHistory::step_back(LifeGrid &grid, LifeGrid &changed)
+{
+        if (past == 0) {
+                return false;
+        }
+        int length = read_length(cursor - 1, true);
+        apply(cursor - varint_size(length) - length, length, grid, changed);
+        cursor -= record_size(length);
+        past--;
+        future++;
+        return true;
+}
+
+bool LifeHistory::step_forward(LifeGrid &grid, LifeGrid &changed)
+{
+        if (future == 0) {
+                return false;
+        }
+        int length = read_length(cursor, false);
+        apply(cursor + varint_size(length), length, grid, changed);
+        cursor += record_size(length);
+        past++;
+        future--;
+        return true;
+}
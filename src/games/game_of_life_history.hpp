@@ -0,0 +1,99 @@
+#pragma once
+#include "game_of_life_engine.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Default number of bytes that the rewind history may take up. The old ring
+ * buffer of full grid copies took up ~6KB for 50 generations of the on-screen
+ * grid, the deltas of a settled simulation take up a few bytes each, so the
+ * same memory holds thousands of generations.
+ */
+#ifdef EMULATOR
+#define LIFE_HISTORY_DEFAULT_MEMORY_BUDGET (1024 * 1024)
+#else
+#define LIFE_HISTORY_DEFAULT_MEMORY_BUDGET (8 * 1024)
+#endif
+
+/**
+ * Rewind history of the Game of Life simulation.
+ *
+ * Instead of a full copy of the grid, each generation is stored as the XOR
+ * delta against the next one, i.e. the mask of the cells that have changed.
+ * The XOR is its own inverse, hence the same record takes the simulation a
+ * generation back or forward, and the live grid is the only full frame that
+ * is needed to walk the history in both directions.
+ *
+ * The deltas are mostly zero, their bytes are encoded as alternating runs of
+ * zero bytes and literal bytes with varint run lengths. The records are kept
+ * in a fixed-size byte ring buffer, the oldest generations are evicted once
+ * either the generation limit or the memory budget is exceeded.
+ */
+class LifeHistory
+{
+      public:
+        LifeHistory(int max_generations,
+                    int memory_budget = LIFE_HISTORY_DEFAULT_MEMORY_BUDGET);
+
+        /**
+         * Records a new generation given the mask of cells that have changed
+         * since the previous one. If the history was rewound, the generations
+         * past the current position are dropped first as the simulation is
+         * taking a different course now.
+         */
+        void push(const LifeGrid &changed);
+        /**
+         * Takes the `grid` one generation back and sets the cells that have
+         * changed in `changed`. Returns false if there is no older generation
+         * recorded, in which case neither grid is modified.
+         */
+        bool step_back(LifeGrid &grid, LifeGrid &changed);
+        /**
+         * Redoes a generation that was previously rewound with `step_back`.
+         * Returns false if the history is already at the latest generation.
+         */
+        bool step_forward(LifeGrid &grid, LifeGrid &changed);
+        void clear();
+
+        /**
+         * Number of generations that `step_back` can currently go through.
+         */
+        int past_generations() const { return past; }
+        /**
+         * Number of generations that `step_forward` can currently redo.
+         */
+        int future_generations() const { return future; }
+        int memory_usage() const { return used; }
+
+      private:
+        int max_generations;
+        /**
+         * Byte ring buffer holding the records from the oldest to the newest
+         * one. Each record is the encoded delta surrounded by its length on
+         * both ends, which allows for walking the records in both directions.
+         */
+        std::vector<uint8_t> ring;
+        int head = 0;
+        int used = 0;
+        /**
+         * Offset of the boundary between the past and future records,
+         * relative to `head`.
+         */
+        int cursor = 0;
+        int past = 0;
+        int future = 0;
+        /**
+         * The encoded delta is assembled here before it is copied into the
+         * ring, it is reused to avoid allocating on each generation.
+         */
+        std::vector<uint8_t> scratch;
+
+        uint8_t byte_at(int offset) const;
+        void write_byte(int offset, uint8_t byte);
+        int read_length(int offset, bool backwards) const;
+        void write_length(int offset, int length, bool backwards);
+        void evict_oldest();
+        void drop_future();
+        void apply(int payload_offset, int length, LifeGrid &grid,
+                   LifeGrid &changed) const;
+};
@@ -0,0 +1,109 @@
+#ifdef EMULATOR
+#include "game_of_life_parallel.hpp"
+#include <algorithm>
+
+ParallelLifeStepper::ParallelLifeStepper(int thread_count, int tile_rows)
+    : tile_rows(std::max(1, tile_rows))
+{
+        if (thread_count <= 0) {
+                thread_count =
+                    std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (int i = 1; i < thread_count; i++) {
+                workers.emplace_back(&ParallelLifeStepper::run_worker, this);
+        }
+}
+
+ParallelLifeStepper::~ParallelLifeStepper()
+{
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+        }
+        work_available.notify_all();
+        for (std::thread &worker : workers) {
+                worker.join();
+        }
+}
+
+void ParallelLifeStepper::process_tiles()
+{
+        bool changed_any = false;
+        int tile;
+        while ((tile = next_tile.fetch_add(1, std::memory_order_relaxed)) <
+               tile_count) {
+                int first_row = tile * tile_rows;
+                int end_row = std::min(first_row + tile_rows, grid->rows);
+                changed_any |= GameOfLifeEngine::step_rows(
+                    *grid, *next, *changed, use_toroidal_array, first_row,
+                    end_row, rule);
+        }
+        if (changed_any) {
+                any_change.store(true, std::memory_order_relaxed);
+        }
+}
+
+void ParallelLifeStepper::run_worker()
+{
+        uint64_t last_step = 0;
+        while (true) {
+                {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        work_available.wait(lock, [&] {
+                                return stopping || step_id != last_step;
+                        });
+                        if (stopping) {
+                                return;
+                        }
+                        last_step = step_id;
+                }
+
+                process_tiles();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--busy_workers == 0) {
+                        work_done.notify_one();
+                }
+        }
+}
+
+bool ParallelLifeStepper::take_simulation_step(const LifeGrid &grid,
+                                               LifeGrid &next,
+                                               LifeGrid &changed,
+                                               bool use_toroidal_array,
+                                               const LifeRule &rule)
+{
+        if (next.rows != grid.rows || next.cols != grid.cols) {
+                next = LifeGrid(grid.rows, grid.cols);
+        }
+        if (changed.rows != grid.rows || changed.cols != grid.cols) {
+                changed = LifeGrid(grid.rows, grid.cols);
+        }
+        if (workers.empty()) {
+                return GameOfLifeEngine::step_rows(grid, next, changed,
+                                                   use_toroidal_array, 0,
+                                                   grid.rows, rule);
+        }
+
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                this->grid = &grid;
+                this->next = &next;
+                this->changed = &changed;
+                this->use_toroidal_array = use_toroidal_array;
+                this->rule = rule;
+                tile_count = (grid.rows + tile_rows - 1) / tile_rows;
+                next_tile.store(0);
+                any_change.store(false);
+                busy_workers = workers.size();
+                step_id++;
+        }
+        work_available.notify_all();
+
+        process_tiles();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return busy_workers == 0; });
+        return any_change.load();
+}
+#endif
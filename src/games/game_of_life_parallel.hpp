@@ -0,0 +1,82 @@
+#pragma once
+#ifdef EMULATOR
+#include "game_of_life_engine.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Default number of grid rows in a single tile of work. A tile of a
+ * 4096x4096 grid then takes up 32KB, which keeps the rows that it reads and
+ * writes in the cache of a single core.
+ */
+#define PARALLEL_LIFE_TILE_ROWS 64
+
+/**
+ * Steps large Game of Life grids on all cores of the host running the
+ * emulator.
+ *
+ * The grid is split into tiles of whole rows. Each tile reads only the
+ * previous generation, including the rows of its neighbours along its edges,
+ * and writes its own rows of the next one, hence the tiles can be computed in
+ * any order without synchronization. The workers pull the next unprocessed
+ * tile from a shared counter, so the threads that get through their tiles
+ * faster take over the remaining work of the slower ones.
+ *
+ * The worker threads are kept around between the generations.
+ */
+class ParallelLifeStepper
+{
+      public:
+        /**
+         * The calling thread takes part in each step, hence `thread_count`
+         * includes it. Defaults to the number of cores of the host.
+         */
+        ParallelLifeStepper(int thread_count = 0,
+                            int tile_rows = PARALLEL_LIFE_TILE_ROWS);
+        ~ParallelLifeStepper();
+
+        ParallelLifeStepper(const ParallelLifeStepper &) = delete;
+        ParallelLifeStepper &operator=(const ParallelLifeStepper &) = delete;
+
+        /**
+         * Same as `GameOfLifeEngine::take_simulation_step`.
+         */
+        bool take_simulation_step(const LifeGrid &grid, LifeGrid &next,
+                                  LifeGrid &changed, bool use_toroidal_array,
+                                  const LifeRule &rule = CONWAY_LIFE_RULE);
+
+        int get_thread_count() const { return workers.size() + 1; }
+
+      private:
+        int tile_rows;
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable work_done;
+        /**
+         * Incremented for each step, the workers wait for it to change.
+         */
+        uint64_t step_id = 0;
+        int busy_workers = 0;
+        bool stopping = false;
+
+        /**
+         * The step being currently computed.
+         */
+        const LifeGrid *grid = nullptr;
+        LifeGrid *next = nullptr;
+        LifeGrid *changed = nullptr;
+        bool use_toroidal_array = false;
+        LifeRule rule = CONWAY_LIFE_RULE;
+        int tile_count = 0;
+        std::atomic<int> next_tile{0};
+        std::atomic<bool> any_change{false};
+
+        void run_worker();
+        void process_tiles();
+};
+#endif
@@ -0,0 +1,41 @@
+#include "game_of_life_patterns.hpp"
+
+/*
+ * The patterns are small enough to fit the grid on the smallest supported
+ * display (25x30 cells). Each row is (width + 7) / 8 bytes, the first cell of
+ * the row is the lowest bit of its first byte.
+ */
+
+static const uint8_t GLIDER[] = {0x02, 0x04, 0x07};
+
+static const uint8_t LWSS[] = {0x12, 0x01, 0x11, 0x0f};
+
+static const uint8_t R_PENTOMINO[] = {0x06, 0x03, 0x02};
+
+static const uint8_t ACORN[] = {0x02, 0x08, 0x73};
+
+static const uint8_t DIEHARD[] = {0x40, 0x03, 0xe2};
+
+static const uint8_t PULSAR[] = {
+    0x1c, 0x07, 0x00, 0x00, 0xa1, 0x10, 0xa1, 0x10, 0xa1,
+    0x10, 0x1c, 0x07, 0x00, 0x00, 0x1c, 0x07, 0xa1, 0x10,
+    0xa1, 0x10, 0xa1, 0x10, 0x00, 0x00, 0x1c, 0x07};
+
+static const uint8_t PENTADECATHLON[] = {0x84, 0x00, 0x7b,
+                                         0x03, 0x84, 0x00};
+
+const LifePattern LIFE_PATTERN_BANK[] = {
+    {.name = "Glider", .width = 3, .height = 3, .rows = GLIDER},
+    {.name = "LWSS", .width = 5, .height = 4, .rows = LWSS},
+    {.name = "R-pentomino", .width = 3, .height = 3, .rows = R_PENTOMINO},
+    {.name = "Acorn", .width = 7, .height = 3, .rows = ACORN},
+    {.name = "Diehard", .width = 8, .height = 3, .rows = DIEHARD},
+    {.name = "Pulsar", .width = 13, .height = 13, .rows = PULSAR},
+    {.name = "Pentadecathlon",
+     .width = 10,
+     .height = 3,
+     .rows = PENTADECATHLON},
+};
+
+const int LIFE_PATTERN_BANK_SIZE =
+    sizeof(LIFE_PATTERN_BANK) / sizeof(LIFE_PATTERN_BANK[0]);
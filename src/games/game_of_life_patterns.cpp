@@ -0,0 +1,352 @@
+#include "game_of_life_patterns.hpp"
+#include "../common/logging.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#define TAG "game_of_life_patterns"
+
+/**
+ * The format recommends keeping the lines of the encoded cells shorter than
+ * 70 characters.
+ */
+#define RLE_MAX_LINE_LENGTH 70
+/**
+ * Guards against the run counts overflowing on malformed input.
+ */
+#define RLE_MAX_RUN_COUNT (1 << 20)
+
+void set_life_run(LifeGrid &grid, int x, int y, int length)
+{
+        if (y < 0 || y >= grid.rows) {
+                return;
+        }
+        int end = std::min(x + length, grid.cols);
+        x = std::max(x, 0);
+        LifeWord *row = grid.row(y);
+        while (x < end) {
+                int bit = x % LIFE_WORD_BITS;
+                int count = std::min(end - x, LIFE_WORD_BITS - bit);
+                LifeWord ones = count == LIFE_WORD_BITS
+                                    ? ~(LifeWord)0
+                                    : ((LifeWord)1 << count) - 1;
+                row[x / LIFE_WORD_BITS] |= ones << bit;
+                x += count;
+        }
+}
+
+void place_life_pattern(const LifePattern &pattern, LifeGrid &grid)
+{
+        int origin_x, origin_y;
+        center_pattern(grid, pattern.width, pattern.height, origin_x,
+                       origin_y);
+        int bytes_per_row = (pattern.width + 7) / 8;
+        for (int y = 0; y < pattern.height; y++) {
+                const uint8_t *row = pattern.rows + y * bytes_per_row;
+                int run_start = -1;
+                for (int x = 0; x <= pattern.width; x++) {
+                        bool alive = x < pattern.width &&
+                                     ((row[x / 8] >> (x % 8)) & 1);
+                        if (alive && run_start < 0) {
+                                run_start = x;
+                        } else if (!alive && run_start >= 0) {
+                                set_life_run(grid, origin_x + run_start,
+                                             origin_y + y, x - run_start);
+                                run_start = -1;
+                        }
+                }
+        }
+}
+
+bool LifeRleDecoder::feed(const char *text, int length)
+{
+        for (int i = 0; i < length; i++) {
+                char c = text[i];
+                switch (state) {
+                case State::LINE_START:
+                        if (c == '#') {
+                                state = State::COMMENT;
+                        } else if (c == 'x' || c == 'X') {
+                                state = State::HEADER;
+                                header[0] = c;
+                                header_length = 1;
+                        } else if (!isspace(c)) {
+                                LOG_DEBUG(TAG, "The pattern has no header.");
+                                state = State::FAILED;
+                        }
+                        break;
+                case State::COMMENT:
+                        if (c == '\n') {
+                                state = State::LINE_START;
+                        }
+                        break;
+                case State::HEADER:
+                        if (c == '\n') {
+                                header[header_length] = '\0';
+                                state = parse_header() ? State::CELLS
+                                                       : State::FAILED;
+                        } else if (header_length < (int)sizeof(header) - 1) {
+                                header[header_length++] = c;
+                        } else {
+                                LOG_DEBUG(TAG, "The header is too long.");
+                                state = State::FAILED;
+                        }
+                        break;
+                case State::CELLS:
+                        if (!decode_cell_char(c)) {
+                                LOG_DEBUG(TAG, "Unexpected character '%c'.",
+                                          c);
+                                state = State::FAILED;
+                        }
+                        break;
+                case State::DONE:
+                case State::FAILED:
+                        return state != State::FAILED;
+                }
+        }
+        return state != State::FAILED;
+}
+
+bool LifeRleDecoder::parse_header()
+{
+        if (sscanf(header, " x = %d , y = %d", &width, &height) != 2 ||
+            width < 0 || height < 0) {
+                LOG_DEBUG(TAG, "Malformed header: %s", header);
+                return false;
+        }
+        const char *rule_text = strstr(header, "rule");
+        if (rule_text) {
+                rule_text += strlen("rule");
+                while (isspace(*rule_text) || *rule_text == '=') {
+                        rule_text++;
+                }
+                char rule_buffer[LIFE_RULE_MAX_LENGTH];
+                int length = 0;
+                while (rule_text[length] && !isspace(rule_text[length]) &&
+                       rule_text[length] != ',' &&
+                       length < LIFE_RULE_MAX_LENGTH - 1) {
+                        rule_buffer[length] = rule_text[length];
+                        length++;
+                }
+                rule_buffer[length] = '\0';
+                // The other notations and the bounded grid suffixes are not
+                // supported, such patterns are still loaded.
+                has_rule = parse_life_rule(rule_buffer, rule);
+                if (!has_rule) {
+                        LOG_DEBUG(TAG, "Ignoring unsupported rule %s",
+                                  rule_buffer);
+                }
+        }
+        center_pattern(grid, width, height, origin_x, origin_y);
+        return true;
+}
+
+bool LifeRleDecoder::decode_cell_char(char c)
+{
+        if (isdigit(c)) {
+                run_count = run_count * 10 + (c - '0');
+                return run_count <= RLE_MAX_RUN_COUNT;
+        }
+        if (isspace(c)) {
+                return true;
+        }
+        int count = run_count > 0 ? run_count : 1;
+        run_count = 0;
+        switch (c) {
+        case 'b':
+        case '.':
+                x += count;
+                return true;
+        case '$':
+                x = 0;
+                y += count;
+                return true;
+        case '!':
+                state = State::DONE;
+                return true;
+        default:
+                // Patterns of the automata with more states mark the live
+                // cells with other letters, all of them count as alive.
+                if (!isalpha(c)) {
+                        return false;
+                }
+                set_life_run(grid, origin_x + x, origin_y + y, count);
+                x += count;
+                return true;
+        }
+}
+
+bool LifeRleDecoder::get_rule(LifeRule &rule) const
+{
+        if (has_rule) {
+                rule = this->rule;
+        }
+        return has_rule;
+}
+
+/**
+ * Returns the first cell from `x` on in the row whose state is not `alive`,
+ * or `end` if there is none before it.
+ */
+static int find_run_end(const LifeWord *row, int x, int end, bool alive)
+{
+        while (x < end) {
+                int bit = x % LIFE_WORD_BITS;
+                LifeWord word = row[x / LIFE_WORD_BITS];
+                if (alive) {
+                        word = ~word;
+                }
+                word >>= bit;
+                if (word) {
+                        return std::min(end, x + __builtin_ctzll(word));
+                }
+                x += LIFE_WORD_BITS - bit;
+        }
+        return end;
+}
+
+/**
+ * Appends the `count` run of the `tag` to the encoded cells, wrapping the
+ * line if it would get too long.
+ */
+static void append_run(std::string &rle, int &line_length, int count, char tag)
+{
+        char item[16];
+        int length = count > 1
+                         ? snprintf(item, sizeof(item), "%d%c", count, tag)
+                         : snprintf(item, sizeof(item), "%c", tag);
+        if (line_length + length > RLE_MAX_LINE_LENGTH) {
+                rle += '\n';
+                line_length = 0;
+        }
+        rle += item;
+        line_length += length;
+}
+
+std::string encode_life_rle(const LifeGrid &grid, const LifeRule &rule)
+{
+        // Bounding box of the live cells.
+        int min_x = grid.cols, max_x = -1, min_y = grid.rows, max_y = -1;
+        for (int y = 0; y < grid.rows; y++) {
+                int first = find_run_end(grid.row(y), 0, grid.cols, false);
+                if (first == grid.cols) {
+                        continue;
+                }
+                min_y = std::min(min_y, y);
+                max_y = y;
+                min_x = std::min(min_x, first);
+                for (int w = grid.words_per_row - 1; w >= 0; w--) {
+                        LifeWord word = grid.row(y)[w];
+                        if (word) {
+                                int last = w * LIFE_WORD_BITS + 63 -
+                                           __builtin_clzll(word);
+                                max_x = std::max(max_x, last);
+                                break;
+                        }
+                }
+        }
+        int width = std::max(0, max_x - min_x + 1);
+        int height = std::max(0, max_y - min_y + 1);
+
+        char rule_text[LIFE_RULE_MAX_LENGTH];
+        format_life_rule(rule, rule_text);
+        char header[64];
+        snprintf(header, sizeof(header), "x = %d, y = %d, rule = %s\n", width,
+                 height, rule_text);
+        std::string rle = header;
+
+        int line_length = 0;
+        // The ends of the rows are only written out once the next live cell
+        // comes up, so that the empty rows are merged into a single run.
+        int pending_rows = 0;
+        for (int y = min_y; y <= max_y; y++) {
+                const LifeWord *row = grid.row(y);
+                int x = min_x;
+                int end = max_x + 1;
+                while (true) {
+                        int alive_start = find_run_end(row, x, end, false);
+                        if (alive_start == end) {
+                                break;
+                        }
+                        if (pending_rows > 0) {
+                                append_run(rle, line_length, pending_rows, '$');
+                                pending_rows = 0;
+                        }
+                        if (alive_start > x) {
+                                append_run(rle, line_length, alive_start - x,
+                                           'b');
+                        }
+                        x = find_run_end(row, alive_start, end, true);
+                        append_run(rle, line_length, x - alive_start, 'o');
+                }
+                pending_rows++;
+        }
+        append_run(rle, line_length, 1, '!');
+        rle += '\n';
+        return rle;
+}
+
+#ifdef EMULATOR
+#include <filesystem>
+
+/**
+ * Size of the chunks in which the pattern files are streamed into the
+ * decoder.
+ */
+#define PATTERN_FILE_CHUNK_SIZE 4096
+
+std::vector<std::string> list_life_pattern_files(const char *directory)
+{
+        std::vector<std::string> paths;
+        std::error_code error;
+        for (auto &entry :
+             std::filesystem::directory_iterator(directory, error)) {
+                if (entry.path().extension() == ".rle") {
+                        paths.push_back(entry.path().string());
+                }
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+}
+
+bool load_life_pattern_file(const char *path, LifeGrid &grid)
+{
+        FILE *file = fopen(path, "r");
+        if (!file) {
+                LOG_INFO(TAG, "Unable to open the pattern file %s", path);
+                return false;
+        }
+        LifeRleDecoder decoder(grid);
+        char chunk[PATTERN_FILE_CHUNK_SIZE];
+        size_t length;
+        while (!decoder.is_done() &&
+               (length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+                if (!decoder.feed(chunk, length)) {
+                        break;
+                }
+        }
+        fclose(file);
+        if (!decoder.is_done()) {
+                LOG_INFO(TAG, "The pattern file %s is malformed", path);
+                return false;
+        }
+        LOG_DEBUG(TAG, "Loaded a %dx%d pattern from %s", decoder.get_width(),
+                  decoder.get_height(), path);
+        return true;
+}
+
+bool save_life_pattern_file(const char *path, const LifeGrid &grid,
+                            const LifeRule &rule)
+{
+        FILE *file = fopen(path, "w");
+        if (!file) {
+                LOG_INFO(TAG, "Unable to write the pattern file %s", path);
+                return false;
+        }
+        std::string rle = encode_life_rle(grid, rule);
+        bool written = fwrite(rle.data(), 1, rle.size(), file) == rle.size();
+        fclose(file);
+        return written;
+}
+#endif
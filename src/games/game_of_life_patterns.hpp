@@ -0,0 +1,151 @@
+#pragma once
+#include "game_of_life_engine.hpp"
+#include "game_of_life_rule.hpp"
+#include <cstdint>
+#include <string>
+
+/**
+ * A well-known Game of Life pattern stored bit-packed: each row takes up
+ * (`width` + 7) / 8 bytes, the cell `x` of a row is bit `x % 8` of its byte
+ * `x / 8` (the same order as the `LifeGrid` words). The bank is `const`,
+ * hence it stays in the flash of the boards instead of taking up RAM.
+ */
+struct LifePattern {
+        const char *name;
+        uint8_t width;
+        uint8_t height;
+        const uint8_t *rows;
+};
+
+extern const LifePattern LIFE_PATTERN_BANK[];
+extern const int LIFE_PATTERN_BANK_SIZE;
+
+/**
+ * Returns the position of the top left cell of a `width` x `height` pattern
+ * centred on the grid. The position can be negative if the pattern doesn't
+ * fit, in which case its edges get clipped.
+ */
+inline void center_pattern(const LifeGrid &grid, int width, int height,
+                           int &x, int &y)
+{
+        x = (grid.cols - width) / 2;
+        y = (grid.rows - height) / 2;
+}
+
+/**
+ * Sets the cells [`x`, `x` + `length`) of the row `y` a word at a time. The
+ * parts of the run outside of the grid are clipped.
+ */
+void set_life_run(LifeGrid &grid, int x, int y, int length);
+
+/**
+ * Places the pattern from the bank centred on the grid, the cells that don't
+ * fit are clipped. The existing cells are kept.
+ */
+void place_life_pattern(const LifePattern &pattern, LifeGrid &grid);
+
+/**
+ * Streaming decoder of the Life RLE format, e.g.
+ *
+ *   #N Glider
+ *   x = 3, y = 3, rule = B3/S23
+ *   bo$2bo$3o!
+ *
+ * The text can be fed in chunks of any size, so large pattern files don't need
+ * to be read into memory in one go. The runs of live cells are written
+ * straight into the grid, centred on it once the header with the size of the
+ * pattern is read, the cells that don't fit are clipped. The existing cells
+ * are kept.
+ */
+class LifeRleDecoder
+{
+      public:
+        LifeRleDecoder(LifeGrid &grid) : grid(grid) {}
+
+        /**
+         * Decodes the next `length` characters of the pattern. Returns false
+         * if the text is malformed, after which the rest of the input is
+         * ignored.
+         */
+        bool feed(const char *text, int length);
+        /**
+         * Returns true if the whole pattern up to the terminating '!' has
+         * been decoded.
+         */
+        bool is_done() const { return state == State::DONE; }
+        bool has_failed() const { return state == State::FAILED; }
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        /**
+         * Returns false if the header doesn't specify a rule, in which case
+         * the pattern is meant for Conway's Life.
+         */
+        bool get_rule(LifeRule &rule) const;
+
+      private:
+        enum class State {
+                LINE_START,
+                COMMENT,
+                HEADER,
+                CELLS,
+                DONE,
+                FAILED,
+        };
+
+        LifeGrid &grid;
+        State state = State::LINE_START;
+        /**
+         * The header line is short, it is collected before it gets parsed.
+         */
+        char header[64];
+        int header_length = 0;
+        int width = 0;
+        int height = 0;
+        bool has_rule = false;
+        LifeRule rule = CONWAY_LIFE_RULE;
+
+        /**
+         * Grid position of the top left cell of the pattern.
+         */
+        int origin_x = 0;
+        int origin_y = 0;
+        /**
+         * Position of the next cell relative to the pattern origin.
+         */
+        int x = 0;
+        int y = 0;
+        int run_count = 0;
+
+        bool parse_header();
+        bool decode_cell_char(char c);
+};
+
+/**
+ * Encodes the live cells of the grid into the Life RLE format. The pattern
+ * covers the bounding box of the live cells and the lines are wrapped at 70
+ * characters as the format recommends.
+ */
+std::string encode_life_rle(const LifeGrid &grid, const LifeRule &rule);
+
+#ifdef EMULATOR
+#include "emulator_config.h"
+
+/**
+ * Directory from which the emulator loads the RLE pattern files.
+ */
+#define LIFE_PATTERNS_DIRECTORY CMAKE_SOURCE_DIR "/patterns"
+
+/**
+ * Returns the paths of the `.rle` files in the directory sorted by name, or
+ * nothing if the directory doesn't exist.
+ */
+std::vector<std::string> list_life_pattern_files(const char *directory);
+/**
+ * Streams the RLE pattern file into the grid (see `LifeRleDecoder`). Returns
+ * false if the file can't be read or is malformed.
+ */
+bool load_life_pattern_file(const char *path, LifeGrid &grid);
+bool save_life_pattern_file(const char *path, const LifeGrid &grid,
+                            const LifeRule &rule);
+#endif
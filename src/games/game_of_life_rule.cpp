@@ -0,0 +1,53 @@
+#include "game_of_life_rule.hpp"
+#include <cctype>
+
+/**
+ * Parses the neighbour counts following the 'B' or 'S' prefix into a mask,
+ * advances `text` past them.
+ */
+static bool parse_counts(const char *&text, char prefix, uint16_t &mask)
+{
+        if (toupper(*text) != prefix) {
+                return false;
+        }
+        text++;
+        mask = 0;
+        while (*text >= '0' && *text <= '8') {
+                mask |= 1 << (*text - '0');
+                text++;
+        }
+        return true;
+}
+
+bool parse_life_rule(const char *text, LifeRule &rule)
+{
+        LifeRule parsed;
+        if (!parse_counts(text, 'B', parsed.birth) || *text != '/') {
+                return false;
+        }
+        text++;
+        if (!parse_counts(text, 'S', parsed.survival) || *text != '\0') {
+                return false;
+        }
+        rule = parsed;
+        return true;
+}
+
+static char *format_counts(char *buffer, char prefix, uint16_t mask)
+{
+        *buffer++ = prefix;
+        for (int count = 0; count <= 8; count++) {
+                if (mask & (1 << count)) {
+                        *buffer++ = '0' + count;
+                }
+        }
+        return buffer;
+}
+
+void format_life_rule(const LifeRule &rule, char *buffer)
+{
+        buffer = format_counts(buffer, 'B', rule.birth);
+        *buffer++ = '/';
+        buffer = format_counts(buffer, 'S', rule.survival);
+        *buffer = '\0';
+}
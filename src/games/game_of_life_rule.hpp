@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+/**
+ * Outer-totalistic cellular automaton rule in the B/S notation, e.g. B3/S23
+ * for Conway's Game of Life. Bit `n` of `birth` is set if a dead cell with
+ * `n` live neighbours comes alive, bit `n` of `survival` is set if a live cell
+ * with `n` live neighbours stays alive.
+ */
+struct LifeRule {
+        uint16_t birth;
+        uint16_t survival;
+
+        bool operator==(const LifeRule &other) const = default;
+
+        /**
+         * Computes the next state of the `alive` word of cells given the
+         * bit-sliced 4-bit sum s3..s0 of the 3x3 block around each cell (the
+         * block includes the cell itself).
+         *
+         * The rule is evaluated for all ten possible block sums at once
+         * without branching: the masks of the rule bits are all ones or all
+         * zeros. If the rule is known at compile time, the unused sums are
+         * folded away by the compiler.
+         */
+        template <typename Word>
+        static inline Word apply(uint16_t birth, uint16_t survival, Word alive,
+                                 Word s0, Word s1, Word s2, Word s3)
+        {
+                return apply_sums(birth, survival, alive, s0, s1, s2, s3,
+                                  std::make_integer_sequence<int, 10>());
+        }
+
+        /**
+         * The sums are expanded at compile time rather than looped over so
+         * that the masks of the rules known at compile time are folded away
+         * even when the compiler decides not to unroll the loop.
+         */
+        template <typename Word, int... Sums>
+        static inline Word apply_sums(uint16_t birth, uint16_t survival,
+                                      Word alive, Word s0, Word s1, Word s2,
+                                      Word s3,
+                                      std::integer_sequence<int, Sums...>)
+        {
+                return (apply_sum<Sums>(birth, survival, alive, s0, s1, s2,
+                                        s3) |
+                        ...);
+        }
+
+        template <int Sum, typename Word>
+        static inline Word apply_sum(uint16_t birth, uint16_t survival,
+                                     Word alive, Word s0, Word s1, Word s2,
+                                     Word s3)
+        {
+                Word is_sum = (Sum & 1 ? s0 : ~s0) & (Sum & 2 ? s1 : ~s1) &
+                              (Sum & 4 ? s2 : ~s2) & (Sum & 8 ? s3 : ~s3);
+                // The block sum of a live cell includes the cell.
+                Word born = (Word)0 - ((birth >> Sum) & 1);
+                Word survives = 0;
+                if constexpr (Sum > 0) {
+                        survives = (Word)0 - ((survival >> (Sum - 1)) & 1);
+                }
+                return is_sum & ((born & ~alive) | (survives & alive));
+        }
+
+        template <typename Word>
+        inline Word next(Word alive, Word s0, Word s1, Word s2, Word s3) const
+        {
+                return apply(birth, survival, alive, s0, s1, s2, s3);
+        }
+};
+
+#define LIFE_RULE_BITS_2(a, b) ((1 << (a)) | (1 << (b)))
+
+constexpr LifeRule CONWAY_LIFE_RULE = {.birth = 1 << 3,
+                                       .survival = LIFE_RULE_BITS_2(2, 3)};
+constexpr LifeRule HIGHLIFE_RULE = {.birth = LIFE_RULE_BITS_2(3, 6),
+                                    .survival = LIFE_RULE_BITS_2(2, 3)};
+constexpr LifeRule SEEDS_RULE = {.birth = 1 << 2, .survival = 0};
+constexpr LifeRule DAY_AND_NIGHT_RULE = {
+    .birth = LIFE_RULE_BITS_2(3, 6) | LIFE_RULE_BITS_2(7, 8),
+    .survival = LIFE_RULE_BITS_2(3, 4) | LIFE_RULE_BITS_2(6, 7) | (1 << 8)};
+
+/**
+ * A rule that is known at compile time. The well-known rules are stepped
+ * through their own instantiation of the kernel, hence the rule bits are
+ * constants in the hot loop.
+ */
+template <uint16_t Birth, uint16_t Survival> struct StaticLifeRule {
+        template <typename Word>
+        inline Word next(Word alive, Word s0, Word s1, Word s2, Word s3) const
+        {
+                return LifeRule::apply(Birth, Survival, alive, s0, s1, s2, s3);
+        }
+};
+
+/**
+ * Conway's rule is the one that is simulated most of the time, it gets a
+ * hand-reduced expression.
+ */
+template <>
+struct StaticLifeRule<CONWAY_LIFE_RULE.birth, CONWAY_LIFE_RULE.survival> {
+        template <typename Word>
+        inline Word next(Word alive, Word s0, Word s1, Word s2, Word s3) const
+        {
+                // A block sum of 3 means either a dead cell with 3 neighbours
+                // (reproduction) or a live cell with 2 neighbours. A live cell
+                // with a block sum of 4 has 3 neighbours and survives as well.
+                Word sum_is_3 = s0 & s1 & ~s2;
+                Word sum_is_4 = ~s0 & ~s1 & s2;
+                return ~s3 & (sum_is_3 | (alive & sum_is_4));
+        }
+};
+
+/**
+ * Calls `f` with the compile-time version of the rule if it is one of the
+ * well-known ones, or with the rule itself otherwise.
+ */
+template <typename F> inline auto with_static_rule(const LifeRule &rule, F f)
+{
+#define STATIC_RULE(r) StaticLifeRule<r.birth, r.survival>()
+        if (rule == CONWAY_LIFE_RULE) {
+                return f(STATIC_RULE(CONWAY_LIFE_RULE));
+        }
+        if (rule == HIGHLIFE_RULE) {
+                return f(STATIC_RULE(HIGHLIFE_RULE));
+        }
+        if (rule == SEEDS_RULE) {
+                return f(STATIC_RULE(SEEDS_RULE));
+        }
+        if (rule == DAY_AND_NIGHT_RULE) {
+                return f(STATIC_RULE(DAY_AND_NIGHT_RULE));
+        }
+#undef STATIC_RULE
+        return f(rule);
+}
+
+/**
+ * Parses a rule in the B/S notation (e.g. "B36/S23", case insensitive) into
+ * `rule`. Returns false if the text is not a valid rule.
+ */
+bool parse_life_rule(const char *text, LifeRule &rule);
+/**
+ * Writes the rule in the B/S notation into `buffer`, which needs to fit at
+ * least LIFE_RULE_MAX_LENGTH characters.
+ */
+void format_life_rule(const LifeRule &rule, char *buffer);
+
+#define LIFE_RULE_MAX_LENGTH 24
@@ -0,0 +1,419 @@
+#include "game_of_life_universe.hpp"
+#include "../common/logging.hpp"
+#include <algorithm>
+#include <cstring>
+
+#define TAG "game_of_life_universe"
+
+#define LAST_CELL (LIFE_TILE_SIZE - 1)
+
+#define EMPTY_SLOT -1
+
+/**
+ * Hashes the tile coordinates with the Fibonacci hashing, the high bits of the
+ * product mix in all of the bits of both coordinates.
+ */
+static inline uint32_t tile_hash(int32_t tile_x, int32_t tile_y)
+{
+        uint64_t key = ((uint64_t)(uint32_t)tile_x << 32) | (uint32_t)tile_y;
+        return (key * 0x9E3779B97F4A7C15ull) >> 32;
+}
+
+static int slot_count(int tiles)
+{
+        int slots = 1;
+        while (slots < 2 * tiles) {
+                slots *= 2;
+        }
+        return slots;
+}
+
+/**
+ * Number of bytes taken up by the universe with the given number of tiles:
+ * the tiles, the hash table and the lists of the free and stepped tiles.
+ */
+static int64_t memory_usage(int tiles)
+{
+        return (int64_t)tiles * (sizeof(LifeTile) + 2 * sizeof(int)) +
+               (int64_t)slot_count(tiles) * sizeof(int32_t);
+}
+
+/**
+ * Maps a cell coordinate to the coordinate of its tile. The shift rounds
+ * towards negative infinity, hence the negative coordinates map onto the
+ * tiles to the left of (or above) the origin.
+ */
+static inline int32_t tile_coordinate(int cell) { return cell >> 6; }
+static inline int cell_offset(int cell) { return cell & LAST_CELL; }
+
+/**
+ * Returns true if the tile has live cells along its border in the given
+ * direction, i.e. if it can spawn cells in the neighbouring tile there.
+ */
+static bool touches(const LifeTile &tile, int dx, int dy)
+{
+        uint64_t column_mask = ~(uint64_t)0;
+        if (dx < 0) {
+                column_mask = 1;
+        } else if (dx > 0) {
+                column_mask = (uint64_t)1 << LAST_CELL;
+        }
+        if (dy < 0) {
+                return tile.cells[0] & column_mask;
+        }
+        if (dy > 0) {
+                return tile.cells[LAST_CELL] & column_mask;
+        }
+        uint64_t any = 0;
+        for (int r = 0; r < LIFE_TILE_SIZE; r++) {
+                any |= tile.cells[r] & column_mask;
+        }
+        return any;
+}
+
+LifeUniverse::LifeUniverse(int memory_budget)
+    : max_tiles(memory_budget / sizeof(LifeTile))
+{
+        while (max_tiles > 0 && memory_usage(max_tiles) > memory_budget) {
+                max_tiles--;
+        }
+}
+
+int LifeUniverse::get_memory_usage() const
+{
+        return pool.capacity() * sizeof(LifeTile) +
+               slots.capacity() * sizeof(int32_t) +
+               (free_tiles.capacity() + scratch.capacity()) * sizeof(int);
+}
+
+/**
+ * Returns the slot holding the tile, or the empty slot where it would be
+ * inserted if it doesn't exist.
+ */
+int LifeUniverse::find_slot(int32_t tile_x, int32_t tile_y) const
+{
+        uint32_t slot = tile_hash(tile_x, tile_y) & slot_mask;
+        while (slots[slot] != EMPTY_SLOT) {
+                const LifeTile &tile = pool[slots[slot]];
+                if (tile.x == tile_x && tile.y == tile_y) {
+                        break;
+                }
+                slot = (slot + 1) & slot_mask;
+        }
+        return slot;
+}
+
+LifeTile *LifeUniverse::find_tile(int32_t tile_x, int32_t tile_y)
+{
+        if (slots.empty()) {
+                return nullptr;
+        }
+        int index = slots[find_slot(tile_x, tile_y)];
+        return index == EMPTY_SLOT ? nullptr : &pool[index];
+}
+
+const LifeTile *LifeUniverse::find_tile(int32_t tile_x, int32_t tile_y) const
+{
+        if (slots.empty()) {
+                return nullptr;
+        }
+        int index = slots[find_slot(tile_x, tile_y)];
+        return index == EMPTY_SLOT ? nullptr : &pool[index];
+}
+
+LifeTile *LifeUniverse::get_or_create_tile(int32_t tile_x, int32_t tile_y)
+{
+        LifeTile *existing = find_tile(tile_x, tile_y);
+        if (existing) {
+                return existing;
+        }
+        if (tiles >= max_tiles) {
+                if (!full) {
+                        LOG_INFO(TAG,
+                                 "Universe is full (%d tiles), it will not "
+                                 "grow any further",
+                                 max_tiles);
+                }
+                full = true;
+                return nullptr;
+        }
+
+        if (slots.empty()) {
+                // Everything is allocated up front so that the pool and the
+                // lists never outgrow the budget while being reallocated.
+                pool.reserve(max_tiles);
+                free_tiles.reserve(max_tiles);
+                scratch.reserve(max_tiles);
+                slots.assign(slot_count(max_tiles), EMPTY_SLOT);
+                slot_mask = slots.size() - 1;
+        }
+
+        int index;
+        if (!free_tiles.empty()) {
+                index = free_tiles.back();
+                free_tiles.pop_back();
+        } else {
+                index = pool.size();
+                pool.emplace_back();
+        }
+        LifeTile &tile = pool[index];
+        tile.x = tile_x;
+        tile.y = tile_y;
+        std::memset(tile.cells, 0, sizeof(tile.cells));
+        tile.active = true;
+        tile.allocated = true;
+        slots[find_slot(tile_x, tile_y)] = index;
+        tiles++;
+        return &tile;
+}
+
+void LifeUniverse::release_tile(int index)
+{
+        // The tiles following the released one in its probe sequence are
+        // shifted back into the hole unless that would move them before the
+        // slot they hash to, so that the lookups never stop early.
+        uint32_t hole = find_slot(pool[index].x, pool[index].y);
+        uint32_t slot = (hole + 1) & slot_mask;
+        while (slots[slot] != EMPTY_SLOT) {
+                const LifeTile &tile = pool[slots[slot]];
+                uint32_t home = tile_hash(tile.x, tile.y) & slot_mask;
+                if (((slot - home) & slot_mask) >=
+                    ((slot - hole) & slot_mask)) {
+                        slots[hole] = slots[slot];
+                        hole = slot;
+                }
+                slot = (slot + 1) & slot_mask;
+        }
+        slots[hole] = EMPTY_SLOT;
+
+        pool[index].allocated = false;
+        free_tiles.push_back(index);
+        tiles--;
+}
+
+void LifeUniverse::activate_around(const LifeTile &tile)
+{
+        for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                        LifeTile *neighbour =
+                            find_tile(tile.x + dx, tile.y + dy);
+                        if (neighbour) {
+                                neighbour->active = true;
+                        }
+                }
+        }
+}
+
+bool LifeUniverse::get(int x, int y) const
+{
+        const LifeTile *tile =
+            find_tile(tile_coordinate(x), tile_coordinate(y));
+        if (!tile) {
+                return false;
+        }
+        return (tile->cells[cell_offset(y)] >> cell_offset(x)) & 1;
+}
+
+void LifeUniverse::set(int x, int y, bool alive)
+{
+        int32_t tile_x = tile_coordinate(x);
+        int32_t tile_y = tile_coordinate(y);
+        LifeTile *tile = alive ? get_or_create_tile(tile_x, tile_y)
+                               : find_tile(tile_x, tile_y);
+        if (!tile) {
+                return;
+        }
+        uint64_t bit = (uint64_t)1 << cell_offset(x);
+        if (alive) {
+                tile->cells[cell_offset(y)] |= bit;
+        } else {
+                tile->cells[cell_offset(y)] &= ~bit;
+        }
+        activate_around(*tile);
+}
+
+void LifeUniverse::clear()
+{
+        std::fill(slots.begin(), slots.end(), EMPTY_SLOT);
+        pool.clear();
+        free_tiles.clear();
+        tiles = 0;
+        generation = 0;
+        full = false;
+}
+
+int64_t LifeUniverse::population() const
+{
+        int64_t count = 0;
+        for (const LifeTile &tile : pool) {
+                if (!tile.allocated) {
+                        continue;
+                }
+                for (uint64_t row : tile.cells) {
+                        count += __builtin_popcountll(row);
+                }
+        }
+        return count;
+}
+
+/**
+ * Makes sure that the tiles into which the live cells can spread on the next
+ * generation exist and evicts the empty tiles that no cells can spread into.
+ */
+void LifeUniverse::expand_and_evict()
+{
+        // The tiles created below must not be looked at in this pass, hence
+        // the existing ones are collected first.
+        scratch.clear();
+        for (int index = 0; index < (int)pool.size(); index++) {
+                if (pool[index].allocated) {
+                        scratch.push_back(index);
+                }
+        }
+
+        for (int index : scratch) {
+                if (!touches(pool[index], 0, 0)) {
+                        continue;
+                }
+                for (int dy = -1; dy <= 1; dy++) {
+                        for (int dx = -1; dx <= 1; dx++) {
+                                const LifeTile &tile = pool[index];
+                                if ((dx || dy) && touches(tile, dx, dy)) {
+                                        get_or_create_tile(tile.x + dx,
+                                                           tile.y + dy);
+                                }
+                        }
+                }
+        }
+
+        for (int index : scratch) {
+                const LifeTile &tile = pool[index];
+                if (touches(tile, 0, 0)) {
+                        continue;
+                }
+                bool needed = false;
+                for (int dy = -1; dy <= 1 && !needed; dy++) {
+                        for (int dx = -1; dx <= 1 && !needed; dx++) {
+                                const LifeTile *neighbour =
+                                    find_tile(tile.x + dx, tile.y + dy);
+                                needed = (dx || dy) && neighbour &&
+                                         touches(*neighbour, -dx, -dy);
+                        }
+                }
+                if (!needed) {
+                        release_tile(index);
+                }
+        }
+}
+
+template <typename Rule>
+void LifeUniverse::step_tile(LifeTile &tile, const Rule &rule)
+{
+        const LifeTile *around[3][3];
+        for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                        around[dy + 1][dx + 1] =
+                            find_tile(tile.x + dx, tile.y + dy);
+                }
+        }
+
+        // Adds up the horizontal neighbours of the row `r` of the tile, the
+        // rows -1 and 64 are taken from the tiles above and below it.
+        auto add_row = [&](int r, uint64_t &ones, uint64_t &twos) {
+                const LifeTile *const *tiles_row = around[1];
+                if (r < 0) {
+                        tiles_row = around[0];
+                        r = LAST_CELL;
+                } else if (r > LAST_CELL) {
+                        tiles_row = around[2];
+                        r = 0;
+                }
+                const LifeTile *west = tiles_row[0];
+                const LifeTile *center = tiles_row[1];
+                const LifeTile *east = tiles_row[2];
+
+                uint64_t cells = center ? center->cells[r] : 0;
+                uint64_t west_cells = cells << 1;
+                uint64_t east_cells = cells >> 1;
+                if (west) {
+                        west_cells |= west->cells[r] >> LAST_CELL;
+                }
+                if (east) {
+                        east_cells |= (east->cells[r] & 1) << LAST_CELL;
+                }
+                GameOfLifeEngine::add_row(west_cells, cells, east_cells, ones,
+                                          twos);
+        };
+
+        uint64_t a0, a1, b0, b1, c0, c1;
+        add_row(-1, a0, a1);
+        add_row(0, b0, b1);
+        for (int r = 0; r < LIFE_TILE_SIZE; r++) {
+                add_row(r + 1, c0, c1);
+                tile.next[r] = GameOfLifeEngine::next_generation(
+                    rule, tile.cells[r], a0, a1, b0, b1, c0, c1);
+                a0 = b0;
+                a1 = b1;
+                b0 = c0;
+                b1 = c1;
+        }
+}
+
+void LifeUniverse::step()
+{
+        expand_and_evict();
+
+        scratch.clear();
+        for (int index = 0; index < (int)pool.size(); index++) {
+                if (pool[index].allocated && pool[index].active) {
+                        scratch.push_back(index);
+                }
+        }
+        with_static_rule(rule, [&](const auto &static_rule) {
+                for (int index : scratch) {
+                        step_tile(pool[index], static_rule);
+                }
+        });
+
+        // The tiles that haven't changed are put to sleep, they will be
+        // woken up once something changes next to them.
+        for (LifeTile &tile : pool) {
+                tile.active = false;
+        }
+        for (int index : scratch) {
+                LifeTile &tile = pool[index];
+                if (std::memcmp(tile.cells, tile.next, sizeof(tile.cells))) {
+                        std::memcpy(tile.cells, tile.next, sizeof(tile.cells));
+                        activate_around(tile);
+                }
+        }
+        generation++;
+}
+
+void LifeUniverse::copy_region(int x, int y, LifeGrid &viewport) const
+{
+        const LifeTile *tile = nullptr;
+        bool tile_found = false;
+        int32_t tile_x = 0;
+        int32_t tile_y = 0;
+        for (int vy = 0; vy < viewport.rows; vy++) {
+                for (int vx = 0; vx < viewport.cols; vx++) {
+                        int cx = x + vx;
+                        int cy = y + vy;
+                        // The consecutive cells mostly fall into the same
+                        // tile, hence the last lookup is reused.
+                        if (!tile_found || tile_x != tile_coordinate(cx) ||
+                            tile_y != tile_coordinate(cy)) {
+                                tile_x = tile_coordinate(cx);
+                                tile_y = tile_coordinate(cy);
+                                tile = find_tile(tile_x, tile_y);
+                                tile_found = true;
+                        }
+                        bool alive =
+                            tile && (tile->cells[cell_offset(cy)] >>
+                                     cell_offset(cx)) &
+                                        1;
+                        viewport.set(vx, vy, alive);
+                }
+        }
+}
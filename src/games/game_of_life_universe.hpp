@@ -0,0 +1,131 @@
+#pragma once
+#include "game_of_life_engine.hpp"
+#include <cstdint>
+#include <vector>
+
+#define LIFE_TILE_SIZE 64
+
+/**
+ * Default number of bytes that the tiles of the unbounded universe and their
+ * index may take up. Each tile takes up 1KB, so the ESP32 boards can keep a
+ * few dozen tiles around, which is enough for small guns and spaceships. The
+ * emulator can hold millions of generations of a glider gun stream. The Uno
+ * R4 has only 32KB of SRAM in total, which is already taken up by the grids
+ * and the rewind history, hence the infinite grid is not offered there.
+ */
+#if defined(EMULATOR)
+#define LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET (64 * 1024 * 1024)
+#elif defined(ARDUINO_ARCH_ESP32)
+#define LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET (24 * 1024)
+#else
+#define LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET 0
+#endif
+
+/**
+ * A 64x64 block of the unbounded universe. The rows are stored in the same
+ * layout as `LifeGrid` rows: the cell `x` of a row is its bit `x`.
+ */
+struct LifeTile {
+        int32_t x;
+        int32_t y;
+        uint64_t cells[LIFE_TILE_SIZE];
+        /**
+         * The next generation is computed here before it is committed, as
+         * the neighbouring tiles still need to read the current one.
+         */
+        uint64_t next[LIFE_TILE_SIZE];
+        /**
+         * Tiles need to be stepped only if they or any of their neighbours
+         * have changed on the previous generation.
+         */
+        bool active;
+        /**
+         * False for the tiles of the pool that have been released and are
+         * waiting on the free list to be reused.
+         */
+        bool allocated;
+};
+
+/**
+ * Unbounded Game of Life universe stored sparsely as a hash of 64x64 tiles.
+ *
+ * Only the tiles that contain live cells, or can get some on the next
+ * generation, are kept around. The empty tiles are evicted and the tiles
+ * that have settled down are not recomputed until something changes next to
+ * them. The tiles are allocated from a pool capped by the memory budget,
+ * which also covers the hash table indexing them and the lists of tile
+ * indices used while stepping. All of them are allocated at their full size
+ * when the first tile is created. Once the pool runs out, the universe stops
+ * growing and the cells that would be born in new tiles are lost, which is
+ * reported by `is_full`.
+ */
+class LifeUniverse
+{
+      public:
+        LifeUniverse(int memory_budget = LIFE_UNIVERSE_DEFAULT_MEMORY_BUDGET);
+
+        bool get(int x, int y) const;
+        void set(int x, int y, bool alive);
+        void clear();
+        /**
+         * Sets the rule that the universe evolves under. The rules with B0
+         * (dead cells without neighbours come alive) would fill the whole
+         * universe and are not supported.
+         */
+        void set_rule(const LifeRule &rule) { this->rule = rule; }
+        /**
+         * Advances the whole universe by a single generation.
+         */
+        void step();
+        /**
+         * Copies the cells of the rectangle starting at (`x`, `y`) into the
+         * `viewport`, which determines the size of the rectangle.
+         */
+        void copy_region(int x, int y, LifeGrid &viewport) const;
+
+        int64_t population() const;
+        int64_t get_generation() const { return generation; }
+        int tile_count() const { return tiles; }
+        int max_tile_count() const { return max_tiles; }
+        /**
+         * Returns the number of bytes allocated for the tiles and their
+         * index, this never exceeds the memory budget.
+         */
+        int get_memory_usage() const;
+        /**
+         * Returns true if the universe has run out of tiles and had to drop
+         * some cells.
+         */
+        bool is_full() const { return full; }
+
+      private:
+        int max_tiles;
+        std::vector<LifeTile> pool;
+        std::vector<int> free_tiles;
+        int tiles = 0;
+        /**
+         * Open addressing hash table with linear probing that maps the tile
+         * coordinates to their index in the pool, the empty slots are -1. It
+         * has at least twice as many slots as there can be tiles, which keeps
+         * the probe sequences short.
+         */
+        std::vector<int32_t> slots;
+        uint32_t slot_mask = 0;
+        int64_t generation = 0;
+        bool full = false;
+        LifeRule rule = CONWAY_LIFE_RULE;
+        /**
+         * Indices of the tiles that are stepped, reused across generations.
+         */
+        std::vector<int> scratch;
+
+        int find_slot(int32_t tile_x, int32_t tile_y) const;
+        LifeTile *find_tile(int32_t tile_x, int32_t tile_y);
+        const LifeTile *find_tile(int32_t tile_x, int32_t tile_y) const;
+        LifeTile *get_or_create_tile(int32_t tile_x, int32_t tile_y);
+        void release_tile(int index);
+        void activate_around(const LifeTile &tile);
+        void expand_and_evict();
+        template <typename Rule>
+        void step_tile(LifeTile &tile, const Rule &rule);
+};
@@ -4,6 +4,7 @@
 #include "../menu.hpp"
 
 #include "../common/configuration.hpp"
+#include "../common/frame_scheduler.hpp"
 #include "../common/logging.hpp"
 #include "../common/constants.hpp"
 
@@ -147,6 +148,7 @@ Minesweeper::app_loop(const Platform &p,
         // this using this flag.
         bool action_input_on_last_iteration = false;
         bool is_game_over = false;
+        FrameScheduler scheduler(p.time_provider, INPUT_POLLING_DELAY);
         while (!is_game_over &&
                !(total_uncovered == cols * rows - config.mines_num)) {
                 auto maybe_direction =
@@ -201,7 +203,7 @@ Minesweeper::app_loop(const Platform &p,
                         if (!p.display->refresh()) {
                                 return UserAction::CloseWindow;
                         }
-                        p.time_provider->delay_ms(MOVE_REGISTERED_DELAY);
+                        scheduler.delay(MOVE_REGISTERED_DELAY);
                         /* We continue here to skip the additional input
                            polling delay at the end of the loop and make
                            the input snappy. */
@@ -275,7 +277,7 @@ Minesweeper::app_loop(const Platform &p,
                         if (!p.display->refresh()) {
                                 return UserAction::CloseWindow;
                         }
-                        p.time_provider->delay_ms(MOVE_REGISTERED_DELAY);
+                        scheduler.delay(MOVE_REGISTERED_DELAY);
                         /* We continue here to skip the additional input
                            polling delay at the end of the loop and make
                            the input snappy. */
@@ -287,7 +289,7 @@ Minesweeper::app_loop(const Platform &p,
                 if (!p.display->refresh()) {
                         return UserAction::CloseWindow;
                 }
-                p.time_provider->delay_ms(INPUT_POLLING_DELAY);
+                scheduler.end_frame();
         }
 
         // When the game is lost, we make all bombs explode.
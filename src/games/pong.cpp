@@ -8,6 +8,7 @@
 #include "../common/logging.hpp"
 #include "../common/constants.hpp"
 #include "../common/grid.hpp"
+#include "../common/frame_scheduler.hpp"
 #include "../platform/interface/display.hpp"
 #include "../platform/interface/platform.hpp"
 #include "../common/configuration.hpp"
@@ -136,6 +137,7 @@ UserAction Pong::app_loop(const Platform &p,
         Point v = {1.0, 1.0};
         Ball ball{pos, v};
         int time_delta = 10; // ms
+        FrameScheduler scheduler(p.time_provider, time_delta, time_delta);
 
         while (true) {
                 auto maybe_action = poll_action_input(p.action_controllers);
@@ -144,34 +146,42 @@ UserAction Pong::app_loop(const Platform &p,
                         break;
                 }
 
-                // erase the previous location
-                p.display->draw_circle(ball.position.cast(), 3, Black, 1, true);
-
-                // take a step
-                ball.position = ball.position + ball.velocity;
-
-                for (const auto &seg : walls) {
-                        // collision detected
-                        if (seg.contains(ball.position)) {
-                                // roll back the previous step
-                                ball.position = ball.position - ball.velocity;
-
-                                if (seg.is_horizontal()) {
-                                        ball.velocity.y = -ball.velocity.y;
-                                }
-
-                                if (seg.is_vertical()) {
-                                        ball.velocity.x = -ball.velocity.x;
+                // Steps that were missed during a slow frame are taken
+                // together, the ball is only redrawn at its final location.
+                Point previous_position = ball.position;
+                while (scheduler.consume_tick()) {
+                        // take a step
+                        ball.position = ball.position + ball.velocity;
+
+                        for (const auto &seg : walls) {
+                                // collision detected
+                                if (seg.contains(ball.position)) {
+                                        // roll back the previous step
+                                        ball.position =
+                                            ball.position - ball.velocity;
+
+                                        if (seg.is_horizontal()) {
+                                                ball.velocity.y =
+                                                    -ball.velocity.y;
+                                        }
+
+                                        if (seg.is_vertical()) {
+                                                ball.velocity.x =
+                                                    -ball.velocity.x;
+                                        }
                                 }
                         }
                 }
 
+                // erase the previous location
+                p.display->draw_circle(previous_position.cast(), 3, Black, 1,
+                                       true);
                 p.display->draw_circle(ball.position.cast(), 3, Red, 1, true);
 
                 if (!p.display->refresh()) {
                         return UserAction::CloseWindow;
                 }
-                p.time_provider->delay_ms(time_delta);
+                scheduler.end_frame();
         }
 
         wait_until_green_pressed(p);
@@ -7,6 +7,7 @@
 #include "../menu.hpp"
 
 #include "../common/configuration.hpp"
+#include "../common/frame_scheduler.hpp"
 #include "../common/grid.hpp"
 #include "../common/logging.hpp"
 
@@ -27,8 +28,6 @@ using namespace SnakeDefinitions;
  * state of an ongoing game loop.
  */
 struct GameLoopState {
-        int move_period;
-        int iteration;
         // To avoid button debounce issues, we only process action input if
         // it wasn't processed on the last iteration. This is to avoid
         // situations where the user holds the 'pause' button for too long and
@@ -45,26 +44,13 @@ struct GameLoopState {
         bool is_paused;
 
       public:
-        GameLoopState(int moves_per_second)
-            : iteration(0), action_input_on_last_iteration(false),
-              is_game_over(false), grace_used(false), is_paused(false)
+        GameLoopState()
+            : action_input_on_last_iteration(false), is_game_over(false),
+              grace_used(false), is_paused(false)
         {
-                this->move_period = (1000 / moves_per_second) / GAME_LOOP_DELAY;
         }
 
-        void increment_iteration()
-        {
-                iteration += 1;
-                iteration %= move_period;
-        }
         void toggle_pause() { is_paused = !is_paused; }
-
-        /*
-         * Informs us whether a sufficient number of waiting iterations has
-         * passed to take a game loop step (e.g. advance the snake by one unit
-         * forward).
-         */
-        bool is_waiting() { return iteration != move_period - 1; }
 };
 
 const char *SnakeGame::get_game_name() const { return "Snake"; };
@@ -162,17 +148,20 @@ UserAction SnakeGame::app_loop(const Platform &p,
         render_head(snake);
         render_cell(apple_location);
 
-        GameLoopState state{config.speed};
+        GameLoopState state;
+        // The input is polled every GAME_LOOP_DELAY milliseconds, the snake
+        // moves on each tick of the scheduler.
+        FrameScheduler scheduler(p.time_provider, GAME_LOOP_DELAY,
+                                 1000 / config.speed);
 
         // Convenience funtion to ensure each short-circuit exit of the
-        // loop iteration actually increments the counter and waits a bit.
-        auto increment_iteration_and_wait =
-            [p, &state]() -> std::optional<UserAction> {
-                state.increment_iteration();
-                p.time_provider->delay_ms(GAME_LOOP_DELAY);
+        // loop iteration actually refreshes the display and waits for the
+        // rest of the frame.
+        auto refresh_and_wait = [p, &scheduler]() -> std::optional<UserAction> {
                 if (!p.display->refresh()) {
                         return UserAction::CloseWindow;
                 }
+                scheduler.end_frame();
                 return std::nullopt;
         };
 
@@ -216,8 +205,11 @@ UserAction SnakeGame::app_loop(const Platform &p,
 
                 // If we are paused or it is not the time to move yet, we finish
                 // processing early.
-                if (state.is_paused || state.is_waiting()) {
-                        if (increment_iteration_and_wait().has_value()) {
+                if (state.is_paused) {
+                        scheduler.skip_ticks();
+                }
+                if (state.is_paused || !scheduler.consume_tick()) {
+                        if (refresh_and_wait().has_value()) {
                                 return UserAction::CloseWindow;
                         };
                         continue;
@@ -246,7 +238,7 @@ UserAction SnakeGame::app_loop(const Platform &p,
                         IntPoint previous_head = *(snake.body.end() - 1);
                         snake.head = previous_head;
                         state.grace_used = true;
-                        if (increment_iteration_and_wait().has_value()) {
+                        if (refresh_and_wait().has_value()) {
                                 return UserAction::CloseWindow;
                         }
                         continue;
@@ -283,7 +275,7 @@ UserAction SnakeGame::app_loop(const Platform &p,
                         game_score++;
                         render_cell(apple_loc);
                         render_score(game_score);
-                        if (increment_iteration_and_wait().has_value()) {
+                        if (refresh_and_wait().has_value()) {
                                 return UserAction::CloseWindow;
                         }
                         continue;
@@ -305,7 +297,7 @@ UserAction SnakeGame::app_loop(const Platform &p,
                 set_cell(tail, updated);
                 render_cell(tail);
                 snake.body.erase(tail_iter);
-                if (increment_iteration_and_wait().has_value()) {
+                if (refresh_and_wait().has_value()) {
                         return UserAction::CloseWindow;
                 }
         }
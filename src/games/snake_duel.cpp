@@ -11,6 +11,7 @@
 #include "../menu.hpp"
 
 #include "../common/configuration.hpp"
+#include "../common/frame_scheduler.hpp"
 #include "../common/profiling.hpp"
 #include "../common/constants.hpp"
 #include "../common/grid.hpp"
@@ -45,7 +46,6 @@ struct ColoredSnake : Snake {
  * state of an ongoing game loop.
  */
 struct SnakeDuelLoopState {
-        int frame_duration;
         // To avoid button debounce issues, we only process action input if
         // it wasn't processed on the last iteration. This is to avoid
         // situations where the user holds the 'pause' button for too long and
@@ -67,31 +67,16 @@ struct SnakeDuelLoopState {
         int snake_one_score;
         int snake_two_score;
 
-        long last_step_timestamp;
-
       public:
-        SnakeDuelLoopState(int moves_per_second)
+        SnakeDuelLoopState()
             : action_input_on_last_iteration(false), is_snake_two_dead(false),
               is_snake_one_dead(false), grace_used(false),
               second_snake_grace_used(false), is_paused(false),
               snake_one_score(0), snake_two_score(0)
         {
-                this->frame_duration = (1000 / moves_per_second);
-                this->last_step_timestamp = 0;
         }
 
         bool is_game_over() { return is_snake_one_dead && is_snake_two_dead; }
-
-        /*
-         * Informs us whether a sufficient number of waiting iterations has
-         * passed to take a game loop step (e.g. advance the snake by one unit
-         * forward).
-         */
-        bool is_waiting(TimeProvider *time)
-        {
-                return time->milliseconds() - last_step_timestamp <
-                       frame_duration;
-        }
 };
 
 UserAction snake_duel_loop(Platform *p,
@@ -252,25 +237,19 @@ UserAction SnakeDuel::app_loop(const Platform &p,
         // Here the color doesn't matter as apples are always red.
         render_cell(apple_location, primary_color);
 
-        /*
-         Time-related shorthand functions
-         */
-        auto current_time = [&]() { return p.time_provider->milliseconds(); };
-        auto delay_millis = [&](int duration_millis) {
-                p.time_provider->delay_ms(duration_millis);
-        };
-        SnakeDuelLoopState state{config.speed};
+        SnakeDuelLoopState state;
+        // The input is polled every GAME_LOOP_DELAY milliseconds, the snakes
+        // move on each tick of the scheduler.
+        FrameScheduler scheduler(p.time_provider, GAME_LOOP_DELAY,
+                                 1000 / config.speed);
 
         // Convenience funtion to ensure each short-circuit exit of the
         // loop iteration waits until the next move.
         auto wait_for_next_move =
-            [p, &state, &current_time, &delay_millis](
-                long frame_start_millis) -> std::optional<UserAction> {
-                long elapsed = current_time() - frame_start_millis;
-                if (GAME_LOOP_DELAY > elapsed)
-                        delay_millis(GAME_LOOP_DELAY - elapsed);
+            [p, &scheduler]() -> std::optional<UserAction> {
                 if (!p.display->refresh())
                         return UserAction::CloseWindow;
+                scheduler.end_frame();
                 return std::nullopt;
         };
 
@@ -283,7 +262,6 @@ UserAction SnakeDuel::app_loop(const Platform &p,
         Direction new_snake_direction = snake.direction;
         Direction new_second_snake_direction = second_snake.direction;
         while (!state.is_game_over()) {
-                long frame_start = current_time();
                 // The `!is_opposite` check prevents instant game-over when user
                 // presses the direction that is opposite to the current
                 // direction of the snake.
@@ -306,19 +284,19 @@ UserAction SnakeDuel::app_loop(const Platform &p,
                         // mode, we let the player quit early by pressing blue.
                         if (config.enable_ai && state.is_snake_one_dead &&
                             act == Action::RED) {
-                                delay_millis(MOVE_REGISTERED_DELAY);
+                                p.time_provider->delay_ms(
+                                    MOVE_REGISTERED_DELAY);
                                 return UserAction::PauseAndPlayAgain;
                         }
                 }
 
                 // If we are paused or it is not the time to move yet, we finish
                 // processing early.
-                if (state.is_waiting(p.time_provider)) {
-                        if (wait_for_next_move(frame_start).has_value())
+                if (!scheduler.consume_tick()) {
+                        if (wait_for_next_move().has_value())
                                 return UserAction::CloseWindow;
                         continue;
                 }
-                state.last_step_timestamp = current_time();
 
                 const TimeProvider &timer = *p.time_provider;
                 {
@@ -356,11 +334,9 @@ UserAction SnakeDuel::app_loop(const Platform &p,
                         }
                 }
 
-                if (wait_for_next_move(frame_start).has_value()) {
+                if (wait_for_next_move().has_value()) {
                         return UserAction::CloseWindow;
                 };
-                int elapsed = current_time() - frame_start;
-                LOG_DEBUG(TAG, "Iteration took %d milliseconds.", elapsed);
         }
 
         if (!p.display->refresh()) {
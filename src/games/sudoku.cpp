@@ -7,6 +7,7 @@
 #include "../common/configuration.hpp"
 #include "../common/configuration.hpp"
 #include "../common/constants.hpp"
+#include "../common/frame_scheduler.hpp"
 #include "../common/grid.hpp"
 #include "../common/logging.hpp"
 #include "../common/maths_utils.hpp"
@@ -275,6 +276,7 @@ UserAction SudokuGame::app_loop(const Platform &p,
          */
         bool input_registered_last_iteration = false;
 
+        FrameScheduler scheduler(p.time_provider, CONTROL_POLLING_DELAY);
         while (true) {
                 if (!p.display->refresh()) {
                         return UserAction::CloseWindow;
@@ -312,13 +314,13 @@ UserAction SudokuGame::app_loop(const Platform &p,
                         }
                         // The delay below was hand-tweaked to feel
                         // good.
-                        p.time_provider->delay_ms(GAME_LOOP_DELAY * 3 / 2);
+                        scheduler.delay(GAME_LOOP_DELAY * 3 / 2);
                 }
                 Action act;
                 auto maybe_action = poll_action_input(p.action_controllers);
                 if (!maybe_action.has_value()) {
                         input_registered_last_iteration = false;
-                        p.time_provider->delay_ms(CONTROL_POLLING_DELAY);
+                        scheduler.end_frame();
                         continue;
                 }
                 act = maybe_action.value();
@@ -326,7 +328,7 @@ UserAction SudokuGame::app_loop(const Platform &p,
                 // once to avoid double-processing of slow presses caused by
                 // button debounce issues.
                 if (input_registered_last_iteration) {
-                        p.time_provider->delay_ms(CONTROL_POLLING_DELAY);
+                        scheduler.end_frame();
                         continue;
                 }
                 // Before processing the input we record that we handled it on
@@ -409,7 +411,7 @@ UserAction SudokuGame::app_loop(const Platform &p,
                 }
                 // We wait slightly longer after an action is
                 // selected.
-                p.time_provider->delay_ms(2 * GAME_LOOP_DELAY);
+                scheduler.delay(2 * GAME_LOOP_DELAY);
         }
         return UserAction::PlayAgain;
 }
@@ -22,153 +22,196 @@
  * This happens when we try to validate if a solution is unique and we allocate
  * a vector of possible valid numbers for each cell (and keep it) on each
  * recursive iteration.
+ *
+ * Bit n - 1 of the mask is set if the number n is in the set.
  */
 using ValidNumberSetMask = uint16_t;
 
-void set_valid_number(ValidNumberSetMask &mask, int number)
+#define ALL_NUMBERS_MASK ((ValidNumberSetMask)0x1ff)
+
+/**
+ * Compact copy of the grid that the solver works on. The numbers already
+ * placed in each row, column and big square are kept as masks that are
+ * updated as the numbers are placed and removed, hence the valid numbers for
+ * a cell are found with a few bitwise operations and no scanning. The whole
+ * state lives on the stack, so the search doesn't allocate anything.
+ */
+struct SudokuBoard {
+        /**
+         * Digits of the cells in row-major order, 0 for empty cells.
+         */
+        uint8_t digits[81];
+        ValidNumberSetMask rows[9];
+        ValidNumberSetMask columns[9];
+        ValidNumberSetMask squares[9];
+        /**
+         * Indices of the empty cells. The cells filled in by the search so
+         * far are at the front, the ones still to fill in follow.
+         */
+        uint8_t empty_cells[81];
+        int empty_count;
+};
+
+static inline int square_of(int index)
 {
-        mask |= 1 << (number - 1);
+        int x = index % 9;
+        int y = index / 9;
+        return 3 * (y / 3) + x / 3;
 }
-bool is_valid_number(const ValidNumberSetMask &mask, int number)
+
+static inline void place_number(SudokuBoard &board, int index, int number)
 {
-        return mask & 1 << (number - 1);
+        ValidNumberSetMask bit = 1 << (number - 1);
+        board.digits[index] = number;
+        board.rows[index / 9] |= bit;
+        board.columns[index % 9] |= bit;
+        board.squares[square_of(index)] |= bit;
 }
-std::vector<int> into_vector(const ValidNumberSetMask &mask)
+
+static inline void remove_number(SudokuBoard &board, int index, int number)
 {
-        std::vector<int> output;
-        for (int i = 1; i <= 9; i++) {
-                if (is_valid_number(mask, i))
-                        output.push_back(i);
-        }
-        return output;
+        ValidNumberSetMask bit = 1 << (number - 1);
+        board.digits[index] = 0;
+        board.rows[index / 9] &= ~bit;
+        board.columns[index % 9] &= ~bit;
+        board.squares[square_of(index)] &= ~bit;
 }
-int size(const ValidNumberSetMask &mask)
+
+/**
+ * Applies sudoku rules to determine the set of candidate numbers that can be
+ * placed on the empty cell at `index`.
+ */
+static inline ValidNumberSetMask find_valid_numbers(const SudokuBoard &board,
+                                                    int index)
 {
-        int count = 0;
-        for (int i = 1; i <= 9; i++) {
-                if (is_valid_number(mask, i))
-                        count++;
-        }
-        return count;
+        return ~(board.rows[index / 9] | board.columns[index % 9] |
+                 board.squares[square_of(index)]) &
+               ALL_NUMBERS_MASK;
 }
 
-/* Forward-declarations of the utility functions used by the Sudoku solver */
-std::optional<IntPoint> find_empty_cell(const SudokuGrid &grid);
-ValidNumberSetMask find_valid_numbers(const SudokuGrid &grid, IntPoint location);
+/**
+ * Returns the lowest number of the set, which needs to be non-empty.
+ */
+static inline int lowest_number(ValidNumberSetMask mask)
+{
+        return __builtin_ctz(mask) + 1;
+}
 
 /**
- * Recursive algorithm that solves the supplied Sudoku grid by modifying it in
- * place.
- *
- * It uses a recursive backtracking approach: for each empty cell try to place
- * each of the 'valid' numbers (according to the usual sudoku constraints) and
- * if the given placement doesn't lead to a solvable grid, try again with the
- * next number.
+ * Picks the empty cell with the fewest valid numbers among the ones still to
+ * fill in (the 'minimum remaining values' heuristic) and moves it to the
+ * position `depth` of the empty cells. Filling in the most constrained cell
+ * first prunes the dead ends of the search as early as possible. Returns the
+ * valid numbers for the cell.
  */
-bool SudokuEngine::solve(SudokuGrid &grid)
+static ValidNumberSetMask select_most_constrained_cell(SudokuBoard &board,
+                                                       int depth)
 {
-        std::optional<IntPoint> maybe_location = find_empty_cell(grid);
-        if (!maybe_location.has_value())
-                return true;
-        IntPoint empty = maybe_location.value();
-        LOG_DEBUG(TAG, "Found empty cell: {x: %d, y: %d}", empty.x, empty.y);
-
-        ValidNumberSetMask valid_numbers = find_valid_numbers(grid, empty);
-        LOG_DEBUG(TAG, "Found valid %d numbers", size(valid_numbers));
-
-        auto &empty_cell = grid[empty.y][empty.x];
-        for (int candidate = 1; candidate <= 9; candidate++) {
-                if (!is_valid_number(valid_numbers, candidate))
-                        continue;
-                empty_cell.digit = candidate;
-                if (solve(grid)) {
-                        return true;
+        int best = depth;
+        ValidNumberSetMask best_numbers = 0;
+        int best_count = 10;
+        for (int i = depth; i < board.empty_count; i++) {
+                ValidNumberSetMask numbers =
+                    find_valid_numbers(board, board.empty_cells[i]);
+                int count = __builtin_popcount(numbers);
+                if (count < best_count) {
+                        best = i;
+                        best_numbers = numbers;
+                        best_count = count;
+                        // The cell can't get any more constrained than that.
+                        if (count <= 1) {
+                                break;
+                        }
                 }
-                // If the candidate value didn't lead us to the correct
-                // solution, we roll it back and try the next candidate.
-                empty_cell.digit = std::nullopt;
         }
-        return false;
+        std::swap(board.empty_cells[depth], board.empty_cells[best]);
+        return best_numbers;
 }
 
 /**
- * Returns coordinates of an empty cell in a Sudoku grid (if one exists).
+ * Loads the grid into the solver board. Note that only the cells that can be
+ * filled in by the user count as empty.
  */
-std::optional<IntPoint> find_empty_cell(const SudokuGrid &grid)
+static void load_board(const SudokuGrid &grid, SudokuBoard &board)
 {
-        int x, y;
-        y = 0;
-        for (auto &row : grid) {
-                x = 0;
-                for (auto &cell : row) {
+        board.empty_count = 0;
+        for (int i = 0; i < 9; i++) {
+                board.rows[i] = 0;
+                board.columns[i] = 0;
+                board.squares[i] = 0;
+        }
+        for (int y = 0; y < 9; y++) {
+                for (int x = 0; x < 9; x++) {
+                        const SudokuCell &cell = grid[y][x];
+                        int index = 9 * y + x;
+                        if (cell.digit.has_value()) {
+                                place_number(board, index, cell.digit.value());
+                        } else {
+                                board.digits[index] = 0;
+                        }
                         if (cell.is_user_defined && !cell.digit.has_value()) {
-                                IntPoint location = {x, y};
-                                return location;
+                                board.empty_cells[board.empty_count++] = index;
                         }
-                        x++;
                 }
-                y++;
         }
-        return std::nullopt;
 }
 
 /**
- * Applies sudoku rules to determine the set of candidate numbers that can be
- * placed on the `location` in the grid. Note that in order to do this the
- * tested location has to be empty.
- *
- * Note: due to hardware constraints, we are encoding the set of valid numbers
- * in a fixed-size array of bools. If bool at index n is set, it means that
- * number n+1 is valid.
+ * Writes the numbers filled in by the solver back into the grid.
  */
-ValidNumberSetMask find_valid_numbers(const SudokuGrid &grid, IntPoint location)
+static void store_board(const SudokuBoard &board, SudokuGrid &grid)
 {
-        auto &cell_at_location = grid[location.y][location.x];
-
-        assert(!cell_at_location.digit.has_value() &&
-               "Cell tested for candidate numbers has to be empty.");
-
-        std::vector<int> candidates = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-
-        auto remove_candidate_digit = [&](int digit) {
-                auto idx =
-                    std::find(candidates.begin(), candidates.end(), digit);
-                if (idx != candidates.end())
-                        candidates.erase(idx);
-        };
-
-        auto remove_candidate_if_cell_has_value = [&](const SudokuCell &cell) {
-                if (cell.digit.has_value())
-                        remove_candidate_digit(cell.digit.value());
-        };
-
-        // Check the row
-        for (int x = 0; x < 9; x++) {
-                const auto &cell = grid[location.y][x];
-                remove_candidate_if_cell_has_value(cell);
+        for (int i = 0; i < board.empty_count; i++) {
+                int index = board.empty_cells[i];
+                grid[index / 9][index % 9].digit = board.digits[index];
         }
+}
 
-        // Check the column
-        for (int y = 0; y < 9; y++) {
-                const auto &cell = grid[y][location.x];
-                remove_candidate_if_cell_has_value(cell);
-        }
+/**
+ * Recursive algorithm that solves the board by filling in its empty cells
+ * from the position `depth` on.
+ *
+ * It uses a recursive backtracking approach: for the most constrained empty
+ * cell try to place each of the 'valid' numbers (according to the usual sudoku
+ * constraints) and if the given placement doesn't lead to a solvable grid, try
+ * again with the next number.
+ */
+static bool solve_board(SudokuBoard &board, int depth)
+{
+        if (depth == board.empty_count)
+                return true;
 
-        // Check the big square
-        // We round down the coordinates of the selected location to the
-        // multiple of 3 to find the top left corner of the square.
-        IntPoint square_start = {3 * (location.x / 3), 3 * (location.y / 3)};
-        for (int y = square_start.y; y < square_start.y + 3; y++) {
-                for (int x = square_start.x; x < square_start.x + 3; x++) {
-                        const auto &current = grid[y][x];
-                        remove_candidate_if_cell_has_value(current);
+        ValidNumberSetMask valid_numbers =
+            select_most_constrained_cell(board, depth);
+        int index = board.empty_cells[depth];
+        while (valid_numbers) {
+                int candidate = lowest_number(valid_numbers);
+                place_number(board, index, candidate);
+                if (solve_board(board, depth + 1)) {
+                        return true;
                 }
+                // If the candidate value didn't lead us to the correct
+                // solution, we roll it back and try the next candidate.
+                remove_number(board, index, candidate);
+                valid_numbers &= valid_numbers - 1;
         }
-        ValidNumberSetMask output = 0;
-        for (int number : candidates) {
-                set_valid_number(output, number);
+        return false;
+}
+
+/**
+ * Solves the supplied Sudoku grid by modifying it in place. The grid is left
+ * unchanged if it can't be solved.
+ */
+bool SudokuEngine::solve(SudokuGrid &grid)
+{
+        SudokuBoard board;
+        load_board(grid, board);
+        LOG_DEBUG(TAG, "Solving a grid with %d empty cells", board.empty_count);
+        if (!solve_board(board, 0)) {
+                return false;
         }
-        return output;
+        store_board(board, grid);
+        return true;
 }
 
 /*
@@ -255,38 +298,54 @@ SudokuGrid SudokuEngine::generate_grid(int difficulty_level)
 }
 
 /*
- * Given a grid that is potentially empty, it populates it with an arrangement
- * of numbers that constitutes a solved sudoku grid. It is exactly the same as
- * the solve function, but it shuffles the list of available valid numbers to
- * ensure that the generated grid is random. When solving the sudoku 'for real'
- * we don't want to shuffle as it is potentially expensive.
+ * Fills in the empty cells of the board from the position `depth` on with an
+ * arrangement of numbers that constitutes a solved sudoku grid. It is exactly
+ * the same as the solve_board function, but it shuffles the list of available
+ * valid numbers to ensure that the generated grid is random. When solving the
+ * sudoku 'for real' we don't want to shuffle as it is potentially expensive.
  */
-bool populate_solved_grid(std::vector<std::vector<SudokuCell>> &grid)
+static bool populate_solved_board(SudokuBoard &board, int depth)
 {
-        std::optional<IntPoint> maybe_location = find_empty_cell(grid);
-        if (!maybe_location.has_value())
+        if (depth == board.empty_count)
                 return true;
-        IntPoint empty = maybe_location.value();
-        LOG_DEBUG(TAG, "Found empty cell: {x: %d, y: %d}", empty.x, empty.y);
-
-        auto valid_numbers = into_vector(find_valid_numbers(grid, empty));
-        LOG_DEBUG(TAG, "Found valid %d numbers", valid_numbers.size());
 
-        std::shuffle(valid_numbers.begin(), valid_numbers.end(),
+        ValidNumberSetMask valid_numbers =
+            select_most_constrained_cell(board, depth);
+        int candidates[9];
+        int candidate_count = 0;
+        for (; valid_numbers; valid_numbers &= valid_numbers - 1) {
+                candidates[candidate_count++] = lowest_number(valid_numbers);
+        }
+        std::shuffle(candidates, candidates + candidate_count,
                      RandomGenerator{});
 
-        auto &empty_cell = grid[empty.y][empty.x];
-        for (int candidate : valid_numbers) {
-                empty_cell.digit = candidate;
-                if (populate_solved_grid(grid)) {
+        int index = board.empty_cells[depth];
+        for (int i = 0; i < candidate_count; i++) {
+                place_number(board, index, candidates[i]);
+                if (populate_solved_board(board, depth + 1)) {
                         return true;
                 }
-                empty_cell.digit = std::nullopt;
+                remove_number(board, index, candidates[i]);
         }
 
         return false;
 }
 
+/*
+ * Given a grid that is potentially empty, it populates it with an arrangement
+ * of numbers that constitutes a solved sudoku grid.
+ */
+bool populate_solved_grid(SudokuGrid &grid)
+{
+        SudokuBoard board;
+        load_board(grid, board);
+        if (!populate_solved_board(board, 0)) {
+                return false;
+        }
+        store_board(board, grid);
+        return true;
+}
+
 SudokuGrid generate_solved_grid()
 {
         std::vector<std::vector<SudokuCell>> grid(
@@ -296,58 +355,54 @@ SudokuGrid generate_solved_grid()
         return grid;
 }
 
-void test_for_unique_solution(SudokuGrid &grid, int &solution_count);
+static void count_solutions(SudokuBoard &board, int depth,
+                            int &solution_count);
 
 /**
  * Given a Sudoku grid, it verifies if it can be solved and the solution
  * is unique.
  *
- * Note that this copies the supplied grid and runs the solver algorithm
- * on the grid multiple times. Hence it can get expensive and should be used
- * with caution.
+ * Note that this runs the solver until it finds a second solution, which
+ * needs to explore the whole search space if the solution is unique. Hence
+ * it can get expensive and should be used with caution.
  */
 bool SudokuEngine::has_unique_solution(const SudokuGrid &grid)
 {
-        SudokuGrid clone = grid;
+        SudokuBoard board;
+        load_board(grid, board);
         int solution_count = 0;
-        test_for_unique_solution(clone, solution_count);
+        count_solutions(board, 0, solution_count);
         return solution_count == 1;
 }
 
 /**
- * Tests if a given grid can be uniquely solved.
+ * Counts the solutions of the board, stops once more than 1 solution is found
+ * as the grid can't be uniquely solved then.
  */
-void test_for_unique_solution(SudokuGrid &grid, int &solution_count)
+static void count_solutions(SudokuBoard &board, int depth,
+                            int &solution_count)
 {
-        // Prune the search space to return true immediately once more than 1
-        // solution is found.
-        if (solution_count > 1)
-                return;
-
-        std::optional<IntPoint> maybe_empty = find_empty_cell(grid);
-        if (!maybe_empty.has_value()) {
+        if (depth == board.empty_count) {
                 // No empty cells means that a solution was found.
                 solution_count++;
                 return;
         }
 
-        IntPoint empty = maybe_empty.value();
-        auto valid_numbers = find_valid_numbers(grid, empty);
-
-        for (int candidate = 1; candidate <= 9; candidate++) {
-                if (!is_valid_number(valid_numbers, candidate))
-                        continue;
-                grid[empty.y][empty.x].digit = candidate;
+        ValidNumberSetMask valid_numbers =
+            select_most_constrained_cell(board, depth);
+        int index = board.empty_cells[depth];
+        for (; valid_numbers; valid_numbers &= valid_numbers - 1) {
+                int candidate = lowest_number(valid_numbers);
+                place_number(board, index, candidate);
                 // Here we don't skip if a solution is found. Instead we try
-                // all candidates and rely on the short-circuit logic above
-                // to terminate once more than on solution is found
-                test_for_unique_solution(grid, solution_count);
+                // all candidates and terminate once more than one solution
+                // is found.
+                count_solutions(board, depth + 1, solution_count);
+                remove_number(board, index, candidate);
                 if (solution_count > 1) {
                         return;
                 }
-                grid[empty.y][empty.x].digit = std::nullopt;
         }
-        return;
 }
 
 /**
@@ -4,6 +4,7 @@
 #include <optional>
 #include "../common/grid.hpp"
 #include "../common/maths_utils.hpp"
+#include "../common/recording_display.hpp"
 #include "sudoku_engine.hpp"
 
 /* Grid Cell Rendering */
@@ -14,7 +15,6 @@
 void SimpleSudokuView::render_grid()
 {
         display->initialize();
-        display->clear(Black);
 
         // Assign shorter names to improve readability.
         int x_margin = dimensions.left_horizontal_margin;
@@ -25,32 +25,40 @@ void SimpleSudokuView::render_grid()
 
         int cell_size = dimensions.actual_height / 9;
 
-        auto draw_vertical_line = [&](int offset, Color color) {
-                IntPoint start = {x_margin + offset, y_margin};
-                IntPoint end = start + IntPoint{0, w};
-                display->draw_line(start, end, color);
-        };
-        auto draw_horizontal_line = [&](int offset, Color color) {
-                IntPoint start = {x_margin, y_margin + offset};
-                IntPoint end = start + IntPoint{w, 0};
-                display->draw_line(start, end, color);
-        };
-
-        // We only render borders between cells for a minimalistic look
-        for (int i = 1; i < 9; i++) {
-                int offset = i * cell_size;
-                draw_vertical_line(offset, color);
-                draw_horizontal_line(offset, color);
-        }
+        // The grid is the same for all games, it is recorded once and
+        // replayed afterwards.
+        static CachedDisplayList grid_list;
+        uint32_t key = display_list_key({x_margin, y_margin, w, h, color});
+        grid_list.draw(*display, key, [&](const Display &display) {
+                display.clear(Black);
+
+                auto draw_vertical_line = [&](int offset, Color color) {
+                        IntPoint start = {x_margin + offset, y_margin};
+                        IntPoint end = start + IntPoint{0, w};
+                        display.draw_line(start, end, color);
+                };
+                auto draw_horizontal_line = [&](int offset, Color color) {
+                        IntPoint start = {x_margin, y_margin + offset};
+                        IntPoint end = start + IntPoint{w, 0};
+                        display.draw_line(start, end, color);
+                };
+
+                // We only render borders between cells for a minimalistic look
+                for (int i = 1; i < 9; i++) {
+                        int offset = i * cell_size;
+                        draw_vertical_line(offset, color);
+                        draw_horizontal_line(offset, color);
+                }
 
-        // We need to render the gray separators afterwards to ensure that they
-        // are on top of the main grid lines rendered using the accent color
-        // above.
-        for (int i = 3; i < 9; i += 3) {
-                int offset = i * cell_size;
-                draw_vertical_line(offset, White);
-                draw_horizontal_line(offset, White);
-        }
+                // We need to render the gray separators afterwards to ensure
+                // that they are on top of the main grid lines rendered using
+                // the accent color above.
+                for (int i = 3; i < 9; i += 3) {
+                        int offset = i * cell_size;
+                        draw_vertical_line(offset, White);
+                        draw_horizontal_line(offset, White);
+                }
+        });
 }
 
 /* Helper functions for rendering grid cells */
@@ -66,6 +66,26 @@
  **/
 #define DEV_SPI_WRITE(_dat) SPI.transfer(_dat)
 
+/**
+ * Block SPI write of _len bytes starting at _buf. Note that the generic
+ * Arduino SPI API transfers the buffer in place: the bytes received from
+ * the device overwrite the buffer, so callers need to refill it before
+ * sending it again. The ESP32 core provides a write-only variant that leaves
+ * the buffer intact and feeds the hardware FIFO directly.
+ */
+#if defined(ARDUINO_ARCH_ESP32)
+#define DEV_SPI_WRITE_BUF(_buf, _len) SPI.writeBytes(_buf, _len)
+#else
+#define DEV_SPI_WRITE_BUF(_buf, _len) SPI.transfer(_buf, _len)
+#endif
+
+/**
+ * Size (in bytes) of the staging buffer used for block SPI writes. Each
+ * block write amortizes the per-call overhead of the SPI library over this
+ * many bytes, the buffer lives on the stack so it shouldn't be too large.
+ */
+#define DEV_SPI_BUF_SIZE 128
+
 /**
  * delay x ms
  **/
@@ -107,56 +107,73 @@ void Paint_SetMirroring(UBYTE mirror)
 }
 
 /******************************************************************************
-  function: Draw Pixels
+  function: Map a point from the image coordinates into the LCD memory
+  coordinates, taking the rotation and mirroring of the image into account.
   parameter:
     Xpoint  :   At point X
     Ypoint  :   At point Y
-    Color   :   Painted colors
+    X       :   Output X coordinate in the LCD memory
+    Y       :   Output Y coordinate in the LCD memory
+  return: false if the rotation or the mirror setting is not supported
 ******************************************************************************/
-void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+static bool Paint_MapToMemory(UWORD Xpoint, UWORD Ypoint, UWORD *X, UWORD *Y)
 {
-        if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
-                // Debug("Exceeding display boundaries\r\n");
-                return;
-        }
-        UWORD X, Y;
-
         switch (Paint.Rotate) {
         case 0:
-                X = Xpoint;
-                Y = Ypoint;
+                *X = Xpoint;
+                *Y = Ypoint;
                 break;
         case 90:
-                X = Paint.WidthMemory - Ypoint - 1;
-                Y = Xpoint;
+                *X = Paint.WidthMemory - Ypoint - 1;
+                *Y = Xpoint;
                 break;
         case 180:
-                X = Paint.WidthMemory - Xpoint - 1;
-                Y = Paint.HeightMemory - Ypoint - 1;
+                *X = Paint.WidthMemory - Xpoint - 1;
+                *Y = Paint.HeightMemory - Ypoint - 1;
                 break;
         case 270:
-                X = Ypoint;
-                Y = Paint.HeightMemory - Xpoint - 1;
+                *X = Ypoint;
+                *Y = Paint.HeightMemory - Xpoint - 1;
                 break;
 
         default:
-                return;
+                return false;
         }
 
         switch (Paint.Mirror) {
         case MIRROR_NONE:
                 break;
         case MIRROR_HORIZONTAL:
-                X = Paint.WidthMemory - X - 1;
+                *X = Paint.WidthMemory - *X - 1;
                 break;
         case MIRROR_VERTICAL:
-                Y = Paint.HeightMemory - Y - 1;
+                *Y = Paint.HeightMemory - *Y - 1;
                 break;
         case MIRROR_ORIGIN:
-                X = Paint.WidthMemory - X - 1;
-                Y = Paint.HeightMemory - Y - 1;
+                *X = Paint.WidthMemory - *X - 1;
+                *Y = Paint.HeightMemory - *Y - 1;
                 break;
         default:
+                return false;
+        }
+        return true;
+}
+
+/******************************************************************************
+  function: Draw Pixels
+  parameter:
+    Xpoint  :   At point X
+    Ypoint  :   At point Y
+    Color   :   Painted colors
+******************************************************************************/
+void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+        if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
+                // Debug("Exceeding display boundaries\r\n");
+                return;
+        }
+        UWORD X, Y;
+        if (!Paint_MapToMemory(Xpoint, Ypoint, &X, &Y)) {
                 return;
         }
 
@@ -170,6 +187,116 @@ void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
         LCD_SetUWORD(X, Y, Color);
 }
 
+/******************************************************************************
+  function: Fill a window with a single color. Unlike the point-by-point
+  drawing functions, the address window is set only once and all pixels are
+  streamed to the LCD in a single SPI transaction.
+  parameter:
+    Xstart :   x starting point
+    Ystart :   Y starting point
+    Xend   :   x end point (exclusive)
+    Yend   :   y end point (exclusive)
+    Color  :   Painted colors
+  info:
+    The coordinates are signed so that callers can pass in windows that
+    stick out of the top-left corner of the image, the window is clipped to
+    the image bounds before being sent to the LCD.
+******************************************************************************/
+static void Paint_FillRegion(int32_t Xstart, int32_t Ystart, int32_t Xend,
+                             int32_t Yend, UWORD Color)
+{
+        if (Xstart < 0)
+                Xstart = 0;
+        if (Ystart < 0)
+                Ystart = 0;
+        if (Xend > Paint.Width)
+                Xend = Paint.Width;
+        if (Yend > Paint.Height)
+                Yend = Paint.Height;
+        if (Xstart >= Xend || Ystart >= Yend)
+                return;
+
+        // Rotation and mirroring map axis-aligned rectangles onto axis-aligned
+        // rectangles, hence it is enough to map the two opposite corners.
+        UWORD X1, Y1, X2, Y2;
+        if (!Paint_MapToMemory(Xstart, Ystart, &X1, &Y1) ||
+            !Paint_MapToMemory(Xend - 1, Yend - 1, &X2, &Y2)) {
+                return;
+        }
+
+        LCD_FillWindow(X1 < X2 ? X1 : X2, Y1 < Y2 ? Y1 : Y2,
+                       X1 < X2 ? X2 : X1, Y1 < Y2 ? Y2 : Y1, Color);
+}
+
+void Paint_FillWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
+                      UWORD Color)
+{
+        Paint_FillRegion(Xstart, Ystart, Xend, Yend, Color);
+}
+
+/******************************************************************************
+  function: Stream a block of pixels into a single LCD window
+  parameter:
+    xStart  :   X starting point
+    yStart  :   Y starting point
+    Width   :   Width of the block, it needs to fit into the image
+    Height  :   Height of the block, it needs to fit into the image
+    Pixel   :   Returns the color of the pixel at the given offset from the
+                top-left corner of the block
+    Source  :   Passed along to Pixel
+  info:
+    The order in which the pixels are requested depends on how the image
+    rotation and mirroring map the image axes onto the LCD memory rows and
+    columns. The pixels are collected in a line buffer that is sent to the
+    LCD each time it fills up.
+******************************************************************************/
+typedef UWORD (*Paint_PixelSource)(const void *Source, UWORD X, UWORD Y);
+
+static void Paint_StreamBlock(UWORD xStart, UWORD yStart, UWORD Width,
+                              UWORD Height, Paint_PixelSource Pixel,
+                              const void *Source)
+{
+        UWORD X0, Y0, X1, Y1, Xx, Yx;
+        if (!Paint_MapToMemory(xStart, yStart, &X0, &Y0) ||
+            !Paint_MapToMemory(xStart + Width - 1, yStart + Height - 1, &X1,
+                               &Y1) ||
+            !Paint_MapToMemory(xStart + 1, yStart, &Xx, &Yx)) {
+                return;
+        }
+
+        // Work out which image axis runs along the LCD memory rows and in
+        // which direction both image axes run.
+        bool x_along_columns = Yx == Y0;
+        bool x_ascending = x_along_columns ? Xx > X0 : Yx > Y0;
+        bool y_ascending = x_along_columns ? Y1 >= Y0 : X1 >= X0;
+        UWORD Columns = x_along_columns ? Width : Height;
+        UWORD Rows = x_along_columns ? Height : Width;
+
+        UWORD buffer[DEV_SPI_BUF_SIZE / 2];
+        UWORD buffered = 0;
+
+        LCD_BeginPixelStream(X0 < X1 ? X0 : X1, Y0 < Y1 ? Y0 : Y1,
+                             X0 < X1 ? X1 : X0, Y0 < Y1 ? Y1 : Y0);
+        for (UWORD Row = 0; Row < Rows; Row++) {
+                for (UWORD Column = 0; Column < Columns; Column++) {
+                        UWORD i = x_along_columns ? Column : Row;
+                        UWORD j = x_along_columns ? Row : Column;
+                        if (!x_ascending)
+                                i = Width - 1 - i;
+                        if (!y_ascending)
+                                j = Height - 1 - j;
+
+                        buffer[buffered++] = Pixel(Source, i, j);
+                        if (buffered == DEV_SPI_BUF_SIZE / 2) {
+                                LCD_PushWords(buffer, buffered);
+                                buffered = 0;
+                        }
+                }
+        }
+        LCD_PushWords(buffer, buffered);
+        LCD_EndPixelStream();
+}
+
 /******************************************************************************
   function: Clear the color of the picture
   parameter:
@@ -177,13 +304,7 @@ void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
 ******************************************************************************/
 void Paint_Clear(UWORD Color)
 {
-        LCD_SetCursor(0, 0, Paint.WidthByte - 1, Paint.HeightByte - 1);
-        for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
-                for (UWORD X = 0; X < Paint.WidthByte;
-                     X++) { // 8 pixel =  1 byte
-                        LCD_WriteData_Word(Color);
-                }
-        }
+        LCD_FillWindow(0, 0, Paint.WidthByte - 1, Paint.HeightByte - 1, Color);
 }
 
 /******************************************************************************
@@ -197,12 +318,7 @@ void Paint_Clear(UWORD Color)
 void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
                         UWORD Color)
 {
-        UWORD X, Y;
-        for (Y = Ystart; Y < Yend; Y++) {
-                for (X = Xstart; X < Xend; X++) { // 8 pixel =  1 byte
-                        Paint_SetPixel(X, Y, Color);
-                }
-        }
+        Paint_FillWindow(Xstart, Ystart, Xend, Yend, Color);
 }
 
 /******************************************************************************
@@ -222,29 +338,26 @@ void Paint_DrawPoint(UWORD Xpoint, UWORD Ypoint, UWORD Color,
                 return;
         }
 
-        int16_t XDir_Num, YDir_Num;
+        if (Dot_Pixel == DOT_PIXEL_1X1 && Dot_FillWay != DOT_FILL_AROUND) {
+                Paint_SetPixel(Xpoint - 1, Ypoint - 1, Color);
+                return;
+        }
+
         if (Dot_FillWay == DOT_FILL_AROUND) {
-                for (XDir_Num = 0; XDir_Num < 2 * Dot_Pixel - 1; XDir_Num++) {
-                        for (YDir_Num = 0; YDir_Num < 2 * Dot_Pixel - 1;
-                             YDir_Num++) {
-                                if (Xpoint + XDir_Num - Dot_Pixel < 0 ||
-                                    Ypoint + YDir_Num - Dot_Pixel < 0)
-                                        break;
-                                // printf("x = %d, y = %d\r\n", Xpoint +
-                                // XDir_Num - Dot_Pixel, Ypoint + YDir_Num -
-                                // Dot_Pixel);
-                                Paint_SetPixel(Xpoint + XDir_Num - Dot_Pixel,
-                                               Ypoint + YDir_Num - Dot_Pixel,
-                                               Color);
-                        }
-                }
+                // The original point-by-point implementation bailed out of
+                // each column as soon as it reached a negative Y coordinate,
+                // which meant that points closer to the top edge than their
+                // size were not drawn at all. We preserve that behaviour.
+                if (Ypoint < Dot_Pixel)
+                        return;
+                Paint_FillRegion((int32_t)Xpoint - Dot_Pixel,
+                                 (int32_t)Ypoint - Dot_Pixel,
+                                 (int32_t)Xpoint + Dot_Pixel - 1,
+                                 (int32_t)Ypoint + Dot_Pixel - 1, Color);
         } else {
-                for (XDir_Num = 0; XDir_Num < Dot_Pixel; XDir_Num++) {
-                        for (YDir_Num = 0; YDir_Num < Dot_Pixel; YDir_Num++) {
-                                Paint_SetPixel(Xpoint + XDir_Num - 1,
-                                               Ypoint + YDir_Num - 1, Color);
-                        }
-                }
+                Paint_FillRegion((int32_t)Xpoint - 1, (int32_t)Ypoint - 1,
+                                 (int32_t)Xpoint + Dot_Pixel - 1,
+                                 (int32_t)Ypoint + Dot_Pixel - 1, Color);
         }
 }
 
@@ -327,11 +440,17 @@ void Paint_DrawRectangle(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
         }
 
         if (Filled) {
-                UWORD Ypoint;
-                for (Ypoint = Ystart; Ypoint < Yend; Ypoint++) {
-                        Paint_DrawLine(Xstart, Ypoint, Xend, Ypoint, Color,
-                                       Line_width, LINE_STYLE_SOLID);
-                }
+                // This used to draw one horizontal line for each Ypoint in
+                // [Ystart, Yend) where each line point covered a Line_width
+                // sized square to the right and down of (x - 1, y - 1). The
+                // union of those squares is filled in one go instead.
+                if (Ystart >= Yend)
+                        return;
+                UWORD Xmin = Xstart < Xend ? Xstart : Xend;
+                UWORD Xmax = Xstart < Xend ? Xend : Xstart;
+                Paint_FillRegion((int32_t)Xmin - 1, (int32_t)Ystart - 1,
+                                 (int32_t)Xmax + Line_width - 1,
+                                 (int32_t)Yend + Line_width - 2, Color);
         } else {
                 Paint_DrawLine(Xstart, Ystart, Xend, Ystart, Color, Line_width,
                                LINE_STYLE_SOLID);
@@ -448,63 +567,107 @@ void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius, UWORD Color,
 }
 
 /******************************************************************************
-  function: Show English characters
+  function: Glyph pixels of a run of characters drawn next to each other
+  info:
+    The font tables store each glyph as a packed plane of Width * Height bits
+    (see fonts/font_packing.h).
+******************************************************************************/
+typedef struct {
+        const char *String;
+        sFONT *Font;
+        UWORD Color_Background;
+        UWORD Color_Foreground;
+} PAINT_GLYPHS;
+
+static bool Paint_GlyphBit(const PAINT_GLYPHS *Glyphs, UWORD X, UWORD Y)
+{
+        sFONT *Font = Glyphs->Font;
+        UWORD Glyph_Size = (Font->Width * Font->Height + 7) / 8;
+        const unsigned char *ptr =
+            &Font->table[(Glyphs->String[X / Font->Width] - ' ') * Glyph_Size];
+        UDOUBLE Bit = (UDOUBLE)Y * Font->Width + X % Font->Width;
+        return pgm_read_byte(ptr + Bit / 8) & (0x80 >> (Bit % 8));
+}
+
+static UWORD Paint_GlyphPixel(const void *Source, UWORD X, UWORD Y)
+{
+        const PAINT_GLYPHS *Glyphs = (const PAINT_GLYPHS *)Source;
+        return Paint_GlyphBit(Glyphs, X, Y) ? Glyphs->Color_Foreground
+                                            : Glyphs->Color_Background;
+}
+
+/******************************************************************************
+  function: Show a run of English characters on a single line
   parameter:
     Xpoint           ：X coordinate
     Ypoint           ：Y coordinate
-    Acsii_Char       ：To display the English characters
+    pString          ：The characters to display
+    Count            ：Number of characters to display
     Font             ：A structure pointer that displays a character size
     Color_Background : Select the background color of the English character
     Color_Foreground : Select the foreground color of the English character
+  info:
+    With an opaque background the whole run is sent as a single LCD window.
+    If the background matches FONT_BACKGROUND, it is left untouched and each
+    horizontal run of foreground pixels is filled as a window instead. The
+    part of the run that sticks out of the image is not drawn.
 ******************************************************************************/
-void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
-                    sFONT *Font, UWORD Color_Background, UWORD Color_Foreground)
+static void Paint_DrawGlyphs(UWORD Xpoint, UWORD Ypoint, const char *pString,
+                             UWORD Count, sFONT *Font, UWORD Color_Background,
+                             UWORD Color_Foreground)
 {
+        if (Xpoint >= Paint.Width || Ypoint >= Paint.Height) {
+                return;
+        }
+        UDOUBLE Width = (UDOUBLE)Count * Font->Width;
+        UDOUBLE Height = Font->Height;
+        if (Xpoint + Width > Paint.Width)
+                Width = Paint.Width - Xpoint;
+        if (Ypoint + Height > Paint.Height)
+                Height = Paint.Height - Ypoint;
+        if (Width == 0 || Height == 0)
+                return;
 
-        UWORD Page, Column;
-
-        if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
-                // Debug("Paint_DrawChar Input exceeds the normal display
-                // range\r\n");
+        PAINT_GLYPHS Glyphs = {pString, Font, Color_Background,
+                               Color_Foreground};
+        if (FONT_BACKGROUND != Color_Background) {
+                Paint_StreamBlock(Xpoint, Ypoint, Width, Height,
+                                  Paint_GlyphPixel, &Glyphs);
                 return;
         }
-        uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height *
-                               (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
-        const unsigned char *ptr = &Font->table[Char_Offset];
-
-        for (Page = 0; Page < Font->Height; Page++) {
-                for (Column = 0; Column < Font->Width; Column++) {
-
-                        // To determine whether the font background color and
-                        // screen background color is consistent
-                        if (FONT_BACKGROUND ==
-                            Color_Background) { // this process is to speed up
-                                                // the scan
-                                if (pgm_read_byte(ptr) & (0x80 >> (Column % 8)))
-                                        Paint_SetPixel(Xpoint + Column,
-                                                       Ypoint + Page,
-                                                       Color_Foreground);
-                        } else {
-                                if (pgm_read_byte(ptr) &
-                                    (0x80 >> (Column % 8))) {
-                                        Paint_SetPixel(Xpoint + Column,
-                                                       Ypoint + Page,
-                                                       Color_Foreground);
-                                } else {
-                                        Paint_SetPixel(Xpoint + Column,
-                                                       Ypoint + Page,
-                                                       Color_Background);
-                                }
-                        }
-                        // One pixel is 8 bits
-                        if (Column % 8 == 7) {
-                                ptr++;
+
+        for (UWORD Y = 0; Y < Height; Y++) {
+                UWORD Run_Start = 0;
+                bool In_Run = false;
+                for (UWORD X = 0; X <= Width; X++) {
+                        bool Set = X < Width && Paint_GlyphBit(&Glyphs, X, Y);
+                        if (Set && !In_Run) {
+                                Run_Start = X;
+                        } else if (!Set && In_Run) {
+                                Paint_FillRegion(Xpoint + Run_Start, Ypoint + Y,
+                                                 Xpoint + X, Ypoint + Y + 1,
+                                                 Color_Foreground);
                         }
-                } /* Write a line */
-                if (Font->Width % 8 != 0) {
-                        ptr++;
+                        In_Run = Set;
                 }
-        } /* Write all */
+        }
+}
+
+/******************************************************************************
+  function: Show English characters
+  parameter:
+    Xpoint           ：X coordinate
+    Ypoint           ：Y coordinate
+    Acsii_Char       ：To display the English characters
+    Font             ：A structure pointer that displays a character size
+    Color_Background : Select the background color of the English character
+    Color_Foreground : Select the foreground color of the English character
+******************************************************************************/
+void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
+                    sFONT *Font, UWORD Color_Background, UWORD Color_Foreground)
+{
+        Paint_DrawGlyphs(Xpoint, Ypoint, &Acsii_Char, 1, Font, Color_Background,
+                         Color_Foreground);
 }
 
 /******************************************************************************
@@ -516,6 +679,9 @@ void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
     Font             ：A structure pointer that displays a character size
     Color_Background : Select the background color of the English character
     Color_Foreground : Select the foreground color of the English character
+  info:
+    Characters that end up on the same line are drawn together, see
+    Paint_DrawGlyphs.
 ******************************************************************************/
 void Paint_DrawString_EN(UWORD Xstart, UWORD Ystart, const char *pString,
                          sFONT *Font, UWORD Color_Background,
@@ -543,15 +709,18 @@ void Paint_DrawString_EN(UWORD Xstart, UWORD Ystart, const char *pString,
                         Xpoint = Xstart;
                         Ypoint = Ystart;
                 }
-                Paint_DrawChar(Xpoint, Ypoint, *pString, Font, Color_Background,
-                               Color_Foreground);
 
-                // The next character of the address
-                pString++;
+                // Take all following characters that fit on the same line.
+                UWORD Count = 1;
+                while (pString[Count] != '\0' &&
+                       Xpoint + (Count + 1) * Font->Width <= Paint.Width) {
+                        Count++;
+                }
+                Paint_DrawGlyphs(Xpoint, Ypoint, pString, Count, Font,
+                                 Color_Background, Color_Foreground);
 
-                // The next word of the abscissa increases the font of the
-                // broadband
-                Xpoint += Font->Width;
+                pString += Count;
+                Xpoint += Count * Font->Width;
         }
 }
 
@@ -767,6 +936,22 @@ void Paint_DrawTime(UWORD Xstart, UWORD Ystart, PAINT_TIME *pTime, sFONT *Font,
                        Color_Background, Color_Foreground);
 }
 
+typedef struct {
+        const unsigned char *Data;
+        UWORD Width;
+} PAINT_IMAGE;
+
+static UWORD Paint_ImagePixel(const void *Source, UWORD X, UWORD Y)
+{
+        const PAINT_IMAGE *Image = (const PAINT_IMAGE *)Source;
+        // Using arrays is a property of sequential storage,
+        // accessing the original array by algorithm j*W_Image*2
+        // Y offset i*2                  X offset
+        const unsigned char *pixel =
+            Image->Data + (UDOUBLE)Y * Image->Width * 2 + X * 2;
+        return pgm_read_byte(pixel + 1) << 8 | pgm_read_byte(pixel);
+}
+
 /******************************************************************************
   function: Display image
   parameter:
@@ -775,28 +960,71 @@ void Paint_DrawTime(UWORD Xstart, UWORD Ystart, PAINT_TIME *pTime, sFONT *Font,
     yStart           : Y starting coordinates
     xEnd             ：Image width
     yEnd             : Image height
+  info:
+    The image is stored row by row with two bytes per pixel (low byte first).
+    The visible part of the image is streamed into a single LCD window, the
+    order in which the pixels are read depends on how the image rotation and
+    mirroring map the image axes onto the LCD memory rows and columns.
 ******************************************************************************/
 void Paint_DrawImage(const unsigned char *image, UWORD xStart, UWORD yStart,
                      UWORD W_Image, UWORD H_Image)
 {
-        int i, j;
-        for (j = 0; j < H_Image; j++) {
-                for (i = 0; i < W_Image; i++) {
-                        if (xStart + i < LCD_WIDTH &&
-                            yStart + j <
-                                LCD_HEIGHT) // Exceeded part does not display
-                                Paint_SetPixel(
-                                    xStart + i, yStart + j,
-                                    (pgm_read_byte(
-                                        image + j * W_Image * 2 + i * 2 +
-                                        1)) << 8 |
-                                        (pgm_read_byte(image + j * W_Image * 2 +
-                                                       i * 2)));
-                        // Using arrays is a property of sequential storage,
-                        // accessing the original array by algorithm j*W_Image*2
-                        // Y offset i*2                  X offset
-                        // pgm_read_byte()
-                }
-        }
+        // Exceeded part does not display
+        UWORD Width = W_Image;
+        UWORD Height = H_Image;
+        if (xStart >= Paint.Width || yStart >= Paint.Height)
+                return;
+        if (xStart + Width > Paint.Width)
+                Width = Paint.Width - xStart;
+        if (yStart + Height > Paint.Height)
+                Height = Paint.Height - yStart;
+        if (Width == 0 || Height == 0)
+                return;
+
+        PAINT_IMAGE Image = {image, W_Image};
+        Paint_StreamBlock(xStart, yStart, Width, Height, Paint_ImagePixel,
+                          &Image);
+}
+
+typedef struct {
+        const UWORD *Data;
+        UWORD Stride;
+} PAINT_PIXELS;
+
+static UWORD Paint_WordPixel(const void *Source, UWORD X, UWORD Y)
+{
+        const PAINT_PIXELS *Pixels = (const PAINT_PIXELS *)Source;
+        return Pixels->Data[(UDOUBLE)Y * Pixels->Stride + X];
+}
+
+/******************************************************************************
+  function: Display a block of pixels composited in RAM
+  parameter:
+    pixels           : Colors of the pixels
+    xStart           : X starting coordinates
+    yStart           : Y starting coordinates
+    Width            : Width of the block
+    Height           : Height of the block
+    Stride           : Number of pixels from the start of one row of the block
+                       to the next one
+  info:
+    Same as Paint_DrawImage, but the pixels are stored as native words, which
+    allows the block to be a part of a larger buffer in RAM.
+******************************************************************************/
+void Paint_DrawPixels(const UWORD *pixels, UWORD xStart, UWORD yStart,
+                      UWORD Width, UWORD Height, UWORD Stride)
+{
+        if (xStart >= Paint.Width || yStart >= Paint.Height)
+                return;
+        if (xStart + Width > Paint.Width)
+                Width = Paint.Width - xStart;
+        if (yStart + Height > Paint.Height)
+                Height = Paint.Height - yStart;
+        if (Width == 0 || Height == 0)
+                return;
+
+        PAINT_PIXELS Pixels = {pixels, Stride};
+        Paint_StreamBlock(xStart, yStart, Width, Height, Paint_WordPixel,
+                          &Pixels);
 }
 #endif
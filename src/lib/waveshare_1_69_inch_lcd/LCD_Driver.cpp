@@ -232,13 +232,7 @@ parameter :
     Color :   The color you want to clear all the screen
 ******************************************************************************/
 void LCD_Clear(UWORD Color) {
-  UWORD i, j;
-  LCD_SetCursor(0, 0, LCD_WIDTH, LCD_HEIGHT);
-  for (i = 0; i < LCD_WIDTH; i++) {
-    for (j = 0; j < LCD_HEIGHT; j++) {
-      LCD_WriteData_Word(Color);
-    }
-  }
+  LCD_FillWindow(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1, Color);
 }
 
 /******************************************************************************
@@ -246,18 +240,14 @@ function: Refresh a certain area to the same color
 parameter :
     Xstart:   Start UWORD x coordinate
     Ystart:   Start UWORD y coordinate
-    Xend  :   End UWORD coordinates
-    Yend  :   End UWORD coordinates
+    Xend  :   End UWORD coordinates (exclusive)
+    Yend  :   End UWORD coordinates (exclusive)
     color :   Set the color
 ******************************************************************************/
 void LCD_ClearWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD color) {
-  UWORD i, j;
-  LCD_SetCursor(Xstart, Ystart, Xend, Yend);
-  for (i = Ystart; i < Yend; i++) {
-    for (j = Xstart; j < Xend; j++) {
-      LCD_WriteData_Word(color);
-    }
-  }
+  if (Xend <= Xstart || Yend <= Ystart)
+    return;
+  LCD_FillWindow(Xstart, Ystart, Xend - 1, Yend - 1, color);
 }
 
 /******************************************************************************
@@ -274,6 +264,106 @@ void LCD_SetWindowColor(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWOR
   LCD_WriteData_Word(Color);
 }
 
+/******************************************************************************
+function: Start streaming pixels into a window
+parameter :
+    Xstart:   Start UWORD x coordinate
+    Ystart:   Start UWORD y coordinate
+    Xend  :   End UWORD x coordinate (inclusive)
+    Yend  :   End UWORD y coordinate (inclusive)
+info :
+    Sets the address window, asserts CS and DC and begins a single SPI
+    transaction that stays open until LCD_EndPixelStream is called. In the
+    meantime LCD_PushColor and LCD_PushWords can be used to send the pixels,
+    which are written row by row starting at (Xstart, Ystart). Nothing else
+    may be sent to the LCD while the stream is open.
+******************************************************************************/
+void LCD_BeginPixelStream(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend) {
+  LCD_SetCursor(Xstart, Ystart, Xend, Yend);
+
+  DEV_Digital_Write(DEV_CS_PIN, 0);
+  DEV_Digital_Write(DEV_DC_PIN, 1);
+  DEV_SPI_BEGIN_TRANSACTION();
+}
+
+/******************************************************************************
+function: Stream the same color count times
+parameter :
+    Color :   Set the color
+    count :   Number of pixels to send
+******************************************************************************/
+void LCD_PushColor(UWORD Color, UDOUBLE count) {
+  UBYTE buffer[DEV_SPI_BUF_SIZE];
+  UDOUBLE chunk_words = DEV_SPI_BUF_SIZE / 2;
+
+  while (count > 0) {
+    UDOUBLE words = count < chunk_words ? count : chunk_words;
+    // The buffer needs to be refilled before each transfer as block SPI
+    // transfers can overwrite it with the data read back from the bus.
+    for (UDOUBLE i = 0; i < words; i++) {
+      buffer[2 * i] = (Color >> 8) & 0xff;
+      buffer[2 * i + 1] = Color & 0xff;
+    }
+    DEV_SPI_WRITE_BUF(buffer, words * 2);
+    count -= words;
+  }
+}
+
+/******************************************************************************
+function: Stream a buffer of pixels
+parameter :
+    data  :   RGB565 colors in the native byte order
+    count :   Number of pixels to send
+******************************************************************************/
+void LCD_PushWords(const UWORD *data, UDOUBLE count) {
+  UBYTE buffer[DEV_SPI_BUF_SIZE];
+  UDOUBLE chunk_words = DEV_SPI_BUF_SIZE / 2;
+
+  while (count > 0) {
+    UDOUBLE words = count < chunk_words ? count : chunk_words;
+    // The LCD expects the colors big-endian.
+    for (UDOUBLE i = 0; i < words; i++) {
+      buffer[2 * i] = (data[i] >> 8) & 0xff;
+      buffer[2 * i + 1] = data[i] & 0xff;
+    }
+    DEV_SPI_WRITE_BUF(buffer, words * 2);
+    data += words;
+    count -= words;
+  }
+}
+
+/******************************************************************************
+function: Finish the pixel stream started by LCD_BeginPixelStream
+******************************************************************************/
+void LCD_EndPixelStream(void) {
+  DEV_SPI_END_TRANSACTION();
+  DEV_Digital_Write(DEV_CS_PIN, 1);
+}
+
+/******************************************************************************
+function: Fill a window with a single color
+parameter :
+    Xstart:   Start UWORD x coordinate
+    Ystart:   Start UWORD y coordinate
+    Xend  :   End UWORD x coordinate (inclusive)
+    Yend  :   End UWORD y coordinate (inclusive)
+    Color :   Set the color
+info :
+    The address window is set only once and all (Xend - Xstart + 1) *
+    (Yend - Ystart + 1) pixels are then streamed inside of a single SPI
+    transaction with CS held low. Compared to calling LCD_SetUWORD for each
+    pixel this saves the CASET/RASET/RAMWR preamble (11 transfers) and a CS
+    toggle per pixel.
+******************************************************************************/
+void LCD_FillWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color) {
+  if (Xend < Xstart || Yend < Ystart)
+    return;
+
+  LCD_BeginPixelStream(Xstart, Ystart, Xend, Yend);
+  LCD_PushColor(Color, (UDOUBLE)(Xend - Xstart + 1) * (Yend - Ystart + 1));
+  LCD_EndPixelStream();
+}
+
 /******************************************************************************
 function: Draw a UWORD
 parameter :
@@ -45,6 +45,13 @@ void LCD_WriteReg(UBYTE da);
 
 void LCD_SetCursor(UWORD x1, UWORD y1, UWORD x2, UWORD y2);
 void LCD_SetUWORD(UWORD x, UWORD y, UWORD Color);
+void LCD_FillWindow(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend,
+                    UWORD Color);
+
+void LCD_BeginPixelStream(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend);
+void LCD_PushColor(UWORD Color, UDOUBLE count);
+void LCD_PushWords(const UWORD *data, UDOUBLE count);
+void LCD_EndPixelStream(void);
 
 void LCD_Init(void);
 void LCD_SetBacklight(UWORD Value);
@@ -1,4 +1,5 @@
-#if defined(WAVESHARE_1_69_INCH_LCD)
+#if defined(WAVESHARE_1_69_INCH_LCD) || defined(WAVESHARE_2_4_INCH_LCD) || \
+    defined(EMULATOR)
 /**
   ******************************************************************************
   * @file    font16.c
@@ -38,11 +39,13 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "fonts.h"
+#include "font_packing.h"
 //
 //  Font data for Courier New 12pt
 //
 
-const unsigned char Font16_Table[] PROGMEM =
+/* The original, byte-padded rows, only used at compile time. */
+static constexpr uint8_t Font16_Rows[] =
 {
   // @0 ' ' (11 pixels wide)
   0x00, 0x00, //
@@ -1755,8 +1758,11 @@ const unsigned char Font16_Table[] PROGMEM =
   0x00, 0x00, //
 };
 
+static constexpr PackedFont<11, 16, sizeof(Font16_Rows)> Font16_Table PROGMEM =
+  pack_font_glyphs<11, 16>(Font16_Rows);
+
 sFONT Font16 = {
-  Font16_Table,
+  Font16_Table.data(),
   11, /* Width */
   16, /* Height */
 };
@@ -38,9 +38,11 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "fonts.h"
+#include "font_packing.h"
 
 // Character bitmaps for Courier New 15pt
-const uint8_t Font20_Table[] PROGMEM =
+/* The original, byte-padded rows, only used at compile time. */
+static constexpr uint8_t Font20_Rows[] =
 {
   // @0 ' ' (14 pixels wide)
   0x00, 0x00, //
@@ -2134,8 +2136,11 @@ const uint8_t Font20_Table[] PROGMEM =
 };
 
 
+static constexpr PackedFont<14, 20, sizeof(Font20_Rows)> Font20_Table PROGMEM =
+  pack_font_glyphs<14, 20>(Font20_Rows);
+
 sFONT Font20 = {
-  Font20_Table,
+  Font20_Table.data(),
   14, /* Width */
   20, /* Height */
 };
@@ -1,4 +1,5 @@
-#if defined(WAVESHARE_1_69_INCH_LCD)
+#if defined(WAVESHARE_1_69_INCH_LCD) || defined(WAVESHARE_2_4_INCH_LCD) || \
+    defined(EMULATOR)
 /**
   ******************************************************************************
   * @file    font24.c
@@ -38,8 +39,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "fonts.h"
+#include "font_packing.h"
 
-const uint8_t Font24_Table [] PROGMEM =
+/* The original, byte-padded rows, only used at compile time. */
+static constexpr uint8_t Font24_Rows[] =
 {
   // @0 ' ' (17 pixels wide)
   0x00, 0x00, 0x00, //
@@ -2512,8 +2515,11 @@ const uint8_t Font24_Table [] PROGMEM =
   0x00, 0x00, 0x00, //
 };
 
+static constexpr PackedFont<17, 24, sizeof(Font24_Rows)> Font24_Table PROGMEM =
+  pack_font_glyphs<17, 24>(Font24_Rows);
+
 sFONT Font24 = {
-  Font24_Table,
+  Font24_Table.data(),
   17, /* Width */
   24, /* Height */
 };
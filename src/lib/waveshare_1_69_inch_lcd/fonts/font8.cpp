@@ -1,4 +1,5 @@
-#if defined(WAVESHARE_1_69_INCH_LCD)
+#if defined(WAVESHARE_1_69_INCH_LCD) || defined(WAVESHARE_2_4_INCH_LCD) || \
+    defined(EMULATOR)
 /**
   ******************************************************************************
   * @file    Font8.c
@@ -38,12 +39,14 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "fonts.h"
+#include "font_packing.h"
 
 //
 //  Font data for Courier New 12pt
 //
 
-const uint8_t Font8_Table[] PROGMEM =
+/* The original, byte-padded rows, only used at compile time. */
+static constexpr uint8_t Font8_Rows[] =
 {
   // @0 ' ' (5 pixels wide)
   0x00, //
@@ -996,8 +999,11 @@ const uint8_t Font8_Table[] PROGMEM =
   0x00, //
 };
 
+static constexpr PackedFont<5, 8, sizeof(Font8_Rows)> Font8_Table PROGMEM =
+  pack_font_glyphs<5, 8>(Font8_Rows);
+
 sFONT Font8 = {
-  Font8_Table,
+  Font8_Table.data(),
   5, /* Width */
   8, /* Height */
 };
@@ -0,0 +1,70 @@
+#if defined(WAVESHARE_1_69_INCH_LCD) || defined(WAVESHARE_2_4_INCH_LCD) || \
+    defined(EMULATOR)
+#ifndef __FONT_PACKING_H
+#define __FONT_PACKING_H
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The font tables below are written down in the layout of the original
+ * STMicroelectronics fonts: each row of a glyph is padded to whole bytes. For
+ * drawing, the glyphs are converted at compile time into a packed layout where
+ * the pixels of a glyph form a single 1-bit plane: row after row without any
+ * padding, most significant bit first, each glyph starting at a byte boundary.
+ * Apart from saving up to a third of the flash taken up by the fonts, this
+ * lets the drawing routines walk a glyph (or a whole string) with a single
+ * running bit index when expanding it into pixels.
+ */
+
+/**
+ * Number of bytes taken up by a glyph in the packed layout.
+ */
+constexpr size_t packed_glyph_size(uint16_t width, uint16_t height)
+{
+        return ((size_t)width * height + 7) / 8;
+}
+
+/**
+ * Number of bytes taken up by a row of a glyph in the original layout.
+ */
+constexpr size_t padded_row_size(uint16_t width) { return (width + 7) / 8; }
+
+template <uint16_t Width, uint16_t Height, size_t TableSize>
+using PackedFont =
+    std::array<uint8_t, TableSize / (Height * padded_row_size(Width)) *
+                            packed_glyph_size(Width, Height)>;
+
+/**
+ * Converts a font table from the original layout into the packed layout.
+ */
+template <uint16_t Width, uint16_t Height, size_t TableSize>
+constexpr PackedFont<Width, Height, TableSize>
+pack_font_glyphs(const uint8_t (&table)[TableSize])
+{
+        PackedFont<Width, Height, TableSize> packed{};
+        size_t glyphs = TableSize / (Height * padded_row_size(Width));
+        for (size_t glyph = 0; glyph < glyphs; glyph++) {
+                const uint8_t *rows =
+                    table + glyph * Height * padded_row_size(Width);
+                size_t packed_start = glyph * packed_glyph_size(Width, Height);
+                size_t bit = 0;
+                for (size_t row = 0; row < Height; row++) {
+                        for (size_t column = 0; column < Width; column++) {
+                                size_t offset =
+                                    row * padded_row_size(Width) + column / 8;
+                                uint8_t byte = rows[offset];
+                                if (byte & (0x80 >> (column % 8))) {
+                                        packed[packed_start + bit / 8] |=
+                                            0x80 >> (bit % 8);
+                                }
+                                bit++;
+                        }
+                }
+        }
+        return packed;
+}
+
+#endif /* __FONT_PACKING_H */
+#endif
@@ -1,4 +1,5 @@
-#if defined(WAVESHARE_1_69_INCH_LCD)
+#if defined(WAVESHARE_1_69_INCH_LCD) || defined(WAVESHARE_2_4_INCH_LCD) || \
+    defined(EMULATOR)
 /**
   ******************************************************************************
   * @file    fonts.h
@@ -52,10 +53,18 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#if !defined(EMULATOR) || defined(WAVESHARE_1_69_INCH_LCD)
 #include <avr/pgmspace.h>
+#elif !defined(PROGMEM)
+/* The emulator keeps the font tables in regular memory. */
+#define PROGMEM
+#endif
 //ASCII
 typedef struct _tFont
 {
+  /* Glyphs from ' ' onwards, each one a packed 1-bit plane of Width * Height
+   * pixels: rows follow each other without padding, most significant bit
+   * first and every glyph starts at a byte boundary (see font_packing.h). */
   const uint8_t *table;
   uint16_t Width;
   uint16_t Height;
@@ -89,7 +98,6 @@ extern sFONT Font8;
 
 extern cFONT Font12CN;
 extern cFONT Font24CN;
-extern const unsigned char Font16_Table[];
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,7 @@
 #include "common/color.hpp"
 #include "common/constants.hpp"
 #include "common/thumbnail.hpp"
+#include "common/thumbnail_cache.hpp"
 
 #include "games/minesweeper.hpp"
 #include "games/pong.hpp"
@@ -62,8 +63,7 @@ std::optional<UserAction> select_app_and_run(const Platform &p)
             "current option. Press the right button to start the game";
         if (maybe_interrupt.has_value() &&
             maybe_interrupt.value() == UserAction::ShowHelp) {
-                render_wrapped_help_text(p, c, help_text);
-                return wait_until_green_pressed(p);
+                return show_wrapped_help_text(p, c, help_text);
         }
 
         // This is needed to handle the 'close window' action.
@@ -130,6 +130,13 @@ void extract_app_selection(GameMenuConfiguration &menu_configuration,
  */
 static std::optional<Game> last_selected_game = std::nullopt;
 
+/**
+ * The thumbnails of the main menu carousel are rendered once and then kept
+ * around as sprites across the visits of the main menu, the list of games
+ * shown in the carousel never changes so the option indices are stable keys.
+ */
+static ThumbnailCache thumbnail_cache;
+
 template <typename GameExecutor>
 std::unique_ptr<ThumbnailRenderer> simple_name_renderer()
 {
@@ -226,7 +233,7 @@ main_menu_interaction_loop(const Platform &p,
                 maybe_interrupt =
                     collect_configuration_single_option_with_thumbnails(
                         p, customization, option, "MicroBox", renderers, false,
-                        true);
+                        true, &thumbnail_cache);
         } else {
                 maybe_interrupt = collect_configuration(
                     p, *config, customization, false, true);
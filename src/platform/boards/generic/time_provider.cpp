@@ -5,4 +5,5 @@
 #include "Arduino.h"
 void ArduinoTimeProvider::delay_ms(int ms) const { delay(ms); }
 long ArduinoTimeProvider::milliseconds() const { return millis(); }
+long ArduinoTimeProvider::microseconds() const { return micros(); }
 #endif
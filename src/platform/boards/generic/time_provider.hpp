@@ -6,5 +6,6 @@ class ArduinoTimeProvider : public TimeProvider
 {
         void delay_ms(int ms) const override;
         long milliseconds() const override;
+        long microseconds() const override;
 };
 #endif
@@ -2,9 +2,20 @@
 #include "lcd_display_1_69_inch.hpp"
 #include "../../../lib/waveshare_1_69_inch_lcd/GUI_Paint.h"
 #include "../../../lib/waveshare_1_69_inch_lcd/LCD_Driver.h"
+#include <algorithm>
 
 #define DISPLAY_CORNER_RADIUS 40
 #define SCREEN_BORDER_WIDTH 3
+
+void PaintRasterTarget::fill_clipped_rect(int x, int y, int w, int h,
+                                          uint16_t color)
+{
+        Paint_FillWindow(x, y, x + w, y + h, color);
+}
+
+// We use the width for the height as the display is mounted horizontally.
+LcdDisplay_1_69::LcdDisplay_1_69() : raster(LCD_HEIGHT, LCD_WIDTH) {}
+
 void LcdDisplay_1_69::setup() const
 {
         Config_Init();
@@ -25,10 +36,11 @@ void LcdDisplay_1_69::draw_rounded_border(Color color) const
         int rounding_radius = DISPLAY_CORNER_RADIUS;
         int margin = SCREEN_BORDER_WIDTH;
         int line_width = 2;
-        Point top_left_corner = {.x = rounding_radius + margin,
-                                 .y = rounding_radius + margin};
-        Point bottom_right_corner = {.x = LCD_HEIGHT - rounding_radius - margin,
-                                     .y = LCD_WIDTH - rounding_radius - margin};
+        IntPoint top_left_corner = {.x = rounding_radius + margin,
+                                    .y = rounding_radius + margin};
+        IntPoint bottom_right_corner = {
+            .x = LCD_HEIGHT - rounding_radius - margin,
+            .y = LCD_WIDTH - rounding_radius - margin};
 
         int x_positions[2] = {top_left_corner.x, bottom_right_corner.x};
         int y_positions[2] = {top_left_corner.y, bottom_right_corner.y};
@@ -103,17 +115,26 @@ void LcdDisplay_1_69::draw_rounded_border(Color color) const
             LCD_WIDTH - margin - line_width - 1, BLACK);
 };
 
-void LcdDisplay_1_69::draw_circle(Point center, int radius, Color color,
+void LcdDisplay_1_69::draw_circle(IntPoint center, int radius, Color color,
                                   int border_width, bool filled) const
 {
-        int filled_repr = filled ? DRAW_FILL_FULL : DRAW_FILL_EMPTY;
+        if (filled) {
+                // Same as `Paint_DrawCircle`, circles centered outside of the
+                // screen are not drawn at all.
+                if (center.x < 0 || center.y < 0 ||
+                    center.x > raster.get_width() ||
+                    center.y >= raster.get_height()) {
+                        return;
+                }
+                raster.fill_circle(center.x - 1, center.y - 1, radius, color);
+                return;
+        }
 
         Paint_DrawCircle(center.x, center.y, radius, color,
-                         static_cast<DOT_PIXEL>(border_width),
-                         static_cast<DRAW_FILL>(filled_repr));
+                         static_cast<DOT_PIXEL>(border_width), DRAW_FILL_EMPTY);
 };
 
-void LcdDisplay_1_69::draw_rectangle(Point start, int width, int height,
+void LcdDisplay_1_69::draw_rectangle(IntPoint start, int width, int height,
                                      Color color, int border_width,
                                      bool filled) const
 {
@@ -134,14 +155,40 @@ void LcdDisplay_1_69::draw_rectangle(Point start, int width, int height,
                             static_cast<DRAW_FILL>(filled_repr));
 };
 
-void LcdDisplay_1_69::draw_rounded_rectangle(Point start, int width, int height,
-                                             int radius, Color color) const
+void LcdDisplay_1_69::draw_rounded_rectangle(IntPoint start, int width,
+                                             int height, int radius,
+                                             Color color) const
 {
+        IntPoint top_left_corner = {.x = start.x + radius,
+                                    .y = start.y + radius};
 
-        Point top_left_corner = {.x = start.x + radius, .y = start.y + radius};
+        IntPoint bottom_right_corner = {.x = start.x + width - radius,
+                                        .y = start.y + height - radius};
 
-        Point bottom_right_corner = {.x = start.x + width - radius,
-                                     .y = start.y + height - radius};
+        /**
+         * The rectangle used to be drawn as four filled circles centered at
+         * the corners and three overlapping rectangles, i.e. most of its
+         * pixels were written several times and the circles pixel by pixel.
+         * The union of those shapes is a box grown by the radius plus a
+         * 1px column on the right of the straight part, which is what we
+         * send as spans. Shapes that the library would have partially
+         * rejected (sticking out of the screen or with the radius exceeding
+         * half of the size) keep the original rendering.
+         */
+        bool fits_on_screen = start.x >= 0 && start.y >= 0 &&
+                              start.x + width + 1 <= raster.get_width() &&
+                              start.y + height + 1 <= raster.get_height();
+        if (fits_on_screen && radius >= 0 && 2 * radius <= width &&
+            2 * radius <= height) {
+                raster.fill_rounded_box(
+                    top_left_corner.x - 1, top_left_corner.y - 1,
+                    bottom_right_corner.x - 1, bottom_right_corner.y - 1,
+                    radius, color);
+                raster.fill_rect(start.x + width, top_left_corner.y - 1, 1,
+                                 bottom_right_corner.y - top_left_corner.y,
+                                 color);
+                return;
+        }
 
         int x_positions[2] = {top_left_corner.x, bottom_right_corner.x};
         int y_positions[2] = {top_left_corner.y, bottom_right_corner.y};
@@ -168,14 +215,14 @@ void LcdDisplay_1_69::draw_rounded_rectangle(Point start, int width, int height,
                             color, DOT_PIXEL_1X1, DRAW_FILL_FULL);
 };
 
-void LcdDisplay_1_69::draw_line(Point start, Point end, Color color) const
+void LcdDisplay_1_69::draw_line(IntPoint start, IntPoint end, Color color) const
 {
         Paint_DrawLine(start.x, start.y, end.x, end.y, color, DOT_PIXEL_1X1,
                        LINE_STYLE_SOLID);
 }
 
 sFONT *map_font_size_1_69_specific(FontSize font_size);
-void LcdDisplay_1_69::draw_string(Point start, char *string_buffer,
+void LcdDisplay_1_69::draw_string(IntPoint start, char *string_buffer,
                                   FontSize font_size, Color bg_color,
                                   Color fg_color) const
 {
@@ -184,7 +231,7 @@ void LcdDisplay_1_69::draw_string(Point start, char *string_buffer,
                             fg_color);
 };
 
-void LcdDisplay_1_69::clear_region(Point top_left, Point bottom_right,
+void LcdDisplay_1_69::clear_region(IntPoint top_left, IntPoint bottom_right,
                                    Color clear_color) const
 
 {
@@ -195,8 +242,8 @@ void LcdDisplay_1_69::clear_region(Point top_left, Point bottom_right,
         // microcontrollers. For some reason it also starts about 1 pixel off
         // to the right so we need to decrease the starting point.
         int adj = 1;
-        Paint_ClearWindows(top_left.x - adj, top_left.y, bottom_right.x - adj,
-                           bottom_right.y - adj, clear_color);
+        Paint_FillWindow(top_left.x - adj, top_left.y, bottom_right.x - adj,
+                         bottom_right.y - adj, clear_color);
 };
 
 sFONT *map_font_size_1_69_specific(FontSize font_size)
@@ -251,6 +298,25 @@ void LcdDisplay_1_69::sleep() const
         // batteries) and so we don't need functionality to sleep the display.
 }
 
+void LcdDisplay_1_69::push_pixels(IntPoint top_left, int width, int height,
+                                  const uint16_t *pixels) const
+{
+        // Same adjustment as in `clear_region`, the first column of the
+        // screen falls outside of the paint image and gets clipped.
+        int adj = 1;
+        int x = top_left.x - adj;
+        int skipped = std::max(0, -x);
+        int y = std::max(0, top_left.y);
+        pixels += (y - top_left.y) * width + skipped;
+        int visible_width = width - skipped;
+        int visible_height = height - (y - top_left.y);
+        if (visible_width <= 0 || visible_height <= 0) {
+                return;
+        }
+        Paint_DrawPixels(pixels, x + skipped, y, visible_width, visible_height,
+                         width);
+}
+
 /**
  * Note that the Waveshare 1.69 inch LCD does not use the same display driver
  * as the 2.4 inch LCD, hence it is not copatible with the TFT_eSPI libarry and
@@ -1,7 +1,25 @@
 #if defined(WAVESHARE_1_69_INCH_LCD)
 #pragma once
+#include "../../../common/raster.hpp"
 #include "../../interface/display.hpp"
 
+/**
+ * Raster target that sends the spans produced by the shared rasterizer
+ * straight to the display memory, each span (or block of identical spans) is
+ * written as a single window fill.
+ */
+class PaintRasterTarget : public RasterTarget
+{
+      public:
+        PaintRasterTarget(int width, int height) : RasterTarget(width, height)
+        {
+        }
+
+      protected:
+        void fill_clipped_rect(int x, int y, int w, int h,
+                               uint16_t color) override;
+};
+
 /**
  * @brief LcdDisplay class that implements the Display interface for the
  * physical LCD display used in the game console.
@@ -13,6 +31,8 @@
 class LcdDisplay_1_69 : public Display
 {
       public:
+        LcdDisplay_1_69();
+
         /**
          * Performs the setup of the display. This is intended for performing
          * initialization of the modules that are responsible for driving the
@@ -46,32 +66,32 @@ class LcdDisplay_1_69 : public Display
         /**
          * Draws a circle with specified color, border width and fill.
          */
-        virtual void draw_circle(Point center, int radius, Color color,
+        virtual void draw_circle(IntPoint center, int radius, Color color,
                                  int border_width, bool filled) const override;
         /**
          * Draws a rectangle with specified color, border width and fill.
          */
-        virtual void draw_rectangle(Point start, int width, int height,
+        virtual void draw_rectangle(IntPoint start, int width, int height,
                                     Color color, int border_width,
                                     bool filled) const override;
         /**
          * Draws a rounded rectangle with specified color. This is useful for
          * drawing nicely-looking game menu items.
          */
-        virtual void draw_rounded_rectangle(Point start, int width, int height,
-                                            int radius,
+        virtual void draw_rounded_rectangle(IntPoint start, int width,
+                                            int height, int radius,
                                             Color color) const override;
         /**
          * Draws a line from a start point to the end point with specified
          * color. Note that fill and thickness are not controllable yet.
          */
-        virtual void draw_line(Point start, Point end,
+        virtual void draw_line(IntPoint start, IntPoint end,
                                Color color) const override;
         /**
          * Prints a string on the display, allows for specifying the font size,
          * color and background color.
          */
-        virtual void draw_string(Point start, char *string_buffer,
+        virtual void draw_string(IntPoint start, char *string_buffer,
                                  FontSize font_size, Color bg_color,
                                  Color fg_color) const override;
         /**
@@ -80,7 +100,7 @@ class LcdDisplay_1_69 : public Display
          * display this operation is potentially slow, hence we need to redraw
          * small regions at a time if we want the game to remain usable.
          */
-        virtual void clear_region(Point top_left, Point bottom_right,
+        virtual void clear_region(IntPoint top_left, IntPoint bottom_right,
                                   Color clear_color) const override;
 
         /**
@@ -121,6 +141,15 @@ class LcdDisplay_1_69 : public Display
         virtual bool refresh() const override;
         virtual void sleep() const override;
 
+        bool supports_pixel_push() const override { return true; }
+        /**
+         * Streams the pixels into a single window of the display memory
+         * (see `Paint_DrawPixels`). The columns are offset by one pixel in
+         * the same way as in `clear_region`.
+         */
+        void push_pixels(IntPoint top_left, int width, int height,
+                         const uint16_t *pixels) const override;
+
         /**
          * This is required so that different implementations of the display
          * interface can 'cast themselves' into the TFT_eSPI-compatible display
@@ -130,5 +159,14 @@ class LcdDisplay_1_69 : public Display
          * vtable and the virtual functions.
          */
         virtual TftCompatibleDisplay *cast_into_tft_compatible() override;
+
+      private:
+        /**
+         * Filled circles and rounded rectangles are rasterized into spans
+         * instead of being drawn pixel by pixel by the Waveshare library.
+         * The raster target works in the rotated coordinates of the screen,
+         * which are offset by one pixel from the ones used by the library.
+         */
+        mutable PaintRasterTarget raster;
 };
 #endif
@@ -0,0 +1,11 @@
+#ifdef EMULATOR
+#pragma once
+
+/**
+ * Size of the emulated screen. This is kept apart from the SFML display so
+ * that the headless display can be built without SFML.
+ */
+constexpr int DISPLAY_HEIGHT = 240;
+constexpr int DISPLAY_WIDTH = 320;
+constexpr int DISPLAY_CORNER_RADIUS = 0;
+#endif
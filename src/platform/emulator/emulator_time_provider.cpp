@@ -19,5 +19,26 @@ class EmulatorTimeProvider : public TimeProvider
                            std::chrono::system_clock::now().time_since_epoch())
                     .count();
         }
+
+        long microseconds() const override
+        {
+                return std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+        }
+};
+
+/**
+ * Time provider used by the headless emulator. Delays do not block, they only
+ * advance a virtual clock. This way the headless runs are not slowed down by
+ * the input polling delays and the reported time is deterministic.
+ */
+class HeadlessTimeProvider : public TimeProvider
+{
+        void delay_ms(int ms) const override { virtual_time_ms += ms; }
+
+        long milliseconds() const override { return virtual_time_ms; }
+
+        mutable long virtual_time_ms = 0;
 };
 #endif
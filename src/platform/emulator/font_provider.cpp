@@ -1,12 +1,49 @@
 #ifdef EMULATOR
 #include "font_provider.hpp"
 #include "emulator_config.h"
+#include <string>
+#include <unordered_map>
 
-const sf::Font get_emulator_font()
+/**
+ * Upper bound on the number of cached text objects. Apps render a handful of
+ * distinct strings per frame, the bound only protects us against apps that
+ * keep generating new strings (e.g. timers) from growing the cache forever.
+ */
+#define TEXT_CACHE_CAPACITY 256
+
+const sf::Font &get_emulator_font()
 {
-        std::string source_dir(CMAKE_SOURCE_DIR);
-        const sf::Font font(
-            source_dir + "/assets/emulator/JetBrainsMonoNerdFont-Regular.ttf");
+        static const sf::Font font(
+            std::string(CMAKE_SOURCE_DIR) +
+            "/assets/emulator/JetBrainsMonoNerdFont-Regular.ttf");
         return font;
 }
+
+void prerasterize_emulator_font(const std::vector<unsigned int> &character_sizes)
+{
+        const sf::Font &font = get_emulator_font();
+        for (unsigned int size : character_sizes) {
+                for (char32_t c = ' '; c <= '~'; c++) {
+                        font.getGlyph(c, size, false);
+                }
+        }
+}
+
+sf::Text &get_emulator_text(const char *string, unsigned int character_size)
+{
+        static std::unordered_map<std::string, sf::Text> cache;
+
+        std::string key = std::to_string(character_size) + ":" + string;
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+                return it->second;
+        }
+
+        if (cache.size() >= TEXT_CACHE_CAPACITY) {
+                cache.clear();
+        }
+        return cache
+            .emplace(key, sf::Text(get_emulator_font(), string, character_size))
+            .first->second;
+}
 #endif
@@ -2,5 +2,31 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 
-const sf::Font get_emulator_font();
+/**
+ * Returns the font used by the emulator to render text. The font file is
+ * loaded and parsed only once per process (on first use), all subsequent calls
+ * return the same instance.
+ */
+const sf::Font &get_emulator_font();
+
+/**
+ * Rasterizes all printable ASCII glyphs of the emulator font for each of the
+ * given character sizes. SFML rasterizes glyphs lazily and stores them in a
+ * texture atlas per character size, calling this up front moves that work out
+ * of the first frames that render text. Note that this requires an active
+ * OpenGL context (i.e. it needs to be called after the render texture or
+ * window has been created).
+ */
+void prerasterize_emulator_font(const std::vector<unsigned int> &character_sizes);
+
+/**
+ * Returns a text object for the given string and character size. Text objects
+ * are cached so that repeatedly drawn strings (menu labels, score counters,
+ * on-screen keyboard keys) reuse the glyph geometry that SFML computed when the
+ * string was drawn for the first time.
+ *
+ * The returned reference stays valid until the next call to this function,
+ * callers are expected to set the color and position before drawing it.
+ */
+sf::Text &get_emulator_text(const char *string, unsigned int character_size);
 #endif
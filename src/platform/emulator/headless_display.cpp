@@ -0,0 +1,92 @@
+#ifdef EMULATOR
+#include "headless_display.hpp"
+#include "../../common/logging.hpp"
+#include <cstdio>
+#include <vector>
+
+#define TAG "headless_display"
+
+void HeadlessDisplay::setup() const {}
+void HeadlessDisplay::initialize() const {}
+void HeadlessDisplay::sleep() const {}
+
+int HeadlessDisplay::get_height() const { return framebuffer.get_height(); }
+
+int HeadlessDisplay::get_width() const { return framebuffer.get_width(); }
+
+DisplayDimensions HeadlessDisplay::get_display_dimensions() const
+{
+        return DisplayDimensions{.width = get_width(),
+                                 .height = get_height(),
+                                 .rounded_corner_radius =
+                                     DISPLAY_CORNER_RADIUS};
+}
+
+int HeadlessDisplay::get_display_corner_radius() const
+{
+        return DISPLAY_CORNER_RADIUS;
+}
+
+bool HeadlessDisplay::refresh() const
+{
+        frame_count++;
+        return frame_limit == 0 || frame_count < frame_limit;
+}
+
+bool HeadlessDisplay::supports_scroll(const ScrollRegion &region) const
+{
+        return true;
+}
+
+void HeadlessDisplay::set_scroll(const ScrollRegion &region, int offset) const
+{
+        framebuffer.set_scroll(region, offset);
+}
+
+bool HeadlessDisplay::supports_pixel_push() const { return true; }
+
+void HeadlessDisplay::push_pixels(IntPoint top_left, int width, int height,
+                                  const uint16_t *pixels) const
+{
+        framebuffer.push_image(top_left.x, top_left.y, width, height, pixels);
+}
+
+/**
+ * Expands each channel of the RGB565 color to the full 8-bit range.
+ */
+static void rgb565_to_rgb888(uint16_t color, uint8_t *rgb)
+{
+        rgb[0] = ((color >> 11) & 0x1F) * 255 / 31;
+        rgb[1] = ((color >> 5) & 0x3F) * 255 / 63;
+        rgb[2] = (color & 0x1F) * 255 / 31;
+}
+
+bool HeadlessDisplay::write_ppm(const char *path) const
+{
+        FILE *file = fopen(path, "wb");
+        if (!file) {
+                LOG_ERROR(TAG, "Unable to open %s for writing", path);
+                return false;
+        }
+
+        int width = get_width();
+        int height = get_height();
+        fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+        std::vector<uint8_t> row(3 * width);
+        bool success = true;
+        for (int y = 0; y < height && success; y++) {
+                for (int x = 0; x < width; x++) {
+                        rgb565_to_rgb888(framebuffer.pixel(x, y),
+                                         &row[3 * x]);
+                }
+                success = fwrite(row.data(), 1, row.size(), file) == row.size();
+        }
+        success = fclose(file) == 0 && success;
+
+        if (!success) {
+                LOG_ERROR(TAG, "Failed to write the snapshot to %s", path);
+        }
+        return success;
+}
+#endif
@@ -0,0 +1,67 @@
+#ifdef EMULATOR
+#pragma once
+#include "../../common/framebuffer.hpp"
+#include "../../common/framebuffer_display.hpp"
+#include "emulator_display_dimensions.hpp"
+
+/**
+ * @brief Display implementation that rasterizes everything into an in-memory
+ * RGB565 framebuffer instead of an SFML window. This allows for running the
+ * emulator without a graphical environment (e.g. in CI) and for inspecting the
+ * exact pixels produced by the apps in tests.
+ */
+class HeadlessDisplay : public FramebufferDisplay
+{
+      public:
+        HeadlessDisplay(int width = DISPLAY_WIDTH, int height = DISPLAY_HEIGHT)
+            : framebuffer(width, height)
+        {
+        }
+
+        void setup() const override;
+        void initialize() const override;
+        int get_height() const override;
+        int get_width() const override;
+        DisplayDimensions get_display_dimensions() const override;
+        int get_display_corner_radius() const override;
+        /**
+         * There is no window that could be closed, instead the refresh fails
+         * once the configured number of frames has been rendered. This is what
+         * terminates the headless emulator runs.
+         */
+        bool refresh() const override;
+        void sleep() const override;
+        /**
+         * Scrolling is emulated in the framebuffer, which always holds the
+         * pixels as they would be shown by the physical display.
+         */
+        bool supports_scroll(const ScrollRegion &region) const override;
+        void set_scroll(const ScrollRegion &region, int offset) const override;
+        bool supports_pixel_push() const override;
+        void push_pixels(IntPoint top_left, int width, int height,
+                         const uint16_t *pixels) const override;
+
+        /**
+         * Sets the number of frames (calls to `refresh`) after which the
+         * display reports that it has been closed. 0 means no limit.
+         */
+        void set_frame_limit(int frames) { frame_limit = frames; }
+        int get_frame_count() const { return frame_count; }
+
+        const Rgb565Framebuffer &get_framebuffer() const { return framebuffer; }
+
+        /**
+         * Saves the current contents of the framebuffer as a binary PPM
+         * image. Returns false if the file could not be written.
+         */
+        bool write_ppm(const char *path) const;
+
+      protected:
+        RasterTarget &target() const override { return framebuffer; }
+
+      private:
+        mutable Rgb565Framebuffer framebuffer;
+        mutable int frame_count = 0;
+        int frame_limit = 0;
+};
+#endif
@@ -4,11 +4,21 @@
 #include "sfml_display.hpp"
 #include <SFML/Graphics.hpp>
 #include "../../common/logging.hpp"
+#include "../../common/maths_utils.hpp"
+#include <algorithm>
+#include <vector>
 
 #define SCREEN_BORDER_WIDTH 3
 #define TAG "sfml_display"
 
-void SfmlDisplay::setup() const {};
+void SfmlDisplay::setup() const
+{
+        // Rasterize the glyphs for all font sizes used by the apps up front.
+        // The TFT-compatible API scales the base font (half of Size16) by
+        // the text size set through `setTextSize`, sizes 1-3 coincide with
+        // the regular font sizes and the lopaka artifacts also use size 4.
+        prerasterize_emulator_font({Size8, Size16, Size24, Size16 / 2 * 4});
+};
 void SfmlDisplay::set_scale(unsigned int scale) const
 {
         this->window->setSize(
@@ -22,10 +32,42 @@ void SfmlDisplay::sleep() const {};
 sf::Color map_to_sf_color(uint32_t color);
 void SfmlDisplay::clear(Color color) const
 {
+        // Everything that is still pending would be overwritten anyway.
+        pending_rectangles.clear();
         texture->clear(map_to_sf_color(color));
-        texture->display();
 };
 
+void SfmlDisplay::batch_filled_rectangle(int x, int y, int width, int height,
+                                         sf::Color color) const
+{
+        sf::Vector2f top_left(x, y);
+        sf::Vector2f top_right(x + width, y);
+        sf::Vector2f bottom_left(x, y + height);
+        sf::Vector2f bottom_right(x + width, y + height);
+
+        pending_rectangles.append(sf::Vertex(top_left, color));
+        pending_rectangles.append(sf::Vertex(top_right, color));
+        pending_rectangles.append(sf::Vertex(bottom_left, color));
+        pending_rectangles.append(sf::Vertex(top_right, color));
+        pending_rectangles.append(sf::Vertex(bottom_right, color));
+        pending_rectangles.append(sf::Vertex(bottom_left, color));
+}
+
+void SfmlRasterTarget::fill_clipped_rect(int x, int y, int w, int h,
+                                         uint16_t color)
+{
+        display->batch_filled_rectangle(x, y, w, h, map_to_sf_color(color));
+}
+
+void SfmlDisplay::flush_pending_rectangles() const
+{
+        if (pending_rectangles.getVertexCount() == 0) {
+                return;
+        }
+        texture->draw(pending_rectangles);
+        pending_rectangles.clear();
+}
+
 /**
  * Draws a rounded border around the game display, this might not be the most
  * efficient solution using the SFML API, but it uses the same logic as the
@@ -136,29 +178,55 @@ void SfmlDisplay::draw_rounded_border(Color color) const
 void SfmlDisplay::draw_circle(IntPoint center, int radius, Color color,
                               int border_width, bool filled) const
 {
+        if (filled) {
+                raster.fill_circle(center.x, center.y, radius, color);
+                return;
+        }
+
         // Note: the circle is always filled, given the current use cases this
         // is fine, but we need to tighten up the API in the future as we
         // start onboarding more complex game rendering.
         sf::CircleShape circle(radius);
         circle.setPosition(
             {(float)(center.x - radius), (float)(center.y - radius)});
-
-        if (filled) {
-                circle.setFillColor(map_to_sf_color(color));
-        } else {
-                circle.setFillColor(map_to_sf_color(Black));
-        }
-
+        circle.setFillColor(map_to_sf_color(Black));
         circle.setOutlineColor(map_to_sf_color(color));
         circle.setOutlineThickness(-border_width);
+        flush_pending_rectangles();
         texture->draw(circle);
-        texture->display();
 };
 
 void SfmlDisplay::draw_rectangle(IntPoint start, int width, int height,
                                  Color color, int border_width,
                                  bool filled) const
 {
+        /**
+         * A filled rectangle with a 1px inner border of the same color covers
+         * exactly the pixels in [x, x + width) x [y, y + height), hence it can
+         * be batched with the other rectangles.
+         */
+        if (filled && border_width <= 1 && width > 0 && height > 0) {
+                batch_filled_rectangle(start.x, start.y, width, height,
+                                       map_to_sf_color(color));
+                return;
+        }
+
+        /**
+         * Similarly, the 1px inner border of an empty rectangle is made up of
+         * four 1px wide strips along its edges.
+         */
+        if (!filled && border_width <= 1 && width >= 2 && height >= 2) {
+                sf::Color sf_color = map_to_sf_color(color);
+                int x = start.x;
+                int y = start.y;
+                batch_filled_rectangle(x, y, width, 1, sf_color);
+                batch_filled_rectangle(x, y + height - 1, width, 1, sf_color);
+                batch_filled_rectangle(x, y + 1, 1, height - 2, sf_color);
+                batch_filled_rectangle(x + width - 1, y + 1, 1, height - 2,
+                                       sf_color);
+                return;
+        }
+
         sf::RectangleShape rectangle({(float)width, (float)height});
         rectangle.setPosition({(float)start.x, (float)start.y});
         if (filled) {
@@ -172,6 +240,7 @@ void SfmlDisplay::draw_rectangle(IntPoint start, int width, int height,
         // with the embedded displays.
         rectangle.setOutlineThickness(-1);
 
+        flush_pending_rectangles();
         texture->draw(rectangle);
 
         /**
@@ -191,38 +260,11 @@ void SfmlDisplay::draw_rectangle(IntPoint start, int width, int height,
                 border.setOutlineThickness(border_width - 1);
                 texture->draw(border);
         }
-        texture->display();
 };
 void SfmlDisplay::draw_rounded_rectangle(IntPoint start, int width, int height,
                                          int radius, Color color) const
 {
-        IntPoint top_left_corner = {.x = start.x + radius, .y = start.y + radius};
-
-        IntPoint bottom_right_corner = {.x = start.x + width - radius,
-                                     .y = start.y + height - radius};
-
-        int x_positions[2] = {top_left_corner.x, bottom_right_corner.x};
-        int y_positions[2] = {top_left_corner.y, bottom_right_corner.y};
-
-        // Draw the four rounded corners.
-        for (int x : x_positions) {
-                for (int y : y_positions) {
-                        draw_circle({.x = x, .y = y}, radius, color, 0, true);
-                }
-        }
-
-        // This needs to be cleaned up
-        draw_rectangle({.x = top_left_corner.x, .y = start.y},
-                       width - 2 * radius, height, color, 0, true);
-
-        // small rectangle on the left
-        draw_rectangle({.x = start.x, .y = top_left_corner.y}, width + 1,
-                       height - 2 * radius, color, 0, true);
-
-        // +1 is because the endY bound is not included
-        // The big rectangle in the middle
-        draw_rectangle({.x = top_left_corner.x, .y = start.y + height - radius},
-                       width - 2 * radius, radius + 1, color, 0, true);
+        raster.fill_round_rect(start.x, start.y, width, height, radius, color);
 };
 
 void SfmlDisplay::draw_line(IntPoint start, IntPoint end, Color color) const
@@ -239,20 +281,19 @@ void SfmlDisplay::draw_line(IntPoint start, IntPoint end, Color color) const
             sf::Vertex(sf::Vector2f(end.x + offset, end.y + offset),
                        map_to_sf_color(color))};
 
+        flush_pending_rectangles();
         texture->draw(line, 2, sf::PrimitiveType::Lines);
-        texture->display();
 }
 void SfmlDisplay::draw_string(IntPoint start, char *string_buffer,
                               FontSize font_size, Color bg_color,
                               Color fg_color) const
 {
-        const sf::Font font = get_emulator_font();
-        sf::Text text(font, string_buffer, font_size);
+        sf::Text &text = get_emulator_text(string_buffer, font_size);
 
         text.setFillColor(map_to_sf_color(fg_color));
         text.setPosition({(float)start.x, (float)start.y});
+        flush_pending_rectangles();
         texture->draw(text);
-        texture->display();
 };
 void SfmlDisplay::clear_region(IntPoint top_left, IntPoint bottom_right,
                                Color clear_color) const
@@ -296,24 +337,73 @@ bool SfmlDisplay::refresh() const
                 }
         }
 
+        // Finalize everything that was drawn into the texture since the last
+        // refresh. This is the only place where the texture is synchronized.
+        flush_pending_rectangles();
+        texture->display();
+
         // Now we start rendering to the window, clear it first
-        // texture->display();
         window->clear();
-        // Draw the texture
-        sf::Sprite sprite(texture->getTexture());
-        window->draw(sprite);
+        present_texture();
 
         // End the current frame and display its contents on screen
         window->display();
         return true;
 };
 
+bool SfmlDisplay::supports_scroll(const ScrollRegion &region) const
+{
+        return true;
+}
+
+void SfmlDisplay::set_scroll(const ScrollRegion &region, int offset) const
+{
+        scroll = region.is_empty() ? ScrollRegion{} : region;
+        int length = scroll.length();
+        scroll_offset = length > 0 ? mathematical_modulo(offset, length) : 0;
+}
+
+void SfmlDisplay::present_texture() const
+{
+        sf::Sprite sprite(texture->getTexture());
+        window->draw(sprite);
+        if (scroll.is_empty() || scroll_offset == 0) {
+                return;
+        }
+
+        // The pixels at `offset` and after it in the region are shown at its
+        // start, the ones before the offset wrap around to its end.
+        int length = scroll.length();
+        int head = length - scroll_offset;
+        bool horizontal = scroll.axis == ScrollAxis::Horizontal;
+        auto draw_part = [&](int source, int target, int part_length) {
+                sf::Vector2i origin = {scroll.top_left.x, scroll.top_left.y};
+                sf::Vector2i size = {scroll.width, scroll.height};
+                sf::Vector2i position = origin;
+                if (horizontal) {
+                        origin.x += source;
+                        position.x += target;
+                        size.x = part_length;
+                } else {
+                        origin.y += source;
+                        position.y += target;
+                        size.y = part_length;
+                }
+                sf::Sprite part(texture->getTexture(),
+                                sf::IntRect(origin, size));
+                part.setPosition({(float)position.x, (float)position.y});
+                window->draw(part);
+        };
+        draw_part(scroll_offset, 0, head);
+        draw_part(0, head, scroll_offset);
+}
+
 /**
  * The Arduino LCD display uses the RGB565 color encoding, whereas SFML uses
  * RGB888 with the additional opacity channel. This function converts from the
  * RGB565 color to the RGB888 by scaling each channel and setting opacity to 1.
  */
-sf::Color map_to_sf_color(uint32_t color)
+static sf::Color convert_rgb565_color(uint16_t color)
 {
         uint8_t red, green, blue;
 
@@ -330,6 +420,28 @@ sf::Color map_to_sf_color(uint32_t color)
 
         return sf::Color(red, green, blue);
 }
+
+/**
+ * All 65536 RGB565 colors converted up front, this way converting images (and
+ * the colors of all other primitives) takes a single lookup per pixel instead
+ * of the floating-point scaling of each channel.
+ */
+static const std::vector<sf::Color> &rgb565_color_table()
+{
+        static const std::vector<sf::Color> table = [] {
+                std::vector<sf::Color> colors(1 << 16);
+                for (size_t color = 0; color < colors.size(); color++) {
+                        colors[color] = convert_rgb565_color(color);
+                }
+                return colors;
+        }();
+        return table;
+}
+
+sf::Color map_to_sf_color(uint32_t color)
+{
+        return rgb565_color_table()[color & 0xFFFF];
+}
 void SfmlDisplay::drawPixel(int32_t x, int32_t y, uint32_t color) {}
 void SfmlDisplay::drawChar(int32_t x, int32_t y, uint16_t c, uint32_t color,
                            uint32_t bg, uint8_t size)
@@ -342,8 +454,8 @@ void SfmlDisplay::drawLine(int32_t xs, int32_t ys, int32_t xe, int32_t ye,
         sf::Vertex line[] = {sf::Vertex(sf::Vector2f(xs, ys), sf_color),
                              sf::Vertex(sf::Vector2f(xe, ye), sf_color)};
 
+        flush_pending_rectangles();
         texture->draw(line, 2, sf::PrimitiveType::Lines);
-        texture->display();
 }
 void SfmlDisplay::drawRect(int x, int y, int w, int h, int color)
 {
@@ -352,28 +464,34 @@ void SfmlDisplay::drawRect(int x, int y, int w, int h, int color)
         rectangle.setFillColor(sf::Color::Transparent);
         rectangle.setOutlineColor(map_to_sf_color(color));
         rectangle.setOutlineThickness(-1);
+        flush_pending_rectangles();
         texture->draw(rectangle);
-        texture->display();
 }
 void SfmlDisplay::fillRect(int32_t x, int32_t y, int32_t w, int32_t h,
                            uint32_t color)
 {
+        if (w > 0 && h > 0) {
+                batch_filled_rectangle(x, y, w, h, map_to_sf_color(color));
+                return;
+        }
         sf::RectangleShape rectangle({(float)w, (float)h});
         rectangle.setPosition({(float)x, (float)y});
         sf::Color sf_color = map_to_sf_color(color);
         rectangle.setFillColor(sf_color);
         rectangle.setOutlineColor(sf_color);
         rectangle.setOutlineThickness(-1);
+        flush_pending_rectangles();
         texture->draw(rectangle);
-        texture->display();
 }
 void SfmlDisplay::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
                                 int32_t radius, uint32_t color)
 {
+        raster.draw_round_rect(x, y, w, h, radius, color);
 }
 void SfmlDisplay::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
                                 int32_t radius, uint32_t color)
 {
+        raster.fill_round_rect(x, y, w, h, radius, color);
 }
 void SfmlDisplay::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color)
 {
@@ -381,18 +499,12 @@ void SfmlDisplay::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color)
         circle.setPosition({(float)(x - r), (float)(y - r)});
         sf::Color sf_color = map_to_sf_color(color);
         circle.setOutlineColor(sf_color);
+        flush_pending_rectangles();
         texture->draw(circle);
-        texture->display();
 }
 void SfmlDisplay::fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color)
 {
-        sf::CircleShape circle(r);
-        circle.setPosition({(float)(x - r), (float)(y - r)});
-        sf::Color sf_color = map_to_sf_color(color);
-        circle.setFillColor(sf_color);
-        circle.setOutlineColor(sf_color);
-        texture->draw(circle);
-        texture->display();
+        raster.fill_circle(x, y, r, color);
 }
 
 void SfmlDisplay::drawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
@@ -405,8 +517,8 @@ void SfmlDisplay::drawEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
         ellipse.setOutlineColor(sf_color);
         ellipse.setOutlineThickness(-1);
         ellipse.setFillColor(sf::Color::Transparent);
+        flush_pending_rectangles();
         texture->draw(ellipse);
-        texture->display();
 }
 void SfmlDisplay::fillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
                               uint32_t color)
@@ -418,15 +530,12 @@ void SfmlDisplay::fillEllipse(int32_t x, int32_t y, int32_t rx, int32_t ry,
         ellipse.setFillColor(sf_color);
         ellipse.setOutlineColor(sf_color);
         ellipse.setOutlineThickness(-1);
+        flush_pending_rectangles();
         texture->draw(ellipse);
-        texture->display();
 }
 
 void SfmlDisplay::drawString(const char *string, int32_t x, int32_t y)
 {
-
-        const sf::Font font = get_emulator_font();
-
         // The default font size is 16. We use the font_size
         // in line with the behaviour of the TFT_eSPI library: font_size == 1
         // means that we are scaling the font as 100%, 2 means 200% and so on.
@@ -439,7 +548,7 @@ void SfmlDisplay::drawString(const char *string, int32_t x, int32_t y)
             dimensions.font_dimensions.height / 2 * this->tft_font_size;
         int resolved_font_width =
             dimensions.font_dimensions.width / 2 * this->tft_font_size;
-        sf::Text text(font, string, resolved_font_size);
+        sf::Text &text = get_emulator_text(string, resolved_font_size);
 
         // For fonts larger than 1, we need to adjust the vertical alignment of
         // the text to make it pixel-close to the actual TFT_eSPI behaviour.
@@ -447,8 +556,8 @@ void SfmlDisplay::drawString(const char *string, int32_t x, int32_t y)
             this->tft_font_size != 1 ? 2 * this->tft_font_size : 1;
         text.setFillColor(sf::Color(this->tft_text_color));
         text.setPosition({(float)(x), (float)(y - adjustment)});
+        flush_pending_rectangles();
         texture->draw(text);
-        texture->display();
 }
 void SfmlDisplay::fillScreen(uint32_t color) {}
 void SfmlDisplay::setTextColor(uint32_t color)
@@ -467,45 +576,75 @@ void SfmlDisplay::drawTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
         triangle.setPoint(2, sf::Vector2f(xe, ye));
         triangle.setFillColor(sf::Color::Transparent);
         triangle.setOutlineColor(map_to_sf_color(color));
+        flush_pending_rectangles();
         texture->draw(triangle);
-        texture->display();
 }
 void SfmlDisplay::fillTriangle(int32_t xs, int32_t ys, int32_t x2, int32_t y2,
                                int32_t xe, int32_t ye, uint32_t color)
 {
-        sf::ConvexShape triangle;
-        triangle.setPointCount(3);
-        triangle.setPoint(0, sf::Vector2f(xs, ys));
-        triangle.setPoint(1, sf::Vector2f(x2, y2));
-        triangle.setPoint(2, sf::Vector2f(xe, ye));
-        triangle.setFillColor(map_to_sf_color(color));
-        triangle.setOutlineColor(map_to_sf_color(color));
-        texture->draw(triangle);
-        texture->display();
+        raster.fill_triangle(xs, ys, x2, y2, xe, ye, color);
 }
 
 void SfmlDisplay::pushImage(int x, int y, int width, int height,
                             const uint16_t *image_array)
 {
-        sf::Image img({(unsigned int)width, (unsigned int)height});
-        for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                        uint16_t pixel = image_array[y * width + x];
-                        sf::Color c = map_to_sf_color(pixel);
-                        img.setPixel({(unsigned int)x, (unsigned int)y}, c);
-                }
-        };
-        sf::Texture tex;
-        bool success = tex.loadFromImage(img);
-        if (!success) {
-                LOG_ERROR(TAG,
-                          "Failed to load texture from image in pushImage");
+        if (width <= 0 || height <= 0) {
                 return;
         }
-        sf::Sprite sprite(tex);
+        sf::Vector2u size = {(unsigned int)width, (unsigned int)height};
+        sf::Vector2u capacity = staging_texture.getSize();
+        if (size.x > capacity.x || size.y > capacity.y) {
+                // Most images fit into the screen, hence the texture starts
+                // out with the size of the screen and is only grown if needed.
+                sf::Vector2u new_capacity = {
+                    std::max({size.x, capacity.x, (unsigned int)DISPLAY_WIDTH}),
+                    std::max(
+                        {size.y, capacity.y, (unsigned int)DISPLAY_HEIGHT})};
+                if (!staging_texture.resize(new_capacity)) {
+                        LOG_ERROR(TAG, "Failed to allocate the pushImage "
+                                       "staging texture");
+                        return;
+                }
+        }
+
+        const std::vector<sf::Color> &colors = rgb565_color_table();
+        staging_pixels.resize((size_t)width * height);
+        for (size_t i = 0; i < staging_pixels.size(); i++) {
+                staging_pixels[i] = colors[image_array[i]];
+        }
+        static_assert(sizeof(sf::Color) == 4,
+                      "sf::Color needs to match the RGBA8888 texture layout");
+        staging_texture.update(
+            reinterpret_cast<const std::uint8_t *>(staging_pixels.data()),
+            size, {0, 0});
+
+        sf::Sprite sprite(staging_texture,
+                          sf::IntRect({0, 0}, {width, height}));
         sprite.setPosition({(float)x, (float)y});
+        flush_pending_rectangles();
         texture->draw(sprite);
 }
 
 TftCompatibleDisplay *SfmlDisplay::cast_into_tft_compatible() { return this; }
+
+bool write_png(const Rgb565Framebuffer &framebuffer, const char *path)
+{
+        int width = framebuffer.get_width();
+        int height = framebuffer.get_height();
+        sf::Image image({(unsigned int)width, (unsigned int)height});
+        for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                        sf::Color color =
+                            map_to_sf_color(framebuffer.pixel(x, y));
+                        image.setPixel({(unsigned int)x, (unsigned int)y},
+                                       color);
+                }
+        }
+
+        if (!image.saveToFile(path)) {
+                LOG_ERROR(TAG, "Failed to write the snapshot to %s", path);
+                return false;
+        }
+        return true;
+}
 #endif
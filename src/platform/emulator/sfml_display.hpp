@@ -1,11 +1,35 @@
 #ifdef EMULATOR
 #pragma once
+#include "../../common/framebuffer.hpp"
+#include "../../common/raster.hpp"
 #include "../interface/display.hpp"
+#include "emulator_display_dimensions.hpp"
 #include <SFML/Graphics.hpp>
+#include <vector>
 
-constexpr int DISPLAY_HEIGHT = 240;
-constexpr int DISPLAY_WIDTH = 320;
-constexpr int DISPLAY_CORNER_RADIUS = 0;
+class SfmlDisplay;
+
+/**
+ * Raster target that adds the spans produced by the shared rasterizer to the
+ * batch of pending rectangles of the SFML display. This way the filled shapes
+ * end up with exactly the same pixels as on the physical displays instead of
+ * SFML's polygon approximations.
+ */
+class SfmlRasterTarget : public RasterTarget
+{
+      public:
+        SfmlRasterTarget(const SfmlDisplay *display)
+            : RasterTarget(DISPLAY_WIDTH, DISPLAY_HEIGHT), display(display)
+        {
+        }
+
+      protected:
+        void fill_clipped_rect(int x, int y, int w, int h,
+                               uint16_t color) override;
+
+      private:
+        const SfmlDisplay *display;
+};
 
 /**
  * @brief SfmlDisplay class that implements the Display interface for the
@@ -111,6 +135,10 @@ class SfmlDisplay : public Display, public TftCompatibleDisplay
          * 'has failed' and this function returns false. Note that on the
          * physical LCD display false willl never be returned.
          *
+         * The drawing primitives of this display only record their output
+         * into the render texture, this is the only place where the texture
+         * gets finalized (`texture->display()`) and presented in the window.
+         *
          * The reason this window close exception handling is implemented with
          * a boolean flag instead of proper exceptions is that Arduino does
          * not support exceptions, hence we would need to gate the
@@ -126,8 +154,16 @@ class SfmlDisplay : public Display, public TftCompatibleDisplay
          */
         void sleep() const override;
 
+        /**
+         * The texture plays the role of the display memory and the scrolled
+         * region is rotated only when the texture gets presented in the
+         * window, in the same way as the display controllers do it.
+         */
+        bool supports_scroll(const ScrollRegion &region) const override;
+        void set_scroll(const ScrollRegion &region, int offset) const override;
+
         SfmlDisplay(sf::RenderWindow *window, sf::RenderTexture *texture)
-            : window(window), texture(texture)
+            : window(window), texture(texture), raster(this)
         {
         }
 
@@ -165,8 +201,55 @@ class SfmlDisplay : public Display, public TftCompatibleDisplay
         TftCompatibleDisplay *cast_into_tft_compatible() override;
 
       private:
+        friend class SfmlRasterTarget;
+
         sf::RenderWindow *window;
         sf::RenderTexture *texture;
+        /**
+         * Rasterizes the filled circles, rounded rectangles and triangles
+         * into spans that are added to the pending rectangles.
+         */
+        mutable SfmlRasterTarget raster;
+
+        /**
+         * Axis-aligned filled rectangles (cells, cleared regions, menu
+         * backgrounds) make up the bulk of what the apps draw. Instead of
+         * issuing a separate draw call for each one of them, they are
+         * collected in this vertex array (two triangles per rectangle) and
+         * submitted to the texture with a single draw call.
+         *
+         * The batch is flushed before any other primitive is drawn so that
+         * the drawing order (and hence the rendered result) stays the same.
+         */
+        mutable sf::VertexArray pending_rectangles{
+            sf::PrimitiveType::Triangles};
+
+        /**
+         * `pushImage` converts the images into this buffer and uploads them
+         * into the top-left corner of the staging texture which is then drawn
+         * as a sprite. Both are reused across the calls so that images can be
+         * pushed every frame without allocating textures.
+         */
+        std::vector<sf::Color> staging_pixels;
+        sf::Texture staging_texture;
+
+        /**
+         * Adds a filled rectangle to the batch of pending rectangles.
+         */
+        void batch_filled_rectangle(int x, int y, int width, int height,
+                                    sf::Color color) const;
+        /**
+         * Draws all pending rectangles onto the texture. This needs to be
+         * called before drawing anything that isn't batched.
+         */
+        void flush_pending_rectangles() const;
+
+        mutable ScrollRegion scroll = {};
+        mutable int scroll_offset = 0;
+        /**
+         * Draws the texture into the window, rotating the scrolled region.
+         */
+        void present_texture() const;
 
         /**
          * Font size that was set by the `setTextSize` method on the
@@ -181,4 +264,10 @@ class SfmlDisplay : public Display, public TftCompatibleDisplay
          */
         sf::Color tft_text_color;
 };
+
+/**
+ * Saves the contents of the framebuffer (e.g. the last frame of the headless
+ * display) as a PNG image. Returns false if the file could not be written.
+ */
+bool write_png(const Rgb565Framebuffer &framebuffer, const char *path);
 #endif
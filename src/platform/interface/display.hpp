@@ -26,6 +26,35 @@ struct DisplayDimensions {
         int rounded_corner_radius;
 };
 
+enum class ScrollAxis : uint8_t { Horizontal, Vertical };
+
+/**
+ * Rectangular band of the screen whose contents are scrolled along one axis,
+ * see `Display::set_scroll`. A region with zero width or height stands for
+ * no scrolling.
+ */
+struct ScrollRegion {
+        ScrollAxis axis;
+        IntPoint top_left;
+        int width;
+        int height;
+
+        /**
+         * Position of the band and its length along the scrolled axis.
+         */
+        int start() const
+        {
+                return axis == ScrollAxis::Horizontal ? top_left.x
+                                                      : top_left.y;
+        }
+        int length() const
+        {
+                return axis == ScrollAxis::Horizontal ? width : height;
+        }
+        bool is_empty() const { return width <= 0 || height <= 0; }
+        bool operator==(const ScrollRegion &other) const = default;
+};
+
 /**
  * A display interface that is drop-in compatible with the interface exposed
  * by the TFT_eSPI library for LCD displays. The idea here is to expose an
@@ -194,6 +223,49 @@ class Display
          */
         virtual void sleep() const = 0;
 
+        /**
+         * Returns true if the display is able to scroll the given region in
+         * place (see `set_scroll`). Only the emulated displays scroll, the
+         * ST7789 controllers of the physical displays can only scroll bands
+         * that span the full height of the screen, which none of the
+         * scrolled screens (e.g. the weather bar graph) do. Those get
+         * redrawn instead.
+         */
+        virtual bool supports_scroll(const ScrollRegion &region) const
+        {
+                return false;
+        }
+        /**
+         * Scrolls the region by `offset` pixels the same way the hardware
+         * scrolling of the display controllers works: the region behaves like
+         * a ring and the pixel drawn at `start + i` along the scrolled axis
+         * is shown at `start + (i - offset) mod length`. Hence after scrolling
+         * only the newly exposed strip needs to be drawn, everything else is
+         * moved by the display itself (see `ScrollView`).
+         *
+         * Only the region most recently passed in is scrolled, an empty
+         * region restores the normal addressing. Must only be called if the
+         * display `supports_scroll` the region.
+         */
+        virtual void set_scroll(const ScrollRegion &region, int offset) const {}
+
+        /**
+         * Returns true if the display is able to send a block of pixels
+         * composited in RAM in a single transfer (see `push_pixels`). This is
+         * the counterpart of `TftCompatibleDisplay::pushImage` for the
+         * displays that don't expose the TFT-compatible interface.
+         */
+        virtual bool supports_pixel_push() const { return false; }
+        /**
+         * Draws the `width` x `height` block of RGB565 pixels stored row by
+         * row with its top left corner at `top_left`. Must only be called if
+         * the display `supports_pixel_push`.
+         */
+        virtual void push_pixels(IntPoint top_left, int width, int height,
+                                 const uint16_t *pixels) const
+        {
+        }
+
         /**
          * This is required so that different implementations of the display
          * interface can 'cast themselves' into the TFT_eSPI-compatible display
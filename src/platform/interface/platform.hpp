@@ -8,6 +8,10 @@
 #include "wifi.hpp"
 #include <vector>
 
+#ifdef DISPLAY_INSTRUMENTATION
+class InstrumentedDisplay;
+#endif
+
 /**
  * Different platforms have different ways of identifying the buttons used
  * for the action controller. For instance, the Arduino input shield has
@@ -76,4 +80,11 @@ struct Platform {
         HttpClient *client;
         PowerManager *power_manager;
         PlatformCapabilities capabilities;
+#ifdef DISPLAY_INSTRUMENTATION
+        /**
+         * Set if the `display` above is wrapped in an `InstrumentedDisplay`,
+         * this allows for attributing the drawing costs to the running app.
+         */
+        InstrumentedDisplay *instrumentation = nullptr;
+#endif
 };
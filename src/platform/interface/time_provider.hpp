@@ -5,4 +5,10 @@ class TimeProvider
       public:
         virtual void delay_ms(int ms) const = 0;
         virtual long milliseconds() const = 0;
+        /**
+         * Higher resolution clock used for measuring short durations (e.g. a
+         * single drawing call). Platforms without one fall back to the
+         * millisecond clock.
+         */
+        virtual long microseconds() const { return milliseconds() * 1000; }
 };
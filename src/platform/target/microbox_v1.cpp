@@ -5,10 +5,22 @@
 #include "../boards/generic/time_provider.hpp"
 #include "../boards/arduino_r4/wifi/wifi_provider.hpp"
 #include "../boards/arduino_r4/wifi/http_client.hpp"
+#include "../../common/palette_display.hpp"
 
 Platform *initialize_platform()
 {
-        LcdDisplay_1_69 *display = new LcdDisplay_1_69();
+        /**
+         * If the `DISPLAY_PALETTE_COMPOSITING` build flag is set, the drawing
+         * calls are composited into a 4 bits per pixel band in RAM and each
+         * band is streamed to the LCD in a few large transfers on refresh (see
+         * `PaletteDisplay`). Otherwise each call goes straight to the LCD.
+         */
+        LcdDisplay_1_69 *lcd_display = new LcdDisplay_1_69();
+#ifdef DISPLAY_PALETTE_COMPOSITING
+        Display *display = new PaletteDisplay(lcd_display);
+#else
+        Display *display = lcd_display;
+#endif
         ArduinoInputShield *controller = new ArduinoInputShield();
         std::vector<DirectionalController *> controllers{controller};
         std::vector<ActionController *> action_controllers{controller};
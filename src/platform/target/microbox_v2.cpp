@@ -8,6 +8,8 @@
 #include "../boards/esp32/power_manager.hpp"
 #include "../interface/controller.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/buffered_display.hpp"
+#include "../../common/queued_display.hpp"
 #include "Adafruit_seesaw.h"
 #include "Arduino.h"
 #include <EEPROM.h>
@@ -16,13 +18,37 @@
 
 Adafruit_seesaw ss(&Wire);
 
+/**
+ * The drawing calls of the game loop are queued and sent to the display over
+ * SPI by the render task running on the other core, see `QueuedDisplay`.
+ */
+LcdDisplay *lcd_display;
+DrawCommandQueue *draw_command_queue;
+/**
+ * Display that the render task executes the queued commands on. If the
+ * `DISPLAY_TILE_DIFFING` build flag is set, the commands are rasterized into a
+ * shadow framebuffer and on each refresh only the 16x16 tiles whose hash
+ * changed since the previous refresh are pushed to the LCD (see
+ * `BufferedDisplay`). Otherwise the commands go straight to the LCD.
+ */
+Display *render_target;
+
 Platform *initialize_platform()
 {
-        LcdDisplay *display = new LcdDisplay();
+        lcd_display = new LcdDisplay();
+#ifdef DISPLAY_TILE_DIFFING
+        render_target =
+            new BufferedDisplay(lcd_display, ShadowMode::TileHashes);
+#else
+        render_target = lcd_display;
+#endif
+        draw_command_queue = new DrawCommandQueue();
         MiniGamepadController *controller = new MiniGamepadController(&ss);
         std::vector<DirectionalController *> controllers{controller};
         std::vector<ActionController *> action_controllers{controller};
         TimeProvider *time_provider = new ArduinoTimeProvider();
+        QueuedDisplay *display =
+            new QueuedDisplay(render_target, draw_command_queue, time_provider);
         WifiProvider *wifi_provider = new Esp32WifiProvider();
         Esp32HttpClient *client = new Esp32HttpClient();
         EspPowerManager *power_manager = new EspPowerManager();
@@ -105,6 +131,20 @@ void rgb_blink_task(void *parameter)
         }
 }
 
+/**
+ * Executes the queued drawing commands on the LCD display. The Arduino loop
+ * task runs on core 1, this task is pinned to core 0 so that the SPI transfers
+ * overlap with the game logic and the input polling.
+ */
+void display_render_task(void *parameter)
+{
+        while (true) {
+                if (draw_command_queue->process(*render_target) == 0) {
+                        vTaskDelay(1);
+                }
+        }
+}
+
 bool setup_adafruit_seesaw_i2c_connection()
 {
 
@@ -144,6 +184,14 @@ void setup(Platform *platform)
                     1,                         // priority
                     NULL                       // task handle
         );
+        xTaskCreatePinnedToCore(display_render_task,   // function
+                                "Display render task", // name
+                                4096,                  // stack size
+                                NULL,                  // parameter
+                                2,                     // priority
+                                NULL,                  // task handle
+                                0                      // core
+        );
 }
 
 size_t getArduinoLoopTaskStackSize() { return 32 * 1024; }
@@ -0,0 +1,60 @@
+#pragma once
+#include "../src/platform/emulator/headless_display.hpp"
+#include "../src/platform/interface/platform.hpp"
+#include <cstring>
+
+/**
+ * Headless display that does not expose the TFT-compatible interface, this
+ * forces the decorators to send their output using the `Display` primitives
+ * (e.g. `clear_region` for each span of pixels). The pixel push (see
+ * `Display::push_pixels`) is only supported if it is enabled, as on the
+ * physical displays without the TFT-compatible interface.
+ */
+class HeadlessDisplayWithoutTft : public HeadlessDisplay
+{
+      public:
+        HeadlessDisplayWithoutTft(int width, int height,
+                                  bool pixel_push = false)
+            : HeadlessDisplay(width, height), pixel_push(pixel_push)
+        {
+        }
+
+        TftCompatibleDisplay *cast_into_tft_compatible() override
+        {
+                return nullptr;
+        }
+        bool supports_pixel_push() const override { return pixel_push; }
+
+      private:
+        bool pixel_push;
+};
+
+inline bool same_contents(const Rgb565Framebuffer &a,
+                          const Rgb565Framebuffer &b)
+{
+        return a.get_width() == b.get_width() &&
+               a.get_height() == b.get_height() &&
+               memcmp(a.data(), b.data(),
+                      a.get_width() * a.get_height() * sizeof(uint16_t)) == 0;
+}
+
+inline bool same_contents(const HeadlessDisplay &a, const HeadlessDisplay &b)
+{
+        return same_contents(a.get_framebuffer(), b.get_framebuffer());
+}
+
+/**
+ * Platform with only the display set, for drawing the UI elements in tests.
+ */
+inline Platform platform_with_display(Display *display)
+{
+        return Platform{.display = display,
+                        .directional_controllers = {},
+                        .action_controllers = {},
+                        .time_provider = nullptr,
+                        .persistent_storage = nullptr,
+                        .wifi_provider = nullptr,
+                        .client = nullptr,
+                        .power_manager = nullptr,
+                        .capabilities = {}};
+}
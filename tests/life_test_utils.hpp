@@ -0,0 +1,18 @@
+#pragma once
+#include "../src/games/game_of_life_engine.hpp"
+#include <cstdlib>
+
+/**
+ * Returns a grid with roughly 40% of its cells alive, seed `rand` for the
+ * grids to be reproducible.
+ */
+inline LifeGrid random_grid(int rows, int cols)
+{
+        LifeGrid grid(rows, cols);
+        for (int y = 0; y < rows; y++) {
+                for (int x = 0; x < cols; x++) {
+                        grid.set(x, y, rand() % 10 <= 3);
+                }
+        }
+        return grid;
+}
@@ -0,0 +1,44 @@
+#pragma once
+/**
+ * Minimal host-side stand-in for the Arduino core. It only provides the
+ * symbols that the vendored display drivers under `src/lib` depend on so
+ * that they can be compiled and exercised by the tests without hardware.
+ *
+ * Pin writes are forwarded to the `MockSpiBus` so that it can track the chip
+ * select and data/command lines (see SPI.h).
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+void on_mock_pin_write(uint8_t pin, uint8_t value);
+
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+        on_mock_pin_write(pin, value);
+}
+inline int digitalRead(uint8_t pin) { return LOW; }
+inline void analogWrite(uint8_t pin, int value) {}
+inline void delay(unsigned long ms) {}
+
+inline char *dtostrf(double value, signed char width, unsigned char precision,
+                     char *buffer)
+{
+        sprintf(buffer, "%*.*f", width, precision, value);
+        return buffer;
+}
+
+class MockSerial
+{
+      public:
+        void begin(unsigned long baud) {}
+};
+
+inline MockSerial Serial;
@@ -0,0 +1,306 @@
+#pragma once
+/**
+ * Host-side SPI mock used by the display driver tests.
+ *
+ * Instead of talking to real hardware, all bytes written to the bus are fed
+ * into `MockSpiBus`, which keeps track of the traffic (bytes, chip select
+ * assertions, transactions) and emulates the subset of the ST7789 command
+ * set that the Waveshare driver relies on: column/row address set
+ * (CASET/RASET) and memory write (RAMWR). This allows tests to assert both
+ * on the amount of bus traffic a drawing operation generates and on the
+ * resulting contents of the display memory.
+ */
+#include "Arduino.h"
+#include <cstring>
+#include <vector>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+#define SPI_MODE3 0x03
+
+/**
+ * Statistics of the traffic that went over the mocked SPI bus.
+ */
+struct SpiBusStatistics {
+        /**
+         * Total number of bytes clocked out while the chip select was
+         * asserted.
+         */
+        uint64_t bytes;
+        /**
+         * Number of bytes sent with the data/command line low.
+         */
+        uint64_t command_bytes;
+        /**
+         * Number of bytes sent with the data/command line high.
+         */
+        uint64_t data_bytes;
+        /**
+         * Number of times the chip select line was pulled low.
+         */
+        uint64_t chip_select_assertions;
+        /**
+         * Number of `SPI.beginTransaction` calls.
+         */
+        uint64_t transactions;
+        /**
+         * Number of calls into the SPI library that moved data (both single
+         * byte and block transfers).
+         */
+        uint64_t transfer_calls;
+        /**
+         * Number of GPIO writes to the chip select and data/command lines.
+         */
+        uint64_t pin_writes;
+        /**
+         * Rough estimate of the time the traffic would take on the target,
+         * see the MOCK_*_OVERHEAD_US cost model below.
+         */
+        double estimated_time_us;
+};
+
+/**
+ * Cost model used to estimate how long the traffic would take on the
+ * target. The numbers are ballpark figures for a Cortex-M4 class
+ * microcontroller running the Arduino core, they are only meant for
+ * comparing different drawing routines with each other.
+ */
+#define MOCK_SPI_TRANSFER_CALL_OVERHEAD_US 0.5
+#define MOCK_SPI_TRANSACTION_OVERHEAD_US 1.0
+#define MOCK_GPIO_WRITE_OVERHEAD_US 0.5
+
+#define ST7789_CASET 0x2A
+#define ST7789_RASET 0x2B
+#define ST7789_RAMWR 0x2C
+
+#define MOCK_PANEL_MEMORY_WIDTH 240
+#define MOCK_PANEL_MEMORY_HEIGHT 320
+
+class MockSpiBus
+{
+      public:
+        /**
+         * Configures which pins the driver under test uses for the chip
+         * select and data/command lines and clears all state.
+         */
+        void attach(uint8_t cs_pin, uint8_t dc_pin)
+        {
+                this->cs_pin = cs_pin;
+                this->dc_pin = dc_pin;
+                reset();
+        }
+
+        /**
+         * Clears the display memory, the emulated controller state and the
+         * traffic statistics.
+         */
+        void reset()
+        {
+                memset(memory, 0, sizeof(memory));
+                reset_statistics();
+                chip_selected = false;
+                data_mode = false;
+                command = 0;
+                parameter_index = 0;
+                column_start = column_end = row_start = row_end = 0;
+                column = row = 0;
+                has_pending_byte = false;
+        }
+
+        void reset_statistics() { memset(&stats, 0, sizeof(stats)); }
+
+        const SpiBusStatistics &statistics() const { return stats; }
+
+        /**
+         * Returns the RGB565 value stored in the emulated display memory.
+         */
+        uint16_t pixel(int x, int y) const { return memory[y][x]; }
+
+        /**
+         * Returns a copy of the whole display memory, useful for comparing
+         * the results of two different drawing routines.
+         */
+        std::vector<uint16_t> memory_snapshot() const
+        {
+                return std::vector<uint16_t>(&memory[0][0],
+                                             &memory[0][0] +
+                                                 sizeof(memory) /
+                                                     sizeof(uint16_t));
+        }
+
+        void on_pin_write(uint8_t pin, uint8_t value)
+        {
+                if (pin == cs_pin || pin == dc_pin) {
+                        stats.pin_writes++;
+                        stats.estimated_time_us += MOCK_GPIO_WRITE_OVERHEAD_US;
+                }
+                if (pin == cs_pin) {
+                        bool selected = value == LOW;
+                        if (selected && !chip_selected) {
+                                stats.chip_select_assertions++;
+                        }
+                        chip_selected = selected;
+                } else if (pin == dc_pin) {
+                        data_mode = value == HIGH;
+                }
+        }
+
+        void on_begin_transaction(uint32_t clock_hz)
+        {
+                stats.transactions++;
+                stats.estimated_time_us += MOCK_SPI_TRANSACTION_OVERHEAD_US;
+                this->clock_hz = clock_hz;
+        }
+
+        void on_transfer_call()
+        {
+                stats.transfer_calls++;
+                stats.estimated_time_us += MOCK_SPI_TRANSFER_CALL_OVERHEAD_US;
+        }
+
+        void on_byte(uint8_t byte)
+        {
+                // The controller ignores the bus while it is not selected.
+                if (!chip_selected) {
+                        return;
+                }
+                stats.bytes++;
+                stats.estimated_time_us += 8 * 1e6 / clock_hz;
+                if (data_mode) {
+                        stats.data_bytes++;
+                        on_data(byte);
+                } else {
+                        stats.command_bytes++;
+                        command = byte;
+                        parameter_index = 0;
+                        has_pending_byte = false;
+                        if (command == ST7789_RAMWR) {
+                                column = column_start;
+                                row = row_start;
+                        }
+                }
+        }
+
+      private:
+        void on_data(uint8_t byte)
+        {
+                switch (command) {
+                case ST7789_CASET:
+                        set_address_parameter(&column_start, &column_end, byte);
+                        break;
+                case ST7789_RASET:
+                        set_address_parameter(&row_start, &row_end, byte);
+                        break;
+                case ST7789_RAMWR:
+                        if (!has_pending_byte) {
+                                pending_byte = byte;
+                                has_pending_byte = true;
+                                break;
+                        }
+                        has_pending_byte = false;
+                        write_pixel((pending_byte << 8) | byte);
+                        break;
+                default:
+                        // Other commands (init sequence etc.) are not modelled.
+                        break;
+                }
+        }
+
+        void set_address_parameter(uint16_t *start, uint16_t *end, uint8_t byte)
+        {
+                switch (parameter_index++) {
+                case 0:
+                        *start = byte << 8;
+                        break;
+                case 1:
+                        *start |= byte;
+                        break;
+                case 2:
+                        *end = byte << 8;
+                        break;
+                case 3:
+                        *end |= byte;
+                        break;
+                }
+        }
+
+        void write_pixel(uint16_t color)
+        {
+                if (column < MOCK_PANEL_MEMORY_WIDTH &&
+                    row < MOCK_PANEL_MEMORY_HEIGHT) {
+                        memory[row][column] = color;
+                }
+                if (column++ >= column_end) {
+                        column = column_start;
+                        if (row++ >= row_end) {
+                                row = row_start;
+                        }
+                }
+        }
+
+        uint8_t cs_pin = 0xFF;
+        uint8_t dc_pin = 0xFF;
+
+        SpiBusStatistics stats;
+        uint32_t clock_hz = 24000000;
+        bool chip_selected;
+        bool data_mode;
+
+        uint8_t command;
+        int parameter_index;
+        uint16_t column_start, column_end, row_start, row_end;
+        uint16_t column, row;
+        bool has_pending_byte;
+        uint8_t pending_byte;
+
+        uint16_t memory[MOCK_PANEL_MEMORY_HEIGHT][MOCK_PANEL_MEMORY_WIDTH];
+};
+
+inline MockSpiBus mock_spi_bus;
+
+inline void on_mock_pin_write(uint8_t pin, uint8_t value)
+{
+        mock_spi_bus.on_pin_write(pin, value);
+}
+
+class SPISettings
+{
+      public:
+        SPISettings(uint32_t clock, uint8_t bit_order, uint8_t data_mode)
+            : clock(clock)
+        {
+        }
+        uint32_t clock;
+};
+
+class SPIClass
+{
+      public:
+        void begin() {}
+        void beginTransaction(SPISettings settings)
+        {
+                mock_spi_bus.on_begin_transaction(settings.clock);
+        }
+        void endTransaction() {}
+        uint8_t transfer(uint8_t data)
+        {
+                mock_spi_bus.on_transfer_call();
+                mock_spi_bus.on_byte(data);
+                return 0;
+        }
+        /**
+         * Like the real implementation, the buffer is overwritten with the
+         * (here always zero) bytes read back from the bus.
+         */
+        void transfer(void *buffer, size_t count)
+        {
+                mock_spi_bus.on_transfer_call();
+                uint8_t *bytes = static_cast<uint8_t *>(buffer);
+                for (size_t i = 0; i < count; i++) {
+                        mock_spi_bus.on_byte(bytes[i]);
+                        bytes[i] = 0;
+                }
+        }
+};
+
+inline SPIClass SPI;
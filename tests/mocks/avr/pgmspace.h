@@ -0,0 +1,10 @@
+#pragma once
+/**
+ * Host-side stand-in for the AVR program memory helpers. On the host all
+ * data lives in regular memory so the accessors are plain dereferences.
+ */
+#include <cstdint>
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/buffered_display.hpp"
+#include "display_test_utils.hpp"
+#include <cstring>
+#include <vector>
+
+/**
+ * Draws the same scene both directly into the reference display and through
+ * the buffered display, the wrapped display needs to end up with the same
+ * pixels.
+ */
+static void draw_scene(Display &display, int frame)
+{
+        display.clear_region({.x = 10, .y = 10}, {.x = 90, .y = 50}, Blue);
+        display.draw_circle({.x = 40 + frame, .y = 30}, 12, Red, 1, true);
+        display.draw_rectangle({.x = 100, .y = 60}, 20, 20, Green, 1, false);
+        char text[] = "Score: 42";
+        display.draw_string({.x = 5, .y = 100}, text, Size16, Black, White);
+}
+
+TEST_CASE("Buffered display reproduces the drawn frames", "[buffered-display]")
+{
+        for (ShadowMode mode : {ShadowMode::FullCopy, ShadowMode::TileHashes}) {
+                HeadlessDisplay reference(160, 128);
+                HeadlessDisplay headless(160, 128);
+                HeadlessDisplayWithoutTft headless_without_tft(160, 128);
+                BufferedDisplay buffered(&headless, mode);
+                BufferedDisplay buffered_spans(&headless_without_tft, mode);
+                buffered.setup();
+                buffered_spans.setup();
+
+                for (int frame = 0; frame < 5; frame++) {
+                        draw_scene(reference, frame);
+                        draw_scene(buffered, frame);
+                        draw_scene(buffered_spans, frame);
+                        buffered.refresh();
+                        buffered_spans.refresh();
+                        REQUIRE(same_contents(headless.get_framebuffer(),
+                                              reference.get_framebuffer()));
+                        REQUIRE(same_contents(
+                            headless_without_tft.get_framebuffer(),
+                            reference.get_framebuffer()));
+                }
+        }
+}
+
+TEST_CASE("Buffered display pushes only the changed tiles",
+          "[buffered-display]")
+{
+        for (ShadowMode mode : {ShadowMode::FullCopy, ShadowMode::TileHashes}) {
+                HeadlessDisplay headless(160, 128);
+                BufferedDisplay buffered(&headless, mode);
+                buffered.setup();
+
+                // The first refresh repaints the whole screen.
+                buffered.refresh();
+                REQUIRE(buffered.get_statistics().pixels_pushed == 160 * 128);
+
+                // A cell inside of a single tile.
+                buffered.draw_rectangle({.x = 18, .y = 18}, 10, 10, Red, 1,
+                                        true);
+                buffered.refresh();
+                REQUIRE(buffered.get_statistics().tiles_pushed == 1);
+                REQUIRE(buffered.get_statistics().pixels_pushed ==
+                        BUFFERED_DISPLAY_TILE_SIZE *
+                            BUFFERED_DISPLAY_TILE_SIZE);
+
+                // Redrawing the same contents doesn't push anything.
+                long saved = buffered.get_statistics().bytes_saved();
+                buffered.draw_rectangle({.x = 18, .y = 18}, 10, 10, Red, 1,
+                                        true);
+                buffered.refresh();
+                REQUIRE(buffered.get_statistics().tiles_pushed == 0);
+                REQUIRE(buffered.get_statistics().transfers == 0);
+                REQUIRE(buffered.get_statistics().pixels_drawn == 100);
+                REQUIRE(buffered.get_statistics().bytes_saved() ==
+                        saved + 100 * 2);
+
+                // Adjacent tiles in a row are sent as a single window.
+                buffered.draw_rectangle({.x = 0, .y = 0}, 64, 4, Blue, 1,
+                                        true);
+                buffered.refresh();
+                REQUIRE(buffered.get_statistics().tiles_pushed == 4);
+                REQUIRE(buffered.get_statistics().transfers == 1);
+        }
+}
+
+TEST_CASE("Framebuffers split into strips hold the same pixels",
+          "[buffered-display]")
+{
+        // The last strip is only 2 rows high.
+        Rgb565Framebuffer contiguous(70, 50);
+        Rgb565Framebuffer striped(70, 50, 16);
+        for (Rgb565Framebuffer *framebuffer : {&contiguous, &striped}) {
+                framebuffer->fill_screen(Blue);
+                framebuffer->fill_circle(35, 25, 20, Red);
+                framebuffer->draw_line(0, 49, 69, 0, White);
+                framebuffer->fill_rect(60, 10, 20, 45, Green);
+                std::vector<uint16_t> image(8 * 8, Yellow);
+                framebuffer->push_image(-2, 44, 8, 8, image.data());
+        }
+        for (int y = 0; y < 50; y++) {
+                for (int x = 0; x < 70; x++) {
+                        REQUIRE(striped.pixel(x, y) == contiguous.pixel(x, y));
+                }
+        }
+        REQUIRE(memcmp(striped.row(47), contiguous.data() + 47 * 70,
+                       70 * sizeof(uint16_t)) == 0);
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "emulator_config.h"
+#include "../src/platform/emulator/font_provider.hpp"
+#include "../src/platform/emulator/sfml_display.hpp"
+
+TEST_CASE("Emulator font is loaded only once", "[emulator-font]")
+{
+        const sf::Font &font = get_emulator_font();
+        REQUIRE(&font == &get_emulator_font());
+}
+
+TEST_CASE("Emulator text objects are cached per string and size",
+          "[emulator-font]")
+{
+        sf::Text *small = &get_emulator_text("Score: 42", Size16);
+        REQUIRE(&get_emulator_text("Score: 42", Size16) == small);
+
+        sf::Text *large = &get_emulator_text("Score: 42", Size24);
+        REQUIRE(large != small);
+        REQUIRE(&get_emulator_text("Score: 42", Size24) == large);
+}
+
+/**
+ * Compares the throughput of `SfmlDisplay::draw_string` with the way it used to
+ * work, where the font was loaded from disk and parsed for every single call.
+ * This requires an OpenGL context and hence is not run by default, run it with
+ * `microbox-tests "[benchmark]"`.
+ */
+TEST_CASE("draw_string throughput", "[.][benchmark][emulator-font]")
+{
+        sf::RenderTexture texture({DISPLAY_WIDTH, DISPLAY_HEIGHT});
+        SfmlDisplay display(nullptr, &texture);
+        display.setup();
+
+        char label[] = "Evolutions/second";
+
+        BENCHMARK("draw_string, font loaded on every call")
+        {
+                const sf::Font font(
+                    std::string(CMAKE_SOURCE_DIR) +
+                    "/assets/emulator/JetBrainsMonoNerdFont-Regular.ttf");
+                sf::Text text(font, label, Size16);
+                text.setFillColor(sf::Color::White);
+                text.setPosition({10, 10});
+                texture.draw(text);
+        };
+
+        BENCHMARK("draw_string, cached font and glyphs")
+        {
+                display.draw_string({.x = 10, .y = 10}, label, Size16, Black,
+                                    White);
+        };
+}
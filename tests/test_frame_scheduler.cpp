@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/frame_scheduler.hpp"
+#include <vector>
+
+/**
+ * Simulated clock, sleeping advances the time without any waiting.
+ */
+class FakeTimeProvider : public TimeProvider
+{
+      public:
+        void delay_ms(int ms) const override
+        {
+                sleeps.push_back(ms);
+                now += ms;
+        }
+        long milliseconds() const override { return now; }
+
+        /**
+         * Time spent by the game loop on input handling and drawing.
+         */
+        void work(int ms) { now += ms; }
+
+        mutable long now = 1000;
+        mutable std::vector<int> sleeps;
+};
+
+TEST_CASE("Frames only sleep for the remaining budget", "[frame-scheduler]")
+{
+        FakeTimeProvider time;
+        FrameScheduler scheduler(&time, 50);
+
+        time.work(20);
+        scheduler.end_frame();
+        time.work(45);
+        scheduler.end_frame();
+        REQUIRE(time.sleeps == std::vector<int>{30, 5});
+        REQUIRE(time.now == 1100);
+        REQUIRE(scheduler.get_statistics().overruns == 0);
+
+        // An overrunning frame doesn't sleep and the next frame gets the whole
+        // budget again.
+        time.work(70);
+        scheduler.end_frame();
+        time.work(10);
+        scheduler.end_frame();
+        REQUIRE(time.sleeps == std::vector<int>{30, 5, 40});
+        REQUIRE(scheduler.get_statistics().overruns == 1);
+        REQUIRE(scheduler.get_statistics().longest_frame == 70);
+        REQUIRE(scheduler.get_statistics().frames == 4);
+}
+
+TEST_CASE("Ticks run at a fixed rate independently of the frames",
+          "[frame-scheduler]")
+{
+        FakeTimeProvider time;
+        FrameScheduler scheduler(&time, 50, 125);
+
+        int ticks = 0;
+        while (time.now <= 3000) {
+                time.work(5);
+                while (scheduler.consume_tick()) {
+                        ticks++;
+                        // The loop wakes up when the tick is due.
+                        REQUIRE(time.now == 1000 + ticks * 125 + 5);
+                }
+                scheduler.end_frame();
+        }
+        REQUIRE(ticks == 16);
+        REQUIRE(scheduler.get_statistics().overruns == 0);
+}
+
+TEST_CASE("Missed ticks are caught up on without sleeping",
+          "[frame-scheduler]")
+{
+        FakeTimeProvider time;
+        FrameScheduler scheduler(&time, 50, 100, 4);
+
+        // A slow frame misses three ticks.
+        time.work(320);
+        REQUIRE(scheduler.consume_tick());
+        time.sleeps.clear();
+        scheduler.end_frame();
+        REQUIRE(scheduler.consume_tick());
+        scheduler.end_frame();
+        REQUIRE(time.sleeps.empty());
+        REQUIRE(scheduler.consume_tick());
+        REQUIRE_FALSE(scheduler.consume_tick());
+
+        // Back on schedule, the loop sleeps until the next tick is due.
+        scheduler.end_frame();
+        scheduler.end_frame();
+        REQUIRE(time.now == 1400);
+        REQUIRE(scheduler.consume_tick());
+        REQUIRE(scheduler.get_statistics().dropped_ticks == 0);
+
+        // Falling further behind than the catch-up limit drops the ticks.
+        time.work(1000);
+        int ticks = 0;
+        while (scheduler.consume_tick()) {
+                ticks++;
+        }
+        REQUIRE(ticks == 4);
+        REQUIRE(scheduler.get_statistics().dropped_ticks == 6);
+}
+
+TEST_CASE("Skipped ticks don't fast-forward the game", "[frame-scheduler]")
+{
+        FakeTimeProvider time;
+        FrameScheduler scheduler(&time, 50, 100);
+
+        // Paused for a while.
+        for (int frame = 0; frame < 10; frame++) {
+                scheduler.skip_ticks();
+                scheduler.end_frame();
+        }
+        REQUIRE_FALSE(scheduler.consume_tick());
+        scheduler.end_frame();
+        scheduler.end_frame();
+        REQUIRE(scheduler.consume_tick());
+        REQUIRE_FALSE(scheduler.consume_tick());
+
+        // The hold-off after an input is not an overrun.
+        scheduler.delay(150);
+        scheduler.end_frame();
+        REQUIRE(scheduler.get_statistics().overruns == 0);
+}
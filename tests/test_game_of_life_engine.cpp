@@ -0,0 +1,330 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/game_of_life_engine.hpp"
+#include "../src/common/point.hpp"
+#include "life_test_utils.hpp"
+#include <cstdlib>
+#include <string>
+
+/**
+ * The original per-cell implementation of the simulation step.
+ */
+static LifeGrid reference_step(const LifeGrid &grid, bool use_toroidal_array,
+                               const LifeRule &rule = CONWAY_LIFE_RULE)
+{
+        LifeGrid next(grid.rows, grid.cols);
+        for (int y = 0; y < grid.rows; y++) {
+                for (int x = 0; x < grid.cols; x++) {
+                        IntPoint curr = {.x = x, .y = y};
+                        std::vector<IntPoint> neighbours =
+                            use_toroidal_array
+                                ? get_neighbours_toroidal_array(curr, grid.rows,
+                                                                grid.cols)
+                                : get_neighbours_inside_grid(curr, grid.rows,
+                                                             grid.cols);
+                        int alive_nb = 0;
+                        for (IntPoint nb : neighbours) {
+                                alive_nb += grid.get(nb.x, nb.y);
+                        }
+                        uint16_t mask =
+                            grid.get(x, y) ? rule.survival : rule.birth;
+                        next.set(x, y, (mask >> alive_nb) & 1);
+                }
+        }
+        return next;
+}
+
+TEST_CASE("Packed simulation steps match the per-cell rules", "[life]")
+{
+        srand(7);
+        struct Size {
+                int rows;
+                int cols;
+        };
+        // Covers single words, rows ending exactly on a word boundary and
+        // rows spanning several words, as well as degenerate toroidal grids.
+        Size sizes[] = {{1, 1},   {2, 2},  {3, 3},  {28, 30},
+                        {5, 64},  {9, 65}, {4, 127}, {17, 130}};
+
+        for (Size size : sizes) {
+                for (bool toroidal : {true, false}) {
+                        CAPTURE(size.rows, size.cols, toroidal);
+                        LifeGrid grid = random_grid(size.rows, size.cols);
+                        LifeGrid next;
+                        LifeGrid changed;
+                        for (int generation = 0; generation < 20;
+                             generation++) {
+                                LifeGrid expected =
+                                    reference_step(grid, toroidal);
+                                bool any_change =
+                                    GameOfLifeEngine::take_simulation_step(
+                                        grid, next, changed, toroidal);
+                                REQUIRE(next == expected);
+                                LifeGrid expected_changes(grid.rows,
+                                                          grid.cols);
+                                for (int y = 0; y < grid.rows; y++) {
+                                        for (int x = 0; x < grid.cols; x++) {
+                                                expected_changes.set(
+                                                    x, y,
+                                                    grid.get(x, y) !=
+                                                        next.get(x, y));
+                                        }
+                                }
+                                REQUIRE(changed == expected_changes);
+                                REQUIRE(any_change == !(grid == next));
+                                std::swap(grid, next);
+                        }
+                }
+        }
+}
+
+TEST_CASE("Gliders wrap around toroidal grids", "[life]")
+{
+        LifeGrid grid(10, 70);
+        IntPoint glider[] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+        for (IntPoint cell : glider) {
+                grid.set(cell.x, cell.y, true);
+        }
+        LifeGrid start = grid;
+        LifeGrid next;
+        LifeGrid changed;
+
+        // A glider moves by one cell diagonally every 4 generations, hence it
+        // returns to its initial position after crossing the whole grid along
+        // both axes.
+        for (int generation = 0; generation < 4 * 70; generation++) {
+                GameOfLifeEngine::take_simulation_step(grid, next, changed,
+                                                       true);
+                std::swap(grid, next);
+                REQUIRE(grid.population() == 5);
+        }
+        REQUIRE(grid == start);
+
+        int changed_cells = 0;
+        GameOfLifeEngine::diff(start, next, changed);
+        GameOfLifeEngine::for_each_set_cell(
+            changed, [&](int, int) { changed_cells++; });
+        REQUIRE(changed_cells == changed.population());
+        REQUIRE(changed_cells > 0);
+}
+
+TEST_CASE("Rules are parsed from and formatted into the B/S notation",
+          "[life]")
+{
+        LifeRule rule;
+        REQUIRE(parse_life_rule("B3/S23", rule));
+        REQUIRE(rule == CONWAY_LIFE_RULE);
+        REQUIRE(parse_life_rule("b36/s23", rule));
+        REQUIRE(rule == HIGHLIFE_RULE);
+        REQUIRE(parse_life_rule("B2/S", rule));
+        REQUIRE(rule == SEEDS_RULE);
+
+        char text[LIFE_RULE_MAX_LENGTH];
+        format_life_rule(DAY_AND_NIGHT_RULE, text);
+        REQUIRE(std::string(text) == "B3678/S34678");
+
+        // The rule is left untouched if the text is invalid.
+        REQUIRE_FALSE(parse_life_rule("B3S23", rule));
+        REQUIRE_FALSE(parse_life_rule("B39/S23", rule));
+        REQUIRE_FALSE(parse_life_rule("S23/B3", rule));
+        REQUIRE_FALSE(parse_life_rule("B3/S23x", rule));
+        REQUIRE(rule == SEEDS_RULE);
+}
+
+TEST_CASE("Packed simulation steps follow other rules", "[life]")
+{
+        srand(17);
+        // Besides the rules with compile-time kernels, covers rules going
+        // through the runtime kernel, including B0 and S8.
+        const char *rules[] = {"B36/S23",     "B2/S",      "B3678/S34678",
+                               "B1357/S1357", "B3/S12345", "B0123/S8"};
+        for (const char *text : rules) {
+                LifeRule rule;
+                REQUIRE(parse_life_rule(text, rule));
+                for (bool toroidal : {true, false}) {
+                        CAPTURE(text, toroidal);
+                        LifeGrid grid = random_grid(19, 70);
+                        LifeGrid next;
+                        LifeGrid changed;
+                        for (int generation = 0; generation < 10;
+                             generation++) {
+                                LifeGrid expected =
+                                    reference_step(grid, toroidal, rule);
+                                GameOfLifeEngine::take_simulation_step(
+                                    grid, next, changed, toroidal, rule);
+                                REQUIRE(next == expected);
+                                std::swap(grid, next);
+                        }
+                }
+        }
+}
+
+TEST_CASE("Active steps match the full steps", "[life]")
+{
+        srand(23);
+        const char *rules[] = {"B3/S23", "B36/S23", "B2/S", "B0123/S8"};
+        IntPoint sizes[] = {{70, 19}, {64, 7}, {130, 40}};
+        for (const char *text : rules) {
+                LifeRule rule;
+                REQUIRE(parse_life_rule(text, rule));
+                for (IntPoint size : sizes) {
+                        for (bool toroidal : {true, false}) {
+                                CAPTURE(text, size.x, toroidal);
+                                LifeGrid grid = random_grid(size.y, size.x);
+                                LifeGrid expected = grid;
+                                LifeGrid next;
+                                LifeGrid changed;
+                                LifeGrid edit(size.y, size.x);
+                                LifeActivity activity;
+                                for (int generation = 0; generation < 60;
+                                     generation++) {
+                                        GameOfLifeEngine::take_simulation_step(
+                                            expected, next, changed, toroidal,
+                                            rule);
+                                        std::swap(expected, next);
+                                        LifeGrid before = grid;
+                                        GameOfLifeEngine::take_active_step(
+                                            grid, changed, toroidal, activity,
+                                            rule);
+                                        REQUIRE(grid == expected);
+                                        GameOfLifeEngine::diff(before, grid,
+                                                               next);
+                                        REQUIRE(changed == next);
+                                        REQUIRE(activity.hash ==
+                                                GameOfLifeEngine::hash_grid(
+                                                    grid));
+
+                                        // Cells flipped by the user are
+                                        // picked up as well.
+                                        if (generation % 7 == 0) {
+                                                int x = rand() % size.x;
+                                                int y = rand() % size.y;
+                                                bool alive = !grid.get(x, y);
+                                                grid.set(x, y, alive);
+                                                expected.set(x, y, alive);
+                                                edit.clear();
+                                                edit.set(x, y, true);
+                                                activity.mark_changed(
+                                                    grid, edit, toroidal);
+                                        }
+                                }
+                        }
+                }
+        }
+}
+
+TEST_CASE("Still boards take no work", "[life]")
+{
+        LifeGrid grid(64, 256);
+        LifeGrid changed;
+        LifeActivity activity;
+        // A block and a blinker far apart from each other.
+        for (IntPoint cell : {IntPoint{10, 10}, IntPoint{11, 10},
+                              IntPoint{10, 11}, IntPoint{11, 11}}) {
+                grid.set(cell.x, cell.y, true);
+        }
+        for (int x = 199; x <= 201; x++) {
+                grid.set(x, 40, true);
+        }
+
+        REQUIRE(GameOfLifeEngine::take_active_step(grid, changed, false,
+                                                   activity));
+        // Only the words around the blinker are stepped from now on.
+        for (int generation = 0; generation < 10; generation++) {
+                REQUIRE(GameOfLifeEngine::take_active_step(grid, changed,
+                                                           false, activity));
+                REQUIRE(activity.active.size() <= 9);
+        }
+        int visited = 0;
+        GameOfLifeEngine::for_each_changed_cell(changed, activity,
+                                                [&](int x, int y) {
+                                                        REQUIRE(changed.get(x,
+                                                                            y));
+                                                        visited++;
+                                                });
+        REQUIRE(visited == 4);
+
+        // Once the blinker is removed, nothing is stepped at all.
+        LifeGrid before = grid;
+        for (int x = 199; x <= 201; x++) {
+                for (int y = 39; y <= 41; y++) {
+                        grid.set(x, y, false);
+                }
+        }
+        LifeGrid removed;
+        GameOfLifeEngine::diff(before, grid, removed);
+        activity.mark_changed(grid, removed, false);
+        REQUIRE_FALSE(activity.is_still());
+        REQUIRE_FALSE(GameOfLifeEngine::take_active_step(grid, changed, false,
+                                                         activity));
+        REQUIRE(activity.is_still());
+        REQUIRE(grid.population() == 4);
+        REQUIRE(changed.population() == 0);
+}
+
+/**
+ * Steps the grid until the detector finds an oscillation, returns its period
+ * and the generation after which the grid has settled.
+ */
+static void find_cycle(LifeGrid &grid, bool toroidal, int &period,
+                       int &settled_generation)
+{
+        LifeGrid changed;
+        LifeActivity activity;
+        activity.mark_all(grid);
+        LifeCycleDetector detector;
+        detector.reset(activity.hash);
+        period = 0;
+        while (period == 0 && detector.get_generation() < 1000) {
+                GameOfLifeEngine::take_active_step(grid, changed, toroidal,
+                                                   activity);
+                period = detector.observe(activity.hash);
+        }
+        settled_generation = detector.get_settled_generation();
+}
+
+TEST_CASE("Oscillations are detected", "[life]")
+{
+        int period;
+        int settled_generation;
+
+        // An L-tromino turns into a block.
+        LifeGrid grid(10, 10);
+        grid.set(4, 4, true);
+        grid.set(5, 4, true);
+        grid.set(4, 5, true);
+        find_cycle(grid, false, period, settled_generation);
+        REQUIRE(period == 1);
+        REQUIRE(settled_generation == 1);
+
+        grid.clear();
+        for (int x = 3; x <= 5; x++) {
+                grid.set(x, 4, true);
+        }
+        find_cycle(grid, false, period, settled_generation);
+        REQUIRE(period == 2);
+        REQUIRE(settled_generation == 0);
+
+        // Pentadecathlon.
+        grid = LifeGrid(20, 20);
+        for (int x : {2, 7}) {
+                grid.set(x + 5, 8, true);
+                grid.set(x + 5, 10, true);
+        }
+        for (int x : {0, 1, 3, 4, 5, 6, 8, 9}) {
+                grid.set(x + 5, 9, true);
+        }
+        find_cycle(grid, false, period, settled_generation);
+        REQUIRE(period == 15);
+        REQUIRE(settled_generation == 0);
+
+        // A glider on a toroidal grid is back where it started after it
+        // travels across the whole grid.
+        grid = LifeGrid(16, 16);
+        IntPoint glider[] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+        for (IntPoint cell : glider) {
+                grid.set(cell.x, cell.y, true);
+        }
+        find_cycle(grid, true, period, settled_generation);
+        REQUIRE(period == 64);
+        REQUIRE(settled_generation == 0);
+}
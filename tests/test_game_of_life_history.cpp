@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/game_of_life_history.hpp"
+#include "life_test_utils.hpp"
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Runs the simulation for the given number of generations, recording each of
+ * them in the history. Returns all visited states, the last one is the
+ * current state of the `grid`.
+ */
+static std::vector<LifeGrid> simulate(LifeGrid &grid, LifeHistory &history,
+                                      int generations)
+{
+        std::vector<LifeGrid> states = {grid};
+        LifeGrid next;
+        LifeGrid changed;
+        for (int i = 0; i < generations; i++) {
+                GameOfLifeEngine::take_simulation_step(grid, next, changed,
+                                                       true);
+                history.push(changed);
+                std::swap(grid, next);
+                states.push_back(grid);
+        }
+        return states;
+}
+
+TEST_CASE("Rewinding walks through all recorded generations", "[life]")
+{
+        srand(11);
+        LifeGrid grid = random_grid(28, 70);
+        LifeHistory history(100, 64 * 1024);
+        std::vector<LifeGrid> states = simulate(grid, history, 60);
+        REQUIRE(history.past_generations() == 60);
+
+        LifeGrid changed;
+        for (int i = (int)states.size() - 2; i >= 0; i--) {
+                LifeGrid before = grid;
+                REQUIRE(history.step_back(grid, changed));
+                REQUIRE(grid == states[i]);
+                LifeGrid expected_changes;
+                GameOfLifeEngine::diff(before, grid, expected_changes);
+                REQUIRE(changed == expected_changes);
+        }
+        REQUIRE_FALSE(history.step_back(grid, changed));
+        REQUIRE(grid == states[0]);
+
+        for (size_t i = 1; i < states.size(); i++) {
+                REQUIRE(history.step_forward(grid, changed));
+                REQUIRE(grid == states[i]);
+        }
+        REQUIRE_FALSE(history.step_forward(grid, changed));
+}
+
+TEST_CASE("History evicts the oldest generations", "[life]")
+{
+        srand(5);
+        SECTION("when the generation limit is reached")
+        {
+                LifeGrid grid = random_grid(20, 40);
+                LifeHistory history(10, 64 * 1024);
+                std::vector<LifeGrid> states = simulate(grid, history, 25);
+                REQUIRE(history.past_generations() == 10);
+
+                LifeGrid changed;
+                while (history.step_back(grid, changed)) {
+                }
+                REQUIRE(grid == states[15]);
+        }
+        SECTION("when the memory budget is exceeded")
+        {
+                LifeGrid grid = random_grid(20, 40);
+                LifeHistory history(1000, 512);
+                std::vector<LifeGrid> states = simulate(grid, history, 200);
+                REQUIRE(history.memory_usage() <= 512);
+                int available = history.past_generations();
+                REQUIRE(available > 0);
+                REQUIRE(available < 200);
+
+                LifeGrid changed;
+                while (history.step_back(grid, changed)) {
+                }
+                REQUIRE(grid == states[200 - available]);
+        }
+}
+
+TEST_CASE("Recording after a rewind drops the undone generations", "[life]")
+{
+        LifeGrid grid(10, 10);
+        LifeGrid changed(10, 10);
+        LifeHistory history(100);
+        for (int x = 0; x < 5; x++) {
+                grid.set(x, 0, true);
+                changed.clear();
+                changed.set(x, 0, true);
+                history.push(changed);
+        }
+        REQUIRE(history.step_back(grid, changed));
+        REQUIRE(history.step_back(grid, changed));
+        REQUIRE(history.future_generations() == 2);
+
+        grid.set(9, 9, true);
+        changed.clear();
+        changed.set(9, 9, true);
+        history.push(changed);
+        REQUIRE(history.future_generations() == 0);
+        REQUIRE(history.past_generations() == 4);
+
+        REQUIRE(history.step_back(grid, changed));
+        REQUIRE(grid.population() == 3);
+}
+
+TEST_CASE("Settled simulations take up little history memory", "[life]")
+{
+        // A blinker flips 4 cells on each generation, a copy of the full 28x30
+        // grid would take up over 100 bytes per generation.
+        LifeGrid grid(28, 30);
+        grid.set(10, 10, true);
+        grid.set(11, 10, true);
+        grid.set(12, 10, true);
+        LifeHistory history(5000, 64 * 1024);
+        simulate(grid, history, 5000);
+        REQUIRE(history.past_generations() == 5000);
+        REQUIRE(history.memory_usage() <= 5000 * 12);
+}
+
+TEST_CASE("History without a memory budget records nothing", "[life]")
+{
+        // The infinite mode can't be rewound and gets such a history.
+        srand(7);
+        LifeGrid grid = random_grid(20, 40);
+        LifeHistory history(0, 0);
+        simulate(grid, history, 10);
+        REQUIRE(history.past_generations() == 0);
+        REQUIRE(history.memory_usage() == 0);
+
+        LifeGrid changed;
+        LifeGrid current = grid;
+        REQUIRE_FALSE(history.step_back(grid, changed));
+        REQUIRE(grid == current);
+}
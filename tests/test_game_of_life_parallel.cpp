@@ -0,0 +1,47 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/game_of_life_parallel.hpp"
+#include "life_test_utils.hpp"
+#include <cstdlib>
+
+TEST_CASE("Parallel steps match the sequential ones", "[life]")
+{
+        srand(13);
+        struct Setup {
+                int rows;
+                int cols;
+                int threads;
+                int tile_rows;
+        };
+        // Covers tiles that don't divide the grid evenly, more threads than
+        // tiles and single row tiles.
+        Setup setups[] = {{100, 130, 4, 16}, {65, 64, 3, 64}, {7, 200, 8, 2},
+                          {50, 50, 2, 1},    {30, 30, 1, 8}};
+
+        for (Setup setup : setups) {
+                ParallelLifeStepper stepper(setup.threads, setup.tile_rows);
+                REQUIRE(stepper.get_thread_count() == setup.threads);
+                for (bool toroidal : {true, false}) {
+                        CAPTURE(setup.rows, setup.cols, setup.threads,
+                                toroidal);
+                        LifeGrid grid = random_grid(setup.rows, setup.cols);
+                        LifeGrid parallel_grid = grid;
+                        LifeGrid next, changed, parallel_next,
+                            parallel_changed;
+                        for (int generation = 0; generation < 30;
+                             generation++) {
+                                bool any_change =
+                                    GameOfLifeEngine::take_simulation_step(
+                                        grid, next, changed, toroidal);
+                                bool parallel_any_change =
+                                    stepper.take_simulation_step(
+                                        parallel_grid, parallel_next,
+                                        parallel_changed, toroidal);
+                                REQUIRE(parallel_next == next);
+                                REQUIRE(parallel_changed == changed);
+                                REQUIRE(parallel_any_change == any_change);
+                                std::swap(grid, next);
+                                std::swap(parallel_grid, parallel_next);
+                        }
+                }
+        }
+}
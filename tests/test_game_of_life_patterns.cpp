@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/game_of_life_patterns.hpp"
+#include <cstring>
+#include <string>
+
+static const char *QUEEN_BEE_SHUTTLE = "#N Queen bee shuttle\n"
+                                       "x = 22, y = 7, rule = B3/S23\n"
+                                       "9bo$7bobo$6bobo$2o3bo2bo11b2o$"
+                                       "2o4bobo11b2o$7bobo$9bo!\n";
+
+static LifeGrid decode(const char *rle, int rows, int cols)
+{
+        LifeGrid grid(rows, cols);
+        LifeRleDecoder decoder(grid);
+        REQUIRE(decoder.feed(rle, strlen(rle)));
+        REQUIRE(decoder.is_done());
+        return grid;
+}
+
+TEST_CASE("Runs of cells are set across words and clipped", "[life]")
+{
+        LifeGrid grid(3, 150);
+        set_life_run(grid, 20, 1, 100);
+        set_life_run(grid, -5, 0, 7);
+        set_life_run(grid, 145, 2, 10);
+        set_life_run(grid, 0, 3, 10);
+
+        for (int x = 0; x < grid.cols; x++) {
+                REQUIRE(grid.get(x, 0) == (x < 2));
+                REQUIRE(grid.get(x, 1) == (x >= 20 && x < 120));
+                REQUIRE(grid.get(x, 2) == (x >= 145));
+        }
+        REQUIRE(grid.population() == 2 + 100 + 5);
+        // The bits past the last column stay clear.
+        REQUIRE((grid.row(2)[grid.words_per_row - 1] &
+                 ~grid.last_word_mask()) == 0);
+}
+
+TEST_CASE("RLE patterns are centred on the grid", "[life]")
+{
+        LifeGrid grid(9, 9);
+        LifeRleDecoder decoder(grid);
+        const char *glider = "#C comment\nx = 3, y = 3\nbo$2bo$3o!";
+        REQUIRE(decoder.feed(glider, strlen(glider)));
+        REQUIRE(decoder.is_done());
+        REQUIRE(decoder.get_width() == 3);
+        REQUIRE(decoder.get_height() == 3);
+        LifeRule rule;
+        REQUIRE_FALSE(decoder.get_rule(rule));
+
+        REQUIRE(grid.population() == 5);
+        REQUIRE(grid.get(4, 3));
+        REQUIRE(grid.get(5, 4));
+        REQUIRE(grid.get(3, 5));
+        REQUIRE(grid.get(4, 5));
+        REQUIRE(grid.get(5, 5));
+}
+
+TEST_CASE("RLE patterns can be decoded in chunks", "[life]")
+{
+        LifeGrid expected = decode(QUEEN_BEE_SHUTTLE, 20, 30);
+
+        // The chunk boundaries fall inside the header and the run counts.
+        LifeGrid grid(20, 30);
+        LifeRleDecoder decoder(grid);
+        for (const char *c = QUEEN_BEE_SHUTTLE; *c; c++) {
+                REQUIRE(decoder.feed(c, 1));
+        }
+        REQUIRE(decoder.is_done());
+        REQUIRE(grid == expected);
+        LifeRule rule;
+        REQUIRE(decoder.get_rule(rule));
+        REQUIRE(rule == CONWAY_LIFE_RULE);
+
+        // The queen bee shuttle is an oscillator with a period of 30.
+        LifeGrid next;
+        LifeGrid changed;
+        for (int generation = 0; generation < 30; generation++) {
+                GameOfLifeEngine::take_simulation_step(grid, next, changed,
+                                                       false);
+                std::swap(grid, next);
+        }
+        REQUIRE(grid == expected);
+}
+
+TEST_CASE("Patterns larger than the grid are clipped", "[life]")
+{
+        LifeGrid grid = decode(QUEEN_BEE_SHUTTLE, 5, 10);
+        // The middle 10 columns and 5 rows of the pattern are kept.
+        LifeGrid full = decode(QUEEN_BEE_SHUTTLE, 7, 22);
+        for (int y = 0; y < grid.rows; y++) {
+                for (int x = 0; x < grid.cols; x++) {
+                        REQUIRE(grid.get(x, y) == full.get(x + 6, y + 1));
+                }
+        }
+}
+
+TEST_CASE("Malformed RLE patterns are rejected", "[life]")
+{
+        const char *patterns[] = {
+            "bo$2bo$3o!",
+            "x = 3\nbo$2bo$3o!",
+            "x = 3, y = 3\nbo$2bo$3o?",
+        };
+        for (const char *pattern : patterns) {
+                LifeGrid grid(10, 10);
+                LifeRleDecoder decoder(grid);
+                REQUIRE_FALSE(decoder.feed(pattern, strlen(pattern)));
+                REQUIRE(decoder.has_failed());
+                REQUIRE_FALSE(decoder.is_done());
+        }
+}
+
+TEST_CASE("Encoded RLE patterns decode to the same cells", "[life]")
+{
+        LifeGrid grid = decode(QUEEN_BEE_SHUTTLE, 20, 30);
+        std::string rle = encode_life_rle(grid, HIGHLIFE_RULE);
+        REQUIRE(rle.rfind("x = 22, y = 7, rule = B36/S23\n", 0) == 0);
+
+        LifeGrid decoded(20, 30);
+        LifeRleDecoder decoder(decoded);
+        REQUIRE(decoder.feed(rle.data(), rle.size()));
+        REQUIRE(decoder.is_done());
+        REQUIRE(decoded == grid);
+        LifeRule rule;
+        REQUIRE(decoder.get_rule(rule));
+        REQUIRE(rule == HIGHLIFE_RULE);
+
+        // A wide pattern with empty rows gets its lines wrapped.
+        LifeGrid wide(10, 200);
+        for (int x = 0; x < wide.cols; x += 2) {
+                wide.set(x, 0, true);
+                wide.set(x + 1, 9, true);
+        }
+        rle = encode_life_rle(wide, CONWAY_LIFE_RULE);
+        size_t line_start = 0;
+        while (line_start < rle.size()) {
+                size_t line_end = rle.find('\n', line_start);
+                REQUIRE(line_end - line_start <= 70);
+                line_start = line_end + 1;
+        }
+        REQUIRE(rle.find("9$") != std::string::npos);
+        REQUIRE(decode(rle.c_str(), 10, 200) == wide);
+}
+
+TEST_CASE("Patterns from the bank are placed on the grid", "[life]")
+{
+        for (int i = 0; i < LIFE_PATTERN_BANK_SIZE; i++) {
+                const LifePattern &pattern = LIFE_PATTERN_BANK[i];
+                // The bank patterns fit the smallest grid.
+                REQUIRE(pattern.width <= 25);
+                REQUIRE(pattern.height <= 30);
+
+                LifeGrid grid(30, 25);
+                place_life_pattern(pattern, grid);
+                int bits = 0;
+                int bytes = (pattern.width + 7) / 8 * pattern.height;
+                for (int b = 0; b < bytes; b++) {
+                        bits += __builtin_popcount(pattern.rows[b]);
+                }
+                REQUIRE(grid.population() == bits);
+        }
+
+        // The glider moves by one cell diagonally every 4 generations.
+        LifeGrid grid(9, 9);
+        place_life_pattern(LIFE_PATTERN_BANK[0], grid);
+        LifeGrid expected = decode("x = 3, y = 3\nbo$2bo$3o!", 11, 11);
+        LifeGrid next;
+        LifeGrid changed;
+        for (int generation = 0; generation < 4; generation++) {
+                GameOfLifeEngine::take_simulation_step(grid, next, changed,
+                                                       false);
+                std::swap(grid, next);
+        }
+        for (int y = 0; y < grid.rows; y++) {
+                for (int x = 0; x < grid.cols; x++) {
+                        REQUIRE(grid.get(x, y) == expected.get(x, y));
+                }
+        }
+}
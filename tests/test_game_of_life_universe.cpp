@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/game_of_life_universe.hpp"
+#include "../src/common/point.hpp"
+#include <cstdlib>
+
+static const IntPoint GLIDER[] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+
+TEST_CASE("Universe matches a bounded grid that the cells never reach",
+          "[life]")
+{
+        srand(3);
+        // The random soup is placed across the tile boundaries around the
+        // origin, the bounded grid is large enough for its edges not to
+        // matter over the simulated generations.
+        int margin = 100;
+        int soup = 80;
+        int origin = -40;
+        LifeGrid grid(soup + 2 * margin, soup + 2 * margin);
+        LifeUniverse universe;
+        for (int y = 0; y < soup; y++) {
+                for (int x = 0; x < soup; x++) {
+                        bool alive = rand() % 10 <= 3;
+                        grid.set(margin + x, margin + y, alive);
+                        universe.set(origin + x, origin + y, alive);
+                }
+        }
+
+        LifeGrid next;
+        LifeGrid changed;
+        LifeGrid viewport(grid.rows, grid.cols);
+        for (int generation = 0; generation < 60; generation++) {
+                GameOfLifeEngine::take_simulation_step(grid, next, changed,
+                                                       false);
+                std::swap(grid, next);
+                universe.step();
+
+                universe.copy_region(origin - margin, origin - margin,
+                                     viewport);
+                REQUIRE(viewport == grid);
+                REQUIRE(universe.population() == grid.population());
+        }
+        REQUIRE(universe.get_generation() == 60);
+}
+
+TEST_CASE("Gliders travel across tiles and leave no tiles behind", "[life]")
+{
+        LifeUniverse universe;
+        for (IntPoint cell : GLIDER) {
+                universe.set(cell.x, cell.y, true);
+        }
+
+        // The glider moves by one cell diagonally every 4 generations.
+        int distance = 500;
+        for (int generation = 0; generation < 4 * distance; generation++) {
+                universe.step();
+        }
+        REQUIRE(universe.population() == 5);
+        for (IntPoint cell : GLIDER) {
+                REQUIRE(universe.get(cell.x + distance, cell.y + distance));
+        }
+        // The glider spans at most 2x2 tiles, plus the empty tiles it is about
+        // to move into.
+        REQUIRE(universe.tile_count() <= 9);
+        REQUIRE_FALSE(universe.is_full());
+}
+
+TEST_CASE("Universe stops growing once it runs out of memory", "[life]")
+{
+        LifeUniverse universe(3 * sizeof(LifeTile));
+        for (IntPoint cell : GLIDER) {
+                universe.set(cell.x + 10, cell.y + 10, true);
+        }
+        for (int generation = 0; generation < 4 * 200; generation++) {
+                universe.step();
+                REQUIRE(universe.tile_count() <= 3);
+        }
+        // The glider has hit the edge of the tiles that could be allocated
+        // and has turned into a still life or died out.
+        REQUIRE(universe.is_full());
+        REQUIRE(universe.population() < 5);
+}
+
+TEST_CASE("Universe stays within the memory budget", "[life]")
+{
+        srand(5);
+        // The budgets of the boards and a few odd sizes.
+        for (int budget : {3 * (int)sizeof(LifeTile), 24 * 1024, 41 * 1000}) {
+                // A soup spread over more tiles than fit into the budget.
+                LifeUniverse universe(budget);
+                for (int y = -200; y < 200; y++) {
+                        for (int x = -200; x < 200; x++) {
+                                universe.set(x, y, rand() % 10 <= 3);
+                        }
+                }
+                REQUIRE(universe.is_full());
+                REQUIRE(universe.tile_count() == universe.max_tile_count());
+                REQUIRE(universe.get_memory_usage() <= budget);
+
+                // The tiles are released and created again as the soup
+                // evolves, without growing the pool or the index.
+                int usage = universe.get_memory_usage();
+                for (int generation = 0; generation < 50; generation++) {
+                        universe.step();
+                        REQUIRE(universe.tile_count() <=
+                                universe.max_tile_count());
+                }
+                REQUIRE(universe.get_memory_usage() == usage);
+                universe.clear();
+                REQUIRE(universe.population() == 0);
+                REQUIRE(universe.get_memory_usage() == usage);
+        }
+}
+
+TEST_CASE("Cells can be set at negative coordinates", "[life]")
+{
+        LifeUniverse universe;
+        universe.set(-1, -1, true);
+        universe.set(-64, -65, true);
+        universe.set(63, 64, true);
+        REQUIRE(universe.get(-1, -1));
+        REQUIRE(universe.get(-64, -65));
+        REQUIRE(universe.get(63, 64));
+        REQUIRE_FALSE(universe.get(0, 0));
+        REQUIRE(universe.population() == 3);
+
+        universe.set(-1, -1, false);
+        REQUIRE_FALSE(universe.get(-1, -1));
+        REQUIRE(universe.population() == 2);
+}
@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/platform/emulator/headless_display.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * Reference implementation of the TFT_eSPI / Adafruit GFX fillCircle, it draws
+ * the circle using vertical lines pixel by pixel.
+ */
+static void reference_fill_circle(std::vector<bool> &pixels, int width,
+                                  int x0, int y0, int r)
+{
+        auto vline = [&](int x, int y, int h) {
+                for (int i = 0; i < h; i++) {
+                        pixels[(y + i) * width + x] = true;
+                }
+        };
+        vline(x0, y0 - r, 2 * r + 1);
+        int f = 1 - r;
+        int ddF_x = 1;
+        int ddF_y = -2 * r;
+        int x = 0;
+        int y = r;
+        int px = x;
+        int py = y;
+        while (x < y) {
+                if (f >= 0) {
+                        y--;
+                        ddF_y += 2;
+                        f += ddF_y;
+                }
+                x++;
+                ddF_x += 2;
+                f += ddF_x;
+                if (x < (y + 1)) {
+                        vline(x0 + x, y0 - y, 2 * y + 1);
+                        vline(x0 - x, y0 - y, 2 * y + 1);
+                }
+                if (y != py) {
+                        vline(x0 + py, y0 - px, 2 * px + 1);
+                        vline(x0 - py, y0 - px, 2 * px + 1);
+                        py = y;
+                }
+                px = x;
+        }
+}
+
+TEST_CASE("Headless display fills circles like TFT_eSPI", "[headless-display]")
+{
+        int size = 64;
+        int center = size / 2;
+        for (int r = 0; r < center; r++) {
+                HeadlessDisplay display(size, size);
+                display.fillCircle(center, center, r, White);
+
+                std::vector<bool> expected(size * size, false);
+                reference_fill_circle(expected, size, center, center, r);
+
+                const Rgb565Framebuffer &framebuffer =
+                    display.get_framebuffer();
+                for (int y = 0; y < size; y++) {
+                        for (int x = 0; x < size; x++) {
+                                INFO("r = " << r << ", x = " << x
+                                            << ", y = " << y);
+                                REQUIRE((framebuffer.pixel(x, y) == White) ==
+                                        expected[y * size + x]);
+                        }
+                }
+        }
+}
+
+TEST_CASE("Headless display clips shapes to the screen", "[headless-display]")
+{
+        HeadlessDisplay display(32, 16);
+        display.clear(Black);
+        display.fillRoundRect(-10, -10, 100, 100, 8, Red);
+        display.drawLine(-5, 8, 40, 8, Blue);
+        display.fillTriangle(-20, 0, 20, 0, -20, 20, Green);
+
+        const Rgb565Framebuffer &framebuffer = display.get_framebuffer();
+        REQUIRE(framebuffer.pixel(0, 0) == Green);
+        REQUIRE(framebuffer.pixel(31, 15) == Red);
+        REQUIRE(framebuffer.pixel(31, 8) == Blue);
+}
+
+TEST_CASE("Headless display renders rounded rectangles", "[headless-display]")
+{
+        HeadlessDisplay display(32, 32);
+        display.clear(Black);
+        display.fillRoundRect(4, 4, 20, 10, 4, White);
+
+        const Rgb565Framebuffer &framebuffer = display.get_framebuffer();
+        // Corners are cut off, edge midpoints and the center are filled.
+        REQUIRE(framebuffer.pixel(4, 4) == Black);
+        REQUIRE(framebuffer.pixel(23, 13) == Black);
+        REQUIRE(framebuffer.pixel(14, 4) == White);
+        REQUIRE(framebuffer.pixel(4, 9) == White);
+        REQUIRE(framebuffer.pixel(23, 9) == White);
+        REQUIRE(framebuffer.pixel(14, 13) == White);
+        REQUIRE(framebuffer.pixel(24, 9) == Black);
+
+        display.clear(Black);
+        display.drawRoundRect(4, 4, 20, 10, 4, White);
+        REQUIRE(framebuffer.pixel(14, 4) == White);
+        REQUIRE(framebuffer.pixel(14, 9) == Black);
+}
+
+TEST_CASE("Headless display draws characters", "[headless-display]")
+{
+        HeadlessDisplay display(32, 32);
+        display.clear(Black);
+
+        // A space with a distinct background fills the whole scaled cell.
+        display.drawChar(0, 0, ' ', White, Blue, 2);
+        const Rgb565Framebuffer &framebuffer = display.get_framebuffer();
+        REQUIRE(framebuffer.pixel(0, 0) == Blue);
+        REQUIRE(framebuffer.pixel(9, 15) == Blue);
+        REQUIRE(framebuffer.pixel(10, 0) == Black);
+
+        // With the same background and foreground color only the glyph
+        // pixels are drawn.
+        display.drawChar(0, 16, 'A', White, White, 1);
+        int set_pixels = 0;
+        for (int y = 16; y < 24; y++) {
+                for (int x = 0; x < 5; x++) {
+                        set_pixels += framebuffer.pixel(x, y) == White;
+                        REQUIRE((framebuffer.pixel(x, y) == White ||
+                                 framebuffer.pixel(x, y) == Black));
+                }
+        }
+        REQUIRE(set_pixels > 0);
+}
+
+TEST_CASE("Headless display stops after the frame limit", "[headless-display]")
+{
+        HeadlessDisplay display;
+        display.set_frame_limit(3);
+        REQUIRE(display.refresh());
+        REQUIRE(display.refresh());
+        REQUIRE_FALSE(display.refresh());
+        REQUIRE_FALSE(display.refresh());
+        REQUIRE(display.get_frame_count() == 4);
+}
+
+TEST_CASE("Headless display writes PPM snapshots", "[headless-display]")
+{
+        HeadlessDisplay display(4, 2);
+        display.clear(Black);
+        display.drawPixel(1, 0, Red);
+        display.drawPixel(3, 1, White);
+
+        std::string path = (std::filesystem::temp_directory_path() /
+                            "microbox-headless-display-test.ppm")
+                               .string();
+        REQUIRE(display.write_ppm(path.c_str()));
+
+        FILE *file = fopen(path.c_str(), "rb");
+        REQUIRE(file != nullptr);
+        int width, height, max_value;
+        REQUIRE(fscanf(file, "P6 %d %d %d", &width, &height, &max_value) == 3);
+        fgetc(file);
+        REQUIRE(width == 4);
+        REQUIRE(height == 2);
+        REQUIRE(max_value == 255);
+
+        std::vector<uint8_t> rgb(3 * width * height);
+        REQUIRE(fread(rgb.data(), 1, rgb.size(), file) == rgb.size());
+        fclose(file);
+        std::filesystem::remove(path);
+
+        REQUIRE(rgb[3 * 1 + 0] == 255);
+        REQUIRE(rgb[3 * 1 + 1] == 0);
+        REQUIRE(rgb[3 * 1 + 2] == 0);
+        REQUIRE(rgb[3 * 7 + 0] == 255);
+        REQUIRE(rgb[3 * 7 + 1] == 255);
+        REQUIRE(rgb[3 * 7 + 2] == 255);
+        REQUIRE(rgb[0] == 0);
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#ifdef DISPLAY_INSTRUMENTATION
+#include "../src/common/instrumented_display.hpp"
+#include "../src/platform/emulator/headless_display.hpp"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * Clock advancing by 5us each time it is read, i.e. each drawing call takes
+ * 5us.
+ */
+class SteppingTimeProvider : public TimeProvider
+{
+      public:
+        void delay_ms(int ms) const override { now_us += ms * 1000; }
+        long milliseconds() const override { return now_us / 1000; }
+        long microseconds() const override
+        {
+                now_us += 5;
+                return now_us;
+        }
+
+      private:
+        mutable long now_us = 0;
+};
+
+static void draw_frame(InstrumentedDisplay &display)
+{
+        TftCompatibleDisplay &tft = *display.cast_into_tft_compatible();
+        display.clear(Black);
+        tft.fillRect(0, 0, 10, 10, Red);
+        // Overlaps the first fill in 50 pixels.
+        tft.fillRect(5, 5, 20, 10, Green);
+        display.draw_line({.x = 0, .y = 40}, {.x = 9, .y = 40}, White);
+}
+
+TEST_CASE("Frame costs are measured per refresh", "[instrumentation]")
+{
+        SteppingTimeProvider time;
+        HeadlessDisplay headless(100, 50);
+        InstrumentedDisplay display(&headless, &time);
+
+        draw_frame(display);
+        REQUIRE(display.refresh());
+        // Polling for input doesn't count as a frame.
+        REQUIRE(display.refresh());
+
+        const FrameCost &frame = display.get_last_frame();
+        REQUIRE(frame.calls == 4);
+        REQUIRE(frame.pixels == 5000 + 100 + 200 + 10);
+        REQUIRE(frame.unique_pixels == 5000);
+        REQUIRE(frame.overdraw_percent() == 106);
+        REQUIRE(frame.transfer_bytes == 5310 * 2 + 4 * 11);
+        REQUIRE(frame.time_us == 4 * 5);
+
+        const AppDisplayCost *menu =
+            display.find_app(INSTRUMENTATION_DEFAULT_APP);
+        REQUIRE(menu != nullptr);
+        REQUIRE(menu->frames == 1);
+        REQUIRE(menu->idle_frames == 1);
+        REQUIRE(menu->primitives[(int)DrawCommandType::TftFillRect].calls == 2);
+        REQUIRE(menu->primitives[(int)DrawCommandType::TftFillRect].pixels ==
+                300);
+        REQUIRE(headless.get_framebuffer().data()[7 * 100 + 7] == Green);
+}
+
+TEST_CASE("Frames are attributed to the running app", "[instrumentation]")
+{
+        SteppingTimeProvider time;
+        HeadlessDisplay headless(100, 50);
+        InstrumentedDisplay display(&headless, &time);
+        display.set_overlay(true);
+
+        draw_frame(display);
+        display.refresh();
+        {
+                InstrumentedAppScope scope(&display, "Snake");
+                REQUIRE(strcmp(display.get_app(), "Snake") == 0);
+                for (int i = 0; i < 3; i++) {
+                        draw_frame(display);
+                        display.refresh();
+                }
+        }
+        REQUIRE(strcmp(display.get_app(), INSTRUMENTATION_DEFAULT_APP) == 0);
+        // The overlay drawn on the previous refresh is not counted.
+        display.refresh();
+
+        REQUIRE(display.get_apps().size() == 2);
+        const AppDisplayCost *snake = display.find_app("Snake");
+        REQUIRE(snake->frames == 3);
+        REQUIRE(snake->idle_frames == 0);
+        REQUIRE(snake->pixels_per_frame.count == 3);
+        REQUIRE(display.find_app(INSTRUMENTATION_DEFAULT_APP)->frames == 1);
+        REQUIRE(display.find_app(INSTRUMENTATION_DEFAULT_APP)->idle_frames ==
+                1);
+
+        const char *path = "test_instrumented_display.csv";
+        REQUIRE(display.write_csv(path));
+        FILE *file = fopen(path, "r");
+        REQUIRE(file != nullptr);
+        char line[64];
+        REQUIRE(fgets(line, sizeof(line), file) != nullptr);
+        REQUIRE(strcmp(line, "app,section,name,count,total\n") == 0);
+        fclose(file);
+        remove(path);
+}
+
+TEST_CASE("Cost histograms use power of two buckets", "[instrumentation]")
+{
+        CostHistogram histogram;
+        for (uint32_t value : {0u, 1u, 2u, 3u, 4u, 1000u}) {
+                histogram.add(value);
+        }
+        REQUIRE(histogram.count == 6);
+        REQUIRE(histogram.buckets[0] == 1);
+        REQUIRE(histogram.buckets[1] == 1);
+        REQUIRE(histogram.buckets[2] == 2);
+        REQUIRE(histogram.buckets[3] == 1);
+        REQUIRE(histogram.buckets[10] == 1);
+        REQUIRE(CostHistogram::bucket_start(10) == 512);
+        REQUIRE(CostHistogram::bucket_end(10) == 1023);
+        REQUIRE(histogram.percentile(50) == 3);
+        REQUIRE(histogram.percentile(100) == 1023);
+
+        histogram.add(UINT32_MAX);
+        REQUIRE(histogram.buckets[COST_HISTOGRAM_BUCKETS - 1] == 1);
+}
+#endif
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/palette_display.hpp"
+#include "display_test_utils.hpp"
+#include <algorithm>
+
+static void draw_scene(Display &display, int frame)
+{
+        if (frame == 0) {
+                display.draw_rounded_border(Cyan);
+        }
+        display.clear_region({.x = 10, .y = 10}, {.x = 90, .y = 50}, Blue);
+        display.draw_circle({.x = 40 + frame, .y = 30}, 12, Red, 1, true);
+        display.draw_circle({.x = 120, .y = 90}, 20, Yellow, 3, false);
+        display.draw_rectangle({.x = 100, .y = 60}, 20, 20, Green, 2, false);
+        display.draw_rounded_rectangle({.x = 20, .y = 70}, 50, 30, 8, Magenta);
+        display.draw_line({.x = 0, .y = 127}, {.x = 159, .y = 3 * frame},
+                          LightBlue);
+        char text[] = "Score: 42";
+        display.draw_string({.x = 5, .y = 100}, text, Size16, Black, White);
+
+        TftCompatibleDisplay *tft = display.cast_into_tft_compatible();
+        tft->setTextColor(Brown);
+        tft->setTextSize(2);
+        tft->drawString("Hi", 130, 5 + frame);
+        tft->fillTriangle(140, 110, 159, 127, 120, 127, GrayBlue);
+}
+
+TEST_CASE("Palette display reproduces the drawn frames", "[palette-display]")
+{
+        // Budgets resulting in a single band, a few bands of an odd height and
+        // single-row bands.
+        for (int bits_per_pixel : {4, 8}) {
+                for (int budget : {64 * 1024, 16 * 1024, 1}) {
+                        HeadlessDisplay reference(160, 128);
+                        HeadlessDisplay headless(160, 128);
+                        HeadlessDisplayWithoutTft headless_pushed(160, 128,
+                                                                  true);
+                        HeadlessDisplayWithoutTft headless_spans(160, 128);
+                        PaletteDisplay palette(&headless, bits_per_pixel,
+                                               budget);
+                        PaletteDisplay palette_pushed(&headless_pushed,
+                                                      bits_per_pixel, budget);
+                        PaletteDisplay palette_spans(&headless_spans,
+                                                     bits_per_pixel, budget);
+
+                        for (int frame = 0; frame < 3; frame++) {
+                                draw_scene(reference, frame);
+                                draw_scene(palette, frame);
+                                draw_scene(palette_pushed, frame);
+                                draw_scene(palette_spans, frame);
+                                palette.refresh();
+                                palette_pushed.refresh();
+                                palette_spans.refresh();
+                                REQUIRE(same_contents(headless, reference));
+                                REQUIRE(same_contents(headless_pushed,
+                                                      reference));
+                                REQUIRE(same_contents(headless_spans,
+                                                      reference));
+                        }
+                }
+        }
+}
+
+TEST_CASE("Palette display stays within the RAM budget", "[palette-display]")
+{
+        // The 1.69 inch display, which does not expose the TFT-compatible
+        // interface but streams the pixels.
+        HeadlessDisplayWithoutTft headless(280, 240, true);
+        PaletteDisplay palette(&headless);
+        REQUIRE(palette.get_memory_usage() <=
+                PALETTE_DISPLAY_DEFAULT_RAM_BUDGET);
+        int band_height = palette.get_surface().get_band_height();
+        REQUIRE(band_height > 8);
+        REQUIRE(palette.get_memory_usage() + 280 / 2 >
+                PALETTE_DISPLAY_DEFAULT_RAM_BUDGET);
+
+        // A full-screen frame is sent in windows of 3 rows that fit into the
+        // staging buffer instead of a transfer per run of pixels.
+        palette.clear(Black);
+        palette.refresh();
+        int bands = (240 + band_height - 1) / band_height;
+        REQUIRE(palette.get_statistics().bands == bands);
+        REQUIRE(palette.get_statistics().pixels_pushed == 280 * 240);
+        REQUIRE(palette.get_statistics().transfers <= 240 / 3 + bands);
+
+        // The recorded texts don't grow past the reserved space.
+        char text[] = "Some text that gets drawn over and over again";
+        for (int i = 0; i < 100; i++) {
+                palette.draw_string({.x = 0, .y = i}, text, Size16, Black,
+                                    White);
+        }
+        REQUIRE(palette.get_memory_usage() <=
+                PALETTE_DISPLAY_DEFAULT_RAM_BUDGET);
+}
+
+TEST_CASE("Colors that do not fit into the palette use the closest entry",
+          "[palette-display]")
+{
+        HeadlessDisplay headless(32, 32);
+        PaletteDisplay palette(&headless, 4);
+
+        const Color colors[] = {White,     Black,      Red,       Green,
+                                Blue,      GreenBlue,  Magenta,   Cyan,
+                                Yellow,    Brown,      BrownRed,  Gray,
+                                DarkBlue,  LightBlue,  GrayBlue,  LightGreen,
+                                LightGray, MediumBlue, LightGrayBlue};
+        int count = sizeof(colors) / sizeof(colors[0]);
+        for (int i = 0; i < count; i++) {
+                palette.clear_region({.x = i, .y = 0}, {.x = i + 1, .y = 1},
+                                     colors[i]);
+        }
+        palette.refresh();
+
+        REQUIRE(palette.get_statistics().palette_misses == count - 15);
+        for (int i = 0; i < 15; i++) {
+                REQUIRE(headless.get_framebuffer().pixel(i, 0) == colors[i]);
+        }
+        for (int i = 15; i < count; i++) {
+                uint16_t pixel = headless.get_framebuffer().pixel(i, 0);
+                REQUIRE(std::find(colors, colors + 15, pixel) != colors + 15);
+        }
+}
@@ -0,0 +1,211 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/queued_display.hpp"
+#include "../src/platform/emulator/headless_display.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SleepingTimeProvider : public TimeProvider
+{
+      public:
+        void delay_ms(int ms) const override
+        {
+                std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        }
+        long milliseconds() const override
+        {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+        }
+};
+
+/**
+ * Stands in for the render task pinned to the second core of the ESP32.
+ */
+class RenderThread
+{
+      public:
+        RenderThread(DrawCommandQueue &queue, Display &display)
+            : thread([this, &queue, &display]() {
+                      while (!stopped) {
+                              if (queue.process(display) == 0) {
+                                      std::this_thread::yield();
+                              }
+                      }
+              })
+        {
+        }
+        ~RenderThread()
+        {
+                stopped = true;
+                thread.join();
+        }
+
+      private:
+        std::atomic<bool> stopped{false};
+        std::thread thread;
+};
+
+/**
+ * Display that remembers the order of the drawing calls, each one can be
+ * slowed down to simulate the SPI transfers.
+ */
+class SlowRecordingDisplay : public DrawCommandRecorder
+{
+      public:
+        SlowRecordingDisplay(int delay_us) : delay_us(delay_us) {}
+
+        void setup() const override {}
+        void initialize() const override {}
+        int get_height() const override { return 240; }
+        int get_width() const override { return 320; }
+        FontConfiguration get_font_configuration() const override
+        {
+                return {};
+        }
+        DisplayDimensions get_display_dimensions() const override
+        {
+                return {};
+        }
+        int get_display_corner_radius() const override { return 0; }
+        bool refresh() const override
+        {
+                refreshes++;
+                return true;
+        }
+        void sleep() const override {}
+
+        mutable std::vector<int> ids;
+        mutable std::vector<std::string> texts;
+        mutable int refreshes = 0;
+
+      protected:
+        void record(const DrawCommand &command,
+                    const char *text) const override
+        {
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(delay_us));
+                ids.push_back(command.args[0]);
+                if (text) {
+                        texts.push_back(text);
+                }
+        }
+
+      private:
+        int delay_us;
+};
+
+static void draw_scene(Display &display, int frame)
+{
+        TftCompatibleDisplay &tft = *display.cast_into_tft_compatible();
+        display.clear(Black);
+        for (int i = 0; i < 40; i++) {
+                display.draw_rectangle({.x = (i * 37 + frame) % 140,
+                                        .y = (i * 23) % 100},
+                                       30, 20, (Color)(i * 2113 + frame),
+                                       1 + i % 3, i % 2 == 0);
+                display.draw_circle({.x = (i * 13) % 160, .y = (i * 7) % 128},
+                                    5 + i % 7, (Color)(i * 4099), 1,
+                                    i % 3 == 0);
+        }
+        char text[] = "Score: 42";
+        display.draw_string({.x = 10, .y = 100}, text, Size16, Black, White);
+        tft.setTextColor(Yellow);
+        tft.drawString("Queued", 40, 60);
+        tft.drawLine(0, 0, 159, 127, Red);
+}
+
+TEST_CASE("Queued drawing matches drawing directly", "[queued-display]")
+{
+        SleepingTimeProvider time;
+        HeadlessDisplay reference(160, 128);
+        HeadlessDisplay headless(160, 128);
+        // A small queue makes the game loop wait for the render thread.
+        DrawCommandQueue queue(16, 32);
+        QueuedDisplay display(&headless, &queue, &time);
+        {
+                RenderThread render_thread(queue, headless);
+                for (int frame = 0; frame < 5; frame++) {
+                        draw_scene(reference, frame);
+                        draw_scene(display, frame);
+                        REQUIRE(display.refresh());
+                }
+                display.flush();
+        }
+        REQUIRE(memcmp(headless.get_framebuffer().data(),
+                       reference.get_framebuffer().data(),
+                       160 * 128 * sizeof(uint16_t)) == 0);
+        REQUIRE(headless.get_frame_count() == 5);
+}
+
+TEST_CASE("Commands are executed in order under back-pressure",
+          "[queued-display]")
+{
+        SleepingTimeProvider time;
+        SlowRecordingDisplay target(200);
+        DrawCommandQueue queue(8, 16);
+        QueuedDisplay display(&target, &queue, &time);
+        TftCompatibleDisplay &tft = *display.cast_into_tft_compatible();
+        {
+                RenderThread render_thread(queue, target);
+                for (int i = 0; i < 200; i++) {
+                        tft.drawPixel(i, 0, White);
+                        if (i % 50 == 49) {
+                                std::string text = "frame " + std::to_string(i);
+                                tft.drawString(text.c_str(), i, 0);
+                                display.refresh();
+                                // At most one frame is in flight.
+                                REQUIRE(queue.get_completed_frames() + 1 >=
+                                        (uint32_t)(i + 1) / 50);
+                        }
+                }
+                display.flush();
+        }
+        std::vector<int> expected;
+        for (int i = 0; i < 200; i++) {
+                expected.push_back(i);
+                if (i % 50 == 49) {
+                        expected.push_back(i);
+                }
+        }
+        REQUIRE(target.ids == expected);
+        REQUIRE(target.texts == std::vector<std::string>{"frame 49", "frame 99",
+                                                         "frame 149",
+                                                         "frame 199"});
+        REQUIRE(target.refreshes == 4);
+        REQUIRE(display.get_statistics().blocked_pushes > 0);
+        // The text of a string that can never fit into the text ring is
+        // drawn on the game loop side after the queue was drained.
+        tft.drawString("longer than sixteen bytes", 7, 0);
+        REQUIRE(display.get_statistics().synchronous_commands == 1);
+        REQUIRE(target.ids.back() == 7);
+}
+
+TEST_CASE("Images can be reused once pushImage returns", "[queued-display]")
+{
+        SleepingTimeProvider time;
+        HeadlessDisplay headless(32, 32);
+        DrawCommandQueue queue;
+        QueuedDisplay display(&headless, &queue, &time);
+        TftCompatibleDisplay &tft = *display.cast_into_tft_compatible();
+        std::vector<uint16_t> image(16 * 16);
+        {
+                RenderThread render_thread(queue, headless);
+                for (int i = 0; i < 4; i++) {
+                        std::fill(image.begin(), image.end(), 0x1111 * i);
+                        tft.pushImage((i % 2) * 16, (i / 2) * 16, 16, 16,
+                                      image.data());
+                }
+                std::fill(image.begin(), image.end(), 0xFFFF);
+                display.flush();
+        }
+        const Rgb565Framebuffer &framebuffer = headless.get_framebuffer();
+        for (int i = 0; i < 4; i++) {
+                REQUIRE(framebuffer.data()[(i / 2) * 16 * 32 + (i % 2) * 16] ==
+                        0x1111 * i);
+        }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/recording_display.hpp"
+#include "display_test_utils.hpp"
+
+/**
+ * Screen with plenty of redundancy: shapes that get cleared later on, pixel
+ * runs, tiled fills and lines drawn in segments.
+ */
+static void draw_screen(const Display &display)
+{
+        TftCompatibleDisplay &tft =
+            *const_cast<Display &>(display).cast_into_tft_compatible();
+        display.clear(Blue);
+        char title[] = "Overdrawn";
+        display.draw_string({.x = 4, .y = 4}, title, Size16, Black, White);
+        display.draw_circle({.x = 40, .y = 40}, 10, Red, 1, true);
+        display.draw_rectangle({.x = 60, .y = 20}, 20, 20, Green, 2, false);
+        // Covers everything above apart from the background.
+        display.clear_region({.x = 0, .y = 0}, {.x = 100, .y = 64}, Black);
+
+        for (int x = 10; x < 90; x++) {
+                tft.drawPixel(x, 70, Yellow);
+        }
+        for (int y = 80; y < 120; y += 8) {
+                for (int x = 0; x < 160; x += 16) {
+                        tft.fillRect(x, y, 16, 8, (y / 8) % 2 ? Red : Green);
+                }
+        }
+        for (int x = 0; x < 150; x += 30) {
+                display.draw_line({.x = x, .y = 124}, {.x = x + 30, .y = 124},
+                                  White);
+        }
+        for (int y = 0; y < 75; y += 15) {
+                tft.drawLine(155, y, 155, y + 15, Magenta);
+        }
+        tft.setTextColor(Cyan);
+        tft.drawString("Kept", 110, 10);
+        char subtitle[] = "Visible";
+        display.draw_string({.x = 4, .y = 40}, subtitle, Size16, Black, White);
+}
+
+TEST_CASE("Optimized display lists draw the same pixels", "[recording]")
+{
+        HeadlessDisplay reference(160, 128);
+        draw_screen(reference);
+
+        HeadlessDisplay headless(160, 128);
+        DisplayList list;
+        RecordingDisplay recorder(&headless, &list);
+        draw_screen(recorder);
+        int recorded = list.get_command_count();
+
+        for (uint8_t optimizations :
+             {0, (int)DropOverdrawn, (int)CoalesceSpans, (int)MergeFills,
+              (int)AllOptimizations}) {
+                CAPTURE(optimizations);
+                DisplayList optimized = list;
+                optimized.optimize(optimizations);
+                headless.clear(White);
+                optimized.replay(headless);
+                REQUIRE(same_contents(headless, reference));
+                if (optimizations != 0) {
+                        REQUIRE(optimized.get_command_count() < recorded);
+                }
+        }
+
+        list.optimize();
+        // The pixel run becomes one fill, each band of tiles a single fill
+        // and the segmented lines one line each.
+        REQUIRE(list.get_command_count() <= 14);
+        int fills = 0;
+        for (const DrawCommand &command : list.get_commands()) {
+                REQUIRE(command.type != DrawCommandType::Circle);
+                REQUIRE(command.type != DrawCommandType::TftPixel);
+                fills += command.type == DrawCommandType::TftFillRect;
+        }
+        REQUIRE(fills == 6);
+}
+
+TEST_CASE("Cached display lists are only recorded once per key",
+          "[recording]")
+{
+        HeadlessDisplay reference(160, 128);
+        HeadlessDisplay headless(160, 128);
+        CachedDisplayList cached;
+        int renders = 0;
+        auto render = [&renders](const Display &display) {
+                renders++;
+                draw_screen(display);
+        };
+
+        draw_screen(reference);
+        for (int i = 0; i < 3; i++) {
+                headless.clear(White);
+                cached.draw(headless, display_list_key({1, 2}), render);
+                REQUIRE(same_contents(headless, reference));
+        }
+        REQUIRE(renders == 1);
+        REQUIRE(cached.get_recordings() == 1);
+
+        cached.draw(headless, display_list_key({1, 3}), render);
+        cached.draw(headless, display_list_key({1, 3}, "text"), render);
+        HeadlessDisplay other(160, 128);
+        cached.draw(other, display_list_key({1, 3}, "text"), render);
+        REQUIRE(renders == 4);
+}
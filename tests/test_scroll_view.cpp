@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/recording_display.hpp"
+#include "../src/common/scroll_view.hpp"
+#include "../src/common/user_interface.hpp"
+#include "display_test_utils.hpp"
+#include <cstdlib>
+
+/**
+ * Content made of stripes that change their color every few pixels, with a
+ * shape drawn across the stripes so that the content isn't symmetric across
+ * the scrolled axis.
+ */
+static void draw_stripes(const Display &display, const ScrollRegion &region,
+                         int content_start, int screen_start, int length)
+{
+        static const Color colors[] = {Red, Green, Blue, Yellow, Cyan};
+        bool horizontal = region.axis == ScrollAxis::Horizontal;
+        for (int i = 0; i < length; i++) {
+                int content = content_start + i;
+                Color color = colors[content / 7 % 5];
+                // The stripe gets shorter towards its end.
+                int across = (horizontal ? region.height : region.width) -
+                             content % 7;
+                IntPoint start =
+                    horizontal ? IntPoint{screen_start + i, region.top_left.y}
+                               : IntPoint{region.top_left.x, screen_start + i};
+                int width = horizontal ? 1 : region.width;
+                int height = horizontal ? region.height : 1;
+                display.draw_rectangle(start, width, height, Black, 1, true);
+                display.draw_rectangle(start, horizontal ? 1 : across,
+                                       horizontal ? across : 1, color, 1,
+                                       true);
+        }
+}
+
+/**
+ * Draws the window at the position directly without any scrolling.
+ */
+static void draw_reference(const Display &display, const ScrollRegion &region,
+                           int position)
+{
+        display.clear(Black);
+        display.draw_rectangle({.x = 2, .y = 2}, 6, 6, White, 1, true);
+        draw_stripes(display, region, position, region.start(),
+                     region.length());
+}
+
+TEST_CASE("Scrolled regions match redrawing them", "[scroll]")
+{
+        for (ScrollAxis axis : {ScrollAxis::Horizontal, ScrollAxis::Vertical}) {
+                CAPTURE((int)axis);
+                ScrollRegion region = {.axis = axis,
+                                       .top_left = {.x = 20, .y = 10},
+                                       .width = 90,
+                                       .height = 70};
+                HeadlessDisplay display(120, 100);
+                HeadlessDisplay reference(120, 100);
+                int drawn = 0;
+                {
+                        ScrollView view(
+                            &display, region,
+                            [&](const Display &target, int content_start,
+                                int screen_start, int length) {
+                                    drawn += length;
+                                    draw_stripes(target, region, content_start,
+                                                 screen_start, length);
+                            });
+                        REQUIRE(view.is_scrolled_by_display());
+                        display.clear(Black);
+                        display.draw_rectangle({.x = 2, .y = 2}, 6, 6, White,
+                                               1, true);
+                        view.draw(0);
+
+                        for (int position : {3, 10, 61, 58, 300, 295, 0}) {
+                                CAPTURE(position);
+                                int previous = view.get_position();
+                                drawn = 0;
+                                view.scroll_to(position);
+                                draw_reference(reference, region, position);
+                                REQUIRE(same_contents(display, reference));
+                                int moved = abs(position - previous);
+                                REQUIRE(drawn == std::min(moved,
+                                                          region.length()));
+                        }
+
+                        // Highlighting a part of the content that wraps
+                        // around the end of the region.
+                        view.scroll_to(40);
+                        view.redraw(60, 40);
+                        draw_reference(reference, region, 40);
+                        REQUIRE(same_contents(display, reference));
+
+                        // Ends with the content back in the order in which it
+                        // lies in the display memory.
+                        view.scroll_to(2 * region.length());
+                        draw_reference(reference, region, 2 * region.length());
+                }
+                // The scrolling is reset with the view, the framebuffer shows
+                // the display memory as is and is drawn into normally.
+                display.draw_rectangle({.x = 20, .y = 10}, 4, 4, White, 1,
+                                       true);
+                reference.draw_rectangle({.x = 20, .y = 10}, 4, 4, White, 1,
+                                         true);
+                REQUIRE(same_contents(display, reference));
+        }
+}
+
+TEST_CASE("Regions are redrawn if the display doesn't scroll", "[scroll]")
+{
+        ScrollRegion region = {.axis = ScrollAxis::Horizontal,
+                               .top_left = {.x = 20, .y = 10},
+                               .width = 90,
+                               .height = 70};
+        HeadlessDisplay headless(120, 100);
+        DisplayList list;
+        RecordingDisplay recorder(&headless, &list);
+        int drawn = 0;
+        ScrollView view(&recorder, region,
+                        [&](const Display &target, int content_start,
+                            int screen_start, int length) {
+                                drawn += length;
+                                draw_stripes(target, region, content_start,
+                                             screen_start, length);
+                        });
+        REQUIRE_FALSE(view.is_scrolled_by_display());
+
+        recorder.clear(Black);
+        recorder.draw_rectangle({.x = 2, .y = 2}, 6, 6, White, 1, true);
+        view.draw(0);
+        drawn = 0;
+        view.scroll_to(5);
+        REQUIRE(drawn == region.length());
+
+        list.replay(headless);
+        HeadlessDisplay reference(120, 100);
+        draw_reference(reference, region, 5);
+        REQUIRE(same_contents(headless, reference));
+        for (const DrawCommand &command : list.get_commands()) {
+                REQUIRE(command.type != DrawCommandType::Scroll);
+        }
+}
+
+TEST_CASE("Staying in place draws nothing", "[scroll]")
+{
+        ScrollRegion region = {.axis = ScrollAxis::Vertical,
+                               .top_left = {.x = 0, .y = 10},
+                               .width = 120,
+                               .height = 60};
+        HeadlessDisplay headless(120, 100);
+        DisplayList list;
+        RecordingDisplay recorder(&headless, &list);
+        ScrollView view(&recorder, region,
+                        [&](const Display &target, int content_start,
+                            int screen_start, int length) {
+                                draw_stripes(target, region, content_start,
+                                             screen_start, length);
+                        });
+        view.draw(20);
+        list.clear();
+        view.scroll_to(20);
+        REQUIRE(list.get_command_count() == 0);
+}
+
+TEST_CASE("Moving the bar graph highlight only redraws the two bars",
+          "[scroll]")
+{
+        UserInterfaceCustomization customization = {
+            .accent_color = Red,
+            .rendering_mode = Detailed,
+            .show_help_text = false};
+        std::vector<std::string> labels = {"07-01", "07-02", "07-03"};
+        // Bars that fit onto the screen and bars that make the graph scroll.
+        for (int bars : {24, 72}) {
+                CAPTURE(bars);
+                std::vector<float> values(bars);
+                for (int i = 0; i < bars; i++) {
+                        values[i] = (i * 37 % 23) - 5.5f;
+                }
+
+                HeadlessDisplay headless(320, 240);
+                DisplayList list;
+                RecordingDisplay recorder(&headless, &list);
+                Platform platform = platform_with_display(&recorder);
+                BarGraph graph(platform, customization, 112, labels, values);
+                graph.render(3);
+                list.replay(headless);
+                list.clear();
+
+                // The window of the scrolling graph stays at the start.
+                graph.move_highlight(4);
+                REQUIRE(list.get_command_count() > 0);
+                for (const DrawCommand &command : list.get_commands()) {
+                        REQUIRE(command.type != DrawCommandType::Scroll);
+                        if (command.type == DrawCommandType::ClearRegion) {
+                                int width = command.args[2] - command.args[0];
+                                REQUIRE(width < 20);
+                        }
+                }
+                list.replay(headless);
+
+                HeadlessDisplay reference(320, 240);
+                Platform reference_platform = platform_with_display(&reference);
+                BarGraph reference_graph(reference_platform, customization,
+                                         112, labels, values);
+                reference_graph.render(4);
+                REQUIRE(same_contents(headless, reference));
+        }
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/games/sudoku_engine.hpp"
+#include <cstdlib>
+
+/**
+ * Parses a grid of 81 digits in row-major order, '0' marks the empty cells.
+ */
+static SudokuGrid parse_grid(const char *digits)
+{
+        SudokuGrid grid(9, std::vector<SudokuCell>(9));
+        for (int i = 0; i < 81; i++) {
+                int digit = digits[i] - '0';
+                grid[i / 9][i % 9] =
+                    digit == 0 ? SudokuCell(std::nullopt, true)
+                               : SudokuCell(digit, false);
+        }
+        return grid;
+}
+
+static const char *PUZZLE = "530070000"
+                            "600195000"
+                            "098000060"
+                            "800060003"
+                            "400803001"
+                            "700020006"
+                            "060000280"
+                            "000419005"
+                            "000080079";
+
+static const char *SOLUTION = "534678912"
+                              "672195348"
+                              "198342567"
+                              "859761423"
+                              "426853791"
+                              "713924856"
+                              "961537284"
+                              "287419635"
+                              "345286179";
+
+/**
+ * A puzzle with only 17 givens, which takes the naive solver a lot of
+ * backtracking.
+ */
+static const char *HARD_PUZZLE = "000000010"
+                                 "400000000"
+                                 "020000000"
+                                 "000050407"
+                                 "008000300"
+                                 "001090000"
+                                 "300400200"
+                                 "050100000"
+                                 "000806000";
+
+TEST_CASE("Sudoku solver fills in the empty cells", "[sudoku]")
+{
+        SudokuGrid grid = parse_grid(PUZZLE);
+        REQUIRE(SudokuEngine::solve(grid));
+        REQUIRE(SudokuEngine::validate(grid));
+        SudokuGrid expected = parse_grid(SOLUTION);
+        for (int y = 0; y < 9; y++) {
+                for (int x = 0; x < 9; x++) {
+                        REQUIRE(grid[y][x].digit == expected[y][x].digit);
+                }
+        }
+
+        grid = parse_grid(HARD_PUZZLE);
+        REQUIRE(SudokuEngine::solve(grid));
+        REQUIRE(SudokuEngine::validate(grid));
+}
+
+TEST_CASE("Sudoku solver leaves unsolvable grids unchanged", "[sudoku]")
+{
+        // The empty cell in the top left corner can only be 1 according to
+        // its row and column, which is already in its big square.
+        SudokuGrid grid = parse_grid("023456789"
+                                     "000000000"
+                                     "001000000"
+                                     "200000000"
+                                     "300000000"
+                                     "400000000"
+                                     "500000000"
+                                     "600000000"
+                                     "700000000");
+        SudokuGrid original = grid;
+        REQUIRE_FALSE(SudokuEngine::solve(grid));
+        REQUIRE_FALSE(SudokuEngine::has_unique_solution(grid));
+        for (int y = 0; y < 9; y++) {
+                for (int x = 0; x < 9; x++) {
+                        REQUIRE(grid[y][x].digit == original[y][x].digit);
+                }
+        }
+}
+
+TEST_CASE("Sudoku puzzles with unique solutions are recognised", "[sudoku]")
+{
+        REQUIRE(SudokuEngine::has_unique_solution(parse_grid(PUZZLE)));
+        REQUIRE(SudokuEngine::has_unique_solution(parse_grid(HARD_PUZZLE)));
+
+        // Removing a given from a minimal puzzle makes it ambiguous.
+        SudokuGrid grid = parse_grid(HARD_PUZZLE);
+        grid[0][7] = SudokuCell(std::nullopt, true);
+        REQUIRE_FALSE(SudokuEngine::has_unique_solution(grid));
+        REQUIRE_FALSE(SudokuEngine::has_unique_solution(
+            parse_grid("000000000000000000000000000000000000000000000000000000"
+                       "000000000000000000000000000")));
+}
+
+TEST_CASE("Generated sudoku grids have unique solutions", "[sudoku]")
+{
+        srand(5);
+        for (int difficulty = 1; difficulty <= 3; difficulty++) {
+                SudokuGrid grid = SudokuEngine::generate_grid(difficulty);
+                REQUIRE(SudokuEngine::has_unique_solution(grid));
+                int empty = 0;
+                for (const auto &row : grid) {
+                        for (const SudokuCell &cell : row) {
+                                empty += !cell.digit.has_value();
+                                // Only the empty cells can be filled in.
+                                REQUIRE(cell.is_user_defined ==
+                                        !cell.digit.has_value());
+                        }
+                }
+                REQUIRE(empty <= 30 + 10 * difficulty);
+                REQUIRE(SudokuEngine::solve(grid));
+                REQUIRE(SudokuEngine::validate(grid));
+        }
+}
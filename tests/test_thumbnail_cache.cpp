@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../src/common/thumbnail_cache.hpp"
+#include "display_test_utils.hpp"
+
+/**
+ * Thumbnail in the style of the game thumbnails: clears the lower part of the
+ * screen, draws a few shapes in `colors` different colors and a subtitle.
+ * Counts how many times it was rendered.
+ */
+class TestThumbnail : public ThumbnailRenderer
+{
+      public:
+        TestThumbnail(int colors) : colors(colors) {}
+
+        void render_thumbnail(
+            const Platform &platform,
+            const UserInterfaceCustomization &customization) override
+        {
+                renders++;
+                const Display &display = *platform.display;
+                TftCompatibleDisplay &tft =
+                    *platform.display->cast_into_tft_compatible();
+                display.clear_region({.x = 0, .y = 60},
+                                     {.x = display.get_width(), .y = 110},
+                                     Black);
+                for (int i = 0; i < colors; i++) {
+                        tft.fillRect(4 + (i % 20) * 7, 64 + (i / 20) * 7, 6, 6,
+                                     (i * 2113) & 0xFFFF);
+                }
+                // Shapes sticking out of the cleared area leave gaps in the
+                // sprite that must not be drawn over.
+                tft.fillCircle(130, 55, 10, customization.accent_color);
+                tft.drawLine(0, 120, 159, 127, White);
+                char subtitle[] = "Life";
+                display.draw_string({.x = 60, .y = 90}, subtitle, Size16, Black,
+                                    White);
+        }
+
+        int renders = 0;
+
+      private:
+        int colors;
+};
+
+/**
+ * Fills the display with a pattern so that drawing over the undrawn pixels of
+ * a thumbnail would be detected.
+ */
+static void draw_background(Display &display)
+{
+        for (int y = 0; y < display.get_height(); y += 8) {
+                display.clear_region({.x = 0, .y = y},
+                                     {.x = display.get_width(), .y = y + 8},
+                                     y % 16 ? Blue : Green);
+        }
+}
+
+TEST_CASE("Cached thumbnails match the directly rendered ones",
+          "[thumbnail-cache]")
+{
+        UserInterfaceCustomization customization = {
+            .accent_color = Red,
+            .rendering_mode = Detailed,
+            .show_help_text = false};
+
+        // Up to 15 colors (and the transparent index) fit into 4 bits.
+        for (int colors : {3, 14, 40}) {
+                CAPTURE(colors);
+                TestThumbnail thumbnail(colors);
+                HeadlessDisplay reference(160, 128);
+                draw_background(reference);
+                Platform reference_platform = platform_with_display(&reference);
+                thumbnail.render_thumbnail(reference_platform, customization);
+
+                HeadlessDisplay headless(160, 128);
+                Platform platform = platform_with_display(&headless);
+                ThumbnailCache cache;
+                for (int i = 0; i < 3; i++) {
+                        draw_background(headless);
+                        cache.render(0, thumbnail, platform, customization);
+                        REQUIRE(same_contents(headless.get_framebuffer(),
+                                              reference.get_framebuffer()));
+                }
+                // Rendered once for the reference and once for the cache.
+                REQUIRE(thumbnail.renders == 2);
+                REQUIRE(cache.get_statistics().hits == 2);
+                REQUIRE(cache.get_statistics().misses == 1);
+        }
+}
+
+TEST_CASE("Thumbnail sprites are compressed and keyed by the customization",
+          "[thumbnail-cache]")
+{
+        HeadlessDisplay headless(160, 128);
+        Platform platform = platform_with_display(&headless);
+        UserInterfaceCustomization customization = {
+            .accent_color = Red,
+            .rendering_mode = Detailed,
+            .show_help_text = false};
+        TestThumbnail thumbnail(10);
+        ThumbnailCache cache;
+
+        cache.render(0, thumbnail, platform, customization);
+        // The sprite spans rows 45 to 127 of the full width at 4 bits per
+        // pixel, the overlay holds the subtitle.
+        REQUIRE(cache.get_memory_usage() < 160 * 83 / 2 + 256);
+
+        customization.accent_color = Green;
+        cache.render(0, thumbnail, platform, customization);
+        REQUIRE(thumbnail.renders == 2);
+        REQUIRE(cache.get_cached_count() == 2);
+
+        customization.accent_color = Red;
+        cache.render(0, thumbnail, platform, customization);
+        REQUIRE(thumbnail.renders == 2);
+}
+
+TEST_CASE("Least recently shown thumbnails are evicted first",
+          "[thumbnail-cache]")
+{
+        HeadlessDisplay headless(160, 128);
+        Platform platform = platform_with_display(&headless);
+        UserInterfaceCustomization customization = {
+            .accent_color = Red,
+            .rendering_mode = Detailed,
+            .show_help_text = false};
+        TestThumbnail thumbnails[3] = {TestThumbnail(5), TestThumbnail(6),
+                                       TestThumbnail(7)};
+
+        // Measure a single sprite and make room for two of them.
+        ThumbnailCache measuring_cache;
+        measuring_cache.render(0, thumbnails[0], platform, customization);
+        int sprite_size = measuring_cache.get_memory_usage();
+
+        ThumbnailCache cache(sprite_size * 2 + sprite_size / 2);
+        cache.render(0, thumbnails[0], platform, customization);
+        cache.render(1, thumbnails[1], platform, customization);
+        cache.render(0, thumbnails[0], platform, customization);
+        cache.render(2, thumbnails[2], platform, customization);
+        REQUIRE(cache.get_statistics().evictions == 1);
+        REQUIRE(cache.get_cached_count() == 2);
+        REQUIRE(cache.get_memory_usage() <= sprite_size * 2 + sprite_size / 2);
+
+        // Thumbnail 1 was the least recently shown one.
+        cache.render(0, thumbnails[0], platform, customization);
+        cache.render(2, thumbnails[2], platform, customization);
+        REQUIRE(thumbnails[0].renders == 2);
+        REQUIRE(thumbnails[2].renders == 1);
+        cache.render(1, thumbnails[1], platform, customization);
+        REQUIRE(thumbnails[1].renders == 2);
+
+        // Sprites larger than the whole budget are drawn but not cached.
+        ThumbnailCache tiny_cache(16);
+        tiny_cache.render(0, thumbnails[0], platform, customization);
+        REQUIRE(tiny_cache.get_cached_count() == 0);
+}
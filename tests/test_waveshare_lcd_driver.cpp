@@ -0,0 +1,675 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+// The display needs to be included before the driver, the color macros of the
+// driver clash with the names used by the display interface.
+#include "../src/platform/drivers/display/lcd_display_1_69_inch.hpp"
+#include "../src/lib/waveshare_1_69_inch_lcd/DEV_Config.cpp"
+#include "../src/lib/waveshare_1_69_inch_lcd/LCD_Driver.cpp"
+#include "../src/lib/waveshare_1_69_inch_lcd/GUI_Paint.cpp"
+#include "../src/lib/waveshare_1_69_inch_lcd/fonts/font_packing.h"
+
+/**
+ * These tests run the vendored Waveshare 1.69 inch LCD driver against the
+ * mocked SPI bus from `tests/mocks/SPI.h`. The mock emulates the display
+ * memory of the ST7789 controller, which allows us to check that the windowed
+ * fill paths produce exactly the same pixels as the original point-by-point
+ * implementation while generating a fraction of the bus traffic.
+ */
+
+/**
+ * Sets up the paint module in the same way as `LcdDisplay_1_69::initialize`
+ * and clears all mock state.
+ */
+static void setup_display()
+{
+        Paint_NewImage(LCD_WIDTH, LCD_HEIGHT, ROTATE_270, WHITE);
+        mock_spi_bus.attach(DEV_CS_PIN, DEV_DC_PIN);
+}
+
+/**
+ * The original implementation of `Paint_DrawPoint`, which sets each pixel of
+ * the point individually.
+ */
+static void reference_draw_point(UWORD Xpoint, UWORD Ypoint, UWORD Color,
+                                 DOT_PIXEL Dot_Pixel, DOT_STYLE Dot_FillWay)
+{
+        if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
+                return;
+        }
+
+        int16_t XDir_Num, YDir_Num;
+        if (Dot_FillWay == DOT_FILL_AROUND) {
+                for (XDir_Num = 0; XDir_Num < 2 * Dot_Pixel - 1; XDir_Num++) {
+                        for (YDir_Num = 0; YDir_Num < 2 * Dot_Pixel - 1;
+                             YDir_Num++) {
+                                if (Xpoint + XDir_Num - Dot_Pixel < 0 ||
+                                    Ypoint + YDir_Num - Dot_Pixel < 0)
+                                        break;
+                                Paint_SetPixel(Xpoint + XDir_Num - Dot_Pixel,
+                                               Ypoint + YDir_Num - Dot_Pixel,
+                                               Color);
+                        }
+                }
+        } else {
+                for (XDir_Num = 0; XDir_Num < Dot_Pixel; XDir_Num++) {
+                        for (YDir_Num = 0; YDir_Num < Dot_Pixel; YDir_Num++) {
+                                Paint_SetPixel(Xpoint + XDir_Num - 1,
+                                               Ypoint + YDir_Num - 1, Color);
+                        }
+                }
+        }
+}
+
+/**
+ * The original implementation of a filled `Paint_DrawRectangle`, which draws
+ * one horizontal line of points for each row of the rectangle.
+ */
+static void reference_fill_rectangle(UWORD Xstart, UWORD Ystart, UWORD Xend,
+                                     UWORD Yend, UWORD Color,
+                                     DOT_PIXEL Line_width)
+{
+        UWORD Xmin = Xstart < Xend ? Xstart : Xend;
+        UWORD Xmax = Xstart < Xend ? Xend : Xstart;
+        for (UWORD Ypoint = Ystart; Ypoint < Yend; Ypoint++) {
+                for (UWORD Xpoint = Xmin; Xpoint <= Xmax; Xpoint++) {
+                        reference_draw_point(Xpoint, Ypoint, Color, Line_width,
+                                             DOT_FILL_RIGHTUP);
+                }
+        }
+}
+
+/**
+ * The original implementation of `Paint_ClearWindows`.
+ */
+static void reference_clear_windows(UWORD Xstart, UWORD Ystart, UWORD Xend,
+                                    UWORD Yend, UWORD Color)
+{
+        for (UWORD Y = Ystart; Y < Yend; Y++) {
+                for (UWORD X = Xstart; X < Xend; X++) {
+                        Paint_SetPixel(X, Y, Color);
+                }
+        }
+}
+
+/**
+ * Runs the reference and the optimized drawing routine on a display that has
+ * been pre-filled with a background color and checks that the resulting
+ * display memory is identical. Returns the bus statistics of both runs so
+ * that the callers can compare them.
+ */
+template <typename Reference, typename Optimized>
+static std::pair<SpiBusStatistics, SpiBusStatistics>
+compare_with_reference(Reference reference, Optimized optimized)
+{
+        setup_display();
+        reference_clear_windows(0, 0, Paint.Width, Paint.Height, BLUE);
+        mock_spi_bus.reset_statistics();
+        reference();
+        SpiBusStatistics reference_stats = mock_spi_bus.statistics();
+        std::vector<uint16_t> expected = mock_spi_bus.memory_snapshot();
+
+        setup_display();
+        reference_clear_windows(0, 0, Paint.Width, Paint.Height, BLUE);
+        mock_spi_bus.reset_statistics();
+        optimized();
+        SpiBusStatistics optimized_stats = mock_spi_bus.statistics();
+
+        REQUIRE(mock_spi_bus.memory_snapshot() == expected);
+        return {reference_stats, optimized_stats};
+}
+
+TEST_CASE("LCD_FillWindow sets the address window once", "[waveshare-lcd]")
+{
+        setup_display();
+
+        LCD_FillWindow(10, 20, 109, 69, RED);
+
+        const SpiBusStatistics &stats = mock_spi_bus.statistics();
+        // CASET, RASET and RAMWR
+        REQUIRE(stats.command_bytes == 3);
+        // 8 address bytes followed by one RGB565 word per pixel.
+        REQUIRE(stats.data_bytes == 8 + 100 * 50 * 2);
+        // 11 transfers for the address window and one for the pixels.
+        REQUIRE(stats.chip_select_assertions == 12);
+        REQUIRE(stats.transactions == 12);
+
+        // The driver applies a 20px offset to the rows of the ST7789 memory.
+        REQUIRE(mock_spi_bus.pixel(10, 40) == RED);
+        REQUIRE(mock_spi_bus.pixel(109, 89) == RED);
+        REQUIRE(mock_spi_bus.pixel(110, 89) == 0);
+        REQUIRE(mock_spi_bus.pixel(109, 90) == 0);
+}
+
+TEST_CASE("Paint_ClearWindows matches the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        auto [reference, optimized] = compare_with_reference(
+            [] { reference_clear_windows(30, 40, 130, 90, RED); },
+            [] { Paint_ClearWindows(30, 40, 130, 90, RED); });
+
+        CAPTURE(reference.bytes, optimized.bytes);
+        REQUIRE(optimized.chip_select_assertions == 12);
+        REQUIRE(reference.chip_select_assertions == 100 * 50 * 12);
+        REQUIRE(optimized.bytes * 5 < reference.bytes);
+}
+
+TEST_CASE("Paint_ClearWindows is clipped to the display bounds",
+          "[waveshare-lcd]")
+{
+        compare_with_reference(
+            [] { reference_clear_windows(200, 180, 400, 300, GREEN); },
+            [] { Paint_ClearWindows(200, 180, 400, 300, GREEN); });
+
+        compare_with_reference(
+            [] { reference_clear_windows(0, 0, 280, 240, GREEN); },
+            [] { Paint_ClearWindows(0, 0, 280, 240, GREEN); });
+}
+
+TEST_CASE("Empty and inverted windows are not drawn", "[waveshare-lcd]")
+{
+        setup_display();
+
+        Paint_ClearWindows(50, 50, 50, 80, RED);
+        Paint_ClearWindows(80, 50, 50, 80, RED);
+        Paint_ClearWindows((UWORD)-1, 50, 50, 80, RED);
+
+        REQUIRE(mock_spi_bus.statistics().bytes == 0);
+}
+
+TEST_CASE("Filled Paint_DrawRectangle matches the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        for (DOT_PIXEL line_width : {DOT_PIXEL_1X1, DOT_PIXEL_3X3}) {
+                auto [reference, optimized] = compare_with_reference(
+                    [=] {
+                            reference_fill_rectangle(20, 30, 60, 70, MAGENTA,
+                                                     line_width);
+                    },
+                    [=] {
+                            Paint_DrawRectangle(20, 30, 60, 70, MAGENTA,
+                                                line_width, DRAW_FILL_FULL);
+                    });
+                REQUIRE(optimized.chip_select_assertions == 12);
+                REQUIRE(optimized.bytes * 5 < reference.bytes);
+        }
+
+        // Rectangles touching the edges of the screen.
+        compare_with_reference(
+            [] { reference_fill_rectangle(0, 0, 10, 10, YELLOW, DOT_PIXEL_2X2); },
+            [] {
+                    Paint_DrawRectangle(0, 0, 10, 10, YELLOW, DOT_PIXEL_2X2,
+                                        DRAW_FILL_FULL);
+            });
+        compare_with_reference(
+            [] {
+                    reference_fill_rectangle(270, 230, 280, 240, YELLOW,
+                                             DOT_PIXEL_4X4);
+            },
+            [] {
+                    Paint_DrawRectangle(270, 230, 280, 240, YELLOW,
+                                        DOT_PIXEL_4X4, DRAW_FILL_FULL);
+            });
+}
+
+TEST_CASE("Paint_DrawPoint matches the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        struct PointCase {
+                UWORD x;
+                UWORD y;
+                DOT_PIXEL size;
+                DOT_STYLE style;
+        };
+
+        PointCase cases[] = {
+            {100, 100, DOT_PIXEL_1X1, DOT_FILL_RIGHTUP},
+            {100, 100, DOT_PIXEL_5X5, DOT_FILL_RIGHTUP},
+            {0, 0, DOT_PIXEL_3X3, DOT_FILL_RIGHTUP},
+            {279, 239, DOT_PIXEL_8X8, DOT_FILL_RIGHTUP},
+            {100, 100, DOT_PIXEL_1X1, DOT_FILL_AROUND},
+            {100, 100, DOT_PIXEL_4X4, DOT_FILL_AROUND},
+            {2, 50, DOT_PIXEL_4X4, DOT_FILL_AROUND},
+            {50, 2, DOT_PIXEL_4X4, DOT_FILL_AROUND},
+            {279, 239, DOT_PIXEL_3X3, DOT_FILL_AROUND},
+        };
+
+        for (const PointCase &c : cases) {
+                CAPTURE(c.x, c.y, c.size, c.style);
+                compare_with_reference(
+                    [&] {
+                            reference_draw_point(c.x, c.y, CYAN, c.size,
+                                                 c.style);
+                    },
+                    [&] { Paint_DrawPoint(c.x, c.y, CYAN, c.size, c.style); });
+        }
+}
+
+TEST_CASE("Fills respect the image rotation and mirroring", "[waveshare-lcd]")
+{
+        for (UWORD rotation : {ROTATE_0, ROTATE_90, ROTATE_180, ROTATE_270}) {
+                for (UBYTE mirror : {MIRROR_NONE, MIRROR_HORIZONTAL,
+                                     MIRROR_VERTICAL, MIRROR_ORIGIN}) {
+                        CAPTURE(rotation, mirror);
+                        auto configure = [=] {
+                                Paint_NewImage(LCD_WIDTH, LCD_HEIGHT, rotation,
+                                               WHITE);
+                                Paint_SetMirroring(mirror);
+                        };
+                        compare_with_reference(
+                            [=] {
+                                    configure();
+                                    reference_clear_windows(15, 25, 75, 45,
+                                                            RED);
+                            },
+                            [=] {
+                                    configure();
+                                    Paint_ClearWindows(15, 25, 75, 45, RED);
+                            });
+                }
+        }
+}
+
+/**
+ * The original implementation of `Paint_Clear`, which sends each pixel in a
+ * separate SPI transaction.
+ */
+static void reference_clear(UWORD Color)
+{
+        LCD_SetCursor(0, 0, Paint.WidthByte - 1, Paint.HeightByte - 1);
+        for (UWORD Y = 0; Y < Paint.HeightByte; Y++) {
+                for (UWORD X = 0; X < Paint.WidthByte; X++) {
+                        LCD_WriteData_Word(Color);
+                }
+        }
+}
+
+/**
+ * The original implementation of `Paint_DrawImage` (clipped to the bounds of
+ * the rotated image), which sets each pixel individually.
+ */
+static void reference_draw_image(const unsigned char *image, UWORD xStart,
+                                 UWORD yStart, UWORD W_Image, UWORD H_Image)
+{
+        for (int j = 0; j < H_Image; j++) {
+                for (int i = 0; i < W_Image; i++) {
+                        if (xStart + i < Paint.Width &&
+                            yStart + j < Paint.Height)
+                                Paint_SetPixel(
+                                    xStart + i, yStart + j,
+                                    (pgm_read_byte(image + j * W_Image * 2 +
+                                                   i * 2 + 1))
+                                            << 8 |
+                                        (pgm_read_byte(image + j * W_Image * 2 +
+                                                       i * 2)));
+                }
+        }
+}
+
+TEST_CASE("Paint_Clear streams the whole screen in one transaction",
+          "[waveshare-lcd]")
+{
+        auto [reference, optimized] = compare_with_reference(
+            [] { reference_clear(GRAY); }, [] { Paint_Clear(GRAY); });
+
+        REQUIRE(optimized.data_bytes == reference.data_bytes);
+        REQUIRE(optimized.chip_select_assertions == 12);
+        REQUIRE(optimized.transactions == 12);
+        REQUIRE(optimized.transfer_calls * 50 < reference.transfer_calls);
+        REQUIRE(mock_spi_bus.pixel(0, 20) == GRAY);
+        REQUIRE(mock_spi_bus.pixel(239, 299) == GRAY);
+}
+
+TEST_CASE("LCD_Clear and LCD_ClearWindow fill exactly the requested area",
+          "[waveshare-lcd]")
+{
+        setup_display();
+
+        LCD_Clear(RED);
+        LCD_ClearWindow(10, 10, 20, 30, GREEN);
+
+        REQUIRE(mock_spi_bus.pixel(0, 20) == RED);
+        REQUIRE(mock_spi_bus.pixel(239, 299) == RED);
+        REQUIRE(mock_spi_bus.pixel(0, 300) == 0);
+        REQUIRE(mock_spi_bus.pixel(10, 30) == GREEN);
+        REQUIRE(mock_spi_bus.pixel(19, 49) == GREEN);
+        REQUIRE(mock_spi_bus.pixel(20, 49) == RED);
+        REQUIRE(mock_spi_bus.pixel(19, 50) == RED);
+}
+
+TEST_CASE("Paint_DrawImage matches the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        const UWORD width = 37;
+        const UWORD height = 23;
+        std::vector<unsigned char> image(width * height * 2);
+        for (size_t i = 0; i < image.size(); i++) {
+                image[i] = (i * 31 + 7) & 0xFF;
+        }
+
+        for (UWORD rotation : {ROTATE_0, ROTATE_90, ROTATE_180, ROTATE_270}) {
+                for (UBYTE mirror : {MIRROR_NONE, MIRROR_HORIZONTAL,
+                                     MIRROR_VERTICAL, MIRROR_ORIGIN}) {
+                        CAPTURE(rotation, mirror);
+                        auto configure = [=] {
+                                Paint_NewImage(LCD_WIDTH, LCD_HEIGHT, rotation,
+                                               WHITE);
+                                Paint_SetMirroring(mirror);
+                        };
+                        for (UWORD x : {10, 220, 260}) {
+                                UWORD y = x / 2;
+                                CAPTURE(x, y);
+                                compare_with_reference(
+                                    [&] {
+                                            configure();
+                                            reference_draw_image(image.data(),
+                                                                 x, y, width,
+                                                                 height);
+                                    },
+                                    [&] {
+                                            configure();
+                                            Paint_DrawImage(image.data(), x, y,
+                                                            width, height);
+                                    });
+                        }
+                }
+        }
+}
+
+TEST_CASE("Pushed pixels match setting them one by one", "[waveshare-lcd]")
+{
+        LcdDisplay_1_69 display;
+        const int width = 45;
+        const int height = 20;
+        std::vector<uint16_t> pixels(width * height);
+        for (size_t i = 0; i < pixels.size(); i++) {
+                pixels[i] = (i * 2654435761u) >> 16;
+        }
+
+        // The blocks at the edges of the screen get clipped.
+        for (IntPoint top_left : {IntPoint{.x = 30, .y = 50},
+                                  IntPoint{.x = 0, .y = 0},
+                                  IntPoint{.x = 250, .y = 230}}) {
+                CAPTURE(top_left.x, top_left.y);
+                auto [reference, optimized] = compare_with_reference(
+                    [&] {
+                            // The screen columns are offset by one pixel
+                            // from the paint image, see `clear_region`.
+                            for (int y = 0; y < height; y++) {
+                                    for (int x = 0; x < width; x++) {
+                                            int column = top_left.x + x - 1;
+                                            int row = top_left.y + y;
+                                            Paint_FillWindow(
+                                                column, row, column + 1,
+                                                row + 1, pixels[y * width + x]);
+                                    }
+                            }
+                    },
+                    [&] {
+                            display.push_pixels(top_left, width, height,
+                                                pixels.data());
+                    });
+                REQUIRE(optimized.chip_select_assertions <= 12);
+                REQUIRE(optimized.chip_select_assertions * 100 <
+                        reference.chip_select_assertions);
+        }
+}
+
+/**
+ * The original implementation of `LcdDisplay_1_69::draw_rounded_rectangle`,
+ * which composes the rounded rectangle out of four filled circles and three
+ * rectangles.
+ */
+static void reference_rounded_rectangle(int x, int y, int width, int height,
+                                        int radius, UWORD color)
+{
+        int left = x + radius;
+        int top = y + radius;
+        int right = x + width - radius;
+        int bottom = y + height - radius;
+        for (int center_x : {left, right}) {
+                for (int center_y : {top, bottom}) {
+                        Paint_DrawCircle(center_x, center_y, radius, color,
+                                         DOT_PIXEL_1X1, DRAW_FILL_FULL);
+                }
+        }
+        Paint_DrawRectangle(left, y, right, y + radius, color, DOT_PIXEL_1X1,
+                            DRAW_FILL_FULL);
+        Paint_DrawRectangle(x, top, x + width + 1, bottom, color,
+                            DOT_PIXEL_1X1, DRAW_FILL_FULL);
+        Paint_DrawRectangle(left, y + height - radius, right, y + height + 1,
+                            color, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
+
+TEST_CASE("Filled circles match the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        LcdDisplay_1_69 display;
+        struct CircleCase {
+                int x;
+                int y;
+                int radius;
+        };
+        CircleCase cases[] = {{100, 100, 0},  {100, 100, 1}, {100, 100, 7},
+                              {140, 120, 40}, {0, 0, 10},    {5, 235, 12},
+                              {279, 10, 20},  {280, 120, 9}, {200, 239, 30}};
+
+        for (const CircleCase &c : cases) {
+                CAPTURE(c.x, c.y, c.radius);
+                auto [reference, optimized] = compare_with_reference(
+                    [&] {
+                            Paint_DrawCircle(c.x, c.y, c.radius, GREEN,
+                                             DOT_PIXEL_1X1, DRAW_FILL_FULL);
+                    },
+                    [&] {
+                            display.draw_circle({.x = c.x, .y = c.y}, c.radius,
+                                                (Color)GREEN, 1, true);
+                    });
+                if (c.radius >= 7) {
+                        REQUIRE(optimized.bytes * 3 < reference.bytes);
+                }
+        }
+}
+
+TEST_CASE("Rounded rectangles match the composed implementation",
+          "[waveshare-lcd]")
+{
+        LcdDisplay_1_69 display;
+        struct RectangleCase {
+                int x;
+                int y;
+                int width;
+                int height;
+                int radius;
+        };
+        RectangleCase cases[] = {
+            {20, 30, 100, 40, 8},  {20, 30, 100, 40, 0}, {0, 0, 60, 20, 10},
+            {10, 10, 16, 16, 8},   {50, 50, 30, 80, 15}, {200, 200, 79, 39, 5},
+            {100, 100, 10, 40, 8}, {260, 20, 40, 20, 5},
+        };
+
+        for (const RectangleCase &c : cases) {
+                CAPTURE(c.x, c.y, c.width, c.height, c.radius);
+                auto [reference, optimized] = compare_with_reference(
+                    [&] {
+                            reference_rounded_rectangle(c.x, c.y, c.width,
+                                                        c.height, c.radius,
+                                                        MAGENTA);
+                    },
+                    [&] {
+                            display.draw_rounded_rectangle(
+                                {.x = c.x, .y = c.y}, c.width, c.height,
+                                c.radius, (Color)MAGENTA);
+                    });
+                REQUIRE(optimized.bytes <= reference.bytes);
+        }
+
+        // A typical menu bar: one window per distinct row of the corners and a
+        // single window for the straight part.
+        auto [reference, optimized] = compare_with_reference(
+            [] { reference_rounded_rectangle(20, 30, 200, 30, 10, BLUE); },
+            [&] {
+                    display.draw_rounded_rectangle({.x = 20, .y = 30}, 200, 30,
+                                                   10, (Color)BLUE);
+            });
+        REQUIRE(optimized.chip_select_assertions * 2 <
+                reference.chip_select_assertions);
+        REQUIRE(optimized.bytes * 2 < reference.bytes);
+}
+
+/**
+ * The original implementation of `Paint_DrawChar` (reading the packed font
+ * tables), which sets each pixel of the character individually.
+ */
+static void reference_draw_char(UWORD Xpoint, UWORD Ypoint, char c,
+                                sFONT *Font, UWORD Color_Background,
+                                UWORD Color_Foreground)
+{
+        if (Xpoint > Paint.Width || Ypoint > Paint.Height) {
+                return;
+        }
+        const unsigned char *glyph =
+            Font->table +
+            (c - ' ') * packed_glyph_size(Font->Width, Font->Height);
+        for (UWORD Page = 0; Page < Font->Height; Page++) {
+                for (UWORD Column = 0; Column < Font->Width; Column++) {
+                        int bit = Page * Font->Width + Column;
+                        if (glyph[bit / 8] & (0x80 >> (bit % 8))) {
+                                Paint_SetPixel(Xpoint + Column, Ypoint + Page,
+                                               Color_Foreground);
+                        } else if (Color_Background != FONT_BACKGROUND) {
+                                Paint_SetPixel(Xpoint + Column, Ypoint + Page,
+                                               Color_Background);
+                        }
+                }
+        }
+}
+
+/**
+ * The original implementation of `Paint_DrawString_EN`, which draws the
+ * string character by character.
+ */
+static void reference_draw_string(UWORD Xstart, UWORD Ystart,
+                                  const char *pString, sFONT *Font,
+                                  UWORD Color_Background,
+                                  UWORD Color_Foreground)
+{
+        UWORD Xpoint = Xstart;
+        UWORD Ypoint = Ystart;
+        if (Xstart > Paint.Width || Ystart > Paint.Height) {
+                return;
+        }
+        for (; *pString != '\0'; pString++) {
+                if ((Xpoint + Font->Width) > Paint.Width) {
+                        Xpoint = Xstart;
+                        Ypoint += Font->Height;
+                }
+                if ((Ypoint + Font->Height) > Paint.Height) {
+                        Xpoint = Xstart;
+                        Ypoint = Ystart;
+                }
+                reference_draw_char(Xpoint, Ypoint, *pString, Font,
+                                    Color_Background, Color_Foreground);
+                Xpoint += Font->Width;
+        }
+}
+
+TEST_CASE("Paint_DrawString_EN matches the per-pixel implementation",
+          "[waveshare-lcd]")
+{
+        const char *text = "Hello, world! {42}";
+        for (UWORD rotation : {ROTATE_0, ROTATE_90, ROTATE_180, ROTATE_270}) {
+                for (UBYTE mirror : {MIRROR_NONE, MIRROR_HORIZONTAL,
+                                     MIRROR_VERTICAL, MIRROR_ORIGIN}) {
+                        for (sFONT *font : {&Font8, &Font16, &Font24}) {
+                                // White backgrounds are transparent.
+                                for (UWORD background : {BLACK, WHITE}) {
+                                        CAPTURE(rotation, mirror, font->Width,
+                                                background);
+                                        auto configure = [=] {
+                                                Paint_NewImage(LCD_WIDTH,
+                                                               LCD_HEIGHT,
+                                                               rotation, WHITE);
+                                                Paint_SetMirroring(mirror);
+                                        };
+                                        // The second string wraps around.
+                                        compare_with_reference(
+                                            [&] {
+                                                    configure();
+                                                    reference_draw_string(
+                                                        10, 20, text, font,
+                                                        background, YELLOW);
+                                                    reference_draw_string(
+                                                        180, 100, text, font,
+                                                        background, RED);
+                                            },
+                                            [&] {
+                                                    configure();
+                                                    Paint_DrawString_EN(
+                                                        10, 20, text, font,
+                                                        background, YELLOW);
+                                                    Paint_DrawString_EN(
+                                                        180, 100, text, font,
+                                                        background, RED);
+                                            });
+                                }
+                        }
+                }
+        }
+}
+
+TEST_CASE("Paint_DrawChar clips characters to the display",
+          "[waveshare-lcd]")
+{
+        for (UWORD background : {BLACK, WHITE}) {
+                CAPTURE(background);
+                compare_with_reference(
+                    [&] {
+                            reference_draw_char(270, 30, 'W', &Font24,
+                                                background, GREEN);
+                    },
+                    [&] {
+                            Paint_DrawChar(270, 30, 'W', &Font24, background,
+                                           GREEN);
+                    });
+        }
+}
+
+TEST_CASE("Paint_DrawString_EN sends each line as a single window",
+          "[waveshare-lcd]")
+{
+        const char *text = "Score: 1024";
+        auto [reference, optimized] = compare_with_reference(
+            [&] { reference_draw_string(20, 40, text, &Font16, BLACK, WHITE); },
+            [&] { Paint_DrawString_EN(20, 40, text, &Font16, BLACK, WHITE); });
+
+        REQUIRE(optimized.chip_select_assertions <= 12);
+        REQUIRE(optimized.chip_select_assertions * 100 <
+                reference.chip_select_assertions);
+        REQUIRE(optimized.bytes * 5 < reference.bytes);
+}
+
+TEST_CASE("Full-screen clear", "[.][benchmark][waveshare-lcd]")
+{
+        setup_display();
+
+        mock_spi_bus.reset_statistics();
+        reference_clear(BLACK);
+        double reference_us = mock_spi_bus.statistics().estimated_time_us;
+
+        mock_spi_bus.reset_statistics();
+        Paint_Clear(BLACK);
+        double streamed_us = mock_spi_bus.statistics().estimated_time_us;
+
+        WARN("Estimated full-screen clear time on the target: per-word "
+             << reference_us / 1000 << "ms, streamed " << streamed_us / 1000
+             << "ms");
+
+        BENCHMARK("Paint_Clear per-word (host, mocked SPI)")
+        {
+                reference_clear(BLACK);
+        };
+        BENCHMARK("Paint_Clear streamed (host, mocked SPI)")
+        {
+                Paint_Clear(BLACK);
+        };
+}